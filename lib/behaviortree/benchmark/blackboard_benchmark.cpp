@@ -0,0 +1,68 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/blackboard.h"
+
+using namespace behaviortree;
+
+namespace {
+struct Pose {
+    double x;
+    double y;
+    double theta;
+};
+
+// Reads of one entry per microsecond, while writersNum threads Set() it.
+template<typename ReadFunction>
+double MeasureReads(Blackboard &rBlackboard, int writersNum, ReadFunction readFunction) {
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writerVec;
+    for(int w = 0; w < writersNum; w++) {
+        writerVec.emplace_back([&rBlackboard, &stop, w]() {
+            for(int i = 0; !stop.load(std::memory_order_relaxed); i++) {
+                rBlackboard.Set("pose", Pose{double(i), double(w), 0.0});
+            }
+        });
+    }
+
+    constexpr int READS_NUM = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < READS_NUM; i++) {
+        readFunction();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+    stop = true;
+    for(auto &rWriter: writerVec) {
+        rWriter.join();
+    }
+    return READS_NUM / elapsed.count();
+}
+}// namespace
+
+TEST_SUITE("blackboard_benchmark") {
+    TEST_CASE("optimistic_vs_locked_reads") {
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("pose", Pose{0.0, 0.0, 0.0});
+
+        for(int writersNum: {0, 1, 2, 4, 8, 16}) {
+            Pose pose{};
+            const double optimisticReads = MeasureReads(*pBlackboard, writersNum, [&]() {
+                auto stamp = pBlackboard->GetStamped("pose", pose);
+                REQUIRE(stamp.has_value());
+            });
+            const double lockedReads = MeasureReads(*pBlackboard, writersNum, [&]() {
+                auto anyLocked = pBlackboard->GetAnyLocked("pose");
+                pose = anyLocked.Get()->Cast<Pose>();
+            });
+            MESSAGE("writers: " << writersNum
+                                << ", GetStamped: " << optimisticReads << " reads/us"
+                                << ", GetAnyLocked: " << lockedReads << " reads/us");
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#include <chrono>
+#include <optional>
+#include <utility>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/blackboard.h"
+#include "behaviortree/util/clock.h"
+
+using namespace behaviortree;
+
+TEST_SUITE("clock_benchmark") {
+    TEST_CASE("set_throughput_per_mode") {
+        constexpr int SETS_NUM = 1000000;
+        const std::pair<Clock::Mode, const char *> modeArr[] = {
+                {Clock::Mode::Precise, "Precise"},
+                {Clock::Mode::Coarse, "Coarse"},
+                {Clock::Mode::TickCached, "TickCached"},
+                {Clock::Mode::Virtual, "Virtual"}};
+
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("value", 0);
+        for(const auto &[mode, pName]: modeArr) {
+            Clock::SetMode(mode);
+            // a whole tick: every Set() shares the same time
+            std::optional<Clock::TickScope> tickScope;
+            if(mode == Clock::Mode::TickCached) {
+                tickScope.emplace();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for(int i = 0; i < SETS_NUM; i++) {
+                pBlackboard->Set("value", i);
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            MESSAGE(pName << ": " << elapsed.count() / SETS_NUM << " ns/Set");
+        }
+        Clock::SetMode(Clock::Mode::Precise);
+    }
+}
@@ -0,0 +1,45 @@
+#include <chrono>
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+#include "helper/tree_text.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+double MeasureTick(Tree &rTree, int ticksNum) {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < ticksNum; i++) {
+        rTree.TickExactlyOnce();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ticksNum;
+}
+}// namespace
+
+TEST_SUITE("compiled_tree_benchmark") {
+    TEST_CASE("compiled_vs_execute_tick") {
+        constexpr int TICKS_NUM = 20000;
+        for(int branchesNum: {4, 32, 256}) {
+            // every tick visits all the nodes
+            const std::string text = MakeTreeText(branchesNum, 7);
+
+            BehaviorTreeFactory factory;
+            auto interpretedTree = factory.CreateTreeFromText(text);
+            auto compiledTree = factory.CreateTreeFromText(text);
+            compiledTree.Compile();
+
+            const double interpretedNs = MeasureTick(interpretedTree, TICKS_NUM);
+            const double compiledNs = MeasureTick(compiledTree, TICKS_NUM);
+            MESSAGE("nodes: " << compiledTree.GetCompiledTree()->GetNodesNum()
+                              << ", ExecuteTick: " << interpretedNs << " ns/tick"
+                              << ", compiled: " << compiledNs << " ns/tick"
+                              << ", speed-up: " << interpretedNs / compiledNs);
+            CHECK(compiledTree.TickExactlyOnce() == interpretedTree.TickExactlyOnce());
+        }
+    }
+}
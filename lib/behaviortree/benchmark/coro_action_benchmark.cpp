@@ -0,0 +1,60 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+#include "behaviortree/util/coro_stack_pool.h"
+
+#include "helper/yield_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+// Coroutines started per second, with all the nodes RUNNING at the same time.
+double MeasureStarts(const std::vector<TreeNode::Ptr> &rNodeVec, int roundsNum) {
+    auto start = std::chrono::steady_clock::now();
+    for(int round = 0; round < roundsNum; round++) {
+        for(const auto &pNode: rNodeVec) {
+            pNode->ExecuteTick();
+        }
+        for(const auto &pNode: rNodeVec) {
+            pNode->ExecuteTick();
+            pNode->HaltNode();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return double(rNodeVec.size()) * roundsNum / elapsed.count();
+}
+}// namespace
+
+TEST_SUITE("coro_action_benchmark") {
+    TEST_CASE("starts_per_second_with_10k_nodes") {
+        constexpr size_t NODES_NUM = 10000;
+        constexpr int ROUNDS_NUM = 10;
+        const auto previousOptions = CoroStackPool::GetOptions();
+
+        BehaviorTreeFactory factory;
+        const auto nodeVec = CreateYieldNodes(factory, NODES_NUM);
+
+        for(size_t stackSize: {size_t(16 * 1024), size_t(64 * 1024)}) {
+            // without a cache, every start allocates a new stack
+            CoroStackPool::SetOptions({stackSize, 0});
+            const double allocatedRate = MeasureStarts(nodeVec, ROUNDS_NUM);
+
+            CoroStackPool::SetOptions({stackSize, NODES_NUM});
+            const auto before = CoroStackPool::GetStats();
+            const double pooledRate = MeasureStarts(nodeVec, ROUNDS_NUM);
+            const auto after = CoroStackPool::GetStats();
+
+            MESSAGE("stack: " << stackSize / 1024 << " KiB"
+                              << ", allocated: " << allocatedRate << " starts/s"
+                              << ", pooled: " << pooledRate << " starts/s"
+                              << ", reused: " << after.reusedNum - before.reusedNum << "/" << NODES_NUM * ROUNDS_NUM
+                              << ", max stack usage: " << after.maxStackUsage << " B");
+        }
+        CoroStackPool::SetOptions(previousOptions);
+    }
+}
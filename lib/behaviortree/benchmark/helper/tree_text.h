@@ -0,0 +1,33 @@
+#ifndef BEHAVIORTREE_BENCHMARK_TREE_TEXT_H
+#define BEHAVIORTREE_BENCHMARK_TREE_TEXT_H
+
+#include <string>
+#include <string_view>
+
+namespace behaviortree::testing {
+/**
+ * @brief The text of the tree "Main": a root Sequence of branchesNum Fallbacks,
+ * each with leavesNum inverted AlwaysSuccess followed by lastChild.
+ *
+ * @param otherTrees    the other trees of the text, e.g. the subtrees used
+ *                      by lastChild, each preceded by a comma.
+ */
+inline std::string MakeTreeText(int branchesNum, int leavesNum, std::string_view lastChild = R"({"type": "AlwaysSuccess"})", std::string_view otherTrees = {}) {
+    std::string text = R"({"mainTreeToExecute": "Main", "behaviortree": [{"treeName": "Main", "root": {"type": "Sequence", "children": [)";
+    for(int i = 0; i < branchesNum; i++) {
+        text += i ? "," : "";
+        text += R"({"type": "Fallback", "children": [)";
+        for(int j = 0; j < leavesNum; j++) {
+            text += R"({"type": "Inverter", "children": [{"type": "AlwaysSuccess"}]},)";
+        }
+        text += lastChild;
+        text += "]}";
+    }
+    text += "]}}";
+    text += otherTrees;
+    text += "]}";
+    return text;
+}
+}// namespace behaviortree::testing
+
+#endif// BEHAVIORTREE_BENCHMARK_TREE_TEXT_H
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/scripting/operators.hpp"
+#include "behaviortree/scripting/script_program.hpp"
+
+using namespace behaviortree;
+
+namespace {
+using Ast::ExprAssignment;
+using Ast::ExprBinaryArithmetic;
+using Ast::ExprComparison;
+using ExprVec = std::vector<Ast::PtrExpr>;
+
+Ast::PtrExpr Name(const std::string &rName) {
+    return std::make_shared<Ast::ExprName>(rName);
+}
+
+Ast::PtrExpr Number(double value) {
+    return std::make_shared<Ast::ExprLiteral>(Any(value));
+}
+
+Ast::PtrExpr Binary(Ast::PtrExpr pLhs, ExprBinaryArithmetic::op_t op, Ast::PtrExpr pRhs) {
+    return std::make_shared<ExprBinaryArithmetic>(std::move(pLhs), op, std::move(pRhs));
+}
+
+template<typename Function>
+double MeasureNs(int runsNum, Function function) {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < runsNum; i++) {
+        function();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / runsNum;
+}
+
+void Compare(const char *pTitle, const ExprVec &rExprVec) {
+    constexpr int RUNS_NUM = 200000;
+    auto pBlackboard = Blackboard::Create();
+    pBlackboard->Set("x", 3.0);
+    pBlackboard->Set("y", 4.0);
+    pBlackboard->Set("z", 0.5);
+    Ast::Environment env{pBlackboard, {}};
+
+    const double astNs = MeasureNs(RUNS_NUM, [&]() {
+        for(const auto &pExpr: rExprVec) {
+            pExpr->evaluate(env);
+        }
+    });
+
+    auto pProgram = ScriptProgram::Compile(rExprVec);
+    REQUIRE(pProgram != nullptr);
+    ScriptProgram::EntryCache entryCache(*pProgram, pBlackboard);
+    const double programNs = MeasureNs(RUNS_NUM, [&]() {
+        pProgram->Execute(env, &entryCache);
+    });
+    MESSAGE(pTitle << ": tree-walker " << astNs << " ns, bytecode " << programNs << " ns, speed-up " << astNs / programNs);
+}
+}// namespace
+
+TEST_SUITE("script_program_benchmark") {
+    TEST_CASE("bytecode_vs_tree_walker") {
+        // (x + y) * z - x / y
+        Compare("arithmetic", {Binary(Binary(Binary(Name("x"), ExprBinaryArithmetic::plus, Name("y")), ExprBinaryArithmetic::times, Name("z")), ExprBinaryArithmetic::minus, Binary(Name("x"), ExprBinaryArithmetic::div, Name("y")))});
+
+        // z < x < y + 1
+        auto pComparison = std::make_shared<ExprComparison>();
+        pComparison->operands = {Name("z"), Name("x"), Binary(Name("y"), ExprBinaryArithmetic::plus, Number(1))};
+        pComparison->ops = {ExprComparison::less, ExprComparison::less};
+        Compare("comparison", {pComparison});
+
+        // x = y * z; y += 1
+        Compare("assignment", {std::make_shared<ExprAssignment>(Name("x"), ExprAssignment::assign_existing, Binary(Name("y"), ExprBinaryArithmetic::times, Name("z"))),
+                               std::make_shared<ExprAssignment>(Name("y"), ExprAssignment::assign_plus, Number(1))});
+    }
+}
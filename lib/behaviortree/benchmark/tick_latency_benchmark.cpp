@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+#include "helper/delayed_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Delayed"}}
+})";
+
+double Percentile(std::vector<double> latencyVec, double percentile) {
+    std::sort(latencyVec.begin(), latencyVec.end());
+    return latencyVec[size_t(percentile * double(latencyVec.size() - 1))];
+}
+
+template<typename TickT>
+DelayedSamples MeasureLatency(int activationsNum, TickT &&rTick) {
+    DelayedSamples samples;
+    samples.minDelay = std::chrono::milliseconds(1);
+    samples.maxDelay = std::chrono::milliseconds(40);
+    samples.latencyVec.reserve(activationsNum);
+    BehaviorTreeFactory factory;
+    factory.RegisterNodeType<DelayedAction>("Delayed", &samples);
+    auto tree = factory.CreateTreeFromText(TREE_TEXT);
+    for(int i = 0; i < activationsNum; i++) {
+        rTick(tree);
+    }
+    return samples;
+}
+}// namespace
+
+TEST_SUITE("tick_latency_benchmark") {
+    TEST_CASE("fixed_sleep_vs_on_event") {
+        constexpr int ACTIVATIONS_NUM = 100;
+        const DelayedSamples fixedSamples = MeasureLatency(ACTIVATIONS_NUM, [](Tree &rTree) {
+            rTree.TickWhileRunning(std::chrono::milliseconds(10));
+        });
+        const DelayedSamples eventSamples = MeasureLatency(ACTIVATIONS_NUM, [](Tree &rTree) {
+            rTree.TickWhileRunningOnEvent();
+        });
+        REQUIRE(fixedSamples.latencyVec.size() == ACTIVATIONS_NUM);
+        REQUIRE(eventSamples.latencyVec.size() == ACTIVATIONS_NUM);
+
+        for(const auto &[pMode, pSamples]: {std::pair{"TickWhileRunning(10ms)", &fixedSamples}, std::pair{"TickWhileRunningOnEvent()", &eventSamples}}) {
+            const auto &rLatencyVec = pSamples->latencyVec;
+            MESSAGE(pMode << " latency: p50 " << Percentile(rLatencyVec, 0.5)
+                          << " us, p90 " << Percentile(rLatencyVec, 0.9)
+                          << " us, p99 " << Percentile(rLatencyVec, 0.99)
+                          << " us, max " << Percentile(rLatencyVec, 1.0)
+                          << " us, ticks per activation: " << double(pSamples->runningNum) / ACTIVATIONS_NUM);
+        }
+        // only the wake-up ticks the action again
+        CHECK(eventSamples.runningNum == ACTIVATIONS_NUM);
+        CHECK(fixedSamples.runningNum > ACTIVATIONS_NUM);
+    }
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+#include "helper/tree_text.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+const char *SUBTREE_TEXT = R"({"type": "Subtree", "id": "Child", "target": "{goal}", "value": "1"})";
+
+const char *CHILD_TREE_TEXT = R"(, {"treeName": "Child", "root": {"type": "Sequence", "children": [
+  {"type": "SetBlackboard", "value": "{value}", "output_key": "target"}, {"type": "AlwaysSuccess"}]}})";
+
+template<typename Create>
+double MeasureCreate(Create &&rCreate, int treesNum) {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < treesNum; i++) {
+        auto tree = rCreate();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return treesNum / elapsed.count();
+}
+}// namespace
+
+TEST_SUITE("tree_template_benchmark") {
+    TEST_CASE("create_tree_from_template") {
+        constexpr int TREES_NUM = 500;
+        for(int branchesNum: {4, 32, 128}) {
+            // each branch ends with a Subtree with a remapped port and a constant
+            const std::string text = MakeTreeText(branchesNum, 3, SUBTREE_TEXT, CHILD_TREE_TEXT);
+
+            BehaviorTreeFactory factory;
+            factory.RegisterBehaviorTreeFromText(text);
+            auto pTemplate = factory.GetTreeTemplate("Main");
+            REQUIRE(pTemplate != nullptr);
+
+            const double fromTextRate = MeasureCreate([&]() {
+                return factory.CreateTreeFromText(text);
+            }, TREES_NUM);
+            const double fromIdRate = MeasureCreate([&]() {
+                return factory.CreateTree("Main");
+            }, TREES_NUM);
+            const double fromTemplateRate = MeasureCreate([&]() {
+                return factory.CreateTree(*pTemplate);
+            }, TREES_NUM);
+            MESSAGE("nodes: " << pTemplate->GetNodesNum()
+                              << ", from text: " << fromTextRate << " trees/s"
+                              << ", from id: " << fromIdRate << " trees/s"
+                              << ", from template: " << fromTemplateRate << " trees/s"
+                              << ", speed-up: " << fromTemplateRate / fromIdRate);
+
+            auto pBlackboard = Blackboard::Create();
+            auto tree = factory.CreateTree(*pTemplate, pBlackboard);
+            CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+            CHECK(pBlackboard->Get<std::string>("goal") == "1");
+        }
+    }
+}
@@ -38,20 +38,23 @@ class BEHAVIORTREE_API ScriptCondition: public ConditionNode {
         if(!GetInput("code", script)) {
             throw util::RuntimeError("Missing port [code] in ScriptCondition");
         }
-        if(script == m_script) {
+        // the enums are assigned after the construction of the node
+        if(script == m_script and GetConfig().pEnums == m_pEnums) {
             return;
         }
-        auto executor = ParseScript(script);
+        auto executor = ParseScript(script, {GetConfig().pBlackboard, GetConfig().pEnums});
         if(!executor) {
             throw util::RuntimeError(executor.error());
         } else {
             m_executor = executor.value();
             m_script = script;
+            m_pEnums = GetConfig().pEnums;
         }
     }
 
     std::string m_script;
     ScriptFunction m_executor;
+    EnumsTablePtr m_pEnums;
 };
 
 }// namespace behaviortree
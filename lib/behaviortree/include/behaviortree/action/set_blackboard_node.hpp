@@ -36,8 +36,8 @@ class BEHAVIORTREE_API SetBlackboardNode: public SyncActionNode {
  private:
     virtual behaviortree::NodeStatus Tick() override {
         std::string outputKey;
-        if(!GetInput("outputKey", outputKey)) {
-            throw util::RuntimeError("missing port [outputKey]");
+        if(!GetInput("output_key", outputKey)) {
+            throw util::RuntimeError("missing port [output_key]");
         }
 
         const std::string valueStr = GetConfig().inputPortMap.at("value");
@@ -55,7 +55,14 @@ class BEHAVIORTREE_API SetBlackboardNode: public SyncActionNode {
                 GetConfig().pBlackboard->CreateEntry(outputKey, pSrcEntry->typeInfo);
                 pDstEntry = GetConfig().pBlackboard->GetEntry(outputKey);
             }
-            pDstEntry->value = pSrcEntry->value;
+            if(pDstEntry != pSrcEntry) {
+                {
+                    std::scoped_lock lock(pSrcEntry->entryMutex, pDstEntry->entryMutex);
+                    pDstEntry->value = pSrcEntry->value;
+                    pDstEntry->InvalidateSnapshot();
+                }
+                GetConfig().pBlackboard->NotifyWatchers(outputKey, Blackboard::EntryEvent::Updated);
+            }
         } else {
             GetConfig().pBlackboard->Set(outputKey, valueStr);
         }
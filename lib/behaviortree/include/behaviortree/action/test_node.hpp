@@ -71,10 +71,14 @@ class BEHAVIORTREE_API TestNode: public behaviortree::StatefulActionNode {
 
     NodeStatus OnCompleted();
 
+    // bind the scripts to the environment of the node
+    void PrepareScripts();
+
     TestNodeConfig m_testConfig;
     ScriptFunction m_successExecutor;
     ScriptFunction m_failureExecutor;
     ScriptFunction m_postExecutor;
+    EnumsTablePtr m_pScriptEnums;
     TimerQueue<> m_timerQueue;
     std::atomic_bool m_completed{false};
 };
@@ -2,10 +2,11 @@
 #define BEHAVIORTREE_ACTION_NODE_H
 
 #include <atomic>
-#include <future>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 
+#include "behaviortree/action_pool.h"
 #include "behaviortree/common.h"
 #include "leaf_node.h"
 
@@ -90,6 +91,16 @@ class SimpleActionNode: public SyncActionNode {
  *
  * For a complete example, look at __AsyncActionTest__ in action_test_node.h in the folder test.
  *
+ * The tick() is executed by the worker threads of an ActionPool (by default
+ * ActionPool::GetDefault(), see SetActionPool()). Halt() cancels the token
+ * read by IsHaltRequested() and returns immediately: the tick() should check
+ * it regularly, and the status it returns after a Halt() is discarded.
+ * If the node is ticked again before the halted tick() returned, the new
+ * activation is RUNNING and starts once the previous one has completed, so
+ * that two tick() never run at the same time. Only the destructor waits for
+ * the tick(). The status callbacks are never invoked with the internal mutex
+ * held, and must not halt the node.
+ *
  * NOTE: when the thread is completed, i.e. the tick() returns its status,
  * a TreeNode::emitWakeUpSignal() will be called.
  */
@@ -98,20 +109,46 @@ class ThreadedAction: public ActionNodeBase {
  public:
     ThreadedAction(const std::string &rName, const NodeConfig &rConfig): ActionNodeBase(rName, rConfig) {}
 
+    /// Wait for the tick() still running, if any (the node wasn't halted).
+    ~ThreadedAction() override;
+
     bool IsHaltRequested() const {
-        return m_haltRequested.load();
+        std::unique_lock lock(m_mutex);
+        return m_token.IsCancelled();
     }
 
-    // This method spawn a new thread. Do NOT remove the "final" keyword.
+    /**
+     * @brief Execute the tick() on pPool instead of the default pool.
+     * pLimit, if not null, bounds the jobs in flight of a group of nodes
+     * (see Tree::SetActionPool()). Takes effect at the next activation.
+     */
+    void SetActionPool(ActionPool::Ptr pPool, ActionPool::Limit::Ptr pLimit = {});
+
+    // This method submits the tick() to the pool. Do NOT remove the "final" keyword.
     virtual NodeStatus ExecuteTick() override final;
 
     virtual void Halt() override;
 
  private:
+    // require m_mutex
+    void StartJob();
+
+    // the job that completes the activation of m_token
+    void RunJob(const CancellationToken &rToken);
+
     std::exception_ptr m_exptr;
-    std::atomic_bool m_haltRequested{false};
-    std::future<void> m_threadHandle;
-    std::mutex m_mutex;
+    ActionPool::Ptr m_pPool;
+    ActionPool::Limit::Ptr m_pLimit;
+    // token of the current activation
+    CancellationToken m_token;
+    // a tick() is waiting in the pool or running
+    bool m_jobActive{false};
+    // the node was ticked again while the job of a halted activation was running
+    bool m_startPending{false};
+    std::condition_variable m_jobCv;
+    mutable std::mutex m_mutex;
+    // serializes the status set by the job with the one reset by Halt()
+    std::mutex m_statusMutex;
 };
 
 /**
@@ -162,6 +199,9 @@ class StatefulActionNode: public ActionNodeBase {
  *
  * It is up to the user to decide when to suspend execution of the Action and resume
  * the parent node, invoking the method setStatusRunningAndYield().
+ *
+ * The stacks of the coroutines are recycled between activations (and between
+ * nodes) by CoroStackPool, which also sets their size.
  */
 class CoroActionNode: public ActionNodeBase {
  public:
@@ -0,0 +1,115 @@
+#ifndef BEHAVIORTREE_ACTION_POOL_H
+#define BEHAVIORTREE_ACTION_POOL_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "behaviortree/common.h"
+
+namespace behaviortree {
+/**
+ * @brief Shared flag used to ask a job to stop. Copies refer to the same flag.
+ */
+class CancellationToken {
+ public:
+    CancellationToken(): m_pCancelled(std::make_shared<std::atomic_bool>(false)) {}
+
+    void Cancel() const {
+        m_pCancelled->store(true, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool IsCancelled() const {
+        return m_pCancelled->load(std::memory_order_acquire);
+    }
+
+ private:
+    std::shared_ptr<std::atomic_bool> m_pCancelled;
+};
+
+/**
+ * @brief ActionPool executes the body of the ThreadedAction nodes on the
+ * worker threads of a shadow::thread::Pool, instead of spawning a thread
+ * for each activation.
+ *
+ * The number of jobs in flight (queued in the pool or running) can be bounded
+ * for the whole pool (Options::maxInFlight) and for a group of jobs, usually
+ * the actions of a tree (see Limit and Tree::SetActionPool()).
+ * The jobs exceeding a limit wait, in FIFO order, until a job of the same
+ * pool completes. Jobs cancelled while waiting bypass the limits, so that
+ * they complete as soon as possible.
+ *
+ * Unless configured otherwise, all the ThreadedAction nodes share GetDefault().
+ */
+class BEHAVIORTREE_API ActionPool {
+ public:
+    using Ptr = std::shared_ptr<ActionPool>;
+    using Job = std::function<void()>;
+
+    struct Options {
+        // 0 means std::thread::hardware_concurrency()
+        size_t threadsNum{0};
+        // 0 means unlimited
+        size_t maxInFlight{0};
+    };
+
+    /// Bound on the jobs in flight of a group. A Limit must be used with
+    /// a single pool.
+    class Limit {
+     public:
+        using Ptr = std::shared_ptr<Limit>;
+
+        /// @param maxInFlight 0 means unlimited.
+        explicit Limit(size_t maxInFlight): m_maxInFlight(maxInFlight) {}
+
+        [[nodiscard]] size_t GetMaxInFlight() const {
+            return m_maxInFlight;
+        }
+
+     private:
+        friend class ActionPool;
+
+        const size_t m_maxInFlight;
+        // guarded by the mutex of the pool
+        size_t m_inFlightNum{0};
+    };
+
+    /// The pool shared by default, with a thread per core and no limit.
+    [[nodiscard]] static Ptr GetDefault();
+
+    ActionPool();
+
+    explicit ActionPool(const Options &rOptions);
+
+    ActionPool(const ActionPool &rOther) = delete;
+    ActionPool &operator=(const ActionPool &rOther) = delete;
+
+    /// Wait for all the jobs, including the ones waiting for a limit.
+    ~ActionPool();
+
+    /**
+     * @brief Execute a job on a worker thread, as soon as the limits allow it.
+     * The job is always executed, even if cancelled: it is up to the job
+     * to check the token.
+     */
+    void Submit(Job job, const CancellationToken &rToken, const Limit::Ptr &pLimit = {});
+
+    /// Cancel the token and release the jobs that were waiting with it.
+    void Cancel(const CancellationToken &rToken);
+
+    [[nodiscard]] size_t GetThreadsNum() const;
+
+    /// Jobs queued in the pool or running.
+    [[nodiscard]] size_t GetInFlightNum() const;
+
+    /// Jobs waiting for a limit.
+    [[nodiscard]] size_t GetPendingNum() const;
+
+ private:
+    struct PImpl;
+    std::unique_ptr<PImpl> m_pPImpl;
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_ACTION_POOL_H
@@ -14,6 +14,7 @@
 #include "behaviortree/action/updated_action.hpp"
 #include "behaviortree/action_node.h"
 #include "behaviortree/common.h"
+#include "behaviortree/compiled_tree.h"
 #include "behaviortree/condition_node.h"
 #include "behaviortree/control/fallback_node.hpp"
 #include "behaviortree/control/if_then_else_node.hpp"
@@ -25,6 +26,7 @@
 #include "behaviortree/control/sequence_with_memory_node.hpp"
 #include "behaviortree/control/switch_node.hpp"
 #include "behaviortree/control/while_do_else_node.hpp"
+#include "behaviortree/coroutine_action_node.h"
 #include "behaviortree/decorator/delay_node.h"
 #include "behaviortree/decorator/force_failure_node.h"
 #include "behaviortree/decorator/force_success_node.h"
@@ -1,8 +1,15 @@
 #ifndef BEHAVIORTREE_BLACKBOARD_H
 #define BEHAVIORTREE_BLACKBOARD_H
 
+import <array>;
+import <atomic>;
+import <cstring>;
+import <deque>;
+import <functional>;
+import <limits>;
 import <memory>;
 import <mutex>;
+import <shared_mutex>;
 import <string>;
 import <unordered_map>;
 
@@ -10,6 +17,7 @@ import common.exception;
 
 #include "behaviortree/basic_types.h"
 #include "behaviortree/common.h"
+#include "behaviortree/util/clock.h"
 #include "behaviortree/util/locked_reference.hpp"
 #include "behaviortree/util/safe_any.hpp"
 #include "nlohmann/json.hpp"
@@ -36,22 +44,84 @@ class Blackboard {
 
  protected:
     // This is intentionally protected. Use Blackboard::create instead
-    Blackboard(Blackboard::Ptr pParentBlackboard): m_pParentBlackboard(pParentBlackboard) {}
+    Blackboard(Blackboard::Ptr pParentBlackboard): m_pSlotStorage(std::make_shared<SlotStorage>()),
+                                                   m_pParentBlackboard(pParentBlackboard) {}
 
  public:
+    /// Interned identifier of a key, i.e. the index of its slot in this blackboard.
+    using KeyId = uint32_t;
+
+    static constexpr KeyId InvalidKeyId = std::numeric_limits<KeyId>::max();
+
+    enum class EntryEvent : uint8_t {
+        Updated = 0,
+        Removed = 1
+    };
+
+    using WatchCallback = std::function<void(const std::string &rKey, EntryEvent event)>;
+    /// The watch is active until the subscriber goes out of scope.
+    using WatchSubscriber = std::shared_ptr<WatchCallback>;
+
     struct Entry {
         Any value;
         TypeInfo typeInfo;
         StringConverter stringConverter;
-        mutable std::mutex entryMutex;
+        // exclusive for the writers, shared for the readers (see LockedView)
+        mutable std::shared_mutex entryMutex;
 
         uint64_t sequenceId{0};
         // timestamp since epoch
         std::chrono::nanoseconds stamp{std::chrono::nanoseconds{0}};
 
+        // true once the entry has been removed from its blackboard.
+        // Used to invalidate handles cached outside the blackboard (see PortBinding).
+        std::atomic_bool detached{false};
+
         Entry(const TypeInfo &rTypeInfo): typeInfo(rTypeInfo) {}
 
         Entry &operator=(const Entry &rOther);
+
+        static constexpr size_t SnapshotWords = 2;
+
+        /// Values of type T can be read optimistically, without locking entryMutex.
+        template<typename T>
+        static constexpr bool HasSnapshot = std::is_trivially_copyable_v<T> and sizeof(T) <= SnapshotWords * sizeof(uint64_t);
+
+        /**
+         * @brief Seqlock-protected copy of the value, used by TryReadSnapshot().
+         * Must be called with entryMutex locked, after value, sequenceId
+         * and stamp have been updated.
+         */
+        template<typename T>
+        void PublishSnapshot(const T &rValue);
+
+        /// Must be called with entryMutex locked, every time value is modified
+        /// without PublishSnapshot(), so that the readers use the lock.
+        void InvalidateSnapshot();
+
+        /**
+         * @brief Optimistic read: copy the snapshot and check that no writer
+         * modified it in the meanwhile. Never blocks.
+         *
+         * @return false if there is no valid snapshot of type T, or if
+         * the read kept conflicting with a writer. Lock entryMutex and
+         * read value, in that case.
+         */
+        template<typename T>
+        [[nodiscard]] bool TryReadSnapshot(T &rValue, Timestamp *pStamp = nullptr) const;
+
+     private:
+        using SnapshotWordArr = std::array<uint64_t, SnapshotWords>;
+
+        // odd while a writer is updating the snapshot
+        std::atomic<uint64_t> m_snapshotVersion{0};
+        // nullptr if the snapshot is not valid
+        std::atomic<const std::type_info *> m_pSnapshotType{nullptr};
+        std::array<std::atomic<uint64_t>, SnapshotWords> m_snapshotWordArr{};
+        std::atomic<uint64_t> m_snapshotSequenceId{0};
+        std::atomic<int64_t> m_snapshotStamp{0};
+
+        void WriteSnapshot(const std::type_info *pType, const SnapshotWordArr &rWordArr);
     };
 
     /** Use this static method to create an instance of the BlackBoard
@@ -69,6 +139,23 @@ class Blackboard {
 
     [[nodiscard]] std::shared_ptr<Blackboard::Entry> GetEntry(const std::string &rKey);
 
+    /**
+     * @brief GetKeyId returns the interned ID of a key stored in this blackboard.
+     * IDs are assigned when the entry is created (usually while the tree is built)
+     * and never change: an entry removed with Unset() and created again keeps its ID.
+     *
+     * Note: remapped keys and keys of the parent blackboard are not resolved.
+     *
+     * @return InvalidKeyId if the key is not stored in this blackboard.
+     */
+    [[nodiscard]] KeyId GetKeyId(const std::string &rKey) const;
+
+    /// O(1) access to an entry by its interned ID, without hashing the key.
+    /// Return nullptr if the ID is invalid or the entry has been removed.
+    [[nodiscard]] std::shared_ptr<Entry> GetEntry(KeyId keyId) const;
+
+    /// The value is locked exclusively. Modifying it through the returned
+    /// pointer invalidates the snapshot of the entry (see TryReadSnapshot()).
     [[nodiscard]] AnyPtrLocked GetAnyLocked(const std::string &rKey);
 
     [[nodiscard]] AnyPtrLocked GetAnyLocked(const std::string &rKey) const;
@@ -95,8 +182,75 @@ class Blackboard {
     template<typename T>
     void Set(const std::string &rKey, const T &rValue);
 
+    /// Same as Set(key, value), moving rValue into the entry.
+    template<typename T, typename = std::enable_if_t<!std::is_reference_v<T>>>
+    void Set(const std::string &rKey, T &&rValue);
+
+    /// Same as Set(key, T(args...)): the value is built, then moved into the entry.
+    template<typename T, typename... Args>
+    void Emplace(const std::string &rKey, Args &&...args);
+
+    /**
+     * @brief Modify invokes fn(T &) on the value of the entry, in place, with
+     * the entry locked; then it updates the Timestamp of the entry and
+     * notifies the watchers. Use it to update large containers a little at a
+     * time, without copying them.
+     *
+     * T must be the type of the value, without conversion. Custom types,
+     * double and uint64_t are modified in place; strings and the other
+     * arithmetic types, that Any stores converted, are modified on a copy
+     * stored back with their type. Throws if the entry doesn't exist or
+     * doesn't contain a T.
+     */
+    template<typename T, typename Fn>
+    void Modify(const std::string &rKey, Fn &&fn);
+
+    /**
+     * @brief SetEntryValue updates an entry that was already retrieved with
+     * GetEntry(), applying the same type checks as Set(), and notifies
+     * the watchers of rKey.
+     *
+     * @param rEntry  the entry to update.
+     * @param rKey    name of the entry, used only in error messages.
+     * @param rValue  new value
+     */
+    template<typename T>
+    void SetEntryValue(Entry &rEntry, const std::string &rKey, const T &rValue);
+
+    /// Same as SetEntryValue(entry, key, value), moving rValue into the entry.
+    template<typename T, typename = std::enable_if_t<!std::is_reference_v<T>>>
+    void SetEntryValue(Entry &rEntry, const std::string &rKey, T &&rValue);
+
     void Unset(const std::string &rKey);
 
+    /**
+     * @brief Watch subscribes a callback to the changes of an entry: it is
+     * invoked after every Set() (EntryEvent::Updated) or Unset()
+     * (EntryEvent::Removed) of the key.
+     *
+     * If the key is remapped (or auto-remapped) to a parent blackboard, the
+     * watch is registered on the blackboard that owns the entry: the changes
+     * done by the parent, or by any child that remaps the key, are notified too.
+     * The callback is invoked in the thread of the writer, without any lock of
+     * the blackboard being held; keep it short.
+     *
+     * @return the subscriber handle; the callback is removed when it is destroyed.
+     * The destruction waits for the invocations of the callback that are running
+     * in other threads, therefore the callback can safely capture its owner.
+     */
+    [[nodiscard]] WatchSubscriber Watch(const std::string &rKey, WatchCallback callback);
+
+    /// Same as Watch(), for all the keys starting with rPrefix.
+    /// An empty prefix watches every key of the blackboard.
+    [[nodiscard]] WatchSubscriber WatchPrefix(const std::string &rPrefix, WatchCallback callback);
+
+    /**
+     * @brief NotifyWatchers invokes the callbacks watching rKey.
+     * Called automatically by Set() and Unset(); code that writes the value
+     * of an Entry directly must call it after releasing the entry's mutex.
+     */
+    void NotifyWatchers(const std::string &rKey, EntryEvent event);
+
     [[nodiscard]] const TypeInfo *GetEntryInfo(const std::string &rKey);
 
     void AddSubtreeRemapping(std::string_view internal, std::string_view external);
@@ -118,6 +272,13 @@ class Blackboard {
    */
     void CloneInto(Blackboard &rDst) const;
 
+    /**
+     * @brief Clone creates a new blackboard, child of pParentBlackboard,
+     * with a copy of the local entries, the subtree remapping and the
+     * auto-remapping flag of this one. Watchers are not copied.
+     */
+    [[nodiscard]] Blackboard::Ptr Clone(Blackboard::Ptr pParentBlackboard) const;
+
     Blackboard::Ptr Parent();
 
     // recursively look for parent Blackboard, until you find the root
@@ -126,14 +287,67 @@ class Blackboard {
     const Blackboard *GetRootBlackboard() const;
 
  private:
+    // The entries live in a contiguous table of slots, indexed by KeyId.
+    // std::deque never relocates its elements, and the handles returned by
+    // GetEntry() share the ownership of the whole table (aliasing shared_ptr).
+    // Removed entries are detached and their value is released; the slot
+    // belongs to the key forever, and is reused if the key is created again.
+    struct SlotStorage {
+        std::deque<Entry> slotDeque;
+    };
+
     mutable std::mutex m_mutex;
     mutable std::recursive_mutex m_entryMutex;
-    std::unordered_map<std::string, std::shared_ptr<Entry>> m_storageMap;
+    std::shared_ptr<SlotStorage> m_pSlotStorage;
+    // interned keys: name of the key -> index of the slot
+    std::unordered_map<std::string, KeyId> m_keyIdMap;
+    // slots of the removed keys
+    std::unordered_map<std::string, KeyId> m_removedKeyIdMap;
     std::weak_ptr<Blackboard> m_pParentBlackboard;
     std::unordered_map<std::string, std::string> m_internalToExternalMap;
 
     std::shared_ptr<Entry> CreateEntryImpl(const std::string &rKey, const TypeInfo &rInfo);
 
+    // m_mutex must be locked
+    Entry &CreateSlot(const std::string &rKey, const TypeInfo &rInfo);
+
+    // m_mutex must be locked
+    void RemoveSlot(std::unordered_map<std::string, KeyId>::iterator keyIdIter);
+
+    std::shared_ptr<Entry> GetSlotHandle(Entry &rEntry) const {
+        return std::shared_ptr<Entry>(m_pSlotStorage, &rEntry);
+    }
+
+    template<typename T>
+    void SetImpl(const std::string &rKey, T &&rValue);
+
+    template<typename T>
+    void SetEntryValueImpl(Entry &rEntry, const std::string &rKey, T &&rValue);
+
+    // Shared by the subscriber and the watcher. The callback is invoked with
+    // mutex locked, and the subscriber clears active with mutex locked too.
+    struct WatchState {
+        std::recursive_mutex mutex;
+        bool active{true};
+        WatchCallback callback;
+    };
+
+    struct Watcher {
+        std::string pattern;
+        bool isPrefix{false};
+        std::weak_ptr<WatchCallback> pSubscriber;
+        std::shared_ptr<WatchState> pState;
+    };
+
+    mutable std::mutex m_watchMutex;
+    std::vector<Watcher> m_watcherVec;
+
+    // watchers of this blackboard; lets the writers skip the notification
+    // when nobody is watching
+    std::atomic<size_t> m_watchersNum{0};
+
+    WatchSubscriber AddWatcher(const std::string &rPattern, bool isPrefix, WatchCallback callback);
+
     bool m_autoRemapping{false};
 };
 
@@ -169,103 +383,271 @@ inline void Blackboard::Unset(const std::string &rKey) {
     std::unique_lock lock(m_mutex);
 
     // check local storage
-    auto it = m_storageMap.find(rKey);
-    if(it == m_storageMap.end()) {
+    auto it = m_keyIdMap.find(rKey);
+    if(it == m_keyIdMap.end()) {
         // No entry, nothing to do.
         return;
     }
+    RemoveSlot(it);
 
-    m_storageMap.erase(it);
+    lock.unlock();
+    NotifyWatchers(rKey, EntryEvent::Removed);
 }
 
 template<typename T>
 inline void Blackboard::Set(const std::string &rKey, const T &rValue) {
+    SetImpl(rKey, rValue);
+}
+
+template<typename T, typename>
+inline void Blackboard::Set(const std::string &rKey, T &&rValue) {
+    SetImpl(rKey, std::move(rValue));
+}
+
+template<typename T, typename... Args>
+inline void Blackboard::Emplace(const std::string &rKey, Args &&...args) {
+    SetImpl(rKey, T(std::forward<Args>(args)...));
+}
+
+template<typename T, typename Fn>
+inline void Blackboard::Modify(const std::string &rKey, Fn &&fn) {
+    auto pEntry = GetEntry(rKey);
+    if(pEntry == nullptr) {
+        throw util::RuntimeError("Blackboard::Modify() error. Missing key [", rKey, "]");
+    }
+    // see Any::CastPtr(): only these are stored without conversion
+    constexpr bool storedConverted = std::is_same_v<T, std::string> or std::is_same_v<T, SafeAny::SimpleString> or (std::is_arithmetic_v<T> and !std::is_same_v<T, double> and !std::is_same_v<T, uint64_t>);
+    {
+        std::scoped_lock scopedLock(pEntry->entryMutex);
+        if constexpr(storedConverted) {
+            if(pEntry->value.Empty() or pEntry->value.Type() != typeid(T)) {
+                throw util::RuntimeError("Blackboard::Modify() error. Entry [", rKey, "] doesn't contain a value of Type [", behaviortree::Demangle(typeid(T)), "]");
+            }
+            T value = pEntry->value.template Cast<T>();
+            pEntry->InvalidateSnapshot();
+            fn(value);
+            pEntry->value = Any(value);
+            pEntry->sequenceId++;
+            pEntry->stamp = Clock::Now();
+            pEntry->PublishSnapshot(value);
+        } else {
+            T *pValue = pEntry->value.template CastPtr<T>();
+            if(pValue == nullptr) {
+                throw util::RuntimeError("Blackboard::Modify() error. Entry [", rKey, "] doesn't contain a value of Type [", behaviortree::Demangle(typeid(T)), "]");
+            }
+            // the optimistic readers must wait for fn, and must not see the old
+            // value if it throws
+            pEntry->InvalidateSnapshot();
+            fn(*pValue);
+            pEntry->sequenceId++;
+            pEntry->stamp = Clock::Now();
+            if(pEntry->value.Type() == typeid(T)) {
+                pEntry->PublishSnapshot(*pValue);
+            }
+        }
+    }
+    NotifyWatchers(rKey, EntryEvent::Updated);
+}
+
+template<typename T>
+inline void Blackboard::SetImpl(const std::string &rKey, T &&rValue) {
+    using ValueT = std::decay_t<T>;
     if(StartWith(rKey, '@')) {
-        GetRootBlackboard()->Set(rKey.substr(1, rKey.size() - 1), rValue);
+        GetRootBlackboard()->SetImpl(rKey.substr(1, rKey.size() - 1), std::forward<T>(rValue));
         return;
     }
     std::unique_lock lock(m_mutex);
 
     // check local storage
-    auto it = m_storageMap.find(rKey);
-    Any newValue(rValue);
-    if(it == m_storageMap.end()) {
+    auto it = m_keyIdMap.find(rKey);
+    if(it == m_keyIdMap.end()) {
         lock.unlock();
+        // rValue may be moved here. The values that have a snapshot are trivially
+        // copyable, moving them doesn't change rValue.
+        Any newValue(std::forward<T>(rValue));
         std::shared_ptr<Blackboard::Entry> entry;
         // if a new generic port is created with a string, it's type should be AnyTypeAllowed
-        if constexpr(std::is_same_v<std::string, T>) {
+        if constexpr(std::is_same_v<std::string, ValueT>) {
             entry = CreateEntryImpl(rKey, PortInfo(PortDirection::InOut));
         } else {
             PortInfo newPort(
                     PortDirection::InOut, newValue.Type(),
-                    GetAnyFromStringFunctor<T>()
+                    GetAnyFromStringFunctor<ValueT>()
             );
             entry = CreateEntryImpl(rKey, newPort);
         }
         lock.lock();
 
-        entry->value = newValue;
+        std::scoped_lock entryLock(entry->entryMutex);
+        entry->value = std::move(newValue);
         entry->sequenceId++;
-        entry->stamp = std::chrono::steady_clock::now().time_since_epoch();
+        entry->stamp = Clock::Now();
+        if(entry->value.Type() == typeid(ValueT)) {
+            entry->PublishSnapshot(rValue);
+        } else {
+            entry->InvalidateSnapshot();
+        }
     } else {
         // this is not the first time we set this entry, we need to check
         // if the type is the same or not.
-        Entry &rEntry = *it->second;
-        std::scoped_lock scopedLock(rEntry.entryMutex);
-
-        Any &rPreviousAny = rEntry.value;
-        // special case: entry exists but it is not strongly typed... yet
-        if(!rEntry.typeInfo.IsStronglyTyped()) {
-            // Use the new type to create a new entry that is strongly typed.
-            rEntry.typeInfo = TypeInfo::Create<T>();
-            rEntry.sequenceId++;
-            rEntry.stamp = std::chrono::steady_clock::now().time_since_epoch();
-            rPreviousAny = std::move(newValue);
-            return;
-        }
+        SetEntryValueImpl(m_pSlotStorage->slotDeque[it->second], rKey, std::forward<T>(rValue));
+    }
 
-        std::type_index previousType = rEntry.typeInfo.Type();
-
-        // check type mismatch
-        if(previousType != std::type_index(typeid(T)) and
-           previousType != newValue.Type()) {
-            bool mismatching = true;
-            if(std::is_constructible<std::string_view, T>::value) {
-                Any anyFromString = rEntry.typeInfo.ParseString(rValue);
-                if(anyFromString.Empty() == false) {
-                    mismatching = false;
-                    newValue = std::move(anyFromString);
-                }
+    lock.unlock();
+    NotifyWatchers(rKey, EntryEvent::Updated);
+}
+
+template<typename T>
+inline void Blackboard::SetEntryValue(Entry &rEntry, const std::string &rKey, const T &rValue) {
+    SetEntryValueImpl(rEntry, rKey, rValue);
+    NotifyWatchers(rKey, EntryEvent::Updated);
+}
+
+template<typename T, typename>
+inline void Blackboard::SetEntryValue(Entry &rEntry, const std::string &rKey, T &&rValue) {
+    SetEntryValueImpl(rEntry, rKey, std::move(rValue));
+    NotifyWatchers(rKey, EntryEvent::Updated);
+}
+
+template<typename T>
+inline void Blackboard::SetEntryValueImpl(Entry &rEntry, const std::string &rKey, T &&rValue) {
+    using ValueT = std::decay_t<T>;
+    std::scoped_lock scopedLock(rEntry.entryMutex);
+
+    // rValue may be moved here. The values that have a snapshot are trivially
+    // copyable, moving them doesn't change rValue.
+    Any newValue(std::forward<T>(rValue));
+    Any &rPreviousAny = rEntry.value;
+    // special case: entry exists but it is not strongly typed... yet
+    if(!rEntry.typeInfo.IsStronglyTyped()) {
+        // Use the new type to create a new entry that is strongly typed.
+        rEntry.typeInfo = TypeInfo::Create<ValueT>();
+        rEntry.sequenceId++;
+        rEntry.stamp = Clock::Now();
+        rPreviousAny = std::move(newValue);
+        rEntry.PublishSnapshot(rValue);
+        return;
+    }
+
+    std::type_index previousType = rEntry.typeInfo.Type();
+    // false if the value is parsed from a string
+    bool storedAsIs = true;
+
+    // check type mismatch
+    if(previousType != std::type_index(typeid(ValueT)) and
+       previousType != newValue.Type()) {
+        bool mismatching = true;
+        if(std::is_constructible<std::string_view, ValueT>::value) {
+            Any anyFromString = newValue.IsString() ? rEntry.typeInfo.ParseString(std::string(newValue.GetStringView())) : Any();
+            if(anyFromString.Empty() == false) {
+                mismatching = false;
+                storedAsIs = false;
+                newValue = std::move(anyFromString);
             }
-            // check if we are doing a safe cast between numbers
-            // for instance, it is safe to use int(100) to set
-            // a uint8_t port, but not int(-42) or int(300)
-            if constexpr(std::is_arithmetic_v<T>) {
-                if(mismatching and IsCastingSafe(previousType, rValue)) {
-                    mismatching = false;
-                }
+        }
+        // check if we are doing a safe cast between numbers
+        // for instance, it is safe to use int(100) to set
+        // a uint8_t port, but not int(-42) or int(300)
+        if constexpr(std::is_arithmetic_v<ValueT>) {
+            if(mismatching and IsCastingSafe(previousType, rValue)) {
+                mismatching = false;
             }
+        }
 
-            if(mismatching) {
-                DebugMessage();
+        if(mismatching) {
+            DebugMessage();
 
-                auto msg = util::StrCat("Blackboard::set(", rKey,
-                                        "): once declared, "
-                                        "the Type of a port shall not change. "
-                                        "Previously declared Type [",
-                                        behaviortree::Demangle(previousType), "], current Type [", behaviortree::Demangle(typeid(T)), "]");
-                throw util::LogicError(msg);
-            }
+            auto msg = util::StrCat("Blackboard::set(", rKey,
+                                    "): once declared, "
+                                    "the Type of a port shall not change. "
+                                    "Previously declared Type [",
+                                    behaviortree::Demangle(previousType), "], current Type [", behaviortree::Demangle(typeid(ValueT)), "]");
+            throw util::LogicError(msg);
         }
-        // if doing set<BT::Any>, skip type check
-        if constexpr(std::is_same_v<Any, T>) {
-            rPreviousAny = newValue;
-        } else {
-            // copy only if the type is compatible
-            newValue.CopyInto(rPreviousAny);
+    }
+    // if doing set<BT::Any>, skip type check
+    if constexpr(std::is_same_v<Any, ValueT>) {
+        rPreviousAny = std::move(newValue);
+    } else {
+        // move only if the type is compatible
+        newValue.MoveInto(rPreviousAny);
+    }
+    rEntry.sequenceId++;
+    rEntry.stamp = Clock::Now();
+    // MoveInto() preserves the type of the destination
+    if(storedAsIs and rPreviousAny.Type() == typeid(ValueT)) {
+        rEntry.PublishSnapshot(rValue);
+    } else {
+        rEntry.InvalidateSnapshot();
+    }
+}
+
+template<typename T>
+inline void Blackboard::Entry::PublishSnapshot(const T &rValue) {
+    if constexpr(HasSnapshot<T>) {
+        SnapshotWordArr wordArr{};
+        std::memcpy(wordArr.data(), &rValue, sizeof(T));
+        WriteSnapshot(&typeid(T), wordArr);
+    } else {
+        InvalidateSnapshot();
+    }
+}
+
+inline void Blackboard::Entry::InvalidateSnapshot() {
+    if(m_pSnapshotType.load(std::memory_order_relaxed) != nullptr) {
+        WriteSnapshot(nullptr, SnapshotWordArr{});
+    }
+}
+
+inline void Blackboard::Entry::WriteSnapshot(const std::type_info *pType, const SnapshotWordArr &rWordArr) {
+    // writers are serialized by entryMutex
+    const uint64_t version = m_snapshotVersion.load(std::memory_order_relaxed);
+    m_snapshotVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_pSnapshotType.store(pType, std::memory_order_relaxed);
+    for(size_t i = 0; i < SnapshotWords; i++) {
+        m_snapshotWordArr[i].store(rWordArr[i], std::memory_order_relaxed);
+    }
+    m_snapshotSequenceId.store(sequenceId, std::memory_order_relaxed);
+    m_snapshotStamp.store(stamp.count(), std::memory_order_relaxed);
+
+    m_snapshotVersion.store(version + 2, std::memory_order_release);
+}
+
+template<typename T>
+inline bool Blackboard::Entry::TryReadSnapshot(T &rValue, Timestamp *pStamp) const {
+    if constexpr(!HasSnapshot<T>) {
+        return false;
+    } else {
+        constexpr int MaxAttempts = 4;
+        for(int attempt = 0; attempt < MaxAttempts; attempt++) {
+            const uint64_t version = m_snapshotVersion.load(std::memory_order_acquire);
+            if(version & 1) {
+                // a writer is active
+                continue;
+            }
+            const std::type_info *pType = m_pSnapshotType.load(std::memory_order_relaxed);
+            if(pType == nullptr or *pType != typeid(T)) {
+                return false;
+            }
+            SnapshotWordArr wordArr;
+            for(size_t i = 0; i < SnapshotWords; i++) {
+                wordArr[i] = m_snapshotWordArr[i].load(std::memory_order_relaxed);
+            }
+            const uint64_t snapshotSequenceId = m_snapshotSequenceId.load(std::memory_order_relaxed);
+            const int64_t snapshotStamp = m_snapshotStamp.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(m_snapshotVersion.load(std::memory_order_relaxed) == version) {
+                std::memcpy(&rValue, wordArr.data(), sizeof(T));
+                if(pStamp != nullptr) {
+                    *pStamp = Timestamp{snapshotSequenceId, std::chrono::nanoseconds(snapshotStamp)};
+                }
+                return true;
+            }
         }
-        rEntry.sequenceId++;
-        rEntry.stamp = std::chrono::steady_clock::now().time_since_epoch();
+        return false;
     }
 }
 
@@ -284,7 +666,11 @@ inline bool Blackboard::Get(const std::string &rKey, T &rValue) const {
 template<typename T>
 inline Expected<Timestamp> Blackboard::GetStamped(const std::string &rKey, T &rValue) const {
     if(auto entry = GetEntry(rKey)) {
-        std::unique_lock lk(entry->entryMutex);
+        Timestamp stamp;
+        if(entry->TryReadSnapshot(rValue, &stamp)) {
+            return stamp;
+        }
+        ReadLock lock(entry->entryMutex);
         if(entry->value.Empty()) {
             return nonstd::make_unexpected(util::StrCat("Blackboard::GetStamped() error. Entry [", rKey, "] hasn't been initialized, yet"));
         }
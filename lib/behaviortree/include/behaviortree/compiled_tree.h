@@ -0,0 +1,120 @@
+#ifndef BEHAVIORTREE_COMPILED_TREE_H
+#define BEHAVIORTREE_COMPILED_TREE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "behaviortree/basic_types.h"
+#include "behaviortree/common.h"
+
+namespace behaviortree {
+class TreeNode;
+
+/**
+ * @brief CompiledTree is a flat, index-addressed tick program built from the
+ * node graph of a Tree.
+ *
+ * The nodes are laid out breadth-first in a single contiguous array, so that
+ * the children of every node occupy a contiguous index range. Hot data
+ * (node records, status bytes, child cursors) is stored in parallel arrays,
+ * while cold data (names, paths) is kept in a separate table that the tick
+ * loop never touches.
+ *
+ * The built-in control flow nodes (Sequence, Fallback, Inverter, ForceSuccess,
+ * ForceFailure, AlwaysSuccess, AlwaysFailure and Subtree) are executed directly
+ * by the program. Any other node, or a built-in node that has pre/post conditions,
+ * injected callbacks or status-change subscribers (loggers), is kept "opaque":
+ * it is ticked through TreeNode::ExecuteTick() and owns its own children.
+ *
+ * Note: the TreeNode instances of inlined nodes are not ticked, therefore their
+ * GetNodeStatus() stays IDLE. Use GetNodeStatus(index) to inspect them.
+ * Callbacks and subscribers added after the compilation are not seen by
+ * inlined nodes.
+ */
+class BEHAVIORTREE_API CompiledTree {
+ public:
+    enum class OpCode : uint8_t {
+        Opaque = 0,
+        Sequence,
+        Fallback,
+        Inverter,
+        ForceSuccess,
+        ForceFailure,
+        AlwaysSuccess,
+        AlwaysFailure,
+        Subtree
+    };
+
+    struct NodeRecord {
+        TreeNode *pNode{nullptr};
+        uint32_t firstChild{0};
+        uint32_t childrenNum{0};
+        OpCode opCode{OpCode::Opaque};
+    };
+
+    struct NodeInfo {
+        std::string name;
+        std::string path;
+        std::string registrationId;
+    };
+
+    explicit CompiledTree(TreeNode *pRootNode);
+
+    CompiledTree(const CompiledTree &rOther) = delete;
+    CompiledTree &operator=(const CompiledTree &rOther) = delete;
+
+    /// Tick the root of the program once.
+    NodeStatus Tick();
+
+    /// Halt all the RUNNING nodes and reset the program to IDLE.
+    void Halt();
+
+    [[nodiscard]] size_t GetNodesNum() const;
+
+    [[nodiscard]] size_t GetOpaqueNodesNum() const;
+
+    [[nodiscard]] NodeStatus GetNodeStatus(size_t index) const;
+
+    [[nodiscard]] const NodeRecord &GetNodeRecord(size_t index) const;
+
+    [[nodiscard]] const NodeInfo &GetNodeInfo(size_t index) const;
+
+ private:
+    struct NodeState {
+        uint32_t currentChildIdx{0};
+        uint32_t skippedNum{0};
+    };
+
+    // hot data, indexed by node
+    std::vector<NodeRecord> m_recordVec;
+    std::vector<uint8_t> m_statusVec;
+    std::vector<NodeState> m_stateVec;
+
+    // cold data, indexed by node
+    std::vector<NodeInfo> m_infoVec;
+
+    size_t m_opaqueNodesNum{0};
+
+    static OpCode SelectOpCode(const TreeNode *pNode);
+
+    NodeStatus TickNode(uint32_t index);
+
+    NodeStatus Execute(uint32_t index);
+
+    void ResetNode(uint32_t index);
+
+    void ResetChildren(uint32_t index);
+
+    void SetStatus(uint32_t index, NodeStatus nodeStatus) {
+        m_statusVec[index] = static_cast<uint8_t>(nodeStatus);
+    }
+
+    [[nodiscard]] NodeStatus Status(uint32_t index) const {
+        return static_cast<NodeStatus>(m_statusVec[index]);
+    }
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_COMPILED_TREE_H
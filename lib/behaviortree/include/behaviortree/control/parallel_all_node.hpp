@@ -1,7 +1,7 @@
 #ifndef BEHAVIORTREE_PARALLEL_ALL_NODE_HPP
 #define BEHAVIORTREE_PARALLEL_ALL_NODE_HPP
 
-#include <set>
+#include <vector>
 
 #include "behaviortree/common.h"
 #include "behaviortree/control_node.h"
@@ -19,13 +19,19 @@ namespace behaviortree {
  * https://www.i2tutorials.com/what-are-negative-indexes-and-why-are-they-used/
  *
  * Therefore -1 is equivalent to the number of GetChildrenNode.
+ *
+ * The concurrent mode and its thread-safety contract are the same as in
+ * ParallelNode.
  */
 class BEHAVIORTREE_API ParallelAllNode: public ControlNode {
  public:
     ParallelAllNode(const std::string &rName, const NodeConfig &rConfig);
 
     static PortMap ProvidedPorts() {
-        return {InputPort<int>("max_failures", 1, "If the number of GetChildrenNode returning FAILURE exceeds this value, ParallelAll returns FAILURE")};
+        return {
+                InputPort<int>("max_failures", 1, "If the number of GetChildrenNode returning FAILURE exceeds this value, ParallelAll returns FAILURE"),
+                InputPort<bool>("concurrent", false, "if true, tick the GetChildrenNode at the same time, in different threads")
+        };
     }
 
     ~ParallelAllNode() override = default;
@@ -35,11 +41,30 @@ class BEHAVIORTREE_API ParallelAllNode: public ControlNode {
     size_t GetFailureThreshold() const;
     void SetFailureThreshold(int32_t threshold);
 
+    /// True if enabled by SetConcurrent() or by the port "concurrent".
+    bool IsConcurrent() const;
+    /// Enable the concurrent mode, whatever the value of the port.
+    void SetConcurrent(bool concurrent);
+
+    /// Pool of the concurrent mode, ActionPool::GetDefault() if null.
+    void SetActionPool(ActionPool::Ptr pPool);
+
  private:
     size_t m_failureThreshold;
+    // SetConcurrent(), OR-ed with the port read at every tick
+    bool m_concurrentOverride{false};
+    bool m_concurrentPort{false};
+    ActionPool::Ptr m_pPool;
 
-    std::set<size_t> m_completedSet;
+    // one bit per child
+    std::vector<bool> m_completedVec;
+    size_t m_completedCount{0};
     size_t m_failureCount{0};
+    // reused by the concurrent mode
+    std::vector<size_t> m_pendingIdxVec;
+    std::vector<NodeStatus> m_pendingStatusVec;
+
+    void Clear();
 
     virtual behaviortree::NodeStatus Tick() override;
 };
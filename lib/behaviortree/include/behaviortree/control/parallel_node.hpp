@@ -1,7 +1,7 @@
 #ifndef BEHAVIORTREE_PARALLEL_NODE_HPP
 #define BEHAVIORTREE_PARALLEL_NODE_HPP
 
-#include <set>
+#include <vector>
 
 #include "behaviortree/common.h"
 #include "behaviortree/control_node.h"
@@ -25,6 +25,25 @@ namespace behaviortree {
  * https://www.i2tutorials.com/what-are-negative-indexes-and-why-are-they-used/
  *
  * Therefore -1 is equivalent to the number of GetChildrenNode.
+ *
+ * CONCURRENT MODE (opt-in, port "concurrent" or SetConcurrent()): the
+ * children that are not completed yet are ticked at the same time, on the
+ * workers of an ActionPool (ActionPool::GetDefault(), see SetActionPool())
+ * and on the calling thread. The results are then aggregated in the order of
+ * the children, as in the sequential mode. The children are started in order,
+ * and no more of them once the result is certain; unlike the sequential mode,
+ * the children that were already started complete their tick, even if they
+ * follow the one that decided the result (they are halted with the others).
+ *
+ * Thread-safety contract of the concurrent mode:
+ * - each child subtree is ticked by one thread at a time, but different
+ *   children run in parallel: they must not share state other than the
+ *   blackboard;
+ * - Blackboard operations are atomic per entry, so branches can read and write
+ *   different entries freely; if several branches write the same entry, the
+ *   last write wins and the result is not deterministic;
+ * - the status-change callbacks (loggers, observers) of the nodes in the
+ *   children are invoked from the worker threads.
  */
 class BEHAVIORTREE_API ParallelNode: public ControlNode {
  public:
@@ -35,7 +54,8 @@ class BEHAVIORTREE_API ParallelNode: public ControlNode {
     static PortMap ProvidedPorts() {
         return {
                 InputPort<int32_t>(THRESHOLD_SUCCESS, -1, "number of GetChildrenNode that need to succeed to trigger a Success"),
-                InputPort<int32_t>(THRESHOLD_FAILURE, 1, "number of GetChildrenNode that need to fail to trigger a Failure")
+                InputPort<int32_t>(THRESHOLD_FAILURE, 1, "number of GetChildrenNode that need to fail to trigger a Failure"),
+                InputPort<bool>(CONCURRENT, false, "if true, tick the GetChildrenNode at the same time, in different threads")
         };
     }
 
@@ -48,11 +68,27 @@ class BEHAVIORTREE_API ParallelNode: public ControlNode {
     void SetSuccessThreshold(int32_t threshold);
     void SetFailureThreshold(int32_t threshold);
 
+    /// True if enabled by SetConcurrent() or by the port "concurrent".
+    bool IsConcurrent() const;
+    /// Enable the concurrent mode, whatever the value of the port.
+    void SetConcurrent(bool concurrent);
+
+    /// Pool of the concurrent mode, ActionPool::GetDefault() if null.
+    void SetActionPool(ActionPool::Ptr pPool);
+
  private:
     int m_successThreshold;
     int m_failureThreshold;
+    // SetConcurrent(), OR-ed with the port read at every tick
+    bool m_concurrentOverride{false};
+    bool m_concurrentPort{false};
+    ActionPool::Ptr m_pPool;
 
-    std::set<size_t> m_completedSet;
+    // one bit per child
+    std::vector<bool> m_completedVec;
+    // reused by the concurrent mode
+    std::vector<size_t> m_pendingIdxVec;
+    std::vector<NodeStatus> m_pendingStatusVec;
 
     size_t m_successCount{0};
     size_t m_failureCount{0};
@@ -60,6 +96,7 @@ class BEHAVIORTREE_API ParallelNode: public ControlNode {
     bool m_readParameterFromPorts;
     static constexpr const char *THRESHOLD_SUCCESS{"success_count"};
     static constexpr const char *THRESHOLD_FAILURE{"failure_count"};
+    static constexpr const char *CONCURRENT{"concurrent"};
 
     virtual behaviortree::NodeStatus Tick() override;
 
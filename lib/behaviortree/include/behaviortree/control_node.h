@@ -1,8 +1,10 @@
 #ifndef BEHAVIORTREE_CONTROL_NODE_H
 #define BEHAVIORTREE_CONTROL_NODE_H
 
+#include <limits>
 #include <vector>
 
+#include "behaviortree/action_pool.h"
 #include "behaviortree/tree_node.h"
 
 namespace behaviortree {
@@ -40,6 +42,26 @@ class ControlNode: public TreeNode {
     /// Set the status of all GetChildrenNode to IDLE.
     /// also send a halt() signal to all RUNNING GetChildrenNode
     void ResetChildren();
+
+ protected:
+    /**
+     * @brief Tick the children with the given indexes on the workers of pPool,
+     * and on the calling thread, which takes part in the work and returns when
+     * all of them have been ticked. rStatusVec[k] is the status of the child
+     * rIndexVec[k].
+     *
+     * If some ticks throw, the exception of the first child (in rIndexVec order)
+     * is rethrown, once all the ticks are completed.
+     *
+     * The children are started in rIndexVec order. Once stopSuccessesNum of
+     * the ticked children succeeded, or stopFailuresNum failed, the others are
+     * not started anymore (the ticks already started are completed).
+     *
+     * @return the number of children ticked, the first ones of rIndexVec; the
+     * status of the others is Idle.
+     */
+    size_t TickChildrenConcurrently(const std::vector<size_t> &rIndexVec, std::vector<NodeStatus> &rStatusVec, const ActionPool::Ptr &pPool,
+                                    size_t stopSuccessesNum = std::numeric_limits<size_t>::max(), size_t stopFailuresNum = std::numeric_limits<size_t>::max());
 };
 }// namespace behaviortree
 
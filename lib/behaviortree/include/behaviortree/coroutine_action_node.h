@@ -0,0 +1,261 @@
+#ifndef BEHAVIORTREE_COROUTINE_ACTION_NODE_H
+#define BEHAVIORTREE_COROUTINE_ACTION_NODE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "behaviortree/action_node.h"
+#include "behaviortree/blackboard.h"
+#include "behaviortree/common.h"
+#include "behaviortree/util/timer_queue.h"
+
+namespace behaviortree {
+/**
+ * @brief CoroFrameAllocator recycles the frames of the C++20 coroutines of
+ * the CoroutineActionNode of a tree (see Tree::Initialize()).
+ *
+ * Freed frames are kept in free lists, one per size class of 64 bytes, and
+ * reused by the next activations. Frames larger than MaxCachedSize use the
+ * heap directly.
+ */
+class BEHAVIORTREE_API CoroFrameAllocator {
+ public:
+    using Ptr = std::shared_ptr<CoroFrameAllocator>;
+
+    static constexpr size_t SizeClass = 64;
+    static constexpr size_t MaxCachedSize = 4096;
+
+    CoroFrameAllocator() = default;
+    ~CoroFrameAllocator();
+
+    CoroFrameAllocator(const CoroFrameAllocator &rOther) = delete;
+    CoroFrameAllocator &operator=(const CoroFrameAllocator &rOther) = delete;
+
+    /// Allocate from pAllocator, or from the heap if it is null.
+    [[nodiscard]] static void *Allocate(CoroFrameAllocator *pAllocator, size_t size);
+
+    /// Release memory returned by Allocate(). Its allocator must be alive.
+    static void Deallocate(void *pMemory) noexcept;
+
+    /// Bytes kept in the free lists.
+    [[nodiscard]] size_t GetCachedBytes() const;
+
+ private:
+    struct FreeBlock {
+        FreeBlock *pNext;
+    };
+
+    mutable std::mutex m_mutex;
+    std::array<FreeBlock *, MaxCachedSize / SizeClass> m_freeListArr{};
+    size_t m_cachedBytes{0};
+};
+
+class CoroutineActionNode;
+
+/**
+ * @brief Return type of CoroutineActionNode::Run(): a C++20 coroutine that
+ * completes with co_return NodeStatus::Success (or Failure).
+ */
+class BEHAVIORTREE_API ActionTask {
+ public:
+    struct promise_type {
+        NodeStatus nodeStatus{NodeStatus::Idle};
+        std::exception_ptr exptr;
+
+        ActionTask get_return_object() {
+            return ActionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        // the node starts the coroutine at the first tick
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        // the node reads the result, then destroys the frame
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        void return_value(NodeStatus status) {
+            nodeStatus = status;
+        }
+
+        void unhandled_exception() {
+            exptr = std::current_exception();
+        }
+
+        // frames of CoroutineActionNode::Run() come from the allocator of the tree
+        static void *operator new(size_t size, CoroutineActionNode &rNode);
+
+        static void *operator new(size_t size);
+
+        static void operator delete(void *pMemory) noexcept;
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    ActionTask() = default;
+
+    explicit ActionTask(Handle handle): m_handle(handle) {}
+
+    ActionTask(ActionTask &&rOther) noexcept: m_handle(std::exchange(rOther.m_handle, nullptr)) {}
+
+    ActionTask &operator=(ActionTask &&rOther) noexcept {
+        if(this != &rOther) {
+            Destroy();
+            m_handle = std::exchange(rOther.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ActionTask(const ActionTask &rOther) = delete;
+    ActionTask &operator=(const ActionTask &rOther) = delete;
+
+    ~ActionTask() {
+        Destroy();
+    }
+
+    [[nodiscard]] explicit operator bool() const {
+        return bool(m_handle);
+    }
+
+    [[nodiscard]] Handle GetHandle() const {
+        return m_handle;
+    }
+
+    void Destroy() {
+        if(m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+ private:
+    Handle m_handle;
+};
+
+/**
+ * @brief The CoroutineActionNode is an asynchronous action implemented as a
+ * stackless C++20 coroutine: override Run() and use co_await on the
+ * awaitables below, then co_return the final status.
+ *
+ *     ActionTask MyAction::Run() {
+ *         SendRequest();
+ *         co_await WaitForSignal();   // the reply handler calls Notify()
+ *         co_await SleepFor(std::chrono::milliseconds(100));
+ *         co_return NodeStatus::Success;
+ *     }
+ *
+ * While suspended, the node is RUNNING and its state is only the coroutine
+ * frame, allocated by the CoroFrameAllocator of the tree. The coroutine is
+ * resumed by a tick of the node, once the condition it waits for is met; the
+ * awaitables emit the wake-up signal of the tree when that happens.
+ *
+ * Halt() destroys the frame (running the destructors of its locals) and
+ * cancels the pending timer or watch.
+ */
+class BEHAVIORTREE_API CoroutineActionNode: public ActionNodeBase {
+ public:
+    class Awaiter {
+     public:
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> /*handle*/);
+
+        void await_resume() const noexcept {}
+
+     private:
+        friend class CoroutineActionNode;
+
+        enum class Kind : uint8_t {
+            NextTick,
+            Sleep,
+            EntryUpdate,
+            Signal
+        };
+
+        Awaiter(CoroutineActionNode *pNode, Kind kind): m_pNode(pNode), m_kind(kind) {}
+
+        CoroutineActionNode *m_pNode;
+        Kind m_kind;
+        std::chrono::milliseconds m_duration{0};
+        std::string m_key;
+    };
+
+    CoroutineActionNode(const std::string &rName, const NodeConfig &rConfig);
+    ~CoroutineActionNode() override;
+
+    /// Thread-safe: resume the coroutine waiting in WaitForSignal(), or the
+    /// next one that will wait, and wake up the tree.
+    void Notify();
+
+    /// Allocator of the coroutine frames; set by Tree::Initialize().
+    /// Must not be changed while the node is RUNNING.
+    void SetFrameAllocator(CoroFrameAllocator::Ptr pAllocator);
+
+    [[nodiscard]] CoroFrameAllocator *GetFrameAllocator() const {
+        return m_pFrameAllocator.get();
+    }
+
+    /** You may want to override this method. But still, remember to call this
+    * implementation too.
+    */
+    void Halt() override;
+
+ protected:
+    /// The body of the action, started when the node goes from IDLE to RUNNING.
+    virtual ActionTask Run() = 0;
+
+    /// Resume at the next tick of the node.
+    [[nodiscard]] Awaiter NextTick();
+
+    /// Resume at the first tick after the duration elapsed (shared TimerService).
+    [[nodiscard]] Awaiter SleepFor(std::chrono::milliseconds duration);
+
+    /// Resume at the first tick after the blackboard entry is set or removed.
+    [[nodiscard]] Awaiter WaitForEntryUpdate(const std::string &rKey);
+
+    /// Resume at the first tick after Notify().
+    [[nodiscard]] Awaiter WaitForSignal();
+
+    // do not override this method
+    NodeStatus Tick() override final;
+
+ private:
+    void Arm(const Awaiter &rAwaiter);
+
+    // thread-safe
+    void Wake(uint64_t waitId);
+
+    void Reset();
+
+    ActionTask m_task;
+    CoroFrameAllocator::Ptr m_pFrameAllocator;
+
+    // suspension in progress, incremented on the tick thread
+    uint64_t m_waitId{0};
+    // highest suspension whose condition is met
+    std::atomic<uint64_t> m_readyWaitId{0};
+
+    std::mutex m_signalMutex;
+    uint64_t m_signalWaitId{0};
+    bool m_signalPending{false};
+
+    Blackboard::WatchSubscriber m_pWatchSubscriber;
+    // last member: destroyed first, it waits for its handlers
+    std::unique_ptr<TimerQueue<>> m_pTimerQueue;
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_COROUTINE_ACTION_NODE_H
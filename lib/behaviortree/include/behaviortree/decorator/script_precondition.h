@@ -48,20 +48,23 @@ class PreconditionNode: public DecoratorNode {
         if(!GetInput("if", script)) {
             throw util::RuntimeError("Missing parameter [if] in Precondition");
         }
-        if(script == m_Script) {
+        // the enums are assigned after the construction of the node
+        if(script == m_Script and GetConfig().pEnums == m_pEnums) {
             return;
         }
-        auto executor = ParseScript(script);
+        auto executor = ParseScript(script, {GetConfig().pBlackboard, GetConfig().pEnums});
         if(!executor) {
             throw util::RuntimeError(executor.error());
         } else {
             m_Executor = executor.value();
             m_Script = script;
+            m_pEnums = GetConfig().pEnums;
         }
     }
 
     std::string m_Script;
     ScriptFunction m_Executor;
+    EnumsTablePtr m_pEnums;
 };
 
 }// namespace behaviortree
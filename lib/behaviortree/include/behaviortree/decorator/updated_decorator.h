@@ -10,6 +10,10 @@ namespace behaviortree {
  * the first time).
  *
  * If it is, the GetChildNode will be executed, otherwise [if_not_updated] value is returned.
+ *
+ * When [if_not_updated] is RUNNING, the node watches the entry and emits a
+ * wake-up signal when it changes, so that a sleeping tree is ticked again
+ * without waiting for the next poll.
  */
 class EntryUpdatedDecorator: public DecoratorNode {
  public:
@@ -26,6 +30,7 @@ class EntryUpdatedDecorator: public DecoratorNode {
     std::string m_entryKey;
     bool m_stillExecutingChild{false};
     NodeStatus m_ifNotUpdated;
+    Blackboard::WatchSubscriber m_pWatchSubscriber;
 
     NodeStatus Tick() override;
 
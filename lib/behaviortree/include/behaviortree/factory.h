@@ -9,14 +9,12 @@
 #include <vector>
 
 #include "behaviortree/behaviortree.h"
+#include "behaviortree/tree_template.h"
 #include "magic_enum.hpp"
 
 #include "behaviortree/action/test_node.hpp";
 
 namespace behaviortree {
-/// The term "Builder" refers to the Builder Pattern
-using NodeBuilder = std::function<std::unique_ptr<TreeNode>(const std::string &, const NodeConfig &)>;
-
 template<typename T, typename... Args>
 inline NodeBuilder CreateBuilder(Args... args) {
     return [=](const std::string &rName, const NodeConfig &rNodeConfig) {
@@ -55,6 +53,8 @@ constexpr const char *PLUGIN_SYMBOL{"RegisterNodesFromPlugin"};
 
 bool WildcardMatch(const std::string &rStr, std::string_view filter);
 
+class CompiledTree;
+
 /**
  * @brief Struct used to store a tree.
  * If this object goes out of scope, the tree is destroyed.
@@ -110,6 +110,54 @@ class Tree {
     /// a Tree::Sleep() is used
     NodeStatus TickWhileRunning(std::chrono::milliseconds sleepTime = std::chrono::milliseconds(10));
 
+    /**
+     * @brief Event-driven version of TickWhileRunning(): while the tree is
+     * RUNNING, it is ticked again only when a node invokes
+     * TreeNode::emitWakeUpSignal() (asynchronous actions, timers, watched
+     * blackboard entries, see WakeUpOnBlackboardUpdate()), instead of at
+     * a fixed rate. Multiple signals received between two ticks produce a
+     * single tick.
+     *
+     * Nodes that don't emit the signal (for instance a StatefulActionNode
+     * polling an external state in OnRunning) need a heartbeat:
+     * if maxInterval is not zero, the tree is ticked at least once every
+     * maxInterval.
+     */
+    NodeStatus TickWhileRunningOnEvent(std::chrono::milliseconds maxInterval = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Compile() lowers the tree into a flat, index-addressed program
+     * (see CompiledTree). From now on, TickOnce(), TickExactlyOnce() and
+     * TickWhileRunning() execute the compiled program instead of walking
+     * the nodes through TreeNode::ExecuteTick().
+     *
+     * Call it once the tree is fully built and the tick callbacks and the
+     * loggers (status-change subscribers), if any, have been attached: the
+     * nodes that have none are inlined and no longer notify status changes.
+     */
+    void Compile();
+
+    /// The compiled program, or nullptr if Compile() was never called.
+    [[nodiscard]] const CompiledTree *GetCompiledTree() const;
+
+    /**
+     * @brief WakeUpOnBlackboardUpdate interrupts Sleep() (and therefore the
+     * wait between two ticks of TickWhileRunning()) whenever an entry whose
+     * key starts with rPrefix is set or removed in any blackboard of the tree.
+     *
+     * An empty prefix watches all the entries. Can be called multiple times
+     * to watch different prefixes; the watches live as long as the tree.
+     */
+    void WakeUpOnBlackboardUpdate(const std::string &rPrefix = "");
+
+    /**
+     * @brief Execute the ThreadedAction nodes of the tree on pPool
+     * (ActionPool::GetDefault() if null), with at most maxInFlight of them
+     * queued or running at the same time (0 means unlimited).
+     * Takes effect at the next activation of each node.
+     */
+    void SetActionPool(ActionPool::Ptr pPool, size_t maxInFlight = 0);
+
     [[nodiscard]] Blackboard::Ptr RootBlackboard();
 
     //Call the visitor for each node of the tree.
@@ -146,12 +194,26 @@ class Tree {
     enum TickOption {
         ExactlyOnce,
         OnceUnlessWokenUp,
-        WhileRunning
+        WhileRunning,
+        WhileRunningOnEvent
     };
 
     NodeStatus TickRoot(TickOption opt, std::chrono::milliseconds sleepTime);
 
     uint16_t m_uidCounter{0};
+
+    std::unique_ptr<CompiledTree> m_pCompiledTree;
+
+    std::vector<Blackboard::WatchSubscriber> m_watchSubscriberVec;
+
+    // nullptr if the nodes were allocated on the heap
+    TreeArena::Ptr m_pArena;
+
+    // frames of the CoroutineActionNode, nullptr if there are none
+    CoroFrameAllocator::Ptr m_pFrameAllocator;
+
+    friend class TreeExecutor;
+    friend class BehaviorTreeFactory;
 };
 
 class Parser;
@@ -241,6 +303,30 @@ class BehaviorTreeFactory {
     /// instead of the filename.
     void RegisterBehaviorTreeFromText(const std::string &rJsonText);
 
+    /**
+     * @brief SavePrecompiledBehaviorTrees writes the trees registered with
+     * RegisterBehaviorTreeFromFile/Text into a binary file: an offline step,
+     * so that the applications load the trees with
+     * RegisterBehaviorTreeFromPrecompiled() instead of parsing them.
+     *
+     * The file depends on the manifests of the nodes used by the trees, and
+     * on the names of the trees and of the subtrees not being registered
+     * nodes: it must be written again when they change.
+     */
+    void SavePrecompiledBehaviorTrees(const std::filesystem::path &rFileName) const;
+
+    /**
+     * @brief RegisterBehaviorTreeFromPrecompiled maps a file written by
+     * SavePrecompiledBehaviorTrees() and registers its trees, without parsing
+     * them.
+     *
+     * Instead of verifying the trees again, it compares the hash of the
+     * manifests stored in the file with the one of the registered nodes.
+     * It throws if they differ, or if the file is not valid: the trees must
+     * be registered from their JSON files in that case.
+     */
+    void RegisterBehaviorTreeFromPrecompiled(const std::filesystem::path &rFileName);
+
     /// Returns the ID of the trees registered either with
     /// RegisterBehaviorTreeFromFile or RegisterBehaviorTreeFromText.
     [[nodiscard]] std::vector<std::string> GetRegisteredTreeName() const;
@@ -364,6 +450,29 @@ class BehaviorTreeFactory {
 
     [[nodiscard]] Tree CreateTree(const std::string &rTreeName, Blackboard::Ptr pBlackboard = Blackboard::Create());
 
+    /**
+     * @brief GetTreeTemplate returns the template of a registered tree,
+     * building it the first time (this instantiates the tree once through
+     * the parser). Templates are cached until a tree, a node type or a
+     * substitution rule is registered or removed.
+     */
+    [[nodiscard]] TreeTemplate::Ptr GetTreeTemplate(const std::string &rTreeName);
+
+    /**
+     * @brief Create a tree from a template. Equivalent to CreateTree(tree_id),
+     * but only the nodes and the blackboards are allocated.
+     * Thread-safe, as long as the factory is not modified.
+     */
+    [[nodiscard]] Tree CreateTree(const TreeTemplate &rTemplate, Blackboard::Ptr pBlackboard = Blackboard::Create()) const;
+
+    /**
+     * @brief SetTreeArenaSize enables the allocation of the nodes of the
+     * trees created from now on in a per-tree TreeArena, whose first block
+     * has the given size (trees created from a TreeTemplate use the size
+     * of the previous instance, if larger). 0 (default) disables the arena.
+     */
+    void SetTreeArenaSize(size_t initialSize);
+
     /// Add metadata to a specific manifest. This metadata will be added
     /// to <TreeNodeModel> with the function WriteTreeNodeModelXML()
     void AddMetadataToManifest(const std::string &rNodeId, const MetedataVec &rMetadata);
@@ -433,6 +542,17 @@ class BehaviorTreeFactory {
  private:
     struct PImpl;
     std::unique_ptr<PImpl> m_pPImpl;
+
+    [[nodiscard]] TreeArena::Ptr CreateTreeArena(size_t sizeHint = 0) const;
+
+    /// Builder of the node, after applying the substitution rules.
+    [[nodiscard]] NodeBuilder GetNodeBuilder(const std::string &rName, const std::string &rId, const NodeConfig &rConfig) const;
+
+    /// Parse the pre/post condition scripts of the config of the node,
+    /// bound to its blackboard and its enums.
+    static void AssignConditionScripts(TreeNode &rNode);
+
+    void InvalidateTreeTemplates();
 };
 
 /**
@@ -35,6 +35,23 @@ class JsonParser: public Parser {
 
     void ClearInternalState() override;
 
+    /**
+     * @brief Write the registered trees, and the models of the subtrees, into
+     * a binary file that LoadPrecompiled() registers again without parsing
+     * nor verifying them.
+     */
+    void SavePrecompiled(const std::filesystem::path &rFilepath) const;
+
+    /**
+     * @brief Map a file written by SavePrecompiled() and register its trees.
+     * The trees refer to the strings of the mapping, that stays alive until
+     * ClearInternalState() or the destruction of the parser.
+     * Throws if the file is not valid, or if the manifests of the nodes used
+     * by the trees, or the registration of names used by the trees and the
+     * subtrees, changed since the file was written.
+     */
+    void LoadPrecompiled(const std::filesystem::path &rFilepath);
+
  private:
     struct PImpl;
     std::unique_ptr<PImpl> m_pPImpl;
@@ -0,0 +1,256 @@
+#ifndef BEHAVIORTREE_PORT_BINDING_H
+#define BEHAVIORTREE_PORT_BINDING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <typeindex>
+
+#include "behaviortree/basic_types.h"
+#include "behaviortree/blackboard.h"
+
+namespace behaviortree {
+/// Error codes returned by the port access functions that use a PortBinding.
+enum class PortErrorCode : uint8_t {
+    Ok = 0,
+    // the port is neither remapped nor has a default value
+    MissingPort,
+    // the node has no blackboard
+    MissingBlackboard,
+    // the remapped blackboard entry doesn't exist
+    MissingEntry,
+    // the blackboard entry exists, but it was never set
+    EmptyEntry,
+    // output ports must be remapped to a blackboard entry
+    NotBlackboardPointer,
+    // the value can not be converted to the requested type
+    ConversionFailed
+};
+
+template<>
+[[nodiscard]] std::string ToStr<behaviortree::PortErrorCode>(const behaviortree::PortErrorCode &rErrorCode);
+
+/**
+ * @brief LiteralCache stores the values parsed from a literal port,
+ * one for each type requested by the node.
+ *
+ * Values are published in a lock-free list: once a type has been parsed,
+ * reading it again is a walk of a very short list plus a copy.
+ * The cache is owned by a PortBinding, therefore it is invalidated together
+ * with the binding (see TreeNode::ModifyPortsRemapping).
+ *
+ * A value may also depend on a key, e.g. the size of the scripting enums
+ * table for an enum parsed from its name: it is only found with the key it
+ * was inserted with.
+ */
+class LiteralCache {
+ public:
+    LiteralCache() = default;
+
+    LiteralCache(const LiteralCache &rOther) = delete;
+    LiteralCache &operator=(const LiteralCache &rOther) = delete;
+
+    // Not thread-safe: bindings are moved only while they are being built
+    LiteralCache(LiteralCache &&rOther) noexcept: m_pHead(rOther.m_pHead.exchange(nullptr)) {}
+
+    LiteralCache &operator=(LiteralCache &&rOther) noexcept {
+        if(this != &rOther) {
+            Clear();
+            m_pHead.store(rOther.m_pHead.exchange(nullptr));
+        }
+        return *this;
+    }
+
+    ~LiteralCache() {
+        Clear();
+    }
+
+    /// Return the cached value of type T, or nullptr if it wasn't parsed yet
+    /// with this key.
+    template<typename T>
+    [[nodiscard]] const T *Find(size_t key = 0) const {
+        for(auto pNode = m_pHead.load(std::memory_order_acquire); pNode != nullptr; pNode = pNode->pNext) {
+            if(pNode->type == typeid(T) and pNode->key == key) {
+                return &static_cast<const Node<T> *>(pNode)->value;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Thread-safe. If two threads insert the same type, the first one found wins.
+    template<typename T>
+    void Insert(const T &rValue, size_t key = 0) const {
+        auto pNode = new Node<T>(rValue, key);
+        const NodeBase *pHead = m_pHead.load(std::memory_order_acquire);
+        do {
+            pNode->pNext = pHead;
+        } while(!m_pHead.compare_exchange_weak(pHead, pNode, std::memory_order_release, std::memory_order_acquire));
+    }
+
+ private:
+    struct NodeBase {
+        NodeBase(std::type_index type, size_t key): type(type), key(key) {}
+        virtual ~NodeBase() = default;
+
+        std::type_index type;
+        size_t key;
+        const NodeBase *pNext{nullptr};
+    };
+
+    template<typename T>
+    struct Node: public NodeBase {
+        Node(const T &rValue, size_t key): NodeBase(typeid(T), key), value(rValue) {}
+
+        T value;
+    };
+
+    mutable std::atomic<const NodeBase *> m_pHead{nullptr};
+
+    void Clear() {
+        auto pNode = m_pHead.exchange(nullptr);
+        while(pNode != nullptr) {
+            auto pNext = pNode->pNext;
+            delete pNode;
+            pNode = pNext;
+        }
+    }
+};
+
+/**
+ * @brief EntryHandle is the handle of a blackboard entry cached by a PortBinding.
+ *
+ * It may be set when the binding is created or, once, later: the first access
+ * that finds an entry created after the binding publishes it, so that the
+ * following ones don't need to look it up by name. The handle shares the
+ * ownership of the blackboard storage, therefore the entry is never freed
+ * while the binding exists.
+ */
+class EntryHandle {
+ public:
+    EntryHandle() = default;
+
+    EntryHandle(const EntryHandle &rOther) = delete;
+    EntryHandle &operator=(const EntryHandle &rOther) = delete;
+
+    // Not thread-safe: bindings are moved only while they are being built
+    EntryHandle(EntryHandle &&rOther) noexcept: m_pHolder(rOther.m_pHolder.exchange(nullptr)),
+                                                m_pEntry(rOther.m_pEntry.exchange(nullptr)) {}
+
+    EntryHandle &operator=(EntryHandle &&rOther) noexcept {
+        if(this != &rOther) {
+            delete m_pHolder.exchange(rOther.m_pHolder.exchange(nullptr));
+            m_pEntry.store(rOther.m_pEntry.exchange(nullptr));
+        }
+        return *this;
+    }
+
+    ~EntryHandle() {
+        delete m_pHolder.load();
+    }
+
+    /// nullptr if no entry was published yet.
+    [[nodiscard]] Blackboard::Entry *Get() const {
+        return m_pEntry.load(std::memory_order_acquire);
+    }
+
+    /// Owning handle of the published entry, nullptr if there is none.
+    [[nodiscard]] std::shared_ptr<Blackboard::Entry> GetShared() const {
+        auto pHolder = m_pHolder.load(std::memory_order_acquire);
+        return pHolder ? *pHolder : nullptr;
+    }
+
+    /// Thread-safe. Only the first entry is kept: later calls are ignored.
+    void Publish(std::shared_ptr<Blackboard::Entry> pEntry) const {
+        if(pEntry == nullptr or m_pHolder.load(std::memory_order_acquire) != nullptr) {
+            return;
+        }
+        auto pRawEntry = pEntry.get();
+        auto pHolder = new std::shared_ptr<Blackboard::Entry>(std::move(pEntry));
+        std::shared_ptr<Blackboard::Entry> *pExpected = nullptr;
+        if(m_pHolder.compare_exchange_strong(pExpected, pHolder, std::memory_order_acq_rel)) {
+            m_pEntry.store(pRawEntry, std::memory_order_release);
+        } else {
+            delete pHolder;
+        }
+    }
+
+ private:
+    mutable std::atomic<std::shared_ptr<Blackboard::Entry> *> m_pHolder{nullptr};
+    // same entry as *m_pHolder, read without the indirection
+    mutable std::atomic<Blackboard::Entry *> m_pEntry{nullptr};
+};
+
+/**
+ * @brief PortBinding is the pre-resolved form of a port remapping.
+ *
+ * It is created by the factory, once the node is instantiated (or when its
+ * ports are remapped), so that reading an input or writing an output doesn't
+ * need to look up the remapping tables or the blackboard by name:
+ *
+ * - Literal:  the port contains a string that must be parsed. The result
+ *             is cached for each requested type.
+ * - Constant: the port uses a non-string default value of the manifest.
+ * - Entry:    the port points to a blackboard entry; entry is a direct
+ *             handle to it. If the entry didn't exist yet when the binding
+ *             was created, the handle is set by the first access that finds it.
+ *
+ * If the entry is removed from the blackboard (see Blackboard::Unset), the
+ * handle is detached and the access falls back to a lookup by blackboardKey,
+ * until the key is created again in the same slot.
+ *
+ * A binding remembers the version of the NodeConfig it was created from,
+ * incremented by TreeNode::ModifyPortsRemapping(), and its blackboard:
+ * TreeNode creates it again when either changed.
+ */
+struct PortBinding {
+    enum class Kind : uint8_t {
+        Unbound = 0,
+        Literal,
+        Constant,
+        Entry
+    };
+
+    Kind kind{Kind::Unbound};
+    std::string portName;
+    // Kind::Literal
+    std::string literal;
+    // Kind::Constant
+    Any constant;
+    // Kind::Literal and Kind::Constant: values already converted
+    LiteralCache literalCache;
+    // Kind::Entry
+    std::string blackboardKey;
+    EntryHandle entry;
+    const Blackboard *pBlackboard{nullptr};
+    // version of the NodeConfig of the node when the binding was created
+    uint64_t configVersion{0};
+
+    /// Create the binding of a port, given its remapped value.
+    /// If the remapped value is not a blackboard pointer, the binding is a Literal.
+    [[nodiscard]] static PortBinding Create(const std::string &rPortName, std::string_view remappedPort, const Blackboard::Ptr &pBlackboard);
+
+    /// Return the entry to be used: the cached handle, or the result of a new
+    /// lookup (kept alive by rHolder) if the handle is missing or detached.
+    /// Return nullptr if the entry doesn't exist.
+    [[nodiscard]] Blackboard::Entry *ResolveEntry(const Blackboard::Ptr &pBlackboard, std::shared_ptr<Blackboard::Entry> &rHolder) const {
+        Blackboard::Entry *pEntry = entry.Get();
+        if(pEntry != nullptr and !pEntry->detached.load(std::memory_order_acquire)) {
+            return pEntry;
+        }
+        if(pBlackboard == nullptr) {
+            return nullptr;
+        }
+        rHolder = pBlackboard->GetEntry(blackboardKey);
+        if(pEntry == nullptr) {
+            // created after the binding: cache it for the next accesses
+            entry.Publish(rHolder);
+        }
+        return rHolder.get();
+    }
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_PORT_BINDING_H
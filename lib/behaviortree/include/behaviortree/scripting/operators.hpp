@@ -63,6 +63,10 @@ struct ExprName: ExprBase {
     explicit ExprName(std::string n): name(LEXY_MOV(n)) {}
 
     Any evaluate(Environment &env) const override {
+        return Load(env, name);
+    }
+
+    static Any Load(Environment &env, const std::string &name) {
         //search first in the enums table
         if(env.ptrEnums) {
             auto enum_ptr = env.ptrEnums->find(name);
@@ -71,7 +75,8 @@ struct ExprName: ExprBase {
             }
         }
         // search now in the variables table
-        auto any_ref = env.ptrVars->GetAnyLocked(name);
+        // read-only access, keeps the optimistic reads of the entry enabled
+        auto any_ref = static_cast<const Blackboard &>(*env.ptrVars).GetAnyLocked(name);
         if(!any_ref) {
             throw util::RuntimeError(util::StrCat("Variable not found: ", name));
         }
@@ -89,7 +94,10 @@ struct ExprUnaryArithmetic: ExprBase {
                                                       rhs(LEXY_MOV(e)) {}
 
     Any evaluate(Environment &env) const override {
-        auto rhs_v = rhs->evaluate(env);
+        return Apply(op, rhs->evaluate(env));
+    }
+
+    static Any Apply(op_t op, const Any &rhs_v) {
         if(rhs_v.IsNumber()) {
             const double rv = rhs_v.Cast<double>();
             switch(op) {
@@ -124,6 +132,10 @@ struct ExprBinaryArithmetic: ExprBase {
     } op;
 
     const char *opStr() const {
+        return opStr(op);
+    }
+
+    static const char *opStr(op_t op) {
         switch(op) {
             case plus:
                 return "+";
@@ -158,12 +170,15 @@ struct ExprBinaryArithmetic: ExprBase {
     Any evaluate(Environment &env) const override {
         auto lhs_v = lhs->evaluate(env);
         auto rhs_v = rhs->evaluate(env);
+        return Apply(op, lhs_v, rhs_v);
+    }
 
+    static Any Apply(op_t op, const Any &lhs_v, const Any &rhs_v) {
         if(lhs_v.Empty()) {
-            throw util::RuntimeError(ErrorNotInit("left", opStr()));
+            throw util::RuntimeError(ErrorNotInit("left", opStr(op)));
         }
         if(rhs_v.Empty()) {
-            throw util::RuntimeError(ErrorNotInit("right", opStr()));
+            throw util::RuntimeError(ErrorNotInit("right", opStr(op)));
         }
 
         if(rhs_v.IsNumber() and lhs_v.IsNumber()) {
@@ -257,7 +272,7 @@ struct ExprComparison: ExprBase {
                 less_equal,
                 greater_equal };
 
-    const char *opStr(op_t op) const {
+    static const char *opStr(op_t op) {
         switch(op) {
             case equal:
                 return "==";
@@ -279,85 +294,61 @@ struct ExprComparison: ExprBase {
     std::vector<PtrExpr> operands;
 
     Any evaluate(Environment &env) const override {
-        auto SwitchImpl = [&](const auto &lv, const auto &rv, op_t op) {
-            switch(op) {
-                case equal:
-                    if(!IsSame(lv, rv))
-                        return false;
-                    break;
-                case not_equal:
-                    if(IsSame(lv, rv))
-                        return false;
-                    break;
-                case less:
-                    if(lv >= rv)
-                        return false;
-                    break;
-                case greater:
-                    if(lv <= rv)
-                        return false;
-                    break;
-                case less_equal:
-                    if(lv > rv)
-                        return false;
-                    break;
-                case greater_equal:
-                    if(lv < rv)
-                        return false;
-                    break;
-            }
-            return true;
-        };
-
         auto lhs_v = operands[0]->evaluate(env);
         for(auto i = 0u; i != ops.size(); ++i) {
             auto rhs_v = operands[i + 1]->evaluate(env);
-
-            if(lhs_v.Empty()) {
-                throw util::RuntimeError(ErrorNotInit("left", opStr(ops[i])));
-            }
-            if(rhs_v.Empty()) {
-                throw util::RuntimeError(ErrorNotInit("right", opStr(ops[i])));
-            }
-            const Any False(0.0);
-
-            if(lhs_v.IsNumber() and rhs_v.IsNumber()) {
-                auto lv = lhs_v.Cast<double>();
-                auto rv = rhs_v.Cast<double>();
-                if(!SwitchImpl(lv, rv, ops[i])) {
-                    return False;
-                }
-            } else if(lhs_v.IsString() and rhs_v.IsString()) {
-                auto lv = lhs_v.Cast<SimpleString>();
-                auto rv = rhs_v.Cast<SimpleString>();
-                if(!SwitchImpl(lv, rv, ops[i])) {
-                    return False;
-                }
-            } else if(lhs_v.IsString() and rhs_v.IsNumber()) {
-                auto lv = StringToDouble(lhs_v, env);
-                auto rv = rhs_v.Cast<double>();
-                if(!SwitchImpl(lv, rv, ops[i])) {
-                    return False;
-                }
-            } else if(lhs_v.IsNumber() and rhs_v.IsString()) {
-                auto lv = lhs_v.Cast<double>();
-                auto rv = StringToDouble(rhs_v, env);
-                if(!SwitchImpl(lv, rv, ops[i])) {
-                    return False;
-                }
-            } else {
-                throw util::RuntimeError(
-                        util::StrCat("Can't mix different types in Comparison. "
-                               "Left operand [",
-                               behaviortree::Demangle(lhs_v.Type()),
-                               "] right operand [",
-                               behaviortree::Demangle(rhs_v.Type()), "]")
-                );
+            if(!Compare(ops[i], lhs_v, rhs_v, env)) {
+                return Any(0.0);
             }
             lhs_v = rhs_v;
         }
         return Any(1.0);
     }
+
+    static bool Compare(op_t op, const Any &lhs_v, const Any &rhs_v, const Environment &env) {
+        if(lhs_v.Empty()) {
+            throw util::RuntimeError(ErrorNotInit("left", opStr(op)));
+        }
+        if(rhs_v.Empty()) {
+            throw util::RuntimeError(ErrorNotInit("right", opStr(op)));
+        }
+
+        if(lhs_v.IsNumber() and rhs_v.IsNumber()) {
+            return Compare(op, lhs_v.Cast<double>(), rhs_v.Cast<double>());
+        } else if(lhs_v.IsString() and rhs_v.IsString()) {
+            return Compare(op, lhs_v.GetStringView(), rhs_v.GetStringView());
+        } else if(lhs_v.IsString() and rhs_v.IsNumber()) {
+            return Compare(op, StringToDouble(lhs_v, env), rhs_v.Cast<double>());
+        } else if(lhs_v.IsNumber() and rhs_v.IsString()) {
+            return Compare(op, lhs_v.Cast<double>(), StringToDouble(rhs_v, env));
+        }
+        throw util::RuntimeError(
+                util::StrCat("Can't mix different types in Comparison. "
+                       "Left operand [",
+                       behaviortree::Demangle(lhs_v.Type()),
+                       "] right operand [",
+                       behaviortree::Demangle(rhs_v.Type()), "]")
+        );
+    }
+
+    template<typename T>
+    static bool Compare(op_t op, const T &lv, const T &rv) {
+        switch(op) {
+            case equal:
+                return IsSame(lv, rv);
+            case not_equal:
+                return !IsSame(lv, rv);
+            case less:
+                return lv < rv;
+            case greater:
+                return lv > rv;
+            case less_equal:
+                return lv <= rv;
+            case greater_equal:
+                return lv >= rv;
+        }
+        return true;
+    }
 };
 
 struct ExprIf: ExprBase {
@@ -368,16 +359,18 @@ struct ExprIf: ExprBase {
                                                                      else_(LEXY_MOV(else_)) {}
 
     Any evaluate(Environment &env) const override {
-        const auto &v = condition->evaluate(env);
-        bool valid = (v.IsType<SimpleString>() and
-                      v.Cast<SimpleString>().size() > 0) or
-                     (v.Cast<double>() != 0.0);
-        if(valid) {
+        if(IsTrue(condition->evaluate(env))) {
             return then->evaluate(env);
         } else {
             return else_->evaluate(env);
         }
     }
+
+    static bool IsTrue(const Any &v) {
+        return (v.IsType<SimpleString>() and
+                !v.GetStringView().empty()) or
+               (v.Cast<double>() != 0.0);
+    }
 };
 
 struct ExprAssignment: ExprBase {
@@ -391,6 +384,10 @@ struct ExprAssignment: ExprBase {
     } op;
 
     const char *opStr() const {
+        return opStr(op);
+    }
+
+    static const char *opStr(op_t op) {
         switch(op) {
             case assign_create:
                 return ":=";
@@ -422,6 +419,13 @@ struct ExprAssignment: ExprBase {
         }
         const auto &key = varname->name;
 
+        auto entry = PrepareEntry(env, key, op);
+        auto value = rhs->evaluate(env);
+        return Assign(env, key, *entry, op, std::move(value));
+    }
+
+    // the entry is looked up (or created) before the right operand is evaluated
+    static std::shared_ptr<Blackboard::Entry> PrepareEntry(Environment &env, const std::string &key, op_t op) {
         auto entry = env.ptrVars->GetEntry(key);
         if(!entry) {
             // variable doesn't exist, create it if using operator assign_create
@@ -442,10 +446,34 @@ struct ExprAssignment: ExprBase {
                 throw util::RuntimeError(msg);
             }
         }
-        auto value = rhs->evaluate(env);
+        return entry;
+    }
 
-        std::scoped_lock lock(entry->entryMutex);
-        auto *dst_ptr = &entry->value;
+    static Any Assign(Environment &env, const std::string &key, Blackboard::Entry &entry, op_t op, Any value) {
+        std::unique_lock lock(entry.entryMutex);
+        auto *dst_ptr = &entry.value;
+
+        // the watchers are notified once the entry is unlocked
+        auto publish = [&]() {
+            entry.sequenceId++;
+            entry.stamp = Clock::Now();
+            // keep the optimistic reads of the numbers
+            if(dst_ptr->Type() == typeid(double)) {
+                entry.PublishSnapshot(dst_ptr->Cast<double>());
+            } else if(dst_ptr->Type() == typeid(int64_t)) {
+                entry.PublishSnapshot(dst_ptr->Cast<int64_t>());
+            } else if(dst_ptr->Type() == typeid(uint64_t)) {
+                entry.PublishSnapshot(dst_ptr->Cast<uint64_t>());
+            } else if(dst_ptr->Type() == typeid(int)) {
+                entry.PublishSnapshot(dst_ptr->Cast<int>());
+            } else {
+                entry.InvalidateSnapshot();
+            }
+            Any result = *dst_ptr;
+            lock.unlock();
+            env.ptrVars->NotifyWatchers(key, Blackboard::EntryEvent::Updated);
+            return result;
+        };
 
         auto errorPrefix = [dst_ptr, &key]() {
             return util::StrCat(
@@ -455,20 +483,20 @@ struct ExprAssignment: ExprBase {
         };
 
         if(value.Empty()) {
-            throw util::RuntimeError(ErrorNotInit("right", opStr()));
+            throw util::RuntimeError(ErrorNotInit("right", opStr(op)));
         }
 
         if(op == assign_create or op == assign_existing) {
             // the very fist assignment can come from any type.
             // In the future, type check will be done by Any::copyInto
             if(dst_ptr->Empty() and
-               entry->typeInfo.Type() == typeid(AnyTypeAllowed)) {
+               entry.typeInfo.Type() == typeid(AnyTypeAllowed)) {
                 *dst_ptr = value;
             } else if(value.IsString() and !dst_ptr->IsString()) {
                 // special case: string to other type.
                 // Check if we can use the StringConverter
                 auto const str = value.Cast<std::string>();
-                const auto *entry_info = env.ptrVars->GetEntryInfo(key);
+                const auto *entry_info = &entry.typeInfo;
 
                 if(auto converter = entry_info->Converter()) {
                     *dst_ptr = converter(str);
@@ -496,13 +524,11 @@ struct ExprAssignment: ExprBase {
                     throw util::RuntimeError(msg);
                 }
             }
-            entry->sequenceId++;
-            entry->stamp = std::chrono::steady_clock::now().time_since_epoch();
-            return *dst_ptr;
+            return publish();
         }
 
         if(dst_ptr->Empty()) {
-            throw util::RuntimeError(ErrorNotInit("left", opStr()));
+            throw util::RuntimeError(ErrorNotInit("left", opStr(op)));
         }
 
         // temporary use
@@ -545,9 +571,7 @@ struct ExprAssignment: ExprBase {
         }
 
         temp_variable.CopyInto(*dst_ptr);
-        entry->sequenceId++;
-        entry->stamp = std::chrono::steady_clock::now().time_since_epoch();
-        return *dst_ptr;
+        return publish();
     }
 };
 }// namespace behaviortree::Ast
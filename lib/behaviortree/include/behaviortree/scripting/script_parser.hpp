@@ -28,8 +28,53 @@ Result ValidateScript(const std::string &refScript);
 
 using ScriptFunction = std::function<Any(Ast::Environment &refEnv)>;
 
+/**
+ * @brief ScriptCache is the process-wide cache of the parsed and compiled
+ * scripts, keyed by their text and shared by all the trees.
+ *
+ * ParseScript() and ValidateScript() parse each distinct text only once;
+ * the compiled scripts are immutable, the functions returned by
+ * ParseScript() share them. Thread-safe.
+ */
+class BEHAVIORTREE_API ScriptCache {
+ public:
+    struct Options {
+        // maximum number of cached scripts, the least recently used are
+        // evicted first. 0 means unbounded
+        size_t maxCachedNum{0};
+    };
+
+    struct Stats {
+        uint64_t hitsNum{0};
+        uint64_t missesNum{0};
+        size_t cachedNum{0};
+    };
+
+    static void SetOptions(const Options &rOptions);
+
+    [[nodiscard]] static Options GetOptions();
+
+    [[nodiscard]] static Stats GetStats();
+
+    /// Remove the cached scripts; the functions already created keep theirs.
+    static void Clear();
+};
+
 Expected<ScriptFunction> ParseScript(const std::string &refScript);
 
+/**
+ * @brief ParseScript binds the script to the environment it will be executed
+ * in, usually the one of the node that owns it: the names of refEnv.ptrEnums
+ * are replaced by their values, constant sub-expressions are folded, and the
+ * variables are resolved once to the entries of refEnv.ptrVars (entries
+ * created later are resolved at their first use).
+ *
+ * Enums may still be added to the table: the script is bound again at its
+ * next execution. The function can also be executed in another environment,
+ * using lookups by name.
+ */
+Expected<ScriptFunction> ParseScript(const std::string &refScript, const Ast::Environment &refEnv);
+
 Expected<Any> ParseScriptAndExecute(
         Ast::Environment &refEnv, const std::string &refScript
 );
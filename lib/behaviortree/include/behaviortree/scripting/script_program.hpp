@@ -0,0 +1,144 @@
+#ifndef BEHAVIORTREE_SCRIPT_PROGRAM_HPP
+#define BEHAVIORTREE_SCRIPT_PROGRAM_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "behaviortree/scripting/script_parser.hpp"
+
+namespace behaviortree {
+namespace Ast {
+struct ExprBase;
+}// namespace Ast
+
+/**
+ * @brief ScriptProgram is a script compiled to the bytecode of a small
+ * register machine.
+ *
+ * Each expression writes its result in a register; the temporaries of its
+ * operands use the registers that follow. Numbers are kept unboxed in the
+ * registers, only the other values (strings, custom types) are held by an
+ * Any. Values are boxed only when they cross the blackboard, or when an
+ * operation falls back to the implementation of the AST (see operators.hpp),
+ * which keeps the semantic of the tree-walking interpreter.
+ *
+ * Constant sub-expressions are folded by the compiler. When a script is
+ * attached to a node, it is also bound to the environment of the node:
+ * the names of its enums become constants, and the variables are read
+ * through an EntryCache instead of being looked up by name.
+ */
+class BEHAVIORTREE_API ScriptProgram {
+ public:
+    using Ptr = std::shared_ptr<const ScriptProgram>;
+
+    enum class OpCode : uint8_t {
+        // dst = numberVec[arg]
+        LoadNumber,
+        // dst = constantVec[arg]
+        LoadConstant,
+        // dst = enum or blackboard entry nameVec[arg]
+        LoadVariable,
+        // dst = op lhs
+        Unary,
+        // dst = lhs op rhs
+        Binary,
+        // dst = (lhs op rhs) ? 1 : 0
+        Compare,
+        // if dst == 0, pc = arg
+        JumpIfZero,
+        // if dst is not true (as the condition of ExprIf), pc = arg
+        JumpUnless,
+        // pc = arg
+        Jump,
+        // find, or create, the entry nameVec[arg] before evaluating the value
+        PrepareAssign,
+        // entry nameVec[arg] op= dst, then dst = entry
+        Assign
+    };
+
+    struct Instruction {
+        OpCode opCode;
+        // operator of the AST node
+        uint8_t op{0};
+        uint16_t dst{0};
+        uint16_t lhs{0};
+        uint16_t rhs{0};
+        // index in the tables of the program, or target of a jump
+        uint32_t arg{0};
+    };
+
+    /**
+     * @brief Handles of the blackboard entries used by a program, resolved
+     * for the blackboard the script is bound to.
+     *
+     * An entry that doesn't exist yet, or that has been removed, is looked
+     * up by name again at each access, until it is found. Thread-safe.
+     */
+    class BEHAVIORTREE_API EntryCache {
+     public:
+        EntryCache(const ScriptProgram &rProgram, const Blackboard::Ptr &pBlackboard);
+
+        EntryCache(const EntryCache &rOther) = delete;
+        EntryCache &operator=(const EntryCache &rOther) = delete;
+
+        [[nodiscard]] bool IsBoundTo(const Blackboard::Ptr &pBlackboard) const {
+            return !m_pBlackboard.owner_before(pBlackboard) and !pBlackboard.owner_before(m_pBlackboard);
+        }
+
+        /// nullptr if the entry doesn't exist.
+        [[nodiscard]] Blackboard::Entry *Resolve(uint32_t nameIdx, const std::string &rName, const Blackboard &rBlackboard);
+
+     private:
+        // identity of the blackboard, compared by owner
+        std::weak_ptr<Blackboard> m_pBlackboard;
+        std::unique_ptr<std::atomic<Blackboard::Entry *>[]> m_pEntryArr;
+
+        std::mutex m_mutex;
+        // keep the entries of m_pEntryArr alive
+        std::vector<std::shared_ptr<Blackboard::Entry>> m_holderVec;
+    };
+
+    /**
+     * @brief Compile the AST of a script.
+     *
+     * @param pEnums if not null, the names found in the table are replaced
+     * by their values, as found when compiling: the program must be compiled
+     * again when names are added to the table, and executed only in an
+     * environment that uses this table.
+     *
+     * @return nullptr if the script contains a construct the compiler
+     * doesn't handle; the AST must be evaluated directly in that case.
+     */
+    [[nodiscard]] static Ptr Compile(const std::vector<std::shared_ptr<Ast::ExprBase>> &rExprVec, const EnumsTablePtr &pEnums = {});
+
+    /// Value of the last statement. pEntryCache, if not null, must have been
+    /// created for this program and be bound to rEnv.ptrVars.
+    Any Execute(Ast::Environment &rEnv, EntryCache *pEntryCache = nullptr) const;
+
+    [[nodiscard]] const std::vector<Instruction> &GetInstructions() const {
+        return m_instructionVec;
+    }
+
+    [[nodiscard]] size_t GetRegistersNum() const {
+        return m_registersNum;
+    }
+
+ private:
+    class Compiler;
+    struct Register;
+
+    std::vector<Instruction> m_instructionVec;
+    std::vector<double> m_numberVec;
+    // literals other than numbers, identical strings are stored once
+    std::vector<Any> m_constantVec;
+    std::vector<std::string> m_nameVec;
+    size_t m_registersNum{0};
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_SCRIPT_PROGRAM_HPP
@@ -0,0 +1,71 @@
+#ifndef BEHAVIORTREE_TREE_ARENA_H
+#define BEHAVIORTREE_TREE_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "behaviortree/common.h"
+
+namespace behaviortree {
+/**
+ * @brief TreeArena is a monotonic memory pool that stores the TreeNode
+ * objects (and their private implementation) of a single Tree.
+ *
+ * While a TreeArena::Scope is active in the current thread, the nodes
+ * created with operator new are placed contiguously in the arena, instead
+ * of being allocated one by one. Deleting such a node only runs its
+ * destructor; the memory is released in bulk when the Tree and all the nodes
+ * that were allocated in the arena have been destroyed.
+ *
+ * Nodes created outside of a Scope use the heap, as usual.
+ */
+class BEHAVIORTREE_API TreeArena {
+ public:
+    using Ptr = std::shared_ptr<TreeArena>;
+
+    [[nodiscard]] static Ptr Create(size_t initialSize);
+
+    TreeArena(const TreeArena &rOther) = delete;
+    TreeArena &operator=(const TreeArena &rOther) = delete;
+
+    /// Bytes requested from the arena so far.
+    [[nodiscard]] size_t GetAllocatedBytes() const;
+
+    /// Allocate from the arena of the current Scope, or from the heap.
+    [[nodiscard]] static void *Allocate(size_t size);
+
+    /// Release memory returned by Allocate().
+    static void Deallocate(void *pMemory) noexcept;
+
+    /// Route the allocations of the current thread to an arena,
+    /// until the Scope is destroyed. Scopes can be nested.
+    class Scope {
+     public:
+        explicit Scope(const Ptr &pArena);
+        ~Scope();
+
+        Scope(const Scope &rOther) = delete;
+        Scope &operator=(const Scope &rOther) = delete;
+
+     private:
+        TreeArena *m_pPreArena;
+    };
+
+ private:
+    explicit TreeArena(size_t initialSize);
+    ~TreeArena() = default;
+
+    // the owners (Ptr) count as one reference, each allocation as another
+    void Acquire();
+    void Release();
+
+    std::pmr::monotonic_buffer_resource m_resource;
+    std::atomic<size_t> m_refsNum{1};
+    std::atomic<size_t> m_allocatedBytes{0};
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_TREE_ARENA_H
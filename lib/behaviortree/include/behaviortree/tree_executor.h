@@ -0,0 +1,108 @@
+#ifndef BEHAVIORTREE_TREE_EXECUTOR_H
+#define BEHAVIORTREE_TREE_EXECUTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "behaviortree/common.h"
+#include "behaviortree/factory.h"
+
+namespace behaviortree {
+/**
+ * @brief TreeExecutor owns many trees and ticks them on the worker threads
+ * of a shadow::thread::Pool.
+ *
+ * A tree is ticked once when it is added (or rescheduled with Schedule()),
+ * then, while it is RUNNING, every time one of its nodes emits a wake-up
+ * signal (asynchronous actions, timers, watched blackboard entries).
+ * Wake-ups received while the tree is queued or being ticked are coalesced
+ * into a single tick, and a tree is never ticked by two threads at the same time.
+ *
+ * Ready trees are pushed into the queue of the worker that woke them up (or
+ * in round-robin when the wake-up comes from another thread); idle workers
+ * steal from the queues of the others.
+ *
+ * Trees whose nodes poll an external state without emitting a wake-up
+ * signal need the heartbeat: every Options::heartbeat, all the RUNNING
+ * trees are scheduled again.
+ */
+class BEHAVIORTREE_API TreeExecutor {
+ public:
+    using TreeId = uint64_t;
+
+    struct Options {
+        // 0 means std::thread::hardware_concurrency()
+        size_t threadsNum{0};
+        // 0 means no heartbeat
+        std::chrono::milliseconds heartbeat{0};
+    };
+
+    struct Stats {
+        uint64_t ticksNum{0};
+        // ticks per second since the previous call of GetStats()
+        double ticksPerSecond{0.0};
+        // trees waiting in the worker queues
+        size_t queueDepth{0};
+        size_t treesNum{0};
+        uint64_t stealsNum{0};
+    };
+
+    struct TreeStats {
+        NodeStatus nodeStatus{NodeStatus::Idle};
+        uint64_t ticksNum{0};
+        // time between the wake-up and the beginning of the tick
+        std::chrono::nanoseconds lastLatency{0};
+        std::chrono::nanoseconds maxLatency{0};
+        std::chrono::nanoseconds lastTickDuration{0};
+        std::chrono::nanoseconds maxTickDuration{0};
+        // what() of the exception thrown by the last tick, if any
+        std::string lastError;
+    };
+
+    TreeExecutor();
+
+    explicit TreeExecutor(const Options &rOptions);
+
+    TreeExecutor(const TreeExecutor &rOther) = delete;
+    TreeExecutor &operator=(const TreeExecutor &rOther) = delete;
+
+    /// Stop the workers and halt all the trees.
+    ~TreeExecutor();
+
+    /// Take the ownership of a tree and schedule its first tick.
+    TreeId Add(Tree &&rTree);
+
+    /**
+     * @brief Remove a tree, waiting for its current tick (if any) to complete.
+     * The tree is halted and destroyed.
+     * Must not be called from a node of the tree itself.
+     *
+     * @return false if the tree doesn't exist.
+     */
+    bool Remove(TreeId treeId);
+
+    /**
+     * @brief Schedule a tick of the tree, as a wake-up signal would do.
+     * Unlike a wake-up, it also restarts a tree that already completed.
+     *
+     * @return false if the tree doesn't exist.
+     */
+    bool Schedule(TreeId treeId);
+
+    [[nodiscard]] std::optional<TreeStats> GetTreeStats(TreeId treeId) const;
+
+    [[nodiscard]] Stats GetStats() const;
+
+    [[nodiscard]] size_t GetThreadsNum() const;
+
+ private:
+    struct PImpl;
+    std::unique_ptr<PImpl> m_pPImpl;
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_TREE_EXECUTOR_H
@@ -3,10 +3,13 @@
 
 #include <exception>
 #include <map>
+#include <optional>
 #include <utility>
 
 #include "behaviortree/basic_types.h"
 #include "behaviortree/blackboard.h"
+#include "behaviortree/port_binding.h"
+#include "behaviortree/tree_arena.h"
 #include "behaviortree/scripting/script_parser.hpp"
 #include "behaviortree/util/signal.h"
 #include "behaviortree/util/wakeup_signal.hpp"
@@ -114,6 +117,30 @@ class TreeNode {
 
     virtual ~TreeNode();
 
+    /// Nodes are placed in the TreeArena of the tree being built, if any.
+    static void *operator new(std::size_t size) {
+        return TreeArena::Allocate(size);
+    }
+
+    static void operator delete(void *pMemory) noexcept {
+        TreeArena::Deallocate(pMemory);
+    }
+
+    // over-aligned nodes always use the heap
+    static void *operator new(std::size_t size, std::align_val_t alignment) {
+        return ::operator new(size, alignment);
+    }
+
+    static void operator delete(void *pMemory, std::align_val_t alignment) noexcept {
+        ::operator delete(pMemory, alignment);
+    }
+
+    static void *operator new(std::size_t, void *pPlace) noexcept {
+        return pPlace;
+    }
+
+    static void operator delete(void *, void *) noexcept {}
+
     /// The method that should be used to invoke tick() and setStatus();
     virtual behaviortree::NodeStatus ExecuteTick();
 
@@ -258,6 +285,71 @@ class TreeNode {
     template<typename T>
     Result SetOutput(const std::string &rKey, const T &rValue);
 
+    /// Same as SetOutput(key, value), moving rValue into the blackboard entry.
+    template<typename T, typename = std::enable_if_t<!std::is_reference_v<T>>>
+    Result SetOutput(const std::string &rKey, T &&rValue);
+
+    /**
+     * @brief GetInputView reads an input port without copying its value.
+     * Use it for large objects (point clouds, paths, maps...):
+     *
+     *    if(auto view = GetInputView<Path>("path")) {
+     *      const Path &path = **view;
+     *      ...
+     *    }
+     *
+     * If the blackboard entry stores a T, the view points to it and keeps the
+     * entry read-locked: the writers of the entry wait until the view is
+     * destroyed, the readers don't. Otherwise (conversion from a string or
+     * between numbers), the view holds the converted value. Views of a literal
+     * port point to the value cached by the node.
+     *
+     * While the view is alive, the same thread may read the entry again
+     * (GetInput, GetInputView), but must not write it (SetOutput,
+     * Blackboard::Set...): that deadlocks.
+     *
+     * @param key   the name of the port.
+     */
+    template<typename T>
+    [[nodiscard]] Expected<LockedView<T>> GetInputView(const std::string &rKey) const;
+
+    /**
+     * @brief Pre-resolved binding of a port. Bindings are created by the factory
+     * when the node is instantiated, and updated when its ports are remapped; store the pointer once
+     * and use it with GetInput(binding, ...) and SetOutput(binding, ...) to
+     * skip any lookup by name.
+     * Nodes not built by the factory, or whose NodeConfig changed since, get
+     * their bindings created on demand from the current NodeConfig.
+     *
+     * @param key  the name of the port.
+     * @return     nullptr if the port is neither remapped nor has a default value.
+     */
+    [[nodiscard]] const PortBinding *GetInputBinding(const std::string &rKey) const;
+
+    [[nodiscard]] const PortBinding *GetOutputBinding(const std::string &rKey) const;
+
+    /**
+     * @brief Same as GetInputStamped(key, destination), using a binding
+     * returned by GetInputBinding(). Errors are reported as error codes.
+     *
+     * @param binding      the binding of the port.
+     * @param destination  reference to the object where the value should be stored
+     * @param stamp        if not nullptr, updated with the Timestamp of the value
+     */
+    template<typename T>
+    [[nodiscard]] PortErrorCode GetInput(const PortBinding &rBinding, T &rDestination, Timestamp *pStamp = nullptr) const;
+
+    /// Same as GetInputView(key), using a binding returned by GetInputBinding().
+    template<typename T>
+    [[nodiscard]] PortErrorCode GetInputView(const PortBinding &rBinding, LockedView<T> &rView) const;
+
+    /// Same as SetOutput(key, value), using a binding returned by GetOutputBinding().
+    template<typename T>
+    PortErrorCode SetOutput(const PortBinding &rBinding, const T &rValue);
+
+    template<typename T, typename = std::enable_if_t<!std::is_reference_v<T>>>
+    PortErrorCode SetOutput(const PortBinding &rBinding, T &&rValue);
+
     /**
    * @brief getLockedPortContent should be used when:
    *
@@ -327,6 +419,7 @@ class TreeNode {
     friend class DecoratorNode;
     friend class ControlNode;
     friend class Tree;
+    friend class CompiledTree;
 
     [[nodiscard]] NodeConfig &GetConfig();
 
@@ -341,8 +434,20 @@ class TreeNode {
 
     void SetWakeUpInstance(std::shared_ptr<WakeUpSignal> pInstance);
 
+    /// nullptr if the node doesn't require the wake-up signal.
+    [[nodiscard]] std::shared_ptr<WakeUpSignal> GetWakeUpInstance() const;
+
+    /// Change the remapping of existing ports and resolve the bindings again.
+    /// A remapping changed through GetConfig() is only used once
+    /// ResolvePortBindings() is called.
     void ModifyPortsRemapping(const PortsRemapping &rNewRemapping);
 
+    /// Create or update the port bindings from the current NodeConfig.
+    /// Called by the factory once the config of the node is final; existing
+    /// bindings are updated in place, so that the pointers returned by
+    /// GetInputBinding() and GetOutputBinding() stay valid.
+    void ResolvePortBindings();
+
     /**
      * @brief setStatus changes the status of the node.
      * it will throw if you try to change the status to IDLE, because
@@ -356,6 +461,10 @@ class TreeNode {
     PreScripts &PreConditionsScripts();
     PostScripts &PostConditionsScripts();
 
+    /// True if the node has pre/post conditions, injected tick callbacks or
+    /// status-change subscribers.
+    [[nodiscard]] bool HasTickHooks() const;
+
     template<typename T>
     T ParseString(const std::string &rStr) const;
 
@@ -366,6 +475,48 @@ class TreeNode {
     Expected<NodeStatus> CheckPreConditions();
     void CheckPostConditions(NodeStatus nodeStatus);
 
+    [[nodiscard]] std::string PortErrorMessage(std::string_view function, const std::string &rKey, const PortBinding &rBinding, PortErrorCode errorCode, std::string_view what = {}) const;
+
+    // pWhat, if not nullptr, receives the cause of a ConversionFailed error
+    template<typename T>
+    [[nodiscard]] PortErrorCode GetInputImpl(const PortBinding &rBinding, T &rDestination, Timestamp *pStamp, std::string *pWhat) const;
+
+    template<typename T>
+    [[nodiscard]] PortErrorCode GetInputViewImpl(const PortBinding &rBinding, LockedView<T> &rView, std::string *pWhat) const;
+
+    template<typename T>
+    PortErrorCode SetOutputImpl(const PortBinding &rBinding, T &&rValue);
+
+    template<typename T>
+    Result SetOutputImpl(const std::string &rKey, T &&rValue);
+
+    // key of the values of rBinding.literalCache: an enum parsed from its name
+    // depends on the enums registered so far (only ever added)
+    template<typename T>
+    [[nodiscard]] size_t LiteralCacheKey([[maybe_unused]] const PortBinding &rBinding) const {
+        if constexpr(std::is_enum_v<T> and !std::is_same_v<T, NodeStatus>) {
+            const auto &pEnums = GetConfig().pEnums;
+            if(rBinding.kind == PortBinding::Kind::Literal and pEnums) {
+                return pEnums->size();
+            }
+        }
+        return 0;
+    }
+
+    template<typename Converter>
+    [[nodiscard]] static PortErrorCode ConvertPortValue(Converter &&rConverter, std::string *pWhat) {
+        // the string and Any conversions report errors by throwing
+        try {
+            rConverter();
+        } catch(std::exception &rError) {
+            if(pWhat != nullptr) {
+                *pWhat = rError.what();
+            }
+            return PortErrorCode::ConversionFailed;
+        }
+        return PortErrorCode::Ok;
+    }
+
     /// The method used to interrupt the execution of a RUNNING node.
     /// Only Async nodes that may return RUNNING should implement it.
     virtual void Halt() = 0;
@@ -389,96 +540,222 @@ T TreeNode::ParseString(const std::string &rStr) const {
 }
 
 template<typename T>
-inline Expected<Timestamp> TreeNode::GetInputStamped(const std::string &rKey, T &rDestination) const {
-    std::string portValue;
+inline PortErrorCode TreeNode::GetInput(const PortBinding &rBinding, T &rDestination, Timestamp *pStamp) const {
+    return GetInputImpl(rBinding, rDestination, pStamp, nullptr);
+}
 
-    auto ptrInputPort = GetConfig().inputPortMap.find(rKey);
-    if(ptrInputPort != GetConfig().inputPortMap.end()) {
-        portValue = ptrInputPort->second;
-    } else if(GetConfig().pManifest != nullptr) {
-        return nonstd::make_unexpected(
-                util::StrCat("GetInput() of node '", GetFullPath(),
-                       "' failed because the manifest is "
-                       "nullptr (WTF?) and the key: [",
-                       rKey, "] is missing")
-        );
-    } else {
-        // maybe it is declared with a default value in the manifest
-        auto pPortManifest = GetConfig().pManifest->portMap.find(rKey);
-        if(pPortManifest == GetConfig().pManifest->portMap.end()) {
-            return nonstd::make_unexpected(
-                    util::StrCat("getInput() of node '", GetFullPath(),
-                           "' failed because the manifest doesn't "
-                           "contain the key: [",
-                           rKey, "]")
-            );
-        }
-        const auto &rPortInfo = pPortManifest->second;
-        // there is a default value
-        if(rPortInfo.DefaultValue().Empty()) {
-            return nonstd::make_unexpected(
-                    util::StrCat("getInput() of node '", GetFullPath(),
-                           "' failed because nor the manifest or the "
-                           "XML contain the key: [",
-                           rKey, "]")
-            );
-        }
-        if(rPortInfo.DefaultValue().IsString()) {
-            portValue = rPortInfo.DefaultValue().Cast<std::string>();
-        } else {
-            rDestination = rPortInfo.DefaultValue().Cast<T>();
-            return Timestamp{};
-        }
+template<typename T>
+inline PortErrorCode TreeNode::GetInputImpl(const PortBinding &rBinding, T &rDestination, Timestamp *pStamp, std::string *pWhat) const {
+    if(pStamp != nullptr) {
+        *pStamp = Timestamp{};
     }
 
-    auto blackboardKey = GetRemappedKey(rKey, portValue);
-    try {
-        // pure string, not a blackboard key
-        if(!blackboardKey) {
-            try {
-                rDestination = ParseString<T>(portValue);
-            } catch(std::exception &ex) {
-                return nonstd::make_unexpected(util::StrCat("getInput(): ", ex.what()));
+    switch(rBinding.kind) {
+        case PortBinding::Kind::Literal:
+        case PortBinding::Kind::Constant: {
+            // parse or convert only the first time
+            const size_t cacheKey = LiteralCacheKey<T>(rBinding);
+            if(const T *pCached = rBinding.literalCache.Find<T>(cacheKey)) {
+                rDestination = *pCached;
+                return PortErrorCode::Ok;
             }
-            return Timestamp{};
+            auto errorCode = ConvertPortValue([&] {
+                if(rBinding.kind == PortBinding::Kind::Literal) {
+                    rDestination = ParseString<T>(rBinding.literal);
+                } else {
+                    rDestination = rBinding.constant.Cast<T>();
+                }
+            }, pWhat);
+            if(errorCode == PortErrorCode::Ok) {
+                rBinding.literalCache.Insert(rDestination, cacheKey);
+            }
+            return errorCode;
         }
-        const auto &rBlackboardKey = blackboardKey.value();
+        case PortBinding::Kind::Entry: {
+            if(GetConfig().pBlackboard == nullptr) {
+                return PortErrorCode::MissingBlackboard;
+            }
+            std::shared_ptr<Blackboard::Entry> pLookupEntry;
+            Blackboard::Entry *pEntry = rBinding.ResolveEntry(GetConfig().pBlackboard, pLookupEntry);
+            if(pEntry == nullptr) {
+                return PortErrorCode::MissingEntry;
+            }
 
-        if(GetConfig().pBlackboard == nullptr) {
-            return nonstd::make_unexpected(
-                    "GetInput(): trying to access "
-                    "an invalid Blackboard"
-            );
-        }
+            // optimistic read of small, trivially copyable values
+            if(pEntry->TryReadSnapshot(rDestination, pStamp)) {
+                return PortErrorCode::Ok;
+            }
 
-        if(auto pEntry = GetConfig().pBlackboard->GetEntry(std::string(rBlackboardKey))) {
-            std::unique_lock lock(pEntry->entryMutex);
-            auto &rAnyValue = pEntry->value;
+            ReadLock lock(pEntry->entryMutex);
+            const auto &rAnyValue = pEntry->value;
 
             // support getInput<Any>()
             if constexpr(std::is_same_v<T, Any>) {
                 rDestination = rAnyValue;
-                return Timestamp{pEntry->sequenceId, pEntry->stamp};
+            } else {
+                if(rAnyValue.Empty()) {
+                    return PortErrorCode::EmptyEntry;
+                }
+                auto errorCode = ConvertPortValue([&] {
+                    if(!std::is_same_v<T, std::string> and rAnyValue.IsString()) {
+                        rDestination = ParseString<T>(rAnyValue.Cast<std::string>());
+                    } else {
+                        rDestination = rAnyValue.Cast<T>();
+                    }
+                }, pWhat);
+                if(errorCode != PortErrorCode::Ok) {
+                    return errorCode;
+                }
             }
+            if(pStamp != nullptr) {
+                *pStamp = Timestamp{pEntry->sequenceId, pEntry->stamp};
+            }
+            return PortErrorCode::Ok;
+        }
+        default: {
+            return PortErrorCode::MissingPort;
+        }
+    }
+}
 
-            if(!pEntry->value.Empty()) {
-                if(!std::is_same_v<T, std::string> and rAnyValue.IsString()) {
-                    rDestination = ParseString<T>(rAnyValue.Cast<std::string>());
+template<typename T>
+inline PortErrorCode TreeNode::GetInputView(const PortBinding &rBinding, LockedView<T> &rView) const {
+    return GetInputViewImpl(rBinding, rView, nullptr);
+}
+
+template<typename T>
+inline PortErrorCode TreeNode::GetInputViewImpl(const PortBinding &rBinding, LockedView<T> &rView, std::string *pWhat) const {
+    rView = {};
+
+    switch(rBinding.kind) {
+        case PortBinding::Kind::Literal:
+        case PortBinding::Kind::Constant: {
+            // literals are converted once, then cached
+            const size_t cacheKey = LiteralCacheKey<T>(rBinding);
+            if(const T *pCached = rBinding.literalCache.Find<T>(cacheKey)) {
+                rView = LockedView<T>(*pCached);
+                return PortErrorCode::Ok;
+            }
+            std::optional<T> value;
+            auto errorCode = ConvertPortValue([&] {
+                if(rBinding.kind == PortBinding::Kind::Literal) {
+                    value.emplace(ParseString<T>(rBinding.literal));
                 } else {
-                    rDestination = rAnyValue.Cast<T>();
+                    value.emplace(rBinding.constant.Cast<T>());
                 }
-                return Timestamp{pEntry->sequenceId, pEntry->stamp};
+            }, pWhat);
+            if(errorCode != PortErrorCode::Ok) {
+                return errorCode;
+            }
+            rBinding.literalCache.Insert(*value, cacheKey);
+            // another thread may have inserted it first
+            rView = LockedView<T>(*rBinding.literalCache.Find<T>(cacheKey));
+            return PortErrorCode::Ok;
+        }
+        case PortBinding::Kind::Entry: {
+            if(GetConfig().pBlackboard == nullptr) {
+                return PortErrorCode::MissingBlackboard;
+            }
+            std::shared_ptr<Blackboard::Entry> pLookupEntry;
+            Blackboard::Entry *pEntry = rBinding.ResolveEntry(GetConfig().pBlackboard, pLookupEntry);
+            if(pEntry == nullptr) {
+                return PortErrorCode::MissingEntry;
             }
+
+            ReadLock lock(pEntry->entryMutex);
+            const auto &rAnyValue = pEntry->value;
+            std::shared_ptr<const void> pOwner = pLookupEntry ? pLookupEntry : rBinding.entry.GetShared();
+            if constexpr(std::is_same_v<T, Any>) {
+                rView = LockedView<T>(rAnyValue, std::move(lock), std::move(pOwner));
+                return PortErrorCode::Ok;
+            } else {
+                if(rAnyValue.Empty()) {
+                    return PortErrorCode::EmptyEntry;
+                }
+                // point to the value stored in the entry, if it doesn't need a conversion
+                if constexpr(std::is_class_v<T> and !std::is_same_v<T, std::string> and !std::is_same_v<T, SafeAny::SimpleString>) {
+                    if(const T *pValue = rAnyValue.template CastPtr<T>()) {
+                        rView = LockedView<T>(*pValue, std::move(lock), std::move(pOwner));
+                        return PortErrorCode::Ok;
+                    }
+                }
+                std::shared_ptr<const T> pSnapshot;
+                auto errorCode = ConvertPortValue([&] {
+                    if(!std::is_same_v<T, std::string> and rAnyValue.IsString()) {
+                        pSnapshot = std::make_shared<const T>(ParseString<T>(rAnyValue.Cast<std::string>()));
+                    } else {
+                        pSnapshot = std::make_shared<const T>(rAnyValue.Cast<T>());
+                    }
+                }, pWhat);
+                if(errorCode != PortErrorCode::Ok) {
+                    return errorCode;
+                }
+                rView = LockedView<T>(std::move(pSnapshot));
+                return PortErrorCode::Ok;
+            }
+        }
+        default: {
+            return PortErrorCode::MissingPort;
+        }
+    }
+}
+
+template<typename T>
+inline PortErrorCode TreeNode::SetOutput(const PortBinding &rBinding, const T &rValue) {
+    return SetOutputImpl(rBinding, rValue);
+}
+
+template<typename T, typename>
+inline PortErrorCode TreeNode::SetOutput(const PortBinding &rBinding, T &&rValue) {
+    return SetOutputImpl(rBinding, std::move(rValue));
+}
+
+template<typename T>
+inline PortErrorCode TreeNode::SetOutputImpl(const PortBinding &rBinding, T &&rValue) {
+    if(GetConfig().pBlackboard == nullptr) {
+        return PortErrorCode::MissingBlackboard;
+    }
+    if(rBinding.kind != PortBinding::Kind::Entry) {
+        return PortErrorCode::NotBlackboardPointer;
+    }
+
+    if constexpr(std::is_same_v<behaviortree::Any, std::decay_t<T>>) {
+        if(GetConfig().pManifest->portMap.at(rBinding.portName).Type() !=
+           typeid(behaviortree::Any)) {
+            throw util::LogicError("setOutput<Any> is not allowed, unless the port was declared using OutputPort<Any>");
         }
+    }
+
+    std::shared_ptr<Blackboard::Entry> pLookupEntry;
+    Blackboard::Entry *pEntry = rBinding.ResolveEntry(GetConfig().pBlackboard, pLookupEntry);
+    if(pEntry == nullptr) {
+        // first write: let the blackboard create the entry
+        GetConfig().pBlackboard->Set(rBinding.blackboardKey, std::forward<T>(rValue));
+    } else {
+        GetConfig().pBlackboard->SetEntryValue(*pEntry, rBinding.blackboardKey, std::forward<T>(rValue));
+    }
+    return PortErrorCode::Ok;
+}
 
+template<typename T>
+inline Expected<Timestamp> TreeNode::GetInputStamped(const std::string &rKey, T &rDestination) const {
+    const PortBinding *pBinding = GetInputBinding(rKey);
+    if(pBinding == nullptr) {
         return nonstd::make_unexpected(
-                util::StrCat("getInput() failed because it was unable to "
-                       "find the key [",
-                       rKey, "] remapped to [", rBlackboardKey, "]")
+                util::StrCat("getInput() of node '", GetFullPath(),
+                             "' failed because nor the manifest or the "
+                             "JSON contain the key: [",
+                             rKey, "]")
         );
-    } catch(std::exception &rError) {
-        return nonstd::make_unexpected(rError.what());
     }
+
+    Timestamp stamp;
+    std::string what;
+    auto errorCode = GetInputImpl(*pBinding, rDestination, &stamp, &what);
+    if(errorCode != PortErrorCode::Ok) {
+        return nonstd::make_unexpected(PortErrorMessage("getInput", rKey, *pBinding, errorCode, what));
+    }
+    return stamp;
 }
 
 template<typename T>
@@ -491,43 +768,52 @@ inline Result TreeNode::GetInput(const std::string &rKey, T &rDestination) const
 }
 
 template<typename T>
-inline Result TreeNode::SetOutput(const std::string &rKey, const T &rValue) {
-    if(GetConfig().pBlackboard == nullptr) {
+inline Expected<LockedView<T>> TreeNode::GetInputView(const std::string &rKey) const {
+    const PortBinding *pBinding = GetInputBinding(rKey);
+    if(pBinding == nullptr) {
         return nonstd::make_unexpected(
-                "setOutput() failed: trying to access a "
-                "Blackboard(BB) entry, but BB is invalid"
+                util::StrCat("getInputView() of node '", GetFullPath(),
+                             "' failed because nor the manifest or the "
+                             "JSON contain the key: [",
+                             rKey, "]")
         );
     }
 
-    auto remapIt = GetConfig().outputPortMap.find(rKey);
-    if(remapIt == GetConfig().outputPortMap.end()) {
+    LockedView<T> view;
+    std::string what;
+    auto errorCode = GetInputViewImpl(*pBinding, view, &what);
+    if(errorCode != PortErrorCode::Ok) {
+        return nonstd::make_unexpected(PortErrorMessage("getInputView", rKey, *pBinding, errorCode, what));
+    }
+    return view;
+}
+
+template<typename T>
+inline Result TreeNode::SetOutput(const std::string &rKey, const T &rValue) {
+    return SetOutputImpl(rKey, rValue);
+}
+
+template<typename T, typename>
+inline Result TreeNode::SetOutput(const std::string &rKey, T &&rValue) {
+    return SetOutputImpl(rKey, std::move(rValue));
+}
+
+template<typename T>
+inline Result TreeNode::SetOutputImpl(const std::string &rKey, T &&rValue) {
+    const PortBinding *pBinding = GetOutputBinding(rKey);
+    if(pBinding == nullptr) {
         return nonstd::make_unexpected(
                 util::StrCat("setOutput() failed: "
-                       "NodeConfig::output_ports "
-                       "does not contain the key: [",
-                       rKey, "]")
+                             "NodeConfig::output_ports "
+                             "does not contain the key: [",
+                             rKey, "]")
         );
     }
-    std::string_view remappedKey = remapIt->second;
-    if(remappedKey == "{=}" or remappedKey == "=") {
-        GetConfig().pBlackboard->Set(static_cast<std::string>(rKey), rValue);
-        return {};
-    }
-
-    if(!IsBlackboardPointer(remappedKey)) {
-        return nonstd::make_unexpected("setOutput requires a blackboard pointer. Use {}");
-    }
 
-    if constexpr(std::is_same_v<behaviortree::Any, T>) {
-        if(GetConfig().pManifest->portMap.at(rKey).Type() !=
-           typeid(behaviortree::Any)) {
-            throw util::LogicError("setOutput<Any> is not allowed, unless the port was declared using OutputPort<Any>");
-        }
+    auto errorCode = SetOutputImpl(*pBinding, std::forward<T>(rValue));
+    if(errorCode != PortErrorCode::Ok) {
+        return nonstd::make_unexpected(PortErrorMessage("setOutput", rKey, *pBinding, errorCode));
     }
-
-    remappedKey = StripBlackboardPointer(remappedKey);
-    GetConfig().pBlackboard->Set(static_cast<std::string>(remappedKey), rValue);
-
     return {};
 }
 
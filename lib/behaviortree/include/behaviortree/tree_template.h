@@ -0,0 +1,89 @@
+#ifndef BEHAVIORTREE_TREE_TEMPLATE_H
+#define BEHAVIORTREE_TREE_TEMPLATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "behaviortree/blackboard.h"
+#include "behaviortree/common.h"
+#include "behaviortree/tree_node.h"
+
+namespace behaviortree {
+/// The term "Builder" refers to the Builder Pattern
+using NodeBuilder = std::function<std::unique_ptr<TreeNode>(const std::string &, const NodeConfig &)>;
+
+/**
+ * @brief TreeTemplate is the resolved definition of a registered tree,
+ * built once by BehaviorTreeFactory::GetTreeTemplate().
+ *
+ * It contains everything that doesn't depend on the instance: the builder of
+ * each node (after the substitution rules), its NodeConfig (including the text
+ * of the pre/post-condition scripts), the links between nodes and the
+ * blackboards of the subtrees (entries, constants and remapping).
+ * The scripts are bound to the blackboard of each instance; their text is
+ * parsed only once (see ParseScript()).
+ * BehaviorTreeFactory::CreateTree(const TreeTemplate&) only creates the nodes
+ * and the blackboards, without going through the parser.
+ *
+ * Like a Tree, it refers to the manifests of the factory: the factory must
+ * outlive it.
+ */
+class BEHAVIORTREE_API TreeTemplate {
+ public:
+    using Ptr = std::shared_ptr<const TreeTemplate>;
+
+    [[nodiscard]] const std::string &GetTreeId() const {
+        return m_treeId;
+    }
+
+    [[nodiscard]] size_t GetNodesNum() const {
+        return m_nodeSpecVec.size();
+    }
+
+    [[nodiscard]] size_t GetSubtreesNum() const {
+        return m_subtreeSpecVec.size();
+    }
+
+ private:
+    friend class BehaviorTreeFactory;
+
+    struct NodeSpec {
+        std::string name;
+        std::string registrationId;
+        NodeBuilder builder;
+        // pBlackboard is assigned at instantiation; the scripts are
+        // parsed from preConditionMap and postConditionMap
+        NodeConfig config;
+        uint32_t subtreeIdx{0};
+        std::vector<uint32_t> childIdxVec;
+        // only for the SubtreeNode
+        std::string subtreeId;
+    };
+
+    struct SubtreeSpec {
+        // -1 for the main tree, that uses the blackboard of the caller
+        int32_t parentIdx{-1};
+        // local entries, constants and remapping of the subtree
+        Blackboard::Ptr pPrototype;
+        std::string instanceName;
+        std::string treeId;
+    };
+
+    std::string m_treeId;
+    std::vector<NodeSpec> m_nodeSpecVec;
+    std::vector<SubtreeSpec> m_subtreeSpecVec;
+    // manifests of the node types used by the tree
+    std::unordered_map<std::string, TreeNodeManifest> m_manifestsMap;
+    uint16_t m_uidCounter{0};
+    // bytes used by the arena of the last instance
+    mutable std::atomic<size_t> m_arenaSizeHint{0};
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_TREE_TEMPLATE_H
@@ -0,0 +1,90 @@
+#ifndef BEHAVIORTREE_CLOCK_H
+#define BEHAVIORTREE_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#include "behaviortree/common.h"
+
+namespace behaviortree {
+/**
+ * @brief Clock is the time source of the library: it stamps the blackboard
+ * entries and the status changes of the nodes, and drives the timers
+ * (see TimerService).
+ *
+ * The time is expressed as the duration since the epoch of
+ * std::chrono::steady_clock (or since the start of the virtual time).
+ * Reading the clock at every write is expensive when the blackboards are
+ * updated millions of times per second; the mode selects a cheaper source:
+ *
+ * - Precise:    std::chrono::steady_clock, read every time.
+ * - Coarse:     the coarse monotonic clock of the system (resolution of a
+ *               few milliseconds, no system call), where available.
+ * - TickCached: the time read once at the beginning of each tick of a tree
+ *               (see TickScope), shared by all the writes of that tick.
+ *               Outside of a tick, the precise time is used.
+ * - Virtual:    the time set by the application (SetVirtualTime()), for
+ *               simulations. The timers expire when the virtual time
+ *               reaches their deadline.
+ *
+ * The timers always use the precise (or virtual) time.
+ */
+class BEHAVIORTREE_API Clock {
+ public:
+    enum class Mode : uint8_t {
+        Precise = 0,
+        Coarse,
+        TickCached,
+        Virtual
+    };
+
+    /**
+     * @brief Select the time source. Call it before the trees are created:
+     * timers started with another mode are not converted.
+     */
+    static void SetMode(Mode mode);
+
+    [[nodiscard]] static Mode GetMode();
+
+    /// Time used for the stamps, according to the mode.
+    [[nodiscard]] static std::chrono::nanoseconds Now() noexcept;
+
+    /// Time never cached: the virtual time in Virtual mode, the steady clock otherwise.
+    [[nodiscard]] static std::chrono::nanoseconds PreciseNow() noexcept;
+
+    /**
+     * @brief Convert a time returned by Now() to a time point of
+     * std::chrono::high_resolution_clock (the clock of TimePoint, that may be
+     * the system clock), as passed to the status-change subscribers.
+     * The virtual time is returned as the time since the epoch of that clock.
+     */
+    [[nodiscard]] static std::chrono::high_resolution_clock::time_point ToTimePoint(std::chrono::nanoseconds time) noexcept;
+
+    /// Set the virtual time, and expire the timers that reached their deadline.
+    static void SetVirtualTime(std::chrono::nanoseconds time);
+
+    static void AdvanceVirtualTime(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief In TickCached mode, TickScope reads the time once; Now() returns
+     * it, in the current thread, until the scope is destroyed.
+     * Tree::TickRoot() opens one at each tick of the root.
+     */
+    class BEHAVIORTREE_API TickScope {
+     public:
+        TickScope() noexcept;
+        ~TickScope();
+
+        TickScope(const TickScope &rOther) = delete;
+        TickScope &operator=(const TickScope &rOther) = delete;
+
+     private:
+        // time of the enclosing scope, 0 if none
+        int64_t m_previousNs{0};
+        bool m_active{false};
+    };
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_CLOCK_H
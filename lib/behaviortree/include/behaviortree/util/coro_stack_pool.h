@@ -0,0 +1,58 @@
+#ifndef BEHAVIORTREE_CORO_STACK_POOL_H
+#define BEHAVIORTREE_CORO_STACK_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "behaviortree/common.h"
+
+namespace behaviortree {
+/**
+ * @brief CoroStackPool recycles the memory of the coroutines of
+ * CoroActionNode (control block and stack, allocated as a single block).
+ *
+ * Each thread keeps a cache of free blocks, shared by all the nodes it ticks:
+ * starting a coroutine reuses a block released by a previous activation,
+ * whose pages are already mapped, instead of allocating a new stack.
+ * Blocks released by another thread than the one that allocated them simply
+ * move to the cache of the releasing thread.
+ */
+class BEHAVIORTREE_API CoroStackPool {
+ public:
+    struct Options {
+        // stack size of the coroutines, 0 means the default of minicoro
+        size_t stackSize{0};
+        // free blocks kept by each thread
+        size_t maxCachedNum{64};
+    };
+
+    struct Stats {
+        size_t stackSize{0};
+        // blocks allocated from the heap
+        uint64_t allocatedNum{0};
+        // blocks taken from a cache
+        uint64_t reusedNum{0};
+        // blocks in the caches of all the threads
+        size_t cachedNum{0};
+        // deepest stack observed when a coroutine yields
+        size_t maxStackUsage{0};
+    };
+
+    /// Takes effect for the coroutines created from now on.
+    static void SetOptions(const Options &rOptions);
+
+    [[nodiscard]] static Options GetOptions();
+
+    [[nodiscard]] static Stats GetStats();
+
+    [[nodiscard]] static void *Allocate(size_t size);
+
+    static void Deallocate(void *pBlock, size_t size) noexcept;
+
+    /// Record the bytes of stack used by a coroutine, for the statistics.
+    static void RecordStackUsage(size_t bytes) noexcept;
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_CORO_STACK_POOL_H
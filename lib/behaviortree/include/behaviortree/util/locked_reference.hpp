@@ -1,7 +1,11 @@
 #ifndef BEHAVIORTREE_LOCKED_REFERENCE_HPP
 #define BEHAVIORTREE_LOCKED_REFERENCE_HPP
 
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
 
 #include "behaviortree/util/safe_any.hpp"
 
@@ -12,13 +16,24 @@ namespace behaviortree {
  *
  * As long as the object remains in scope, the mutex is locked, therefore
  * you must destroy this instance as soon as the pointer was used.
+ *
+ * An optional ModifyHook is called, with the mutex locked, before the first
+ * mutable access to the object (non-const operator-> or Assign()) after
+ * each lock.
  */
 template<typename T>
 class LockedPtr {
  public:
+    using ModifyHook = void (*)(void *pContext);
+
     LockedPtr() = default;
 
-    LockedPtr(T *pObj, std::mutex *pObjMutex): m_Ref(pObj), m_Mutex(pObjMutex) {
+    LockedPtr(T *pObj, std::shared_mutex *pObjMutex): m_Ref(pObj), m_Mutex(pObjMutex) {
+        m_Mutex->lock();
+    }
+
+    LockedPtr(T *pObj, std::shared_mutex *pObjMutex, ModifyHook modifyHook, void *pHookContext)
+        : m_Ref(pObj), m_Mutex(pObjMutex), m_modifyHook(modifyHook), m_pHookContext(pHookContext) {
         m_Mutex->lock();
     }
 
@@ -32,13 +47,12 @@ class LockedPtr {
     LockedPtr &operator=(LockedPtr const &) = delete;
 
     LockedPtr(LockedPtr &&rOther) {
-        std::swap(m_Ref, rOther.m_Ref);
-        std::swap(m_Mutex, rOther.m_Mutex);
+        Swap(rOther);
     }
 
     LockedPtr &operator=(LockedPtr &&rOther) {
-        std::swap(m_Ref, rOther.m_Ref);
-        std::swap(m_Mutex, rOther.m_Mutex);
+        Swap(rOther);
+        return *this;
     }
 
     operator bool() const {
@@ -48,6 +62,7 @@ class LockedPtr {
     void Lock() {
         if(m_Mutex) {
             m_Mutex->lock();
+            m_modifyNotified = false;
         }
     }
 
@@ -66,6 +81,7 @@ class LockedPtr {
     }
 
     T *operator->() {
+        NotifyModify();
         return m_Ref;
     }
 
@@ -73,7 +89,9 @@ class LockedPtr {
     void Assign(const OtherT &rOther) {
         if(m_Ref == nullptr) {
             throw std::runtime_error("Empty LockedPtr reference");
-        } else if constexpr(std::is_same_v<T, OtherT>) {
+        }
+        NotifyModify();
+        if constexpr(std::is_same_v<T, OtherT>) {
             *m_Ref = rOther;
         } else if constexpr(std::is_same_v<behaviortree::Any, OtherT>) {
             rOther->CopyInto(*m_Ref);
@@ -84,7 +102,188 @@ class LockedPtr {
 
  private:
     T *m_Ref{nullptr};
-    std::mutex *m_Mutex{nullptr};
+    std::shared_mutex *m_Mutex{nullptr};
+    ModifyHook m_modifyHook{nullptr};
+    void *m_pHookContext{nullptr};
+    bool m_modifyNotified{false};
+
+    void NotifyModify() {
+        // once per lock: nobody else can access the object meanwhile
+        if(m_modifyHook != nullptr and !m_modifyNotified) {
+            m_modifyNotified = true;
+            m_modifyHook(m_pHookContext);
+        }
+    }
+
+    void Swap(LockedPtr &rOther) {
+        std::swap(m_Ref, rOther.m_Ref);
+        std::swap(m_Mutex, rOther.m_Mutex);
+        std::swap(m_modifyHook, rOther.m_modifyHook);
+        std::swap(m_pHookContext, rOther.m_pHookContext);
+        std::swap(m_modifyNotified, rOther.m_modifyNotified);
+    }
+};
+
+/**
+ * @brief ReadLock holds a shared lock of a std::shared_mutex.
+ *
+ * The locks are counted per thread: a thread that already holds a ReadLock
+ * of the mutex doesn't lock it again, therefore the same object can be read
+ * again (for instance through a second LockedView) without deadlocking.
+ * Locking the mutex exclusively from that thread still deadlocks.
+ * A ReadLock may be released by another thread (e.g. a coroutine resumed
+ * by another worker): it is still counted for the thread that created it.
+ */
+class ReadLock {
+ public:
+    ReadLock() = default;
+
+    explicit ReadLock(std::shared_mutex &rMutex): m_pMutex(&rMutex), m_pHeldSet(ThisThreadHeldSet()) {
+        {
+            std::unique_lock lock(m_pHeldSet->mutex);
+            for(auto &rHeld: m_pHeldSet->heldVec) {
+                if(rHeld.first == m_pMutex) {
+                    rHeld.second++;
+                    return;
+                }
+            }
+        }
+        // not under the mutex of the set: a ReadLock of this thread released
+        // by another one must not wait for a writer
+        m_pMutex->lock_shared();
+        std::unique_lock lock(m_pHeldSet->mutex);
+        m_pHeldSet->heldVec.emplace_back(m_pMutex, 1);
+    }
+
+    ~ReadLock() {
+        Unlock();
+    }
+
+    ReadLock(ReadLock &&rOther) noexcept: m_pMutex(std::exchange(rOther.m_pMutex, nullptr)),
+                                          m_pHeldSet(std::move(rOther.m_pHeldSet)) {}
+
+    ReadLock &operator=(ReadLock &&rOther) noexcept {
+        if(this != &rOther) {
+            Unlock();
+            m_pMutex = std::exchange(rOther.m_pMutex, nullptr);
+            m_pHeldSet = std::move(rOther.m_pHeldSet);
+        }
+        return *this;
+    }
+
+    ReadLock(const ReadLock &) = delete;
+    ReadLock &operator=(const ReadLock &) = delete;
+
+    void Unlock() {
+        if(m_pMutex == nullptr) {
+            return;
+        }
+        bool unlock = false;
+        {
+            std::unique_lock lock(m_pHeldSet->mutex);
+            auto &rHeldVec = m_pHeldSet->heldVec;
+            for(auto iter = rHeldVec.begin(); iter != rHeldVec.end(); ++iter) {
+                if(iter->first == m_pMutex) {
+                    if(--iter->second == 0) {
+                        rHeldVec.erase(iter);
+                        unlock = true;
+                    }
+                    break;
+                }
+            }
+        }
+        if(unlock) {
+            m_pMutex->unlock_shared();
+        }
+        m_pMutex = nullptr;
+        m_pHeldSet.reset();
+    }
+
+ private:
+    // mutexes read-locked by a thread, with the number of ReadLock of each
+    struct HeldSet {
+        // only contended when a ReadLock is released by another thread
+        std::mutex mutex;
+        std::vector<std::pair<std::shared_mutex *, size_t>> heldVec;
+    };
+
+    static const std::shared_ptr<HeldSet> &ThisThreadHeldSet() {
+        thread_local const std::shared_ptr<HeldSet> pHeldSet = std::make_shared<HeldSet>();
+        return pHeldSet;
+    }
+
+    std::shared_mutex *m_pMutex{nullptr};
+    // of the thread that created the lock, alive as long as the lock
+    std::shared_ptr<HeldSet> m_pHeldSet;
+};
+
+/**
+ * @brief The LockedView class gives a read-only access to an object, without
+ * copying it.
+ *
+ * The view either points to an object protected by a std::shared_mutex,
+ * that remains read-locked as long as the view is in scope, or to an
+ * immutable snapshot shared with the view, when the object had to be
+ * converted. Other readers are not blocked by the view, writers are.
+ *
+ * Re-entrancy: the thread that holds a view may read the same object again
+ * (see ReadLock), but must not modify it while the view is alive: that
+ * deadlocks. Destroy the view as soon as the value was used, on any thread.
+ */
+template<typename T>
+class LockedView {
+ public:
+    LockedView() = default;
+
+    /// rObj is protected by the mutex of lock; pOwner keeps it alive.
+    LockedView(const T &rObj, ReadLock lock, std::shared_ptr<const void> pOwner): m_pOwner(std::move(pOwner)),
+                                                                                  m_lock(std::move(lock)),
+                                                                                  m_pObj(&rObj) {}
+
+    /// rObj is immutable and outlives the view.
+    explicit LockedView(const T &rObj): m_pObj(&rObj) {}
+
+    explicit LockedView(std::shared_ptr<const T> pSnapshot): m_pOwner(pSnapshot),
+                                                             m_pObj(pSnapshot.get()) {}
+
+    LockedView(LockedView &&rOther) noexcept: m_pOwner(std::move(rOther.m_pOwner)),
+                                              m_lock(std::move(rOther.m_lock)),
+                                              m_pObj(std::exchange(rOther.m_pObj, nullptr)) {}
+
+    LockedView &operator=(LockedView &&rOther) noexcept {
+        if(this != &rOther) {
+            // unlock before releasing the owner of the mutex
+            m_lock = std::move(rOther.m_lock);
+            m_pOwner = std::move(rOther.m_pOwner);
+            m_pObj = std::exchange(rOther.m_pObj, nullptr);
+        }
+        return *this;
+    }
+
+    LockedView(const LockedView &) = delete;
+    LockedView &operator=(const LockedView &) = delete;
+
+    explicit operator bool() const {
+        return m_pObj != nullptr;
+    }
+
+    const T *Get() const {
+        return m_pObj;
+    }
+
+    const T &operator*() const {
+        return *m_pObj;
+    }
+
+    const T *operator->() const {
+        return m_pObj;
+    }
+
+ private:
+    // released after the mutex
+    std::shared_ptr<const void> m_pOwner;
+    ReadLock m_lock;
+    const T *m_pObj{nullptr};
 };
 
 }// namespace behaviortree
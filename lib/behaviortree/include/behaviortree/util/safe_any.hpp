@@ -5,9 +5,14 @@
 #    include <charconv>
 #endif
 
+#include <atomic>
+#include <cstring>
+#include <new>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <typeindex>
+#include <utility>
 
 #include "behaviortree/contrib/any.hpp"
 #include "behaviortree/contrib/expected.hpp"
@@ -21,6 +26,11 @@ static std::type_index UndefinedAnyType = typeid(nullptr);
 
 // Rational: since type erased numbers will always use at least 8 bytes
 // it is faster to cast everything to either double, uint64_t or int64_t.
+//
+// Numbers and strings, the values used by the ports and the scripts, are
+// stored in a tagged union and dispatched with a switch on the tag: copying
+// them never allocates (short strings are stored in place, long strings are
+// immutable and shared by the copies). The other types use linb::any.
 class Any {
     template<typename T>
     using EnableIntegral = typename std::enable_if<
@@ -46,63 +56,95 @@ class Any {
             !std::is_arithmetic<T>::value and !std::is_enum<T>::value and
             !std::is_same<T, std::string>::value>::type *;
 
+    // custom types, that can be moved into linb::any
+    template<typename T>
+    using EnableMovable = typename std::enable_if<
+            !std::is_reference<T>::value and !std::is_arithmetic<T>::value and
+            !std::is_enum<T>::value and !std::is_same<T, Any>::value and
+            !std::is_convertible<T, std::string_view>::value and
+            !std::is_same<T, SafeAny::SimpleString>::value and
+            !std::is_same<T, std::type_index>::value>::type *;
+
     template<typename T>
     nonstd::expected<T, std::string> StringToNumber() const;
 
  public:
     Any(): m_OriginalType(UndefinedAnyType) {}
 
-    ~Any() = default;
+    ~Any() {
+        Reset();
+    }
 
-    Any(const Any &rOther): m_Any(rOther.m_Any),
-                            m_OriginalType(rOther.m_OriginalType) {}
+    Any(const Any &rOther): m_OriginalType(rOther.m_OriginalType) {
+        CopyValue(rOther);
+    }
 
-    Any(Any &&rOther): m_Any(std::move(rOther.m_Any)),
-                       m_OriginalType(rOther.m_OriginalType) {}
+    Any(Any &&rOther) noexcept: m_OriginalType(rOther.m_OriginalType) {
+        MoveValue(rOther);
+    }
 
-    explicit Any(const double &rValue): m_Any(rValue),
-                                        m_OriginalType(typeid(double)) {}
+    explicit Any(const double &rValue): m_kind(Kind::Double),
+                                        m_OriginalType(typeid(double)) {
+        m_storage.doubleValue = rValue;
+    }
 
-    explicit Any(const uint64_t &rValue): m_Any(rValue),
-                                          m_OriginalType(typeid(uint64_t)) {}
+    explicit Any(const uint64_t &rValue): m_kind(Kind::UInt64),
+                                          m_OriginalType(typeid(uint64_t)) {
+        m_storage.uint64Value = rValue;
+    }
 
-    explicit Any(const float &rValue): m_Any(double(rValue)),
-                                       m_OriginalType(typeid(float)) {}
+    explicit Any(const float &rValue): m_kind(Kind::Double),
+                                       m_OriginalType(typeid(float)) {
+        m_storage.doubleValue = double(rValue);
+    }
 
-    explicit Any(const std::string &rStr): m_Any(SafeAny::SimpleString(rStr)),
-                                           m_OriginalType(typeid(std::string)) {}
+    explicit Any(const std::string &rStr): Any(std::string_view(rStr)) {}
 
-    explicit Any(const char *pStr): m_Any(SafeAny::SimpleString(pStr)),
-                                    m_OriginalType(typeid(std::string)) {}
+    explicit Any(const char *pStr): Any(std::string_view(pStr)) {}
 
-    explicit Any(const SafeAny::SimpleString &rStr): m_Any(rStr),
-                                                     m_OriginalType(typeid(std::string)) {}
+    explicit Any(const SafeAny::SimpleString &rStr): Any(rStr.toStdStringView()) {}
 
-    explicit Any(const std::string_view &rStr): m_Any(SafeAny::SimpleString(rStr)),
-                                                m_OriginalType(typeid(std::string)) {}
+    explicit Any(const std::string_view &rStr): m_OriginalType(typeid(std::string)) {
+        SetString(rStr);
+    }
 
     // all the other integrals are casted to int64_t
     template<typename T>
-    explicit Any(const T &rValue, EnableIntegral<T> = 0): m_Any(int64_t(rValue)),
-                                                          m_OriginalType(typeid(T)) {}
+    explicit Any(const T &rValue, EnableIntegral<T> = 0): m_kind(Kind::Int64),
+                                                          m_OriginalType(typeid(T)) {
+        m_storage.int64Value = int64_t(rValue);
+    }
 
     explicit Any(const std::type_index &rType): m_OriginalType(rType) {}
 
     // default for other custom types
     template<typename T>
-    explicit Any(const T &rValue, EnableNonIntegral<T> = 0): m_Any(rValue),
-                                                             m_OriginalType(typeid(T)) {
+    explicit Any(const T &rValue, EnableNonIntegral<T> = 0): m_OriginalType(typeid(T)) {
         static_assert(!std::is_reference<T>::value, "Any can not contain references");
+        new(&m_storage.other) linb::any(rValue);
+        m_kind = Kind::Other;
+    }
+
+    template<typename T>
+    explicit Any(T &&rValue, EnableMovable<T> = 0): m_OriginalType(typeid(T)) {
+        new(&m_storage.other) linb::any(std::move(rValue));
+        m_kind = Kind::Other;
     }
 
     Any &operator=(const Any &rOther);
 
-    [[nodiscard]] bool IsNumber() const;
+    Any &operator=(Any &&rOther) noexcept;
 
-    [[nodiscard]] bool IsIntegral() const;
+    [[nodiscard]] bool IsNumber() const {
+        return m_kind == Kind::Int64 or m_kind == Kind::UInt64 or m_kind == Kind::Double;
+    }
+
+    [[nodiscard]] bool IsIntegral() const {
+        return m_kind == Kind::Int64 or m_kind == Kind::UInt64;
+    }
 
     [[nodiscard]] bool IsString() const {
-        return m_Any.Type() == typeid(SafeAny::SimpleString);
+        return m_kind == Kind::ShortString or m_kind == Kind::LongString;
     }
 
     // check is the original type is equal to T
@@ -111,9 +153,25 @@ class Any {
         return m_OriginalType == typeid(T);
     }
 
+    /// View of the stored string, without copy. Empty if the value is not a
+    /// string; valid as long as the value is not modified.
+    [[nodiscard]] std::string_view GetStringView() const noexcept {
+        switch(m_kind) {
+            case Kind::ShortString:
+                return {m_storage.shortString.data, m_storage.shortString.size};
+            case Kind::LongString:
+                return m_storage.pLongString->value;
+            default:
+                return {};
+        }
+    }
+
     // copy the value (casting into dst). We preserve the destination type.
     void CopyInto(Any &rDst);
 
+    // same as CopyInto, but the value is moved if it doesn't need a cast.
+    void MoveInto(Any &rDst);
+
     // this is different from any_cast, because if allows safe
     // conversions between arithmetic values and from/to string.
     template<typename T>
@@ -134,10 +192,22 @@ class Any {
     // wrong type or if Any was empty.
     template<typename T>
     [[nodiscard]] T *CastPtr() {
+        static_assert(!std::is_same_v<T, std::string> and !std::is_same_v<T, SafeAny::SimpleString>, "Strings are not stored as objects. Use Cast<std::string>() or GetStringView() instead");
         static_assert(!std::is_same_v<T, float>, "The value has been casted internally to [double]. Use that instead");
         static_assert(!SafeAny::details::is_integer<T>() or std::is_same_v<T, uint64_t>, "The value has been casted internally to [int64_t]. Use that instead");
 
-        return m_Any.Empty() ? nullptr : linb::any_cast<T>(&m_Any);
+        if constexpr(std::is_same_v<T, uint64_t>) {
+            return m_kind == Kind::UInt64 ? &m_storage.uint64Value : nullptr;
+        } else if constexpr(std::is_same_v<T, double>) {
+            return m_kind == Kind::Double ? &m_storage.doubleValue : nullptr;
+        } else {
+            return m_kind == Kind::Other ? linb::any_cast<T>(&m_storage.other) : nullptr;
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]] const T *CastPtr() const {
+        return const_cast<Any *>(this)->CastPtr<T>();
     }
 
     // This is the original type
@@ -147,19 +217,148 @@ class Any {
 
     // This is the type we casted to, internally
     [[nodiscard]] const std::type_info &CastedType() const noexcept {
-        return m_Any.Type();
+        switch(m_kind) {
+            case Kind::Empty:
+                return typeid(void);
+            case Kind::Int64:
+                return typeid(int64_t);
+            case Kind::UInt64:
+                return typeid(uint64_t);
+            case Kind::Double:
+                return typeid(double);
+            case Kind::ShortString:
+            case Kind::LongString:
+                return typeid(SafeAny::SimpleString);
+            case Kind::Other:
+                return m_storage.other.Type();
+        }
+        return typeid(void);
     }
 
     [[nodiscard]] bool Empty() const noexcept {
-        return m_Any.Empty();
+        return m_kind == Kind::Empty;
     }
 
  private:
-    linb::any m_Any;
+    enum class Kind : uint8_t {
+        Empty,
+        Int64,
+        UInt64,
+        Double,
+        ShortString,
+        LongString,
+        Other
+    };
+
+    static constexpr size_t ShortStringCapacity = sizeof(linb::any) - 1;
+
+    struct ShortString {
+        char data[ShortStringCapacity];
+        uint8_t size;
+    };
+
+    // immutable, shared by the copies of the Any
+    struct LongString {
+        explicit LongString(std::string_view str): value(str) {}
+
+        std::atomic<size_t> refCount{1};
+        const std::string value;
+    };
+
+    union Storage {
+        Storage() noexcept {}
+
+        ~Storage() {}
+
+        int64_t int64Value;
+        uint64_t uint64Value;
+        double doubleValue;
+        ShortString shortString;
+        LongString *pLongString;
+        linb::any other;
+    };
+
+    Storage m_storage;
+    Kind m_kind{Kind::Empty};
     std::type_index m_OriginalType;
 
     //----------------------------
 
+    void SetString(std::string_view str) {
+        if(str.size() <= ShortStringCapacity) {
+            if(!str.empty()) {
+                std::memcpy(m_storage.shortString.data, str.data(), str.size());
+            }
+            m_storage.shortString.size = uint8_t(str.size());
+            m_kind = Kind::ShortString;
+        } else {
+            m_storage.pLongString = new LongString(str);
+            m_kind = Kind::LongString;
+        }
+    }
+
+    // destroy the value, the original type is preserved
+    void Reset() noexcept {
+        switch(m_kind) {
+            case Kind::LongString: {
+                if(m_storage.pLongString->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete m_storage.pLongString;
+                }
+            } break;
+            case Kind::Other: {
+                m_storage.other.~any();
+            } break;
+            default:
+                break;
+        }
+        m_kind = Kind::Empty;
+    }
+
+    // require Empty()
+    void CopyValue(const Any &rOther) {
+        switch(rOther.m_kind) {
+            case Kind::LongString: {
+                rOther.m_storage.pLongString->refCount.fetch_add(1, std::memory_order_relaxed);
+                m_storage.pLongString = rOther.m_storage.pLongString;
+            } break;
+            case Kind::Other: {
+                new(&m_storage.other) linb::any(rOther.m_storage.other);
+            } break;
+            case Kind::ShortString: {
+                m_storage.shortString = rOther.m_storage.shortString;
+            } break;
+            default: {
+                // numbers
+                m_storage.uint64Value = rOther.m_storage.uint64Value;
+            } break;
+        }
+        m_kind = rOther.m_kind;
+    }
+
+    // require Empty(). rOther becomes empty
+    void MoveValue(Any &rOther) noexcept {
+        const Kind kind = rOther.m_kind;
+        switch(kind) {
+            case Kind::LongString: {
+                m_storage.pLongString = rOther.m_storage.pLongString;
+                rOther.m_kind = Kind::Empty;
+            } break;
+            case Kind::Other: {
+                new(&m_storage.other) linb::any(std::move(rOther.m_storage.other));
+                rOther.Reset();
+            } break;
+            case Kind::ShortString: {
+                m_storage.shortString = rOther.m_storage.shortString;
+                rOther.m_kind = Kind::Empty;
+            } break;
+            default: {
+                m_storage.uint64Value = rOther.m_storage.uint64Value;
+                rOther.m_kind = Kind::Empty;
+            } break;
+        }
+        m_kind = kind;
+    }
+
     template<typename DST>
     nonstd::expected<DST, std::string> Convert(EnableString<DST> = 0) const;
 
@@ -233,18 +432,21 @@ inline bool IsCastingSafe(const std::type_index &rType, const T &rVal) {
 }
 
 inline Any &Any::operator=(const Any &rOther) {
-    this->m_Any = rOther.m_Any;
-    this->m_OriginalType = rOther.m_OriginalType;
+    if(this != &rOther) {
+        Reset();
+        CopyValue(rOther);
+        this->m_OriginalType = rOther.m_OriginalType;
+    }
     return *this;
 }
 
-inline bool Any::IsNumber() const {
-    return m_Any.Type() == typeid(int64_t) or
-           m_Any.Type() == typeid(uint64_t) or m_Any.Type() == typeid(double);
-}
-
-inline bool Any::IsIntegral() const {
-    return m_Any.Type() == typeid(int64_t) or m_Any.Type() == typeid(uint64_t);
+inline Any &Any::operator=(Any &&rOther) noexcept {
+    if(this != &rOther) {
+        Reset();
+        MoveValue(rOther);
+        this->m_OriginalType = rOther.m_OriginalType;
+    }
+    return *this;
 }
 
 inline void Any::CopyInto(Any &rDst) {
@@ -253,47 +455,68 @@ inline void Any::CopyInto(Any &rDst) {
         return;
     }
 
-    const auto &refDstType = rDst.CastedType();
-
-    if((CastedType() == refDstType) or (IsString() and rDst.IsString())) {
-        rDst.m_Any = m_Any;
-    } else if(IsNumber() and rDst.IsNumber()) {
-        if(refDstType == typeid(int64_t)) {
-            rDst.m_Any = Cast<int64_t>();
-        } else if(refDstType == typeid(uint64_t)) {
-            rDst.m_Any = Cast<uint64_t>();
-        } else if(refDstType == typeid(double)) {
-            rDst.m_Any = Cast<double>();
-        } else {
-            throw std::runtime_error("Any::CopyInto fails");
+    if(m_kind == rDst.m_kind or (IsString() and rDst.IsString())) {
+        if(m_kind != Kind::Other or CastedType() == rDst.CastedType()) {
+            rDst.Reset();
+            rDst.CopyValue(*this);
+            return;
         }
-    } else {
         throw std::runtime_error("Any::CopyInto fails");
     }
+    if(IsNumber() and rDst.IsNumber()) {
+        switch(rDst.m_kind) {
+            case Kind::Int64: {
+                rDst.m_storage.int64Value = Cast<int64_t>();
+            } break;
+            case Kind::UInt64: {
+                rDst.m_storage.uint64Value = Cast<uint64_t>();
+            } break;
+            default: {
+                rDst.m_storage.doubleValue = Cast<double>();
+            } break;
+        }
+        return;
+    }
+    throw std::runtime_error("Any::CopyInto fails");
 }
 
-template<typename DST>
-inline nonstd::expected<DST, std::string> Any::Convert(EnableString<DST>) const {
-    const auto &rType = m_Any.Type();
+inline void Any::MoveInto(Any &rDst) {
+    if(rDst.Empty()) {
+        rDst = std::move(*this);
+        return;
+    }
 
-    if(rType == typeid(SafeAny::SimpleString)) {
-        return linb::any_cast<SafeAny::SimpleString>(m_Any).toStdString();
-    } else if(rType == typeid(int64_t)) {
-        return std::to_string(linb::any_cast<int64_t>(m_Any));
-    } else if(rType == typeid(uint64_t)) {
-        return std::to_string(linb::any_cast<uint64_t>(m_Any));
-    } else if(rType == typeid(double)) {
-        return std::to_string(linb::any_cast<double>(m_Any));
+    if((m_kind == rDst.m_kind and (m_kind != Kind::Other or CastedType() == rDst.CastedType())) or
+       (IsString() and rDst.IsString())) {
+        rDst.Reset();
+        rDst.MoveValue(*this);
+    } else {
+        CopyInto(rDst);
     }
+}
 
-    return nonstd::make_unexpected(errorMsg<DST>());
+template<typename DST>
+inline nonstd::expected<DST, std::string> Any::Convert(EnableString<DST>) const {
+    switch(m_kind) {
+        case Kind::ShortString:
+        case Kind::LongString:
+            return std::string(GetStringView());
+        case Kind::Int64:
+            return std::to_string(m_storage.int64Value);
+        case Kind::UInt64:
+            return std::to_string(m_storage.uint64Value);
+        case Kind::Double:
+            return std::to_string(m_storage.doubleValue);
+        default:
+            return nonstd::make_unexpected(errorMsg<DST>());
+    }
 }
 
 template<typename T>
 inline nonstd::expected<T, std::string> Any::StringToNumber() const {
     static_assert(std::is_arithmetic_v<T> and !std::is_same_v<T, bool>, "Expecting a numeric Type");
 
-    const auto str = linb::any_cast<SafeAny::SimpleString>(m_Any);
+    const std::string_view str = GetStringView();
 #if __cpp_lib_to_chars >= 201611L
     T out;
     auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), out);
@@ -306,15 +529,15 @@ inline nonstd::expected<T, std::string> Any::StringToNumber() const {
 #else
     try {
         if constexpr(std::is_same_v<T, uint16_t>) {
-            return std::stoul(str.toStdString());
+            return std::stoul(std::string(str));
         }
         if constexpr(std::is_integral_v<T>) {
-            const int64_t val = std::stol(str.toStdString());
+            const int64_t val = std::stol(std::string(str));
             Any temp_any(val);
             return temp_any.convert<T>();
         }
         if constexpr(std::is_floating_point_v<T>) {
-            return std::stod(str.toStdString());
+            return std::stod(std::string(str));
         }
     } catch(...) {
         return nonstd::make_unexpected("Any failed string to number conversion"
@@ -326,19 +549,14 @@ inline nonstd::expected<T, std::string> Any::StringToNumber() const {
 
 template<typename DST>
 inline nonstd::expected<DST, std::string> Any::Convert(EnableEnum<DST>) const {
-    using SafeAny::details::convertNumber;
-
-    const auto &refType = m_Any.Type();
-
-    if(refType == typeid(int64_t)) {
-        auto out = linb::any_cast<int64_t>(m_Any);
-        return static_cast<DST>(out);
-    } else if(refType == typeid(uint64_t)) {
-        auto out = linb::any_cast<uint64_t>(m_Any);
-        return static_cast<DST>(out);
+    switch(m_kind) {
+        case Kind::Int64:
+            return static_cast<DST>(m_storage.int64Value);
+        case Kind::UInt64:
+            return static_cast<DST>(m_storage.uint64Value);
+        default:
+            return nonstd::make_unexpected(errorMsg<DST>());
     }
-
-    return nonstd::make_unexpected(errorMsg<DST>());
 }
 
 template<typename DST>
@@ -347,16 +565,18 @@ inline nonstd::expected<DST, std::string> Any::Convert(EnableArithmetic<DST>)
     using SafeAny::details::convertNumber;
     DST out;
 
-    const auto &refType = m_Any.Type();
-
-    if(refType == typeid(int64_t)) {
-        convertNumber<int64_t, DST>(linb::any_cast<int64_t>(m_Any), out);
-    } else if(refType == typeid(uint64_t)) {
-        convertNumber<uint64_t, DST>(linb::any_cast<uint64_t>(m_Any), out);
-    } else if(refType == typeid(double)) {
-        convertNumber<double, DST>(linb::any_cast<double>(m_Any), out);
-    } else {
-        return nonstd::make_unexpected(errorMsg<DST>());
+    switch(m_kind) {
+        case Kind::Int64: {
+            convertNumber<int64_t, DST>(m_storage.int64Value, out);
+        } break;
+        case Kind::UInt64: {
+            convertNumber<uint64_t, DST>(m_storage.uint64Value, out);
+        } break;
+        case Kind::Double: {
+            convertNumber<double, DST>(m_storage.doubleValue, out);
+        } break;
+        default:
+            return nonstd::make_unexpected(errorMsg<DST>());
     }
     return out;
 }
@@ -365,12 +585,32 @@ template<typename T>
 inline nonstd::expected<T, std::string> Any::TryCast() const {
     static_assert(!std::is_reference<T>::value, "Any::Cast uses value semantic, can not Cast to reference");
 
-    if(m_Any.Empty()) {
-        throw std::runtime_error("Any::Cast failed because it is Empty");
+    // the types stored without conversion
+    if constexpr(std::is_same_v<T, int64_t>) {
+        if(m_kind == Kind::Int64) {
+            return m_storage.int64Value;
+        }
+    } else if constexpr(std::is_same_v<T, uint64_t>) {
+        if(m_kind == Kind::UInt64) {
+            return m_storage.uint64Value;
+        }
+    } else if constexpr(std::is_same_v<T, double>) {
+        if(m_kind == Kind::Double) {
+            return m_storage.doubleValue;
+        }
+    } else if constexpr(std::is_same_v<T, SafeAny::SimpleString>) {
+        if(IsString()) {
+            return SafeAny::SimpleString(GetStringView());
+        }
+    } else {
+        // also the arithmetic types that are not casted, as long double
+        if(m_kind == Kind::Other and m_storage.other.Type() == typeid(T)) {
+            return *linb::any_cast<T>(&m_storage.other);
+        }
     }
 
-    if(CastedType() == typeid(T)) {
-        return linb::any_cast<T>(m_Any);
+    if(m_kind == Kind::Empty) {
+        throw std::runtime_error("Any::Cast failed because it is Empty");
     }
 
     // special case when the output is an enum.
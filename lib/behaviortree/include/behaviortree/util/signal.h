@@ -27,6 +27,11 @@ class Signal {
         }
     }
 
+    /// False if nobody ever subscribed: lets the caller skip building the arguments.
+    [[nodiscard]] bool HasSubscribers() const {
+        return !m_Subscribers.empty();
+    }
+
     Subscriber Subscribe(CallableFunction func) {
         Subscriber sub = std::make_shared<CallableFunction>(std::move(func));
         m_Subscribers.emplace_back(sub);
@@ -0,0 +1,137 @@
+#ifndef BEHAVIORTREE_TIMER_SERVICE_H
+#define BEHAVIORTREE_TIMER_SERVICE_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "behaviortree/common.h"
+
+namespace behaviortree {
+/**
+ * @brief TimerService is the process-wide timer thread used by all the
+ * TimerQueue instances (SleepNode, DelayNode, TimeoutNode, TestNode...).
+ *
+ * Timers are stored in a hierarchical timing wheel with a resolution of
+ * one millisecond: 4 levels of 64 slots each, with an occupancy bitmap per
+ * level. Insertion and cancellation are O(1); all the timers expiring at
+ * the same tick are collected in a batch and their handlers are executed,
+ * without holding the lock, by the single service thread.
+ *
+ * A timer never expires earlier than requested; it may expire up to one
+ * tick later. The timers expiring at the same tick are executed in the
+ * order they were added. The time comes from Clock::PreciseNow(): in Clock::Mode::Virtual,
+ * the timers expire when the virtual time is advanced.
+ */
+class BEHAVIORTREE_API TimerService: public std::enable_shared_from_this<TimerService> {
+ public:
+    using Handler = std::function<void(bool aborted)>;
+
+    /// Timers of a single owner (see TimerQueue), which can be cancelled
+    /// all together and waited for.
+    struct Client {
+        std::unordered_set<uint64_t> timerIdSet;
+        // handlers not executed yet, including the aborted ones
+        size_t pendingNum{0};
+        std::condition_variable idleCv;
+    };
+
+    /// The shared instance. It is kept alive by its users.
+    [[nodiscard]] static std::shared_ptr<TimerService> Get();
+
+    TimerService();
+    /// Stop the service thread. When the last reference is released by a
+    /// handler, the destructor runs in the service thread, which is detached.
+    ~TimerService();
+
+    TimerService(const TimerService &rOther) = delete;
+    TimerService &operator=(const TimerService &rOther) = delete;
+
+    /// Execute handler(false) once duration has elapsed.
+    /// @return the ID of the timer.
+    uint64_t Add(const std::shared_ptr<Client> &pClient, std::chrono::milliseconds duration, Handler handler);
+
+    /// Cancel a timer of the client: its handler is executed as soon as
+    /// possible with aborted == true. @return 1 if cancelled, 0 if too late.
+    size_t Cancel(Client &rClient, uint64_t timerId);
+
+    /// Cancel all the timers of the client. @return the number of timers cancelled.
+    size_t CancelAll(Client &rClient);
+
+    /// Block until all the handlers of the client have been executed.
+    /// Does nothing when called by a handler.
+    void Wait(Client &rClient);
+
+    [[nodiscard]] size_t GetTimersNum() const;
+
+    /// Called by Clock when the time source changes or the virtual time moves.
+    static void NotifyClockChanged();
+
+ private:
+    static constexpr uint32_t LevelBits = 6;
+    static constexpr uint32_t SlotsNum = 1u << LevelBits;
+    static constexpr uint32_t LevelsNum = 4;
+
+    struct Timer {
+        uint64_t id{0};
+        uint64_t expiryTick{0};
+        Handler handler;
+        std::shared_ptr<Client> pClient;
+        Timer *pPrev{nullptr};
+        Timer *pNext{nullptr};
+        uint32_t level{0};
+        uint32_t slot{0};
+    };
+
+    struct Level {
+        std::array<Timer *, SlotsNum> slotArr{};
+        uint64_t occupancyBits{0};
+    };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCv;
+    bool m_stopping{false};
+
+    std::array<Level, LevelsNum> m_levelArr;
+    std::unordered_map<uint64_t, std::unique_ptr<Timer>> m_timerMap;
+    // cancelled timers, whose handlers must be executed with aborted == true
+    std::vector<std::unique_ptr<Timer>> m_abortedVec;
+
+    // Clock::PreciseNow() at the creation of the service
+    const std::chrono::nanoseconds m_startTime;
+    // last tick processed by the wheel
+    uint64_t m_currentTick{0};
+    uint64_t m_nextWakeTick{UINT64_MAX};
+    uint64_t m_idCounter{0};
+
+    std::thread m_thread;
+
+    void Run();
+
+    [[nodiscard]] uint64_t NowTick() const;
+
+    [[nodiscard]] std::chrono::steady_clock::time_point TickTime(uint64_t tick) const;
+
+    // all the functions below require m_mutex
+    void Insert(Timer *pTimer);
+
+    void Unlink(Timer *pTimer);
+
+    void Cascade(uint32_t level, uint32_t slot);
+
+    void AdvanceTo(uint64_t tick, std::vector<std::unique_ptr<Timer>> &rExpiredVec);
+
+    [[nodiscard]] uint64_t NextWakeTick() const;
+};
+
+}// namespace behaviortree
+
+#endif// BEHAVIORTREE_TIMER_SERVICE_H
@@ -4,6 +4,8 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
 
 namespace behaviortree {
@@ -21,15 +23,43 @@ class WakeUpSignal {
         return res;
     }
 
+    /// Block until the signal is received.
+    void Wait() {
+        std::unique_lock<std::mutex> lk(m_Mutex);
+        m_CV.wait(lk, [this] {
+            return m_Ready.load();
+        });
+        m_Ready = false;
+    }
+
+    /// Signals emitted before the next wait are coalesced into one.
     void EmitSignal() {
-        m_Ready = true;
+        std::shared_ptr<const std::function<void()>> pListener;
+        {
+            // set the flag under the mutex, or a waiter could miss it
+            // between the predicate check and the wait
+            std::lock_guard<std::mutex> lk(m_Mutex);
+            m_Ready = true;
+            pListener = m_pListener;
+        }
         m_CV.notify_all();
+        if(pListener) {
+            (*pListener)();
+        }
+    }
+
+    /// Invoke listener (outside the lock) every time the signal is emitted,
+    /// for schedulers that don't block on WaitFor(). Pass nullptr to remove it.
+    void SetListener(std::function<void()> listener) {
+        std::lock_guard<std::mutex> lk(m_Mutex);
+        m_pListener = listener ? std::make_shared<const std::function<void()>>(std::move(listener)) : nullptr;
     }
 
  private:
     std::mutex m_Mutex;
     std::condition_variable m_CV;
     std::atomic_bool m_Ready{false};
+    std::shared_ptr<const std::function<void()>> m_pListener;
 };
 
 }// namespace behaviortree
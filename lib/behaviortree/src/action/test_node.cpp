@@ -9,9 +9,14 @@ TestNode::TestNode(const std::string &rName, const NodeConfig &rConfig, TestNode
         throw util::RuntimeError("TestNode can not return IDLE");
     }
 
-    auto prepareScript = [](const std::string &rScript, auto &rExecutor) {
+    PrepareScripts();
+}
+
+void TestNode::PrepareScripts() {
+    const Ast::Environment env = {GetConfig().pBlackboard, GetConfig().pEnums};
+    auto prepareScript = [&env](const std::string &rScript, auto &rExecutor) {
         if(!rScript.empty()) {
-            auto result = ParseScript(rScript);
+            auto result = ParseScript(rScript, env);
             if(!result) {
                 throw util::RuntimeError(result.error());
             }
@@ -21,6 +26,7 @@ TestNode::TestNode(const std::string &rName, const NodeConfig &rConfig, TestNode
     prepareScript(m_testConfig.successScript, m_successExecutor);
     prepareScript(m_testConfig.failureScript, m_failureExecutor);
     prepareScript(m_testConfig.postScript, m_postExecutor);
+    m_pScriptEnums = GetConfig().pEnums;
 }
 
 NodeStatus behaviortree::TestNode::OnStart() {
@@ -56,6 +62,10 @@ void TestNode::OnHalted() {
 }
 
 NodeStatus behaviortree::TestNode::OnCompleted() {
+    // the enums are assigned after the construction of the node
+    if(m_pScriptEnums != GetConfig().pEnums) {
+        PrepareScripts();
+    }
     Ast::Environment env = {GetConfig().pBlackboard, GetConfig().pEnums};
 
     auto status = m_testConfig.completeFunc();
@@ -1,6 +1,7 @@
 #define MINICORO_IMPL
 #include "behaviortree/action_node.h"
 
+#include "behaviortree/util/coro_stack_pool.h"
 #include "minicoro/minicoro.h"
 
 namespace behaviortree {
@@ -56,20 +57,34 @@ CoroActionNode::~CoroActionNode() {
 
 void CoroActionNode::SetStatusRunningAndYield() {
     SetNodeStatus(NodeStatus::Running);
-    mco_yield(m_pPimpl->pCoro);
+
+    // the stack grows downward from stack_base + stack_size
+    mco_coro *pCoro = m_pPimpl->pCoro;
+    char marker;
+    const auto stackTop = reinterpret_cast<uintptr_t>(pCoro->stack_base) + pCoro->stack_size;
+    const auto stackPointer = reinterpret_cast<uintptr_t>(&marker);
+    if(stackPointer < stackTop) {
+        CoroStackPool::RecordStackUsage(stackTop - stackPointer);
+    }
+
+    mco_yield(pCoro);
 }
 
 NodeStatus CoroActionNode::ExecuteTick() {
     // create a new coroutine, if necessary
     if(m_pPimpl->pCoro == nullptr) {
         // First initialize a `desc` object through `mco_desc_init`.
-        m_pPimpl->desc = mco_desc_init(CoroEntry, 0);
+        m_pPimpl->desc = mco_desc_init(CoroEntry, CoroStackPool::GetOptions().stackSize);
         m_pPimpl->desc.user_data = this;
 
-        mco_result res = mco_create(&m_pPimpl->pCoro, &m_pPimpl->desc);
+        // the memory of the coroutine (stack included) comes from the pool
+        auto pCoro = static_cast<mco_coro *>(CoroStackPool::Allocate(m_pPimpl->desc.coro_size));
+        mco_result res = mco_init(pCoro, &m_pPimpl->desc);
         if(res != MCO_SUCCESS) {
+            CoroStackPool::Deallocate(pCoro, m_pPimpl->desc.coro_size);
             throw util::RuntimeError("Can't create coroutine");
         }
+        m_pPimpl->pCoro = pCoro;
     }
 
     //------------------------
@@ -96,10 +111,11 @@ void CoroActionNode::Halt() {
 
 void CoroActionNode::DestroyCoroutine() {
     if(m_pPimpl->pCoro) {
-        mco_result res = mco_destroy(m_pPimpl->pCoro);
+        mco_result res = mco_uninit(m_pPimpl->pCoro);
         if(res != MCO_SUCCESS) {
             throw util::RuntimeError("Can't destroy coroutine");
         }
+        CoroStackPool::Deallocate(m_pPimpl->pCoro, m_pPimpl->desc.coro_size);
         m_pPimpl->pCoro = nullptr;
     }
 }
@@ -141,51 +157,125 @@ void StatefulActionNode::Halt() {
     ResetNodeStatus();// might be redundant
 }
 
-NodeStatus behaviortree::ThreadedAction::ExecuteTick() {
-    using LockType = std::unique_lock<std::mutex>;
-    //send signal to other thread.
-    // The other thread is in charge for changing the status
-    if(GetNodeStatus() == NodeStatus::Idle) {
-        SetNodeStatus(NodeStatus::Running);
-        m_haltRequested = false;
-        m_threadHandle = std::async(std::launch::async, [this]() {
-            try {
-                auto nodeStatus = Tick();
-                if(!IsHaltRequested()) {
-                    SetNodeStatus(nodeStatus);
-                }
-            } catch(std::exception &) {
-                std::cerr << "\nUncaught exception from tick(): ["
-                          << GetRegistrAtionName() << "/" << GetNodeName()
-                          << "]\n"
-                          << std::endl;
-                // Set the exception pointer and the status atomically.
-                LockType lock(m_mutex);
+ThreadedAction::~ThreadedAction() {
+    std::unique_lock lock(m_mutex);
+    m_startPending = false;
+    if(m_jobActive) {
+        // release the job if it is still waiting for a limit
+        m_pPool->Cancel(m_token);
+    }
+    m_jobCv.wait(lock, [this]() {
+        return !m_jobActive;
+    });
+}
+
+void ThreadedAction::SetActionPool(ActionPool::Ptr pPool, ActionPool::Limit::Ptr pLimit) {
+    std::unique_lock lock(m_mutex);
+    m_pPool = std::move(pPool);
+    m_pLimit = std::move(pLimit);
+}
+
+void ThreadedAction::StartJob() {
+    if(!m_pPool) {
+        m_pPool = ActionPool::GetDefault();
+    }
+    m_jobActive = true;
+    m_token = CancellationToken();
+
+    auto token = m_token;
+    m_pPool->Submit(
+            [this, token]() {
+                RunJob(token);
+            },
+            token, m_pLimit
+    );
+}
+
+void ThreadedAction::RunJob(const CancellationToken &rToken) {
+    if(!rToken.IsCancelled()) {
+        try {
+            auto nodeStatus = Tick();
+            // the activation was halted meanwhile: discard the result
+            std::unique_lock statusLock(m_statusMutex);
+            if(!rToken.IsCancelled()) {
+                SetNodeStatus(nodeStatus);
+            }
+        } catch(std::exception &) {
+            std::cerr << "\nUncaught exception from tick(): ["
+                      << GetRegistrAtionName() << "/" << GetNodeName()
+                      << "]\n"
+                      << std::endl;
+            std::unique_lock statusLock(m_statusMutex);
+            // set the exception pointer before the status, ExecuteTick() checks it first
+            std::unique_lock lock(m_mutex);
+            if(!rToken.IsCancelled()) {
                 m_exptr = std::current_exception();
-                SetNodeStatus(behaviortree::NodeStatus::Idle);
+                lock.unlock();
+                ResetNodeStatus();
             }
-            EmitWakeUpSignal();
-        });
+        }
     }
 
-    LockType lock(m_mutex);
-    if(m_exptr) {
-        // The official interface of std::exception_ptr does not define any move
-        // semantics. Thus, we copy and reset exptr_ manually.
-        const auto exptrCopy = m_exptr;
-        m_exptr = nullptr;
-        std::rethrow_exception(exptrCopy);
+    // the node may be destroyed as soon as m_jobActive is cleared
+    auto pWakeUp = GetWakeUpInstance();
+    {
+        // last access to the node, unless an activation was waiting for this job
+        std::unique_lock lock(m_mutex);
+        m_jobActive = false;
+        if(m_startPending) {
+            m_startPending = false;
+            StartJob();
+        } else {
+            m_jobCv.notify_all();
+        }
+    }
+    // the tree ticked on wake-up finds the job completed
+    if(pWakeUp) {
+        pWakeUp->EmitSignal();
+    }
+}
+
+NodeStatus ThreadedAction::ExecuteTick() {
+    {
+        std::unique_lock lock(m_mutex);
+        if(m_exptr) {
+            // The official interface of std::exception_ptr does not define any move
+            // semantics. Thus, we copy and reset exptr_ manually.
+            const auto exptrCopy = m_exptr;
+            m_exptr = nullptr;
+            std::rethrow_exception(exptrCopy);
+        }
+        if(GetNodeStatus() != NodeStatus::Idle) {
+            return GetNodeStatus();
+        }
+    }
+
+    // The other thread is in charge for changing the status.
+    // The status callbacks are invoked without holding m_mutex.
+    SetNodeStatus(NodeStatus::Running);
+    {
+        std::unique_lock lock(m_mutex);
+        if(m_jobActive) {
+            // the tick() of a halted activation is still returning: don't wait for it
+            m_startPending = true;
+        } else {
+            StartJob();
+        }
     }
     return GetNodeStatus();
 }
 
 void ThreadedAction::Halt() {
-    m_haltRequested.store(true);
-
-    if(m_threadHandle.valid()) {
-        m_threadHandle.wait();
+    // a job completing at the same time either sets its status before the
+    // reset below or finds its token cancelled
+    std::unique_lock statusLock(m_statusMutex);
+    {
+        std::unique_lock lock(m_mutex);
+        m_startPending = false;
+        if(m_jobActive) {
+            m_pPool->Cancel(m_token);
+        }
     }
-    m_threadHandle = {};
     ResetNodeStatus();// might be redundant
 }
 }// namespace behaviortree
@@ -0,0 +1,152 @@
+import shadow.thread.pool;
+
+#include "behaviortree/action_pool.h"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace behaviortree {
+struct ActionPool::PImpl {
+    struct Entry {
+        Job job;
+        CancellationToken token;
+        Limit::Ptr pLimit;
+        // true if it takes a slot of the limits
+        bool counted{false};
+    };
+
+    explicit PImpl(const Options &rOptions): maxInFlight(rOptions.maxInFlight), pool(rOptions.threadsNum) {}
+
+    // require mutex
+    bool CanStart(const Entry &rEntry) const {
+        if(maxInFlight != 0 and inFlightNum >= maxInFlight) {
+            return false;
+        }
+        const auto &pLimit = rEntry.pLimit;
+        return !pLimit or pLimit->m_maxInFlight == 0 or pLimit->m_inFlightNum < pLimit->m_maxInFlight;
+    }
+
+    // require mutex
+    void Acquire(Entry &rEntry) {
+        rEntry.counted = true;
+        inFlightNum++;
+        if(rEntry.pLimit) {
+            rEntry.pLimit->m_inFlightNum++;
+        }
+    }
+
+    // require mutex
+    void Release(const Entry &rEntry) {
+        if(!rEntry.counted) {
+            return;
+        }
+        inFlightNum--;
+        if(rEntry.pLimit) {
+            rEntry.pLimit->m_inFlightNum--;
+        }
+    }
+
+    // require mutex. Move the pending entries that can start into rReadyVec.
+    void TakeReady(std::vector<Entry> &rReadyVec) {
+        for(auto iter = pendingDeque.begin(); iter != pendingDeque.end();) {
+            if(iter->token.IsCancelled()) {
+                rReadyVec.push_back(std::move(*iter));
+            } else if(CanStart(*iter)) {
+                Acquire(*iter);
+                rReadyVec.push_back(std::move(*iter));
+            } else {
+                ++iter;
+                continue;
+            }
+            iter = pendingDeque.erase(iter);
+        }
+    }
+
+    void Run(Entry &&rEntry) {
+        pool.detach_task([this, entry = std::move(rEntry)]() {
+            entry.job();
+
+            std::vector<Entry> readyVec;
+            {
+                std::unique_lock lock(mutex);
+                Release(entry);
+                TakeReady(readyVec);
+            }
+            for(auto &rReady: readyVec) {
+                Run(std::move(rReady));
+            }
+        });
+    }
+
+    const size_t maxInFlight;
+
+    mutable std::mutex mutex;
+    std::deque<Entry> pendingDeque;
+    size_t inFlightNum{0};
+
+    // last member: its threads are joined before the rest is destroyed
+    shadow::thread::Pool<shadow::thread::tp::none> pool;
+};
+
+ActionPool::Ptr ActionPool::GetDefault() {
+    static Ptr pPool = std::make_shared<ActionPool>();
+    return pPool;
+}
+
+ActionPool::ActionPool(): ActionPool(Options{}) {}
+
+ActionPool::ActionPool(const Options &rOptions): m_pPImpl(new PImpl(rOptions)) {}
+
+ActionPool::~ActionPool() {
+    // a job waiting for a limit is started by the completion of another
+    // job: waiting for the pool is enough
+    m_pPImpl->pool.wait();
+}
+
+void ActionPool::Submit(Job job, const CancellationToken &rToken, const Limit::Ptr &pLimit) {
+    PImpl::Entry entry{std::move(job), rToken, pLimit};
+    {
+        std::unique_lock lock(m_pPImpl->mutex);
+        if(!rToken.IsCancelled()) {
+            if(!m_pPImpl->CanStart(entry)) {
+                m_pPImpl->pendingDeque.push_back(std::move(entry));
+                return;
+            }
+            m_pPImpl->Acquire(entry);
+        }
+    }
+    m_pPImpl->Run(std::move(entry));
+}
+
+void ActionPool::Cancel(const CancellationToken &rToken) {
+    rToken.Cancel();
+
+    std::vector<PImpl::Entry> readyVec;
+    {
+        std::unique_lock lock(m_pPImpl->mutex);
+        if(m_pPImpl->pendingDeque.empty()) {
+            return;
+        }
+        m_pPImpl->TakeReady(readyVec);
+    }
+    for(auto &rReady: readyVec) {
+        m_pPImpl->Run(std::move(rReady));
+    }
+}
+
+size_t ActionPool::GetThreadsNum() const {
+    return m_pPImpl->pool.get_thread_count();
+}
+
+size_t ActionPool::GetInFlightNum() const {
+    std::unique_lock lock(m_pPImpl->mutex);
+    return m_pPImpl->inFlightNum;
+}
+
+size_t ActionPool::GetPendingNum() const {
+    std::unique_lock lock(m_pPImpl->mutex);
+    return m_pPImpl->pendingDeque.size();
+}
+
+}// namespace behaviortree
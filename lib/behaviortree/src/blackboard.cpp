@@ -16,14 +16,17 @@ void Blackboard::EnableAutoRemapping(bool remapping) {
 
 AnyPtrLocked Blackboard::GetAnyLocked(const std::string &rKey) {
     if(auto pEntry = GetEntry(rKey)) {
-        return AnyPtrLocked(&pEntry->value, &pEntry->entryMutex);
+        // once the caller modifies the value, the optimistic readers must use the lock
+        return AnyPtrLocked(&pEntry->value, &pEntry->entryMutex, [](void *pContext) {
+            static_cast<Entry *>(pContext)->InvalidateSnapshot();
+        }, pEntry.get());
     }
     return {};
 }
 
 AnyPtrLocked Blackboard::GetAnyLocked(const std::string &rKey) const {
     if(auto pEntry = GetEntry(rKey)) {
-        return AnyPtrLocked(&pEntry->value, const_cast<std::mutex *>(&pEntry->entryMutex));
+        return AnyPtrLocked(&pEntry->value, const_cast<std::shared_mutex *>(&pEntry->entryMutex));
     }
     return {};
 }
@@ -35,9 +38,9 @@ const std::shared_ptr<Blackboard::Entry> Blackboard::GetEntry(const std::string
     }
 
     std::unique_lock<std::mutex> lock(m_mutex);
-    auto iter = m_storageMap.find(rKey);
-    if(iter != m_storageMap.end()) {
-        return iter->second;
+    auto iter = m_keyIdMap.find(rKey);
+    if(iter != m_keyIdMap.end()) {
+        return GetSlotHandle(m_pSlotStorage->slotDeque[iter->second]);
     }
     // not found. Try autoremapping
     if(auto pParent = m_pParentBlackboard.lock()) {
@@ -57,6 +60,24 @@ std::shared_ptr<Blackboard::Entry> Blackboard::GetEntry(const std::string &rKey)
     return static_cast<const Blackboard &>(*this).GetEntry(rKey);
 }
 
+Blackboard::KeyId Blackboard::GetKeyId(const std::string &rKey) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto iter = m_keyIdMap.find(rKey);
+    return iter == m_keyIdMap.end() ? InvalidKeyId : iter->second;
+}
+
+std::shared_ptr<Blackboard::Entry> Blackboard::GetEntry(KeyId keyId) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(keyId >= m_pSlotStorage->slotDeque.size()) {
+        return {};
+    }
+    auto &rEntry = m_pSlotStorage->slotDeque[keyId];
+    if(rEntry.detached.load(std::memory_order_acquire)) {
+        return {};
+    }
+    return GetSlotHandle(rEntry);
+}
+
 const TypeInfo *Blackboard::GetEntryInfo(const std::string &rKey) {
     auto pEntry = GetEntry(rKey);
     return (pEntry == nullptr) ? nullptr : &(pEntry->typeInfo);
@@ -67,10 +88,11 @@ void Blackboard::AddSubtreeRemapping(std::string_view internal, std::string_view
 }
 
 void Blackboard::DebugMessage() const {
-    for(const auto &[key, pEntry]: m_storageMap) {
-        auto portType = pEntry->typeInfo.Type();
+    for(const auto &[key, keyId]: m_keyIdMap) {
+        const auto &rEntry = m_pSlotStorage->slotDeque[keyId];
+        auto portType = rEntry.typeInfo.Type();
         if(portType == typeid(void)) {
-            portType = pEntry->value.Type();
+            portType = rEntry.value.Type();
         }
 
         std::cout << key << " (" << behaviortree::Demangle(portType) << ")" << std::endl;
@@ -83,12 +105,12 @@ void Blackboard::DebugMessage() const {
 }
 
 std::vector<std::string_view> Blackboard::GetKeys() const {
-    if(m_storageMap.empty()) {
+    if(m_keyIdMap.empty()) {
         return {};
     }
     std::vector<std::string_view> out;
-    out.reserve(m_storageMap.size());
-    for(const auto &refEntryIt: m_storageMap) {
+    out.reserve(m_keyIdMap.size());
+    for(const auto &refEntryIt: m_keyIdMap) {
         out.push_back(refEntryIt.first);
     }
     return out;
@@ -108,38 +130,169 @@ void Blackboard::CloneInto(Blackboard &rDst) const {
 
     // keys that are not updated must be removed.
     std::unordered_set<std::string> keysToRemoveSet;
-    auto &rDstStorage = rDst.m_storageMap;
-    for(const auto &[key, _]: rDstStorage) {
+    auto &rDstKeyIdMap = rDst.m_keyIdMap;
+    auto &rDstSlotDeque = rDst.m_pSlotStorage->slotDeque;
+    for(const auto &[key, _]: rDstKeyIdMap) {
         keysToRemoveSet.insert(key);
     }
 
     // update or create entries in dst_storage
-    for(const auto &[srcKey, pSrcEntry]: m_storageMap) {
+    std::vector<std::string> updatedKeyVec;
+    updatedKeyVec.reserve(m_keyIdMap.size());
+    for(const auto &[srcKey, srcKeyId]: m_keyIdMap) {
+        const auto &rSrcEntry = m_pSlotStorage->slotDeque[srcKeyId];
         keysToRemoveSet.erase(srcKey);
+        updatedKeyVec.push_back(srcKey);
 
-        auto pIt = rDstStorage.find(srcKey);
-        if(pIt != rDstStorage.end()) {
+        auto pIt = rDstKeyIdMap.find(srcKey);
+        if(pIt != rDstKeyIdMap.end()) {
             // overwite
-            auto &rDstEntry = pIt->second;
-            rDstEntry->stringConverter = pSrcEntry->stringConverter;
-            rDstEntry->value = pSrcEntry->value;
-            rDstEntry->typeInfo = pSrcEntry->typeInfo;
-            rDstEntry->sequenceId++;
-            rDstEntry->stamp = std::chrono::steady_clock::now().time_since_epoch();
+            auto &rDstEntry = rDstSlotDeque[pIt->second];
+            std::scoped_lock entryLock(rDstEntry.entryMutex);
+            rDstEntry.InvalidateSnapshot();
+            rDstEntry.stringConverter = rSrcEntry.stringConverter;
+            rDstEntry.value = rSrcEntry.value;
+            rDstEntry.typeInfo = rSrcEntry.typeInfo;
+            rDstEntry.sequenceId++;
+            rDstEntry.stamp = Clock::Now();
         } else {
             // create new
-            auto pNewEntry = std::make_shared<Entry>(pSrcEntry->typeInfo);
-            pNewEntry->value = pSrcEntry->value;
-            pNewEntry->stringConverter = pSrcEntry->stringConverter;
-            rDstStorage.insert({srcKey, pNewEntry});
+            auto &rNewEntry = rDst.CreateSlot(srcKey, rSrcEntry.typeInfo);
+            rNewEntry.value = rSrcEntry.value;
+            rNewEntry.stringConverter = rSrcEntry.stringConverter;
         }
     }
 
     for(const auto &rKey: keysToRemoveSet) {
-        rDstStorage.erase(rKey);
+        rDst.RemoveSlot(rDstKeyIdMap.find(rKey));
+    }
+
+    lock2.unlock();
+    lock1.unlock();
+    for(const auto &rKey: updatedKeyVec) {
+        rDst.NotifyWatchers(rKey, EntryEvent::Updated);
+    }
+    for(const auto &rKey: keysToRemoveSet) {
+        rDst.NotifyWatchers(rKey, EntryEvent::Removed);
     }
 }
 
+Blackboard::Ptr Blackboard::Clone(Blackboard::Ptr pParentBlackboard) const {
+    auto pBlackboard = Create(std::move(pParentBlackboard));
+    pBlackboard->m_internalToExternalMap = m_internalToExternalMap;
+    pBlackboard->m_autoRemapping = m_autoRemapping;
+    CloneInto(*pBlackboard);
+    return pBlackboard;
+}
+
+Blackboard::WatchSubscriber Blackboard::Watch(const std::string &rKey, WatchCallback callback) {
+    return AddWatcher(rKey, false, std::move(callback));
+}
+
+Blackboard::WatchSubscriber Blackboard::WatchPrefix(const std::string &rPrefix, WatchCallback callback) {
+    return AddWatcher(rPrefix, true, std::move(callback));
+}
+
+Blackboard::WatchSubscriber Blackboard::AddWatcher(const std::string &rPattern, bool isPrefix, WatchCallback callback) {
+    if(!isPrefix) {
+        // watch the entry on the blackboard that owns it, which is notified
+        // by the writers of all the blackboards that remap the key
+        if(StartWith(rPattern, '@')) {
+            return GetRootBlackboard()->AddWatcher(rPattern.substr(1, rPattern.size() - 1), false, std::move(callback));
+        }
+        bool isLocal = false;
+        {
+            std::unique_lock lock(m_mutex);
+            isLocal = m_keyIdMap.find(rPattern) != m_keyIdMap.end();
+        }
+        auto pParent = m_pParentBlackboard.lock();
+        if(!isLocal and pParent != nullptr) {
+            auto remapIt = m_internalToExternalMap.find(rPattern);
+            if(remapIt != m_internalToExternalMap.end()) {
+                // the callback receives the local name of the key
+                return pParent->AddWatcher(remapIt->second, false, [key = rPattern, callback = std::move(callback)](const std::string &, EntryEvent event) {
+                    callback(key, event);
+                });
+            }
+            if(m_autoRemapping and !IsPrivateKey(rPattern)) {
+                return pParent->AddWatcher(rPattern, false, std::move(callback));
+            }
+        }
+    }
+
+    auto pState = std::make_shared<WatchState>();
+    pState->callback = std::move(callback);
+    // the deleter waits for the running callback, if any, and disables the next ones
+    WatchSubscriber pSubscriber(&pState->callback, [pState](WatchCallback *) {
+        std::scoped_lock lock(pState->mutex);
+        pState->active = false;
+    });
+    std::unique_lock lock(m_watchMutex);
+    m_watcherVec.push_back({rPattern, isPrefix, pSubscriber, std::move(pState)});
+    m_watchersNum.fetch_add(1, std::memory_order_relaxed);
+    return pSubscriber;
+}
+
+void Blackboard::NotifyWatchers(const std::string &rKey, EntryEvent event) {
+    if(StartWith(rKey, '@')) {
+        GetRootBlackboard()->NotifyWatchers(rKey.substr(1, rKey.size() - 1), event);
+        return;
+    }
+
+    if(m_watchersNum.load(std::memory_order_relaxed) != 0) {
+        // copy the matching callbacks, to invoke them without holding the lock
+        std::vector<std::shared_ptr<WatchState>> stateVec;
+        {
+            std::unique_lock lock(m_watchMutex);
+            auto it = m_watcherVec.begin();
+            while(it != m_watcherVec.end()) {
+                if(it->pSubscriber.expired()) {
+                    // the subscriber was destroyed
+                    it = m_watcherVec.erase(it);
+                    m_watchersNum.fetch_sub(1, std::memory_order_relaxed);
+                    continue;
+                }
+                if(it->isPrefix ? StartWith(rKey, it->pattern) : rKey == it->pattern) {
+                    stateVec.push_back(it->pState);
+                }
+                ++it;
+            }
+        }
+        for(const auto &pState: stateVec) {
+            std::scoped_lock lock(pState->mutex);
+            if(pState->active) {
+                pState->callback(rKey, event);
+            }
+        }
+    }
+
+    // an updated entry may belong to the parent blackboard, while
+    // removals are always local (see Unset)
+    if(event != EntryEvent::Updated) {
+        return;
+    }
+    auto pParent = m_pParentBlackboard.lock();
+    if(pParent == nullptr) {
+        return;
+    }
+    const std::string *pParentKey = nullptr;
+    auto remapIt = m_internalToExternalMap.find(rKey);
+    if(remapIt != m_internalToExternalMap.end()) {
+        pParentKey = &remapIt->second;
+    } else if(m_autoRemapping and !IsPrivateKey(rKey)) {
+        pParentKey = &rKey;
+    } else {
+        return;
+    }
+    {
+        std::unique_lock lock(m_mutex);
+        if(m_keyIdMap.find(rKey) != m_keyIdMap.end()) {
+            return;
+        }
+    }
+    pParent->NotifyWatchers(*pParentKey, event);
+}
+
 Blackboard::Ptr Blackboard::Parent() {
     if(auto pParent = m_pParentBlackboard.lock()) {
         return pParent;
@@ -153,9 +306,10 @@ std::shared_ptr<Blackboard::Entry> Blackboard::CreateEntryImpl(const std::string
     // to the top scope to find already existing  entries
 
     // search if exists already
-    auto storageIter = m_storageMap.find(rKey);
-    if(storageIter != m_storageMap.end()) {
-        const auto &rPreInfo = storageIter->second->typeInfo;
+    auto storageIter = m_keyIdMap.find(rKey);
+    if(storageIter != m_keyIdMap.end()) {
+        auto &rPreEntry = m_pSlotStorage->slotDeque[storageIter->second];
+        const auto &rPreInfo = rPreEntry.typeInfo;
         if(rPreInfo.Type() != rInfo.Type() and
            rPreInfo.IsStronglyTyped() and rInfo.IsStronglyTyped()) {
             auto msg = util::StrCat("Blackboard entry [", rKey,
@@ -165,7 +319,7 @@ std::shared_ptr<Blackboard::Entry> Blackboard::CreateEntryImpl(const std::string
 
             throw util::LogicError(msg);
         }
-        return storageIter->second;
+        return GetSlotHandle(rPreEntry);
     }
 
     // manual remapping first
@@ -186,11 +340,51 @@ std::shared_ptr<Blackboard::Entry> Blackboard::CreateEntryImpl(const std::string
     }
     // not remapped, not found. Create locally.
 
-    auto pEntry = std::make_shared<Entry>(rInfo);
+    auto &rEntry = CreateSlot(rKey, rInfo);
     // even if empty, let's assign to it a default type
-    pEntry->value = Any(rInfo.Type());
-    m_storageMap.insert({rKey, pEntry});
-    return pEntry;
+    rEntry.value = Any(rInfo.Type());
+    return GetSlotHandle(rEntry);
+}
+
+Blackboard::Entry &Blackboard::CreateSlot(const std::string &rKey, const TypeInfo &rInfo) {
+    auto &rSlotDeque = m_pSlotStorage->slotDeque;
+    // the key was removed: reuse its slot
+    auto removedIter = m_removedKeyIdMap.find(rKey);
+    if(removedIter != m_removedKeyIdMap.end()) {
+        auto &rEntry = rSlotDeque[removedIter->second];
+        {
+            std::scoped_lock entryLock(rEntry.entryMutex);
+            rEntry.InvalidateSnapshot();
+            rEntry.value = Any();
+            rEntry.typeInfo = rInfo;
+            rEntry.stringConverter = StringConverter();
+            // sequenceId keeps growing, so that the readers notice the change
+            rEntry.stamp = std::chrono::nanoseconds{0};
+            rEntry.detached.store(false, std::memory_order_release);
+        }
+        m_keyIdMap.insert(m_removedKeyIdMap.extract(removedIter));
+        return rEntry;
+    }
+
+    if(rSlotDeque.size() >= InvalidKeyId) {
+        throw util::RuntimeError("Blackboard: too many entries");
+    }
+    const auto keyId = static_cast<KeyId>(rSlotDeque.size());
+    auto &rEntry = rSlotDeque.emplace_back(rInfo);
+    m_keyIdMap.insert({rKey, keyId});
+    return rEntry;
+}
+
+void Blackboard::RemoveSlot(std::unordered_map<std::string, KeyId>::iterator keyIdIter) {
+    auto &rEntry = m_pSlotStorage->slotDeque[keyIdIter->second];
+    {
+        // release the value now: the slot might never be reused
+        std::scoped_lock entryLock(rEntry.entryMutex);
+        rEntry.InvalidateSnapshot();
+        rEntry.value = Any();
+        rEntry.detached.store(true, std::memory_order_release);
+    }
+    m_removedKeyIdMap.insert(m_keyIdMap.extract(keyIdIter));
 }
 
 nlohmann::json ExportBlackboardToJson(const Blackboard &rBlackboard) {
@@ -214,12 +408,18 @@ void ImportBlackboardFromJson(const nlohmann::json &rJson, Blackboard &rBlackboa
                 rBlackboard.CreateEntry(iter.key(), res->second);
                 pEntry = rBlackboard.GetEntry(iter.key());
             }
-            pEntry->value = res->first;
+            {
+                std::scoped_lock entryLock(pEntry->entryMutex);
+                pEntry->value = res->first;
+                pEntry->InvalidateSnapshot();
+            }
+            rBlackboard.NotifyWatchers(iter.key(), Blackboard::EntryEvent::Updated);
         }
     }
 }
 
 Blackboard::Entry &Blackboard::Entry::operator=(const Entry &rOther) {
+    InvalidateSnapshot();
     value = rOther.value;
     typeInfo = rOther.typeInfo;
     stringConverter = rOther.stringConverter;
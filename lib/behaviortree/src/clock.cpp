@@ -0,0 +1,103 @@
+#include "behaviortree/util/clock.h"
+
+#include <atomic>
+#include <ctime>
+#include <type_traits>
+#include <utility>
+
+#include "behaviortree/util/timer_service.h"
+
+namespace behaviortree {
+namespace {
+std::atomic<Clock::Mode> s_mode{Clock::Mode::Precise};
+std::atomic<int64_t> s_virtualNs{0};
+
+// time of the tick being executed by this thread, 0 outside of a tick
+thread_local int64_t t_tickNs{0};
+
+int64_t SteadyNs() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t CoarseNs() noexcept {
+#if defined(CLOCK_MONOTONIC_COARSE)
+    // same epoch as steady_clock (CLOCK_MONOTONIC)
+    timespec ts;
+    if(clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0) {
+        return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+#endif
+    return SteadyNs();
+}
+
+// high_resolution_clock minus steady_clock, read once
+int64_t HighResolutionOffsetNs() noexcept {
+    if constexpr(std::is_same_v<std::chrono::high_resolution_clock, std::chrono::steady_clock>) {
+        return 0;
+    } else {
+        static const int64_t offsetNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count() - SteadyNs();
+        return offsetNs;
+    }
+}
+}// namespace
+
+void Clock::SetMode(Mode mode) {
+    s_mode.store(mode, std::memory_order_relaxed);
+    TimerService::NotifyClockChanged();
+}
+
+Clock::Mode Clock::GetMode() {
+    return s_mode.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds Clock::Now() noexcept {
+    switch(s_mode.load(std::memory_order_relaxed)) {
+        case Mode::Coarse:
+            return std::chrono::nanoseconds(CoarseNs());
+        case Mode::TickCached:
+            return std::chrono::nanoseconds(t_tickNs != 0 ? t_tickNs : SteadyNs());
+        case Mode::Virtual:
+            return std::chrono::nanoseconds(s_virtualNs.load(std::memory_order_acquire));
+        default:
+            return std::chrono::nanoseconds(SteadyNs());
+    }
+}
+
+std::chrono::nanoseconds Clock::PreciseNow() noexcept {
+    if(s_mode.load(std::memory_order_relaxed) == Mode::Virtual) {
+        return std::chrono::nanoseconds(s_virtualNs.load(std::memory_order_acquire));
+    }
+    return std::chrono::nanoseconds(SteadyNs());
+}
+
+std::chrono::high_resolution_clock::time_point Clock::ToTimePoint(std::chrono::nanoseconds time) noexcept {
+    if(s_mode.load(std::memory_order_relaxed) != Mode::Virtual) {
+        time += std::chrono::nanoseconds(HighResolutionOffsetNs());
+    }
+    return std::chrono::high_resolution_clock::time_point(std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(time));
+}
+
+void Clock::SetVirtualTime(std::chrono::nanoseconds time) {
+    s_virtualNs.store(time.count(), std::memory_order_release);
+    TimerService::NotifyClockChanged();
+}
+
+void Clock::AdvanceVirtualTime(std::chrono::nanoseconds duration) {
+    s_virtualNs.fetch_add(duration.count(), std::memory_order_acq_rel);
+    TimerService::NotifyClockChanged();
+}
+
+Clock::TickScope::TickScope() noexcept {
+    if(s_mode.load(std::memory_order_relaxed) == Mode::TickCached) {
+        m_active = true;
+        m_previousNs = std::exchange(t_tickNs, SteadyNs());
+    }
+}
+
+Clock::TickScope::~TickScope() {
+    if(m_active) {
+        t_tickNs = m_previousNs;
+    }
+}
+
+}// namespace behaviortree
@@ -0,0 +1,238 @@
+#include "behaviortree/compiled_tree.h"
+
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+#include "behaviortree/control_node.h"
+#include "behaviortree/decorator_node.h"
+
+namespace behaviortree {
+CompiledTree::OpCode CompiledTree::SelectOpCode(const TreeNode *pNode) {
+    static const std::unordered_map<std::string_view, CompiledTree::OpCode> opCodeMap = {
+            {"Sequence", CompiledTree::OpCode::Sequence},
+            {"Fallback", CompiledTree::OpCode::Fallback},
+            {"Inverter", CompiledTree::OpCode::Inverter},
+            {"ForceSuccess", CompiledTree::OpCode::ForceSuccess},
+            {"ForceFailure", CompiledTree::OpCode::ForceFailure},
+            {"AlwaysSuccess", CompiledTree::OpCode::AlwaysSuccess},
+            {"AlwaysFailure", CompiledTree::OpCode::AlwaysFailure},
+            {"Subtree", CompiledTree::OpCode::Subtree}};
+
+    auto iter = opCodeMap.find(pNode->GetRegistrAtionName());
+    if(iter == opCodeMap.end() or pNode->HasTickHooks()) {
+        return CompiledTree::OpCode::Opaque;
+    }
+    // the registration ID might have been reused by a custom node
+    switch(iter->second) {
+        case CompiledTree::OpCode::Sequence:
+        case CompiledTree::OpCode::Fallback: {
+            return dynamic_cast<const ControlNode *>(pNode) ? iter->second : CompiledTree::OpCode::Opaque;
+        }
+        case CompiledTree::OpCode::AlwaysSuccess:
+        case CompiledTree::OpCode::AlwaysFailure: {
+            return pNode->Type() == NodeType::Action ? iter->second : CompiledTree::OpCode::Opaque;
+        }
+        default: {
+            auto pDecorator = dynamic_cast<const DecoratorNode *>(pNode);
+            return (pDecorator and pDecorator->GetChildNode()) ? iter->second : CompiledTree::OpCode::Opaque;
+        }
+    }
+}
+
+CompiledTree::CompiledTree(TreeNode *pRootNode) {
+    if(pRootNode == nullptr) {
+        throw util::RuntimeError("CompiledTree: empty tree");
+    }
+
+    // Breadth-first layout: the children of a node are assigned
+    // contiguous indices when their parent is visited.
+    std::deque<TreeNode *> pendingQueue = {pRootNode};
+    m_recordVec.push_back({pRootNode, 0, 0, OpCode::Opaque});
+
+    for(uint32_t index = 0; index < m_recordVec.size(); index++) {
+        TreeNode *pNode = pendingQueue.front();
+        pendingQueue.pop_front();
+
+        NodeRecord record{pNode, static_cast<uint32_t>(m_recordVec.size()), 0, SelectOpCode(pNode)};
+
+        std::vector<TreeNode *> childrenVec;
+        if(record.opCode == OpCode::Sequence or record.opCode == OpCode::Fallback) {
+            childrenVec = static_cast<ControlNode *>(pNode)->GetChildrenNode();
+        } else if(record.opCode != OpCode::Opaque and record.opCode != OpCode::AlwaysSuccess and record.opCode != OpCode::AlwaysFailure) {
+            childrenVec.push_back(static_cast<DecoratorNode *>(pNode)->GetChildNode());
+        }
+
+        record.childrenNum = static_cast<uint32_t>(childrenVec.size());
+        for(TreeNode *pChildNode: childrenVec) {
+            pendingQueue.push_back(pChildNode);
+            m_recordVec.push_back({pChildNode, 0, 0, OpCode::Opaque});
+        }
+        if(record.opCode == OpCode::Opaque) {
+            m_opaqueNodesNum++;
+        }
+        m_recordVec[index] = record;
+    }
+
+    m_statusVec.assign(m_recordVec.size(), static_cast<uint8_t>(NodeStatus::Idle));
+    m_stateVec.assign(m_recordVec.size(), NodeState{});
+
+    m_infoVec.reserve(m_recordVec.size());
+    for(const auto &rRecord: m_recordVec) {
+        m_infoVec.push_back({rRecord.pNode->GetNodeName(), rRecord.pNode->GetFullPath(), rRecord.pNode->GetRegistrAtionName()});
+    }
+}
+
+NodeStatus CompiledTree::Tick() {
+    const NodeStatus nodeStatus = TickNode(0);
+    if(IsNodeStatusCompleted(nodeStatus)) {
+        ResetNode(0);
+    }
+    return nodeStatus;
+}
+
+void CompiledTree::Halt() {
+    ResetNode(0);
+}
+
+size_t CompiledTree::GetNodesNum() const {
+    return m_recordVec.size();
+}
+
+size_t CompiledTree::GetOpaqueNodesNum() const {
+    return m_opaqueNodesNum;
+}
+
+NodeStatus CompiledTree::GetNodeStatus(size_t index) const {
+    const auto &rRecord = m_recordVec.at(index);
+    if(rRecord.opCode == OpCode::Opaque) {
+        return rRecord.pNode->GetNodeStatus();
+    }
+    return Status(static_cast<uint32_t>(index));
+}
+
+const CompiledTree::NodeRecord &CompiledTree::GetNodeRecord(size_t index) const {
+    return m_recordVec.at(index);
+}
+
+const CompiledTree::NodeInfo &CompiledTree::GetNodeInfo(size_t index) const {
+    return m_infoVec.at(index);
+}
+
+NodeStatus CompiledTree::TickNode(uint32_t index) {
+    const NodeStatus nodeStatus = Execute(index);
+    // preserve the IDLE state if skipped, but communicate SKIPPED to parent
+    if(nodeStatus != NodeStatus::Skipped) {
+        SetStatus(index, nodeStatus);
+    }
+    return nodeStatus;
+}
+
+NodeStatus CompiledTree::Execute(uint32_t index) {
+    const NodeRecord &rRecord = m_recordVec[index];
+
+    switch(rRecord.opCode) {
+        case OpCode::Opaque: {
+            return rRecord.pNode->ExecuteTick();
+        }
+        case OpCode::AlwaysSuccess: {
+            return NodeStatus::Success;
+        }
+        case OpCode::AlwaysFailure: {
+            return NodeStatus::Failure;
+        }
+        case OpCode::Sequence:
+        case OpCode::Fallback: {
+            // Sequence and Fallback are symmetrical: they stop at the first
+            // child returning respectively FAILURE or SUCCESS.
+            const NodeStatus stopNodeStatus = rRecord.opCode == OpCode::Sequence ? NodeStatus::Failure : NodeStatus::Success;
+            const NodeStatus continueNodeStatus = rRecord.opCode == OpCode::Sequence ? NodeStatus::Success : NodeStatus::Failure;
+            auto &rState = m_stateVec[index];
+
+            if(Status(index) == NodeStatus::Idle) {
+                rState.skippedNum = 0;
+            }
+            SetStatus(index, NodeStatus::Running);
+
+            while(rState.currentChildIdx < rRecord.childrenNum) {
+                const NodeStatus childNodeStatus = TickNode(rRecord.firstChild + rState.currentChildIdx);
+
+                if(childNodeStatus == NodeStatus::Running) {
+                    return NodeStatus::Running;
+                } else if(childNodeStatus == stopNodeStatus) {
+                    ResetChildren(index);
+                    rState.currentChildIdx = 0;
+                    return childNodeStatus;
+                } else if(childNodeStatus == continueNodeStatus) {
+                    rState.currentChildIdx++;
+                } else if(childNodeStatus == NodeStatus::Skipped) {
+                    rState.currentChildIdx++;
+                    rState.skippedNum++;
+                } else {
+                    throw util::LogicError("[", m_infoVec[index].name, "]: A children should not return IDLE");
+                }
+            }
+
+            ResetChildren(index);
+            rState.currentChildIdx = 0;
+            // Skip if ALL the nodes have been skipped
+            return rState.skippedNum == rRecord.childrenNum ? NodeStatus::Skipped : continueNodeStatus;
+        }
+        case OpCode::Inverter:
+        case OpCode::ForceSuccess:
+        case OpCode::ForceFailure:
+        case OpCode::Subtree: {
+            SetStatus(index, NodeStatus::Running);
+            const NodeStatus childNodeStatus = TickNode(rRecord.firstChild);
+
+            if(childNodeStatus == NodeStatus::Idle) {
+                throw util::LogicError("[", m_infoVec[index].name, "]: A children should not return IDLE");
+            }
+            if(!IsNodeStatusCompleted(childNodeStatus)) {
+                // RUNNING or SKIPPED
+                return childNodeStatus;
+            }
+
+            ResetNode(rRecord.firstChild);
+            switch(rRecord.opCode) {
+                case OpCode::Inverter: {
+                    return childNodeStatus == NodeStatus::Success ? NodeStatus::Failure : NodeStatus::Success;
+                }
+                case OpCode::ForceSuccess: {
+                    return NodeStatus::Success;
+                }
+                case OpCode::ForceFailure: {
+                    return NodeStatus::Failure;
+                }
+                default: {
+                    return childNodeStatus;
+                }
+            }
+        }
+    }
+    return Status(index);
+}
+
+void CompiledTree::ResetNode(uint32_t index) {
+    const NodeRecord &rRecord = m_recordVec[index];
+
+    if(rRecord.opCode == OpCode::Opaque) {
+        if(Status(index) == NodeStatus::Running) {
+            rRecord.pNode->HaltNode();
+        }
+        rRecord.pNode->ResetNodeStatus();
+    } else {
+        ResetChildren(index);
+        m_stateVec[index] = NodeState{};
+    }
+    SetStatus(index, NodeStatus::Idle);
+}
+
+void CompiledTree::ResetChildren(uint32_t index) {
+    const NodeRecord &rRecord = m_recordVec[index];
+    for(uint32_t childIdx = rRecord.firstChild; childIdx < rRecord.firstChild + rRecord.childrenNum; childIdx++) {
+        ResetNode(childIdx);
+    }
+}
+
+}// namespace behaviortree
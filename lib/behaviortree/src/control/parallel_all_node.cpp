@@ -11,6 +11,9 @@ NodeStatus ParallelAllNode::Tick() {
     if(!GetInput("max_failures", maxFailures)) {
         throw util::RuntimeError("Missing parameter [max_failures] in ParallelNode");
     }
+    if(!GetInput("concurrent", m_concurrentPort)) {
+        m_concurrentPort = false;
+    }
     const size_t childrenNum = m_childrenNodeVec.size();
     SetFailureThreshold(maxFailures);
 
@@ -22,23 +25,42 @@ NodeStatus ParallelAllNode::Tick() {
 
     SetNodeStatus(NodeStatus::Running);
 
+    if(m_completedVec.size() != childrenNum) {
+        m_completedVec.assign(childrenNum, false);
+        m_completedCount = 0;
+    }
+
+    // concurrent mode: tick all the pending children first, then aggregate
+    // their statuses in order, as the sequential mode does
+    const bool concurrent = IsConcurrent();
+    if(concurrent) {
+        m_pendingIdxVec.clear();
+        for(size_t index = 0; index < childrenNum; index++) {
+            if(!m_completedVec[index]) {
+                m_pendingIdxVec.push_back(index);
+            }
+        }
+        TickChildrenConcurrently(m_pendingIdxVec, m_pendingStatusVec, m_pPool ? m_pPool : ActionPool::GetDefault());
+    }
+    size_t pendingIdx = 0;
+
     // Routing the tree according to the sequence node's logic:
     for(size_t index = 0; index < childrenNum; index++) {
-        TreeNode *pChildNode = m_childrenNodeVec[index];
-
         // already completed
-        if(m_completedSet.count(index) != 0) {
+        if(m_completedVec[index]) {
             continue;
         }
 
-        NodeStatus const childNodeStatus = pChildNode->ExecuteTick();
+        NodeStatus const childNodeStatus = concurrent ? m_pendingStatusVec[pendingIdx++] : m_childrenNodeVec[index]->ExecuteTick();
 
         switch(childNodeStatus) {
             case NodeStatus::Success: {
-                m_completedSet.insert(index);
+                m_completedVec[index] = true;
+                m_completedCount++;
             } break;
             case NodeStatus::Failure: {
-                m_completedSet.insert(index);
+                m_completedVec[index] = true;
+                m_completedCount++;
                 m_failureCount++;
             } break;
             case NodeStatus::Running: {
@@ -56,14 +78,13 @@ NodeStatus ParallelAllNode::Tick() {
     if(skippedCount == childrenNum) {
         return NodeStatus::Skipped;
     }
-    if(skippedCount + m_completedSet.size() >= childrenNum) {
+    if(skippedCount + m_completedCount >= childrenNum) {
         // DONE
         HaltChildren();
-        m_completedSet.clear();
         auto const status = (m_failureCount >= m_failureThreshold)
                                     ? NodeStatus::Failure
                                     : NodeStatus::Success;
-        m_failureCount = 0;
+        Clear();
         return status;
     }
 
@@ -71,9 +92,14 @@ NodeStatus ParallelAllNode::Tick() {
     return NodeStatus::Running;
 }
 
-void ParallelAllNode::Halt() {
-    m_completedSet.clear();
+void ParallelAllNode::Clear() {
+    m_completedVec.assign(m_completedVec.size(), false);
+    m_completedCount = 0;
     m_failureCount = 0;
+}
+
+void ParallelAllNode::Halt() {
+    Clear();
     ControlNode::Halt();
 }
 
@@ -89,4 +115,16 @@ void ParallelAllNode::SetFailureThreshold(int32_t threshold) {
     }
 }
 
+bool ParallelAllNode::IsConcurrent() const {
+    return m_concurrentOverride or m_concurrentPort;
+}
+
+void ParallelAllNode::SetConcurrent(bool concurrent) {
+    m_concurrentOverride = concurrent;
+}
+
+void ParallelAllNode::SetActionPool(ActionPool::Ptr pPool) {
+    m_pPool = std::move(pPool);
+}
+
 }// namespace behaviortree
@@ -6,6 +6,7 @@
 namespace behaviortree {
 constexpr const char *ParallelNode::THRESHOLD_FAILURE;
 constexpr const char *ParallelNode::THRESHOLD_SUCCESS;
+constexpr const char *ParallelNode::CONCURRENT;
 
 ParallelNode::ParallelNode(const std::string &rName): ControlNode::ControlNode(rName, {}),
                                                       m_successThreshold(-1),
@@ -28,6 +29,10 @@ NodeStatus ParallelNode::Tick() {
         if(!GetInput(THRESHOLD_FAILURE, m_failureThreshold)) {
             throw util::RuntimeError("Missing parameter [", THRESHOLD_FAILURE, "] in ParallelNode");
         }
+
+        if(!GetInput(CONCURRENT, m_concurrentPort)) {
+            m_concurrentPort = false;
+        }
     }
 
     const size_t childrenNum = m_childrenNodeVec.size();
@@ -42,24 +47,49 @@ NodeStatus ParallelNode::Tick() {
 
     SetNodeStatus(NodeStatus::Running);
 
+    if(m_completedVec.size() != childrenNum) {
+        m_completedVec.assign(childrenNum, false);
+    }
+
+    const size_t requiredSuccessCount = SuccessThreshold();
+
+    // concurrent mode: tick the pending children first, then aggregate their
+    // statuses in order, as the sequential mode does. The children are not
+    // started anymore once the thresholds are certainly reached
+    const bool concurrent = IsConcurrent();
+    size_t tickedNum = 0;
+    if(concurrent) {
+        m_pendingIdxVec.clear();
+        for(size_t i = 0; i < childrenNum; i++) {
+            if(!m_completedVec[i]) {
+                m_pendingIdxVec.push_back(i);
+            }
+        }
+        const size_t maxFailureCount = std::min(FailureThreshold(), childrenNum - requiredSuccessCount + 1);
+        const size_t stopSuccessesNum = requiredSuccessCount > m_successCount ? requiredSuccessCount - m_successCount : 1;
+        const size_t stopFailuresNum = maxFailureCount > m_failureCount ? maxFailureCount - m_failureCount : 1;
+        tickedNum = TickChildrenConcurrently(m_pendingIdxVec, m_pendingStatusVec, m_pPool ? m_pPool : ActionPool::GetDefault(), stopSuccessesNum, stopFailuresNum);
+    }
+    size_t pendingIdx = 0;
+
     size_t skippedCount = 0;
 
     // Routing the tree according to the sequence node's logic:
     for(size_t i = 0; i < childrenNum; i++) {
-        if(m_completedSet.count(i) == 0) {
-            TreeNode *pChildNode = m_childrenNodeVec[i];
-            NodeStatus const childNodeStatus = pChildNode->ExecuteTick();
+        // in the concurrent mode, the children not started are still pending
+        if(!m_completedVec[i] and (!concurrent or pendingIdx < tickedNum)) {
+            NodeStatus const childNodeStatus = concurrent ? m_pendingStatusVec[pendingIdx++] : m_childrenNodeVec[i]->ExecuteTick();
 
             switch(childNodeStatus) {
                 case NodeStatus::Skipped: {
                     skippedCount++;
                 } break;
                 case NodeStatus::Success: {
-                    m_completedSet.insert(i);
+                    m_completedVec[i] = true;
                     m_successCount++;
                 } break;
                 case NodeStatus::Failure: {
-                    m_completedSet.insert(i);
+                    m_completedVec[i] = true;
                     m_failureCount++;
                 } break;
                 case NodeStatus::Running: {
@@ -73,8 +103,6 @@ NodeStatus ParallelNode::Tick() {
             }
         }
 
-        const size_t requiredSuccessCount = SuccessThreshold();
-
         if(m_successCount >= requiredSuccessCount or (m_successThreshold < 0 and (m_successCount + skippedCount) >= requiredSuccessCount)) {
             Clear();
             ResetChildren();
@@ -96,7 +124,7 @@ NodeStatus ParallelNode::Tick() {
 }
 
 void ParallelNode::Clear() {
-    m_completedSet.clear();
+    m_completedVec.assign(m_completedVec.size(), false);
     m_successCount = 0;
     m_failureCount = 0;
 }
@@ -130,4 +158,16 @@ void ParallelNode::SetFailureThreshold(int threshold) {
     m_failureThreshold = threshold;
 }
 
+bool ParallelNode::IsConcurrent() const {
+    return m_concurrentOverride or m_concurrentPort;
+}
+
+void ParallelNode::SetConcurrent(bool concurrent) {
+    m_concurrentOverride = concurrent;
+}
+
+void ParallelNode::SetActionPool(ActionPool::Ptr pPool) {
+    m_pPool = std::move(pPool);
+}
+
 }// namespace behaviortree
@@ -1,5 +1,12 @@
 #include "behaviortree/control_node.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <mutex>
+
 namespace behaviortree {
 ControlNode::ControlNode(const std::string &rName, const NodeConfig &rConfig): TreeNode::TreeNode(rName, rConfig) {}
 
@@ -43,4 +50,111 @@ void ControlNode::HaltChildren() {
     }
 }
 
+size_t ControlNode::TickChildrenConcurrently(const std::vector<size_t> &rIndexVec, std::vector<NodeStatus> &rStatusVec, const ActionPool::Ptr &pPool,
+                                             size_t stopSuccessesNum, size_t stopFailuresNum) {
+    // Shared with the helpers, that may start after the return of this function:
+    // the children are claimed one at a time, so a helper starting late finds
+    // nothing to do, and the caller never waits for a tick that didn't begin.
+    struct Batch {
+        std::vector<TreeNode *> nodeVec;
+        std::vector<NodeStatus> statusVec;
+        std::vector<std::exception_ptr> exptrVec;
+        size_t stopSuccessesNum;
+        size_t stopFailuresNum;
+        std::atomic<size_t> nextIdx{0};
+        std::atomic<size_t> successesNum{0};
+        std::atomic<size_t> failuresNum{0};
+        std::atomic<size_t> doneNum{0};
+        // number of ticks the caller waits for, known once the batch is closed
+        std::atomic<size_t> startedNum;
+        std::mutex mutex;
+        std::condition_variable doneCv;
+
+        [[nodiscard]] bool IsDecided() const {
+            return successesNum.load(std::memory_order_relaxed) >= stopSuccessesNum or
+                   failuresNum.load(std::memory_order_relaxed) >= stopFailuresNum;
+        }
+
+        void Work() {
+            const size_t nodesNum = nodeVec.size();
+            while(!IsDecided()) {
+                const size_t i = nextIdx.fetch_add(1, std::memory_order_relaxed);
+                if(i >= nodesNum) {
+                    break;
+                }
+                try {
+                    statusVec[i] = nodeVec[i]->ExecuteTick();
+                    if(statusVec[i] == NodeStatus::Success) {
+                        successesNum.fetch_add(1, std::memory_order_relaxed);
+                    } else if(statusVec[i] == NodeStatus::Failure) {
+                        failuresNum.fetch_add(1, std::memory_order_relaxed);
+                    }
+                } catch(...) {
+                    exptrVec[i] = std::current_exception();
+                }
+                if(doneNum.fetch_add(1) + 1 == startedNum.load()) {
+                    std::unique_lock lock(mutex);
+                    doneCv.notify_all();
+                }
+            }
+        }
+
+        // no child is started after it; returns the number of children started
+        size_t Close() {
+            const size_t nodesNum = nodeVec.size();
+            const size_t claimedNum = std::min(nextIdx.exchange(nodesNum), nodesNum);
+            startedNum.store(claimedNum);
+            return claimedNum;
+        }
+    };
+
+    const size_t childrenNum = rIndexVec.size();
+    rStatusVec.resize(childrenNum);
+    if(childrenNum == 0) {
+        return 0;
+    }
+
+    auto pBatch = std::make_shared<Batch>();
+    pBatch->nodeVec.reserve(childrenNum);
+    for(size_t index: rIndexVec) {
+        pBatch->nodeVec.push_back(m_childrenNodeVec[index]);
+    }
+    pBatch->statusVec.resize(childrenNum, NodeStatus::Idle);
+    pBatch->exptrVec.resize(childrenNum);
+    pBatch->stopSuccessesNum = stopSuccessesNum;
+    pBatch->stopFailuresNum = stopFailuresNum;
+    // until Close(), no tick is the last one
+    pBatch->startedNum.store(std::numeric_limits<size_t>::max());
+
+    const size_t helpersNum = std::min(childrenNum - 1, pPool->GetThreadsNum());
+    const CancellationToken token;
+    for(size_t i = 0; i < helpersNum; i++) {
+        pPool->Submit(
+                [pBatch]() {
+                    pBatch->Work();
+                },
+                token
+        );
+    }
+    pBatch->Work();
+
+    const size_t startedNum = pBatch->Close();
+    {
+        std::unique_lock lock(pBatch->mutex);
+        pBatch->doneCv.wait(lock, [&pBatch, startedNum]() {
+            return pBatch->doneNum.load() == startedNum;
+        });
+    }
+
+    for(size_t i = 0; i < startedNum; i++) {
+        if(pBatch->exptrVec[i]) {
+            std::rethrow_exception(pBatch->exptrVec[i]);
+        }
+    }
+    for(size_t i = 0; i < childrenNum; i++) {
+        rStatusVec[i] = pBatch->statusVec[i];
+    }
+    return startedNum;
+}
+
 }// namespace behaviortree
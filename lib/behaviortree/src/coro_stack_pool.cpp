@@ -0,0 +1,106 @@
+#include "behaviortree/util/coro_stack_pool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace behaviortree {
+namespace {
+std::atomic<size_t> s_stackSize{0};
+std::atomic<size_t> s_maxCachedNum{64};
+
+std::atomic<uint64_t> s_allocatedNum{0};
+std::atomic<uint64_t> s_reusedNum{0};
+std::atomic<size_t> s_cachedNum{0};
+std::atomic<size_t> s_maxStackUsage{0};
+
+struct ThreadCache {
+    // all the blocks of the cache have the same size
+    size_t blockSize{0};
+    std::vector<void *> blockVec;
+
+    ~ThreadCache() {
+        Clear();
+    }
+
+    void Clear() {
+        for(void *pBlock: blockVec) {
+            std::free(pBlock);
+        }
+        s_cachedNum.fetch_sub(blockVec.size(), std::memory_order_relaxed);
+        blockVec.clear();
+    }
+};
+
+ThreadCache &GetThreadCache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+}// namespace
+
+void CoroStackPool::SetOptions(const Options &rOptions) {
+    s_stackSize.store(rOptions.stackSize, std::memory_order_relaxed);
+    s_maxCachedNum.store(rOptions.maxCachedNum, std::memory_order_relaxed);
+}
+
+CoroStackPool::Options CoroStackPool::GetOptions() {
+    return {s_stackSize.load(std::memory_order_relaxed), s_maxCachedNum.load(std::memory_order_relaxed)};
+}
+
+CoroStackPool::Stats CoroStackPool::GetStats() {
+    Stats stats;
+    stats.stackSize = s_stackSize.load(std::memory_order_relaxed);
+    stats.allocatedNum = s_allocatedNum.load(std::memory_order_relaxed);
+    stats.reusedNum = s_reusedNum.load(std::memory_order_relaxed);
+    stats.cachedNum = s_cachedNum.load(std::memory_order_relaxed);
+    stats.maxStackUsage = s_maxStackUsage.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void *CoroStackPool::Allocate(size_t size) {
+    auto &rCache = GetThreadCache();
+    if(rCache.blockSize == size and !rCache.blockVec.empty()) {
+        void *pBlock = rCache.blockVec.back();
+        rCache.blockVec.pop_back();
+        s_cachedNum.fetch_sub(1, std::memory_order_relaxed);
+        s_reusedNum.fetch_add(1, std::memory_order_relaxed);
+        return pBlock;
+    }
+
+    void *pBlock = std::malloc(size);
+    if(pBlock == nullptr) {
+        throw std::bad_alloc();
+    }
+    s_allocatedNum.fetch_add(1, std::memory_order_relaxed);
+    return pBlock;
+}
+
+void CoroStackPool::Deallocate(void *pBlock, size_t size) noexcept {
+    if(pBlock == nullptr) {
+        return;
+    }
+    auto &rCache = GetThreadCache();
+    if(rCache.blockSize != size) {
+        // the stack size changed: the old blocks are useless
+        rCache.Clear();
+        rCache.blockSize = size;
+    }
+    if(rCache.blockVec.size() < s_maxCachedNum.load(std::memory_order_relaxed)) {
+        try {
+            rCache.blockVec.push_back(pBlock);
+            s_cachedNum.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } catch(...) {
+        }
+    }
+    std::free(pBlock);
+}
+
+void CoroStackPool::RecordStackUsage(size_t bytes) noexcept {
+    size_t maxBytes = s_maxStackUsage.load(std::memory_order_relaxed);
+    while(bytes > maxBytes and !s_maxStackUsage.compare_exchange_weak(maxBytes, bytes, std::memory_order_relaxed)) {
+    }
+}
+
+}// namespace behaviortree
@@ -0,0 +1,237 @@
+#include "behaviortree/coroutine_action_node.h"
+
+#include <cstddef>
+#include <new>
+
+namespace behaviortree {
+namespace {
+// Placed in front of every frame, to know where it comes from.
+// Its size preserves the fundamental alignment of the frame.
+struct alignas(std::max_align_t) FrameHeader {
+    CoroFrameAllocator *pAllocator;
+    // 0 for the frames allocated on the heap
+    size_t blockSize;
+};
+}// namespace
+
+CoroFrameAllocator::~CoroFrameAllocator() {
+    for(FreeBlock *pBlock: m_freeListArr) {
+        while(pBlock) {
+            FreeBlock *pNext = pBlock->pNext;
+            ::operator delete(pBlock);
+            pBlock = pNext;
+        }
+    }
+}
+
+void *CoroFrameAllocator::Allocate(CoroFrameAllocator *pAllocator, size_t size) {
+    const size_t blockSize = (sizeof(FrameHeader) + size + SizeClass - 1) / SizeClass * SizeClass;
+    void *pBlock = nullptr;
+    if(pAllocator != nullptr and blockSize <= MaxCachedSize) {
+        const size_t classIdx = blockSize / SizeClass - 1;
+        {
+            std::unique_lock lock(pAllocator->m_mutex);
+            FreeBlock *&rpHead = pAllocator->m_freeListArr[classIdx];
+            if(rpHead) {
+                pBlock = rpHead;
+                rpHead = rpHead->pNext;
+                pAllocator->m_cachedBytes -= blockSize;
+            }
+        }
+        if(pBlock == nullptr) {
+            pBlock = ::operator new(blockSize);
+        }
+    } else {
+        pAllocator = nullptr;
+        pBlock = ::operator new(sizeof(FrameHeader) + size);
+    }
+
+    auto pHeader = new(pBlock) FrameHeader{pAllocator, pAllocator ? blockSize : 0};
+    return pHeader + 1;
+}
+
+void CoroFrameAllocator::Deallocate(void *pMemory) noexcept {
+    if(pMemory == nullptr) {
+        return;
+    }
+    auto pHeader = static_cast<FrameHeader *>(pMemory) - 1;
+    CoroFrameAllocator *pAllocator = pHeader->pAllocator;
+    if(pAllocator == nullptr) {
+        ::operator delete(pHeader);
+        return;
+    }
+
+    const size_t blockSize = pHeader->blockSize;
+    auto pBlock = new(pHeader) FreeBlock{nullptr};
+    std::unique_lock lock(pAllocator->m_mutex);
+    FreeBlock *&rpHead = pAllocator->m_freeListArr[blockSize / SizeClass - 1];
+    pBlock->pNext = rpHead;
+    rpHead = pBlock;
+    pAllocator->m_cachedBytes += blockSize;
+}
+
+size_t CoroFrameAllocator::GetCachedBytes() const {
+    std::unique_lock lock(m_mutex);
+    return m_cachedBytes;
+}
+
+//-------------------------------------------------------
+
+void *ActionTask::promise_type::operator new(size_t size, CoroutineActionNode &rNode) {
+    return CoroFrameAllocator::Allocate(rNode.GetFrameAllocator(), size);
+}
+
+void *ActionTask::promise_type::operator new(size_t size) {
+    return CoroFrameAllocator::Allocate(nullptr, size);
+}
+
+void ActionTask::promise_type::operator delete(void *pMemory) noexcept {
+    CoroFrameAllocator::Deallocate(pMemory);
+}
+
+//-------------------------------------------------------
+
+void CoroutineActionNode::Awaiter::await_suspend(std::coroutine_handle<> /*handle*/) {
+    m_pNode->Arm(*this);
+}
+
+CoroutineActionNode::CoroutineActionNode(const std::string &rName, const NodeConfig &rConfig): ActionNodeBase(rName, rConfig) {}
+
+CoroutineActionNode::~CoroutineActionNode() {
+    // the frame must be released while its allocator is alive
+    Reset();
+}
+
+void CoroutineActionNode::Notify() {
+    uint64_t waitId = 0;
+    {
+        std::unique_lock lock(m_signalMutex);
+        if(m_signalWaitId == 0) {
+            m_signalPending = true;
+            return;
+        }
+        waitId = std::exchange(m_signalWaitId, 0);
+    }
+    Wake(waitId);
+}
+
+void CoroutineActionNode::SetFrameAllocator(CoroFrameAllocator::Ptr pAllocator) {
+    if(m_task) {
+        throw util::LogicError("CoroutineActionNode [", GetNodeName(), "]: can't change the frame allocator of a running coroutine");
+    }
+    m_pFrameAllocator = std::move(pAllocator);
+}
+
+void CoroutineActionNode::Halt() {
+    Reset();
+    ResetNodeStatus();
+}
+
+CoroutineActionNode::Awaiter CoroutineActionNode::NextTick() {
+    return {this, Awaiter::Kind::NextTick};
+}
+
+CoroutineActionNode::Awaiter CoroutineActionNode::SleepFor(std::chrono::milliseconds duration) {
+    Awaiter awaiter(this, Awaiter::Kind::Sleep);
+    awaiter.m_duration = duration;
+    return awaiter;
+}
+
+CoroutineActionNode::Awaiter CoroutineActionNode::WaitForEntryUpdate(const std::string &rKey) {
+    Awaiter awaiter(this, Awaiter::Kind::EntryUpdate);
+    awaiter.m_key = rKey;
+    return awaiter;
+}
+
+CoroutineActionNode::Awaiter CoroutineActionNode::WaitForSignal() {
+    return {this, Awaiter::Kind::Signal};
+}
+
+NodeStatus CoroutineActionNode::Tick() {
+    if(!m_task) {
+        m_task = Run();
+    } else if(m_readyWaitId.load(std::memory_order_acquire) < m_waitId) {
+        // still waiting
+        return NodeStatus::Running;
+    }
+    m_pWatchSubscriber.reset();
+
+    auto handle = m_task.GetHandle();
+    handle.resume();
+    if(!handle.done()) {
+        return NodeStatus::Running;
+    }
+
+    const auto exptr = handle.promise().exptr;
+    const auto nodeStatus = handle.promise().nodeStatus;
+    Reset();
+    if(exptr) {
+        std::rethrow_exception(exptr);
+    }
+    if(nodeStatus == NodeStatus::Idle or nodeStatus == NodeStatus::Running) {
+        throw util::LogicError("CoroutineActionNode [", GetNodeName(), "]: Run() must co_return SUCCESS or FAILURE");
+    }
+    return nodeStatus;
+}
+
+void CoroutineActionNode::Arm(const Awaiter &rAwaiter) {
+    const uint64_t waitId = ++m_waitId;
+    switch(rAwaiter.m_kind) {
+        case Awaiter::Kind::NextTick: {
+            m_readyWaitId.store(waitId, std::memory_order_release);
+        } break;
+        case Awaiter::Kind::Sleep: {
+            if(!m_pTimerQueue) {
+                m_pTimerQueue = std::make_unique<TimerQueue<>>();
+            }
+            m_pTimerQueue->Add(rAwaiter.m_duration, [this, waitId](bool aborted) {
+                if(!aborted) {
+                    Wake(waitId);
+                }
+            });
+        } break;
+        case Awaiter::Kind::EntryUpdate: {
+            const auto &pBlackboard = GetConfig().pBlackboard;
+            if(!pBlackboard) {
+                throw util::RuntimeError("CoroutineActionNode [", GetNodeName(), "]: no blackboard to watch [", rAwaiter.m_key, "]");
+            }
+            m_pWatchSubscriber = pBlackboard->Watch(rAwaiter.m_key, [this, waitId](const std::string &, Blackboard::EntryEvent) {
+                Wake(waitId);
+            });
+        } break;
+        case Awaiter::Kind::Signal: {
+            std::unique_lock lock(m_signalMutex);
+            if(m_signalPending) {
+                // Notify() came first
+                m_signalPending = false;
+                m_readyWaitId.store(waitId, std::memory_order_release);
+            } else {
+                m_signalWaitId = waitId;
+            }
+        } break;
+    }
+}
+
+void CoroutineActionNode::Wake(uint64_t waitId) {
+    // signals of previous suspensions must not hide the current one
+    uint64_t readyWaitId = m_readyWaitId.load(std::memory_order_relaxed);
+    while(readyWaitId < waitId) {
+        if(m_readyWaitId.compare_exchange_weak(readyWaitId, waitId, std::memory_order_release, std::memory_order_relaxed)) {
+            EmitWakeUpSignal();
+            return;
+        }
+    }
+}
+
+void CoroutineActionNode::Reset() {
+    m_task.Destroy();
+    m_pWatchSubscriber.reset();
+    if(m_pTimerQueue) {
+        m_pTimerQueue->CancelAll();
+    }
+    std::unique_lock lock(m_signalMutex);
+    m_signalWaitId = 0;
+    m_signalPending = false;
+}
+
+}// namespace behaviortree
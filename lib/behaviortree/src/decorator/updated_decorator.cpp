@@ -16,6 +16,14 @@ EntryUpdatedDecorator::EntryUpdatedDecorator(const std::string &rName, const Nod
     } else {
         m_entryKey = entryStr;
     }
+
+    if(m_ifNotUpdated == NodeStatus::Running and rConfig.pBlackboard) {
+        // Capturing this is safe: m_pWatchSubscriber is destroyed before the
+        // TreeNode base, and its destruction waits for a running callback.
+        m_pWatchSubscriber = rConfig.pBlackboard->Watch(m_entryKey, [this](const std::string &, Blackboard::EntryEvent) {
+            EmitWakeUpSignal();
+        });
+    }
 }
 
 NodeStatus EntryUpdatedDecorator::Tick() {
@@ -4,7 +4,13 @@ import common.shared_library;
 
 #include "behaviortree/factory.h"
 
+#include <algorithm>
+#include <optional>
+
+#include "behaviortree/compiled_tree.h"
+#include "behaviortree/decorator/subtree_node.h"
 #include "behaviortree/json_parser.h"
+#include "behaviortree/util/clock.h"
 #include "behaviortree/util/wildcards.hpp"
 #include "nlohmann/json.hpp"
 
@@ -19,8 +25,13 @@ struct BehaviorTreeFactory::PImpl {
     std::set<std::string> builtinIdSet;
     std::unordered_map<std::string, Any> behaviortreeDefinitionsMap;
     std::shared_ptr<std::unordered_map<std::string, int>> pScriptingEnums;
-    std::shared_ptr<behaviortree::Parser> pParser;
+    std::shared_ptr<JsonParser> pParser;
     std::unordered_map<std::string, SubstitutionRule> substitutionRulesMap;
+
+    std::mutex treeTemplateMutex;
+    std::unordered_map<std::string, TreeTemplate::Ptr> treeTemplateMap;
+
+    size_t treeArenaSize{0};
 };
 
 BehaviorTreeFactory::BehaviorTreeFactory(): m_pPImpl(new PImpl) {
@@ -106,6 +117,7 @@ bool BehaviorTreeFactory::UnregisterBuilder(const std::string &rId) {
     }
     m_pPImpl->builderMap.erase(rId);
     m_pPImpl->manifestMap.erase(rId);
+    InvalidateTreeTemplates();
     return true;
 }
 
@@ -117,6 +129,7 @@ void BehaviorTreeFactory::RegisterBuilder(const TreeNodeManifest &rManifest, con
 
     m_pPImpl->builderMap.insert({rManifest.registrationId, rBuilder});
     m_pPImpl->manifestMap.insert({rManifest.registrationId, rManifest});
+    InvalidateTreeTemplates();
 }
 
 void BehaviorTreeFactory::RegisterSimpleCondition(const std::string &rName, const SimpleConditionNode::TickFunctor &rTickFunctor, PortMap portMap) {
@@ -161,10 +174,21 @@ void BehaviorTreeFactory::RegisterFromPlugin(const std::string &rFilePath) {
 
 void BehaviorTreeFactory::RegisterBehaviorTreeFromFile(const std::filesystem::path &rFileName) {
     m_pPImpl->pParser->LoadFromFile(rFileName);
+    InvalidateTreeTemplates();
 }
 
 void BehaviorTreeFactory::RegisterBehaviorTreeFromText(const std::string &rJsonText) {
     m_pPImpl->pParser->LoadFromText(rJsonText);
+    InvalidateTreeTemplates();
+}
+
+void BehaviorTreeFactory::SavePrecompiledBehaviorTrees(const std::filesystem::path &rFileName) const {
+    m_pPImpl->pParser->SavePrecompiled(rFileName);
+}
+
+void BehaviorTreeFactory::RegisterBehaviorTreeFromPrecompiled(const std::filesystem::path &rFileName) {
+    m_pPImpl->pParser->LoadPrecompiled(rFileName);
+    InvalidateTreeTemplates();
 }
 
 std::vector<std::string> BehaviorTreeFactory::GetRegisteredTreeName() const {
@@ -173,9 +197,10 @@ std::vector<std::string> BehaviorTreeFactory::GetRegisteredTreeName() const {
 
 void BehaviorTreeFactory::ClearRegisteredBehaviorTrees() {
     m_pPImpl->pParser->ClearInternalState();
+    InvalidateTreeTemplates();
 }
 
-std::unique_ptr<TreeNode> BehaviorTreeFactory::InstantiateTreeNode(const std::string &rName, const std::string &rId, const NodeConfig &rConfig) const {
+NodeBuilder BehaviorTreeFactory::GetNodeBuilder(const std::string &rName, const std::string &rId, const NodeConfig &rConfig) const {
     auto idNotFound = [this, rId] {
         std::cerr << rId << " not included in this list:" << std::endl;
         for(const auto &rBuilderIter: m_pPImpl->builderMap) {
@@ -189,9 +214,6 @@ std::unique_ptr<TreeNode> BehaviorTreeFactory::InstantiateTreeNode(const std::st
         idNotFound();
     }
 
-    std::unique_ptr<TreeNode> node;
-
-    bool substituted = false;
     for(const auto &[filter, rule]: m_pPImpl->substitutionRulesMap) {
         if(filter == rName or filter == rId or wildcards::match(rConfig.path, filter)) {
             // first case: the rule is simply a string with the name of the
@@ -199,47 +221,36 @@ std::unique_ptr<TreeNode> BehaviorTreeFactory::InstantiateTreeNode(const std::st
             if(const auto pSbstitutedId = std::get_if<std::string>(&rule)) {
                 auto builderIter = m_pPImpl->builderMap.find(*pSbstitutedId);
                 if(builderIter != m_pPImpl->builderMap.end()) {
-                    auto &rBuilder = builderIter->second;
-                    node = rBuilder(rName, rConfig);
-                } else {
-                    throw util::RuntimeError("Substituted Node ID [", *pSbstitutedId, "] not found");
+                    return builderIter->second;
                 }
-                substituted = true;
-                break;
+                throw util::RuntimeError("Substituted Node ID [", *pSbstitutedId, "] not found");
             } else if(const auto pTestConfig = std::get_if<TestNodeConfig>(&rule)) {
                 // second case, the varian is a TestNodeConfig
-                auto pTestNode = new TestNode(rName, rConfig, *pTestConfig);
-                node.reset(pTestNode);
-                substituted = true;
-                break;
+                return [testConfig = *pTestConfig](const std::string &rNodeName, const NodeConfig &rNodeConfig) {
+                    return std::make_unique<TestNode>(rNodeName, rNodeConfig, testConfig);
+                };
             }
         }
     }
 
     // No substitution rule applied: default behavior
-    if(!substituted) {
-        auto it_builder = m_pPImpl->builderMap.find(rId);
-        if(it_builder == m_pPImpl->builderMap.end()) {
-            idNotFound();
-        }
-        auto &rBuilder = it_builder->second;
-        node = rBuilder(rName, rConfig);
+    auto it_builder = m_pPImpl->builderMap.find(rId);
+    if(it_builder == m_pPImpl->builderMap.end()) {
+        idNotFound();
     }
+    return it_builder->second;
+}
+
+std::unique_ptr<TreeNode> BehaviorTreeFactory::InstantiateTreeNode(const std::string &rName, const std::string &rId, const NodeConfig &rConfig) const {
+    std::unique_ptr<TreeNode> node = GetNodeBuilder(rName, rId, rConfig)(rName, rConfig);
 
     node->SetRegistrationId(rId);
     node->GetConfig().pEnums = m_pPImpl->pScriptingEnums;
 
-    auto assignConditions = [](auto &rConditions, auto &rExecutors) {
-        for(const auto &[rCondId, rScript]: rConditions) {
-            if(auto executor = ParseScript(rScript)) {
-                rExecutors[size_t(rCondId)] = executor.value();
-            } else {
-                throw util::LogicError("Error in the script \"", rScript, "\"\n", executor.error());
-            }
-        }
-    };
-    assignConditions(rConfig.preConditionMap, node->PreConditionsScripts());
-    assignConditions(rConfig.postConditionMap, node->PostConditionsScripts());
+    AssignConditionScripts(*node);
+
+    // the config might have been assigned after the construction (see TreeNode::Instantiate)
+    node->ResolvePortBindings();
 
     return node;
 }
@@ -268,8 +279,14 @@ Tree BehaviorTreeFactory::CreateTreeFromText(const std::string &rText, const Bla
     }
     JsonParser parser(*this);
     parser.LoadFromText(rText);
+    auto pArena = CreateTreeArena();
+    std::optional<TreeArena::Scope> arenaScope;
+    if(pArena) {
+        arenaScope.emplace(pArena);
+    }
     auto tree = parser.InstantiateTree(pBlackboard);
     tree.m_manifestsMap = this->GetManifest();
+    tree.m_pArena = std::move(pArena);
     return tree;
 }
 
@@ -286,17 +303,220 @@ Tree BehaviorTreeFactory::CreateTreeFromFile(const std::filesystem::path &rFileP
 
     JsonParser parser(*this);
     parser.LoadFromFile(rFilePath);
+    auto pArena = CreateTreeArena();
+    std::optional<TreeArena::Scope> arenaScope;
+    if(pArena) {
+        arenaScope.emplace(pArena);
+    }
     auto tree = parser.InstantiateTree(pBlackboard);
     tree.m_manifestsMap = this->GetManifest();
+    tree.m_pArena = std::move(pArena);
     return tree;
 }
 
 Tree BehaviorTreeFactory::CreateTree(const std::string &rTreeName, Blackboard::Ptr pBlackboard) {
+    auto pArena = CreateTreeArena();
+    std::optional<TreeArena::Scope> arenaScope;
+    if(pArena) {
+        arenaScope.emplace(pArena);
+    }
     auto tree = m_pPImpl->pParser->InstantiateTree(pBlackboard, rTreeName);
     tree.m_manifestsMap = this->GetManifest();
+    tree.m_pArena = std::move(pArena);
+    return tree;
+}
+
+void BehaviorTreeFactory::SetTreeArenaSize(size_t initialSize) {
+    m_pPImpl->treeArenaSize = initialSize;
+}
+
+TreeArena::Ptr BehaviorTreeFactory::CreateTreeArena(size_t sizeHint) const {
+    if(m_pPImpl->treeArenaSize == 0) {
+        return nullptr;
+    }
+    return TreeArena::Create(std::max(m_pPImpl->treeArenaSize, sizeHint));
+}
+
+TreeTemplate::Ptr BehaviorTreeFactory::GetTreeTemplate(const std::string &rTreeName) {
+    {
+        std::unique_lock lock(m_pPImpl->treeTemplateMutex);
+        auto iter = m_pPImpl->treeTemplateMap.find(rTreeName);
+        if(iter != m_pPImpl->treeTemplateMap.end()) {
+            return iter->second;
+        }
+    }
+
+    // instantiate the tree once through the parser, then record how it was built
+    Tree prototype = m_pPImpl->pParser->InstantiateTree(Blackboard::Create(), rTreeName);
+
+    auto pTemplate = std::make_shared<TreeTemplate>();
+    pTemplate->m_treeId = rTreeName;
+    pTemplate->m_uidCounter = prototype.m_uidCounter;
+
+    std::unordered_map<const Blackboard *, int32_t> subtreeIdxMap;
+    std::unordered_map<const TreeNode *, uint32_t> nodeIdxMap;
+    for(const auto &pSubtree: prototype.m_subtreeVec) {
+        TreeTemplate::SubtreeSpec subtreeSpec;
+        subtreeSpec.pPrototype = pSubtree->pBlackboard;
+        subtreeSpec.instanceName = pSubtree->instanceName;
+        subtreeSpec.treeId = pSubtree->treeId;
+        if(!pTemplate->m_subtreeSpecVec.empty()) {
+            subtreeSpec.parentIdx = subtreeIdxMap.at(pSubtree->pBlackboard->Parent().get());
+        }
+        const auto subtreeIdx = static_cast<uint32_t>(pTemplate->m_subtreeSpecVec.size());
+        subtreeIdxMap.insert({pSubtree->pBlackboard.get(), subtreeIdx});
+        pTemplate->m_subtreeSpecVec.push_back(std::move(subtreeSpec));
+
+        for(const auto &pNode: pSubtree->nodeVec) {
+            TreeTemplate::NodeSpec nodeSpec;
+            nodeSpec.name = pNode->GetNodeName();
+            nodeSpec.registrationId = pNode->GetRegistrAtionName();
+            nodeSpec.config = pNode->GetConfig();
+            nodeSpec.config.pBlackboard = nullptr;
+            nodeSpec.builder = GetNodeBuilder(nodeSpec.name, nodeSpec.registrationId, nodeSpec.config);
+            nodeSpec.subtreeIdx = subtreeIdx;
+            if(auto pSubtreeNode = dynamic_cast<const SubtreeNode *>(pNode.get())) {
+                nodeSpec.subtreeId = pSubtreeNode->GetSubtreeId();
+            }
+            nodeIdxMap.insert({pNode.get(), static_cast<uint32_t>(pTemplate->m_nodeSpecVec.size())});
+            pTemplate->m_nodeSpecVec.push_back(std::move(nodeSpec));
+
+            auto manifestIter = m_pPImpl->manifestMap.find(pNode->GetRegistrAtionName());
+            if(manifestIter != m_pPImpl->manifestMap.end()) {
+                pTemplate->m_manifestsMap.insert(*manifestIter);
+            }
+        }
+    }
+
+    // links, in the same order used by the parser
+    for(const auto &pSubtree: prototype.m_subtreeVec) {
+        for(const auto &pNode: pSubtree->nodeVec) {
+            auto &rNodeSpec = pTemplate->m_nodeSpecVec[nodeIdxMap.at(pNode.get())];
+            if(auto pControlNode = dynamic_cast<const ControlNode *>(pNode.get())) {
+                for(const TreeNode *pChildNode: pControlNode->GetChildrenNode()) {
+                    rNodeSpec.childIdxVec.push_back(nodeIdxMap.at(pChildNode));
+                }
+            } else if(auto pDecoratorNode = dynamic_cast<const DecoratorNode *>(pNode.get())) {
+                if(const TreeNode *pChildNode = pDecoratorNode->GetChildNode()) {
+                    rNodeSpec.childIdxVec.push_back(nodeIdxMap.at(pChildNode));
+                }
+            }
+        }
+    }
+
+    std::unique_lock lock(m_pPImpl->treeTemplateMutex);
+    m_pPImpl->treeTemplateMap[rTreeName] = pTemplate;
+    return pTemplate;
+}
+
+Tree BehaviorTreeFactory::CreateTree(const TreeTemplate &rTemplate, Blackboard::Ptr pBlackboard) const {
+    if(!pBlackboard) {
+        throw util::RuntimeError("BehaviorTreeFactory::CreateTree needs a non-Empty blackboard");
+    }
+    Tree tree;
+
+    // blackboards: the main tree uses the one of the caller, that must
+    // contain the entries of the ports remapped by the main tree
+    std::vector<Blackboard::Ptr> blackboardVec;
+    blackboardVec.reserve(rTemplate.m_subtreeSpecVec.size());
+    for(const auto &rSubtreeSpec: rTemplate.m_subtreeSpecVec) {
+        if(rSubtreeSpec.parentIdx < 0) {
+            for(auto key: rSubtreeSpec.pPrototype->GetKeys()) {
+                const std::string portKey(key);
+                const TypeInfo &rPortInfo = *rSubtreeSpec.pPrototype->GetEntryInfo(portKey);
+                if(auto pPrevInfo = pBlackboard->GetEntryInfo(portKey)) {
+                    const bool portTypeMismatch = pPrevInfo->IsStronglyTyped() and rPortInfo.IsStronglyTyped() and pPrevInfo->Type() != rPortInfo.Type();
+                    if(portTypeMismatch and pPrevInfo->Type() != typeid(std::string)) {
+                        throw util::RuntimeError("The creation of the tree failed because the port [", portKey, "] was initially created with Type [", Demangle(pPrevInfo->Type()), "] and, later Type [", Demangle(rPortInfo.Type()), "] was used somewhere else.");
+                    }
+                } else {
+                    pBlackboard->CreateEntry(portKey, rPortInfo);
+                }
+            }
+            blackboardVec.push_back(pBlackboard);
+        } else {
+            blackboardVec.push_back(rSubtreeSpec.pPrototype->Clone(blackboardVec[rSubtreeSpec.parentIdx]));
+        }
+
+        auto pSubtree = std::make_shared<Tree::Subtree>();
+        pSubtree->pBlackboard = blackboardVec.back();
+        pSubtree->instanceName = rSubtreeSpec.instanceName;
+        pSubtree->treeId = rSubtreeSpec.treeId;
+        tree.m_subtreeVec.push_back(std::move(pSubtree));
+    }
+
+    // nodes
+    auto pArena = CreateTreeArena(rTemplate.m_arenaSizeHint.load(std::memory_order_relaxed));
+    std::optional<TreeArena::Scope> arenaScope;
+    if(pArena) {
+        arenaScope.emplace(pArena);
+    }
+    std::vector<TreeNode *> nodeVec;
+    nodeVec.reserve(rTemplate.m_nodeSpecVec.size());
+    for(const auto &rNodeSpec: rTemplate.m_nodeSpecVec) {
+        NodeConfig config = rNodeSpec.config;
+        config.pBlackboard = blackboardVec[rNodeSpec.subtreeIdx];
+
+        TreeNode::Ptr pNode = rNodeSpec.builder(rNodeSpec.name, config);
+        pNode->SetRegistrationId(rNodeSpec.registrationId);
+        pNode->GetConfig().pEnums = m_pPImpl->pScriptingEnums;
+        // parsed once per text, but bound to the blackboard of this instance
+        AssignConditionScripts(*pNode);
+        pNode->ResolvePortBindings();
+        if(!rNodeSpec.subtreeId.empty()) {
+            if(auto pSubtreeNode = dynamic_cast<SubtreeNode *>(pNode.get())) {
+                pSubtreeNode->SetSubtreeId(rNodeSpec.subtreeId);
+            }
+        }
+
+        nodeVec.push_back(pNode.get());
+        tree.m_subtreeVec[rNodeSpec.subtreeIdx]->nodeVec.push_back(std::move(pNode));
+    }
+
+    for(size_t i = 0; i < nodeVec.size(); i++) {
+        for(uint32_t childIdx: rTemplate.m_nodeSpecVec[i].childIdxVec) {
+            if(auto pControlNode = dynamic_cast<ControlNode *>(nodeVec[i])) {
+                pControlNode->AddChildNode(nodeVec[childIdx]);
+            } else if(auto pDecoratorNode = dynamic_cast<DecoratorNode *>(nodeVec[i])) {
+                pDecoratorNode->SetChildNode(nodeVec[childIdx]);
+            }
+        }
+    }
+
+    if(pArena) {
+        arenaScope.reset();
+        rTemplate.m_arenaSizeHint.store(pArena->GetAllocatedBytes(), std::memory_order_relaxed);
+    }
+
+    tree.m_uidCounter = rTemplate.m_uidCounter;
+    tree.m_manifestsMap = rTemplate.m_manifestsMap;
+    tree.m_pArena = std::move(pArena);
+    tree.Initialize();
     return tree;
 }
 
+void BehaviorTreeFactory::AssignConditionScripts(TreeNode &rNode) {
+    // the scripts are bound to the blackboard and the enums of the node
+    const auto &rConfig = rNode.GetConfig();
+    const Ast::Environment env = {rConfig.pBlackboard, rConfig.pEnums};
+    auto assignConditions = [&env](auto &rConditions, auto &rExecutors) {
+        for(const auto &[rCondId, rScript]: rConditions) {
+            if(auto executor = ParseScript(rScript, env)) {
+                rExecutors[size_t(rCondId)] = executor.value();
+            } else {
+                throw util::LogicError("Error in the script \"", rScript, "\"\n", executor.error());
+            }
+        }
+    };
+    assignConditions(rConfig.preConditionMap, rNode.PreConditionsScripts());
+    assignConditions(rConfig.postConditionMap, rNode.PostConditionsScripts());
+}
+
+void BehaviorTreeFactory::InvalidateTreeTemplates() {
+    std::unique_lock lock(m_pPImpl->treeTemplateMutex);
+    m_pPImpl->treeTemplateMap.clear();
+}
+
 void BehaviorTreeFactory::AddMetadataToManifest(const std::string &rNodeId, const MetedataVec &rMetadata) {
     auto iter = m_pPImpl->manifestMap.find(rNodeId);
     if(iter == m_pPImpl->manifestMap.end()) {
@@ -321,10 +541,12 @@ void BehaviorTreeFactory::RegisterScriptingEnum(std::string_view name, int value
 
 void BehaviorTreeFactory::ClearSubstitutionRules() {
     m_pPImpl->substitutionRulesMap.clear();
+    InvalidateTreeTemplates();
 }
 
 void BehaviorTreeFactory::AddSubstitutionRule(std::string_view filter, SubstitutionRule rule) {
     m_pPImpl->substitutionRulesMap[std::string(filter)] = rule;
+    InvalidateTreeTemplates();
 }
 
 void BehaviorTreeFactory::LoadSubstitutionRuleFromJSON(const std::string &rJsonText) {
@@ -372,6 +594,10 @@ Tree &Tree::operator=(Tree &&rOther) {
     m_subtreeVec = std::move(rOther.m_subtreeVec);
     m_manifestsMap = std::move(rOther.m_manifestsMap);
     m_wakeUp = rOther.m_wakeUp;
+    m_pCompiledTree = std::move(rOther.m_pCompiledTree);
+    m_watchSubscriberVec = std::move(rOther.m_watchSubscriberVec);
+    m_pArena = std::move(rOther.m_pArena);
+    m_pFrameAllocator = std::move(rOther.m_pFrameAllocator);
     return *this;
 }
 
@@ -386,6 +612,15 @@ void Tree::Initialize() {
     for(auto &rSubtree: m_subtreeVec) {
         for(auto &rNode: rSubtree->nodeVec) {
             rNode->SetWakeUpInstance(m_wakeUp);
+            if(auto pCoroNode = dynamic_cast<CoroutineActionNode *>(rNode.get())) {
+                // shared by all the coroutines of the tree
+                if(!m_pFrameAllocator) {
+                    m_pFrameAllocator = std::make_shared<CoroFrameAllocator>();
+                }
+                if(pCoroNode->GetFrameAllocator() != m_pFrameAllocator.get()) {
+                    pCoroNode->SetFrameAllocator(m_pFrameAllocator);
+                }
+            }
         }
     }
 }
@@ -394,6 +629,10 @@ void Tree::HaltTree() {
     if(!GetRootNode()) {
         return;
     }
+    if(m_pCompiledTree) {
+        m_pCompiledTree->Halt();
+    }
+
     // the halt should propagate to all the node if the nodes
     // have been implemented correctly
     GetRootNode()->HaltNode();
@@ -435,6 +674,55 @@ NodeStatus Tree::TickWhileRunning(std::chrono::milliseconds sleepTime) {
     return TickRoot(WhileRunning, sleepTime);
 }
 
+NodeStatus Tree::TickWhileRunningOnEvent(std::chrono::milliseconds maxInterval) {
+    return TickRoot(WhileRunningOnEvent, maxInterval);
+}
+
+void Tree::Compile() {
+    if(!m_wakeUp) {
+        Initialize();
+    }
+    m_pCompiledTree = std::make_unique<CompiledTree>(GetRootNode());
+}
+
+const CompiledTree *Tree::GetCompiledTree() const {
+    return m_pCompiledTree.get();
+}
+
+void Tree::WakeUpOnBlackboardUpdate(const std::string &rPrefix) {
+    if(!m_wakeUp) {
+        Initialize();
+    }
+    std::weak_ptr<WakeUpSignal> pWeakWakeUp = m_wakeUp;
+    auto callback = [pWeakWakeUp](const std::string &, Blackboard::EntryEvent) {
+        if(auto pWakeUp = pWeakWakeUp.lock()) {
+            pWakeUp->EmitSignal();
+        }
+    };
+    for(const auto &rSubtree: m_subtreeVec) {
+        if(rSubtree->pBlackboard) {
+            m_watchSubscriberVec.push_back(rSubtree->pBlackboard->WatchPrefix(rPrefix, callback));
+        }
+    }
+}
+
+void Tree::SetActionPool(ActionPool::Ptr pPool, size_t maxInFlight) {
+    if(!pPool) {
+        pPool = ActionPool::GetDefault();
+    }
+    ActionPool::Limit::Ptr pLimit;
+    if(maxInFlight > 0) {
+        pLimit = std::make_shared<ActionPool::Limit>(maxInFlight);
+    }
+    for(const auto &rSubtree: m_subtreeVec) {
+        for(const auto &rNode: rSubtree->nodeVec) {
+            if(auto pAction = dynamic_cast<ThreadedAction *>(rNode.get())) {
+                pAction->SetActionPool(pPool, pLimit);
+            }
+        }
+    }
+}
+
 Blackboard::Ptr Tree::RootBlackboard() {
     if(m_subtreeVec.size() > 0) {
         return m_subtreeVec.front()->pBlackboard;
@@ -466,19 +754,37 @@ NodeStatus Tree::TickRoot(TickOption opt, std::chrono::milliseconds sleepTime) {
         throw util::RuntimeError("Empty Tree");
     }
 
-    while(nodeStatus == NodeStatus::Idle or (opt == TickOption::WhileRunning and nodeStatus == NodeStatus::Running)) {
-        nodeStatus = GetRootNode()->ExecuteTick();
+    auto tickRoot = [this]() {
+        // in Clock::Mode::TickCached, all the stamps of a tick have the same time
+        Clock::TickScope tickScope;
+        // the compiled program resets itself once completed
+        return m_pCompiledTree ? m_pCompiledTree->Tick() : GetRootNode()->ExecuteTick();
+    };
+
+    const bool whileRunning = opt == TickOption::WhileRunning or opt == TickOption::WhileRunningOnEvent;
+    while(nodeStatus == NodeStatus::Idle or (whileRunning and nodeStatus == NodeStatus::Running)) {
+        nodeStatus = tickRoot();
 
         // Inner loop. The previous tick might have triggered the wake-up
         // in this case, unless TickOption::EXACTLY_ONCE, we tick again
         while(opt != TickOption::ExactlyOnce and nodeStatus == NodeStatus::Running and m_wakeUp->WaitFor(std::chrono::milliseconds(0))) {
-            nodeStatus = GetRootNode()->ExecuteTick();
+            nodeStatus = tickRoot();
         }
 
-        if(IsNodeStatusCompleted(nodeStatus)) {
+        if(IsNodeStatusCompleted(nodeStatus) and !m_pCompiledTree) {
             GetRootNode()->ResetNodeStatus();
         }
-        if(nodeStatus == NodeStatus::Running and sleepTime.count() > 0) {
+        if(nodeStatus != NodeStatus::Running) {
+            continue;
+        }
+        if(opt == TickOption::WhileRunningOnEvent) {
+            // sleepTime is the heartbeat interval: zero means no heartbeat
+            if(sleepTime.count() > 0) {
+                Sleep(sleepTime);
+            } else {
+                m_wakeUp->Wait();
+            }
+        } else if(sleepTime.count() > 0) {
             Sleep(std::chrono::milliseconds(sleepTime));
         }
     }
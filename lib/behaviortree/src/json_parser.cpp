@@ -1,25 +1,39 @@
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
-#include <iostream>
-#include <list>
+#include <iterator>
+#include <memory>
+#include <set>
 #include <string>
+#include <string_view>
 #include <typeindex>
 #include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
 
 #if defined(__linux) or defined(__linux__)
 #    pragma GCC diagnostic push
 #    pragma GCC diagnostic ignored "-Wattributes"
 #endif
 
-#include <filesystem>
 #include <map>
 
 import common.exception;
 
 #include "behaviortree/blackboard.h"
+#include "behaviortree/control_node.h"
+#include "behaviortree/decorator/subtree_node.h"
+#include "behaviortree/decorator_node.h"
 #include "behaviortree/json_parser.h"
 #include "behaviortree/tree_node.h"
 #include "behaviortree/util/demangle_util.h"
@@ -27,44 +41,914 @@ import common.exception;
 #include "nlohmann/json.hpp"
 
 namespace behaviortree {
-auto StrEqual = [](const char *pStr1, const char *pStr2) -> bool {
-    return strcmp(pStr1, pStr2) == 0;
-};
-
 struct SubtreeModel {
     std::unordered_map<std::string, behaviortree::PortInfo> portMap;
 };
 
+namespace {
+/**
+ * @brief A node, as written in the document.
+ *
+ * The nodes of a tree are stored in pre-order: the first child of the node i
+ * is at i + 1, and the next sibling of a node is at its endIdx.
+ *
+ * The strings refer to the storage of the document (see Document::pStorage),
+ * that the parser keeps alive with the tree.
+ */
+struct NodeSpec {
+    // registration ID of the node, or one of Action, Condition, Control,
+    // Decorator and Subtree
+    std::string_view type;
+    // the other members of the node, in the order of the document: "id",
+    // "name", ports and scripts
+    std::vector<std::pair<std::string_view, std::string_view>> attributeVec;
+    uint32_t endIdx{0};
+    uint32_t childrenNum{0};
+
+    /// nullptr if the node doesn't have this attribute.
+    [[nodiscard]] const std::string_view *FindAttribute(std::string_view name) const {
+        for(const auto &[rName, rValue]: attributeVec) {
+            if(rName == name) {
+                return &rValue;
+            }
+        }
+        return nullptr;
+    }
+};
+
+struct TreeSpec {
+    std::vector<NodeSpec> nodeVec;
+};
+
+// what a document contains, before it is added to the parser
+struct Document {
+    // owner of the characters of the NodeSpecs: the text read from a JSON
+    // document, or the mapping of a precompiled file
+    std::shared_ptr<const void> pStorage;
+    std::string mainTreeId;
+    // the name is empty if the tree has no "treeName"
+    std::vector<std::pair<std::string, TreeSpec>> treeVec;
+    std::vector<std::pair<std::string, SubtreeModel>> subtreeModelVec;
+    std::vector<std::string> includeVec;
+};
+
+/**
+ * @brief DocumentReader receives the events of the SAX parser of nlohmann
+ * and builds the specs of the trees directly, in a single pass: the DOM of
+ * the document is never created.
+ *
+ * A document looks like:
+ *
+ *   {
+ *       "mainTreeToExecute": "MainTree",
+ *       "include": ["other_trees.json"],
+ *       "behaviortree": [
+ *           {
+ *               "treeName": "MainTree",
+ *               "root": {
+ *                   "type": "Sequence",
+ *                   "children": [
+ *                       {"type": "SaySomething", "message": "hello"},
+ *                       {"type": "Subtree", "id": "Child", "target": "{goal}"}
+ *                   ]
+ *               }
+ *           }
+ *       ],
+ *       "treeNodeModel": [
+ *           {"type": "Subtree", "id": "Child", "input": [{"name": "target"}]}
+ *       ]
+ *   }
+ *
+ * Every member of a node, except "type" and "children", is an attribute: a
+ * string, a number or a boolean; so a port can't be called "type" or
+ * "children". The other members the reader doesn't know are skipped.
+ */
+class DocumentReader final: public nlohmann::json_sax<nlohmann::json> {
+ public:
+    explicit DocumentReader(Document &rDocument): m_rDocument(rDocument), m_pStringDeque(std::make_shared<std::deque<std::string>>()) {
+        m_rDocument.pStorage = m_pStringDeque;
+    }
+
+    bool null() override {
+        // a null member is the same as a missing one
+        return true;
+    }
+
+    bool boolean(bool val) override {
+        return Value(val ? "true" : "false");
+    }
+
+    bool number_integer(number_integer_t val) override {
+        return Value(std::to_string(val));
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        return Value(std::to_string(val));
+    }
+
+    bool number_float(number_float_t, const string_t &rText) override {
+        // keep the number as written
+        return Value(std::string(rText));
+    }
+
+    bool string(string_t &rVal) override {
+        return Value(std::move(rVal));
+    }
+
+    bool binary(binary_t &) override {
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        return Enter(true);
+    }
+
+    bool key(string_t &rVal) override {
+        m_key = std::move(rVal);
+        return true;
+    }
+
+    bool end_object() override {
+        return Leave();
+    }
+
+    bool start_array(std::size_t) override {
+        return Enter(false);
+    }
+
+    bool end_array() override {
+        return Leave();
+    }
+
+    bool parse_error(std::size_t position, const std::string &, const nlohmann::detail::exception &rEx) override {
+        throw util::RuntimeError("Error parsing the JSON at byte ", std::to_string(position), ": ", rEx.what());
+    }
+
+ private:
+    enum class State : uint8_t {
+        Document,
+        TreeList,
+        Tree,
+        Node,
+        ChildList,
+        ModelList,
+        Model,
+        PortList,
+        Port,
+        IncludeList,
+        // content of a member that is ignored
+        Skip
+    };
+
+    struct Frame {
+        State state;
+        // index of the node, or direction of the ports
+        uint32_t idx{0};
+    };
+
+    Document &m_rDocument;
+    // the strings of the nodes; a deque doesn't move them when it grows
+    std::shared_ptr<std::deque<std::string>> m_pStringDeque;
+    std::vector<Frame> m_frameVec;
+    std::string m_key;
+
+    std::string m_modelType;
+    std::string m_modelId;
+    SubtreeModel m_model;
+    std::string m_portName;
+    PortInfo m_port;
+
+    std::string_view Store(std::string &&rText) {
+        return m_pStringDeque->emplace_back(std::move(rText));
+    }
+
+    [[nodiscard]] TreeSpec &CurrentTree() {
+        return m_rDocument.treeVec.back().second;
+    }
+
+    [[nodiscard]] std::string CurrentTreeName() const {
+        const auto &rName = m_rDocument.treeVec.back().first;
+        if(!rName.empty()) {
+            return rName;
+        }
+        return "#" + std::to_string(m_rDocument.treeVec.size() - 1);
+    }
+
+    uint32_t BeginNode() {
+        auto &rNodeVec = CurrentTree().nodeVec;
+        if(m_frameVec.back().state == State::ChildList) {
+            rNodeVec[m_frameVec[m_frameVec.size() - 2].idx].childrenNum++;
+        } else if(!rNodeVec.empty()) {
+            throw util::RuntimeError("The tree [", CurrentTreeName(), "] must have exactly 1 root node");
+        }
+        rNodeVec.emplace_back();
+        return uint32_t(rNodeVec.size() - 1);
+    }
+
+    bool Enter(bool isObject) {
+        if(m_frameVec.empty()) {
+            if(!isObject) {
+                throw util::RuntimeError("The root of a behavior tree document must be an object");
+            }
+            m_frameVec.push_back({State::Document});
+            return true;
+        }
+
+        Frame next{State::Skip};
+        switch(m_frameVec.back().state) {
+            case State::Document:
+                if(m_key == "behaviortree") {
+                    next.state = isObject ? State::Tree : State::TreeList;
+                } else if(m_key == "treeNodeModel" and !isObject) {
+                    next.state = State::ModelList;
+                } else if(m_key == "include" and !isObject) {
+                    next.state = State::IncludeList;
+                }
+                break;
+            case State::TreeList:
+                if(!isObject) {
+                    throw util::RuntimeError("[behaviortree] must contain objects, not arrays");
+                }
+                next.state = State::Tree;
+                break;
+            case State::Tree:
+                if(m_key == "root") {
+                    if(!isObject) {
+                        throw util::RuntimeError("The [root] of the tree [", CurrentTreeName(), "] must be an object");
+                    }
+                    next = {State::Node, BeginNode()};
+                }
+                break;
+            case State::Node:
+                if(m_key != "children") {
+                    throw util::RuntimeError("In the tree [", CurrentTreeName(), "], the member [", m_key, "] of a node must be a string, a number or a boolean");
+                }
+                if(isObject) {
+                    throw util::RuntimeError("In the tree [", CurrentTreeName(), "], [children] must be an array");
+                }
+                next.state = State::ChildList;
+                break;
+            case State::ChildList:
+                if(!isObject) {
+                    throw util::RuntimeError("In the tree [", CurrentTreeName(), "], [children] must contain objects, not arrays");
+                }
+                next = {State::Node, BeginNode()};
+                break;
+            case State::ModelList:
+                if(isObject) {
+                    next.state = State::Model;
+                    m_modelType.clear();
+                    m_modelId.clear();
+                    m_model = {};
+                }
+                break;
+            case State::Model:
+                if(!isObject and (m_key == "input" or m_key == "output" or m_key == "inOut")) {
+                    const auto direction = m_key == "input" ? PortDirection::In : (m_key == "output" ? PortDirection::Out : PortDirection::InOut);
+                    next = {State::PortList, uint32_t(direction)};
+                }
+                break;
+            case State::PortList:
+                if(isObject) {
+                    next.state = State::Port;
+                    m_portName.clear();
+                    m_port = PortInfo(PortDirection(m_frameVec.back().idx));
+                }
+                break;
+            case State::IncludeList:
+                throw util::RuntimeError("[include] must contain only the paths of the files");
+            default:
+                break;
+        }
+
+        if(next.state == State::Tree) {
+            m_rDocument.treeVec.emplace_back();
+        }
+        m_frameVec.push_back(next);
+        return true;
+    }
+
+    bool Leave() {
+        const Frame frame = m_frameVec.back();
+        m_frameVec.pop_back();
+
+        switch(frame.state) {
+            case State::Node: {
+                auto &rNodeVec = CurrentTree().nodeVec;
+                auto &rNode = rNodeVec[frame.idx];
+                if(rNode.type.empty()) {
+                    throw util::RuntimeError("In the tree [", CurrentTreeName(), "], a node doesn't have the member [type]");
+                }
+                rNode.endIdx = uint32_t(rNodeVec.size());
+                break;
+            }
+            case State::Tree: {
+                auto &rNodeVec = CurrentTree().nodeVec;
+                if(rNodeVec.empty()) {
+                    throw util::RuntimeError("The tree [", CurrentTreeName(), "] doesn't have a [root] node");
+                }
+                rNodeVec.shrink_to_fit();
+                break;
+            }
+            case State::Model:
+                // only the models of the subtrees are used by the parser
+                if(m_modelType == "Subtree") {
+                    if(m_modelId.empty()) {
+                        throw util::RuntimeError("Missing attribute [id] in a Subtree model");
+                    }
+                    m_rDocument.subtreeModelVec.emplace_back(std::move(m_modelId), std::move(m_model));
+                }
+                break;
+            case State::Port:
+                if(m_portName.empty()) {
+                    throw util::RuntimeError("Missing attribute [name] in port (Subtree model)");
+                }
+                m_model.portMap[std::move(m_portName)] = std::move(m_port);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool Value(std::string &&rText) {
+        if(m_frameVec.empty()) {
+            throw util::RuntimeError("The root of a behavior tree document must be an object");
+        }
+
+        switch(m_frameVec.back().state) {
+            case State::Document:
+                if(m_key == "mainTreeToExecute") {
+                    m_rDocument.mainTreeId = std::move(rText);
+                }
+                break;
+            case State::Tree:
+                if(m_key == "treeName") {
+                    m_rDocument.treeVec.back().first = std::move(rText);
+                }
+                break;
+            case State::Node: {
+                auto &rNode = CurrentTree().nodeVec[m_frameVec.back().idx];
+                if(m_key == "type") {
+                    rNode.type = Store(std::move(rText));
+                } else if(m_key == "children") {
+                    throw util::RuntimeError("In the tree [", CurrentTreeName(), "], [children] must be an array");
+                } else {
+                    rNode.attributeVec.emplace_back(Store(std::string(m_key)), Store(std::move(rText)));
+                }
+                break;
+            }
+            case State::Model:
+                if(m_key == "type") {
+                    m_modelType = std::move(rText);
+                } else if(m_key == "id") {
+                    m_modelId = std::move(rText);
+                }
+                break;
+            case State::Port:
+                if(m_key == "name") {
+                    m_portName = std::move(rText);
+                } else if(m_key == "default") {
+                    m_port.SetDefaultValue(rText);
+                } else if(m_key == "description") {
+                    m_port.SetDescription(rText);
+                }
+                break;
+            case State::IncludeList:
+                m_rDocument.includeVec.push_back(std::move(rText));
+                break;
+            case State::TreeList:
+            case State::ChildList:
+            case State::ModelList:
+            case State::PortList:
+                throw util::RuntimeError("Unexpected value [", rText, "] in an array of objects");
+            default:
+                break;
+        }
+        return true;
+    }
+};
+
+template<typename InputT>
+Document ReadDocument(InputT &&rInput) {
+    Document document;
+    DocumentReader reader(document);
+    // the errors are thrown by DocumentReader::parse_error()
+    nlohmann::json::sax_parse(std::forward<InputT>(rInput), &reader);
+    return document;
+}
+
+Document ReadDocumentFile(const std::filesystem::path &rFilepath) {
+    if(!std::filesystem::exists(rFilepath) or !std::filesystem::is_regular_file(rFilepath)) {
+        throw util::RuntimeError("file is not exists: ", rFilepath.string());
+    }
+
+    std::ifstream jsonFile(rFilepath, std::ios::binary);
+    if(!jsonFile) {
+        throw util::RuntimeError("read json file fail: ", rFilepath.string());
+    }
+    try {
+        return ReadDocument(jsonFile);
+    } catch(std::exception &ex) {
+        throw util::RuntimeError("read json file fail: ", rFilepath.string(), ": ", ex.what());
+    }
+}
+
+NodeType RegisteredType(NodeType type) {
+    return type;
+}
+
+NodeType RegisteredType(const TreeNodeManifest &rManifest) {
+    return rManifest.type;
+}
+
+/// Check the structure of a tree: the types of the nodes, their "id" and the
+/// number of their children.
+template<typename RegisteredMap>
+void VerifyTree(const std::string &rTreeName, const TreeSpec &rTree, const RegisteredMap &rRegisteredNodes) {
+    auto ThrowError = [&rTreeName](const NodeSpec &rNode, const std::string_view &rText) {
+        throw util::RuntimeError("Error in the tree [", rTreeName, "] -> The node <", rNode.type, "> ", rText);
+    };
+
+    if(rRegisteredNodes.count(rTreeName) != 0) {
+        throw util::RuntimeError("The name of the tree [", rTreeName, "] must not use the name of a registered Node");
+    }
+
+    for(const auto &rNode: rTree.nodeVec) {
+        const std::string_view *pId = rNode.FindAttribute("id");
+        const bool hasId = pId != nullptr and !pId->empty();
+
+        switch(ConvertFromString<NodeType>(rNode.type)) {
+            case NodeType::Decorator:
+                if(rNode.childrenNum != 1) {
+                    ThrowError(rNode, "must have exactly 1 child");
+                }
+                if(!hasId) {
+                    ThrowError(rNode, "must have the attribute [id]");
+                }
+                break;
+            case NodeType::Action:
+            case NodeType::Condition:
+                if(rNode.childrenNum != 0) {
+                    ThrowError(rNode, "must not have any child");
+                }
+                if(!hasId) {
+                    ThrowError(rNode, "must have the attribute [id]");
+                }
+                break;
+            case NodeType::Control:
+                if(rNode.childrenNum == 0) {
+                    ThrowError(rNode, "must have at least 1 child");
+                }
+                if(!hasId) {
+                    ThrowError(rNode, "must have the attribute [id]");
+                }
+                break;
+            case NodeType::Subtree:
+                if(rNode.childrenNum != 0) {
+                    ThrowError(rNode, "should not have any child");
+                }
+                if(!hasId) {
+                    ThrowError(rNode, "must have the attribute [id]");
+                }
+                if(rRegisteredNodes.count(std::string(*pId)) != 0) {
+                    ThrowError(rNode, "must not use the name of a registered Node as [id]");
+                }
+                break;
+            default: {
+                // search in the factory
+                const auto search = rRegisteredNodes.find(std::string(rNode.type));
+                if(search == rRegisteredNodes.end()) {
+                    throw util::RuntimeError("Error in the tree [", rTreeName, "] -> Node not recognized: ", rNode.type);
+                }
+                const NodeType type = RegisteredType(search->second);
+                if(type == NodeType::Decorator and rNode.childrenNum != 1) {
+                    ThrowError(rNode, "must have exactly 1 child");
+                } else if(type == NodeType::Control and rNode.childrenNum == 0) {
+                    ThrowError(rNode, "must have 1 or more children");
+                }
+                break;
+            }
+        }
+    }
+}
+
+//-------- precompiled trees -----------------
+
+// to change at each modification of the layout of the file
+constexpr uint32_t PRECOMPILED_VERSION = 2;
+constexpr char PRECOMPILED_MAGIC[8] = {'B', 'T', 'P', 'R', 'E', 'C', 'M', 'P'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+// index of a string that is not present
+constexpr uint32_t NO_STRING = UINT32_MAX;
+
+/**
+ * @brief Header of a file of precompiled trees.
+ *
+ * It is followed by the arrays of records, in this order: trees, nodes,
+ * attributes, subtree models, ports, registration IDs, strings, and the
+ * characters of the strings. The strings are interned, the records refer to
+ * them by index. The integers use the byte order of the machine that wrote
+ * the file.
+ *
+ * The nodes of the loaded trees refer to the strings in place: the parser
+ * keeps the file mapped as long as it holds the trees.
+ */
+struct PrecompiledHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    // hash of the manifests of the names checked against the registered nodes
+    uint64_t manifestHash;
+    uint32_t mainTreeStr;
+    uint32_t treesNum;
+    uint32_t nodesNum;
+    uint32_t attributesNum;
+    uint32_t subtreeModelsNum;
+    uint32_t portsNum;
+    uint32_t registrationIdsNum;
+    uint32_t stringsNum;
+    uint64_t charsNum;
+};
+
+struct TreeRecord {
+    uint32_t nameStr;
+    uint32_t firstNode;
+    uint32_t nodesNum;
+};
+
+struct NodeRecord {
+    uint32_t typeStr;
+    uint32_t firstAttribute;
+    uint32_t attributesNum;
+    // relative to the first node of the tree
+    uint32_t endIdx;
+    uint32_t childrenNum;
+};
+
+struct AttributeRecord {
+    uint32_t nameStr;
+    uint32_t valueStr;
+};
+
+struct SubtreeModelRecord {
+    uint32_t idStr;
+    uint32_t firstPort;
+    uint32_t portsNum;
+};
+
+struct PortRecord {
+    uint32_t nameStr;
+    uint32_t direction;
+    uint32_t defaultStr;
+    uint32_t descriptionStr;
+};
+
+struct StringRecord {
+    uint32_t offset;
+    uint32_t size;
+};
+
+static_assert(sizeof(PrecompiledHeader) % alignof(uint64_t) == 0);
+
+/// FNV-1a, stable across the platforms and the runs.
+class Fnv1aHash {
+ public:
+    void Add(uint64_t value) {
+        for(int i = 0; i < 8; i++) {
+            AddByte(uint8_t(value >> (i * 8)));
+        }
+    }
+
+    void Add(std::string_view str) {
+        Add(uint64_t(str.size()));
+        for(char c: str) {
+            AddByte(uint8_t(c));
+        }
+    }
+
+    [[nodiscard]] uint64_t Get() const {
+        return m_hash;
+    }
+
+ private:
+    uint64_t m_hash{14695981039346656037ull};
+
+    void AddByte(uint8_t byte) {
+        m_hash = (m_hash ^ byte) * 1099511628211ull;
+    }
+};
+
+/// Hash of what the verification of the trees depends on: the type and the
+/// ports of the nodes they use, and whether the names of the trees and of
+/// the subtrees are registered.
+uint64_t ManifestHash(const std::unordered_map<std::string, TreeNodeManifest> &rManifestMap, const std::vector<std::string_view> &rIdVec) {
+    Fnv1aHash hash;
+    hash.Add(PRECOMPILED_VERSION);
+    for(const auto &rId: rIdVec) {
+        hash.Add(rId);
+        auto manifestIt = rManifestMap.find(std::string(rId));
+        if(manifestIt == rManifestMap.end()) {
+            hash.Add(uint64_t(NodeType::Undefined));
+            continue;
+        }
+        const TreeNodeManifest &rManifest = manifestIt->second;
+        hash.Add(uint64_t(rManifest.type));
+
+        // the order of the PortMap is not stable
+        std::map<std::string_view, const PortInfo *> orderedPortMap;
+        for(const auto &[rName, rPortInfo]: rManifest.portMap) {
+            orderedPortMap.emplace(rName, &rPortInfo);
+        }
+        for(const auto &[rName, pPortInfo]: orderedPortMap) {
+            hash.Add(rName);
+            hash.Add(uint64_t(pPortInfo->Direction()));
+            hash.Add(pPortInfo->TypeName());
+            hash.Add(uint64_t(pPortInfo->IsStronglyTyped()));
+            hash.Add(pPortInfo->DefaultValueString());
+        }
+    }
+    return hash.Get();
+}
+
+/// Sorted names that VerifyTree() looks up in the registered nodes: the
+/// registration IDs of the nodes, the names of the trees and the IDs of the
+/// subtrees.
+std::vector<std::string> CollectRegistrationIds(const std::map<std::string, TreeSpec> &rTreeMap) {
+    std::set<std::string> idSet;
+    for(const auto &[rName, rTree]: rTreeMap) {
+        idSet.insert(rName);
+        for(const auto &rNode: rTree.nodeVec) {
+            const NodeType type = ConvertFromString<NodeType>(rNode.type);
+            if(type == NodeType::Undefined) {
+                idSet.emplace(rNode.type);
+            } else if(const std::string_view *pId = rNode.FindAttribute("id")) {
+                idSet.emplace(*pId);
+            }
+        }
+    }
+    return {idSet.begin(), idSet.end()};
+}
+
+/**
+ * @brief Read-only mapping of a whole file in memory.
+ * Where mmap is not available, the file is read instead.
+ */
+class MappedFile {
+ public:
+    explicit MappedFile(const std::filesystem::path &rFilepath) {
+#if defined(_WIN32)
+        std::ifstream file(rFilepath, std::ios::binary);
+        if(!file) {
+            throw util::RuntimeError("file is not exists: ", rFilepath.string());
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_pData = m_buffer.data();
+        m_size = m_buffer.size();
+#else
+        const int fd = open(rFilepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0) {
+            throw util::RuntimeError("file is not exists: ", rFilepath.string());
+        }
+        struct stat fileStat {};
+        if(fstat(fd, &fileStat) != 0) {
+            close(fd);
+            throw util::RuntimeError("read precompiled trees fail: ", rFilepath.string());
+        }
+        m_size = size_t(fileStat.st_size);
+        if(m_size != 0) {
+            void *pMapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(pMapping == MAP_FAILED) {
+                close(fd);
+                throw util::RuntimeError("map precompiled trees fail: ", rFilepath.string());
+            }
+            m_pData = static_cast<const char *>(pMapping);
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if(m_pData) {
+            munmap(const_cast<char *>(m_pData), m_size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &rOther) = delete;
+    MappedFile &operator=(const MappedFile &rOther) = delete;
+
+    [[nodiscard]] const char *Data() const {
+        return m_pData;
+    }
+
+    [[nodiscard]] size_t Size() const {
+        return m_size;
+    }
+
+ private:
+    const char *m_pData{nullptr};
+    size_t m_size{0};
+#if defined(_WIN32)
+    std::vector<char> m_buffer;
+#endif
+};
+
+/// Arrays of records following each other in a file, checked against its size.
+class SectionReader {
+ public:
+    SectionReader(const char *pData, size_t size, size_t offset): m_pData(pData), m_size(size), m_offset(offset) {}
+
+    template<typename T>
+    [[nodiscard]] const T *Next(uint64_t num) {
+        if(num > (m_size - m_offset) / sizeof(T)) {
+            throw util::RuntimeError("Invalid precompiled trees: the file is truncated");
+        }
+        const T *pArr = reinterpret_cast<const T *>(m_pData + m_offset);
+        m_offset += size_t(num) * sizeof(T);
+        return pArr;
+    }
+
+ private:
+    const char *m_pData;
+    size_t m_size;
+    size_t m_offset;
+};
+
+/**
+ * @brief Read a file written by JsonParser::SavePrecompiled(). The nodes of
+ * the Document refer to the strings of the mapping, that becomes the storage
+ * of the Document. Only the structure of the trees is checked: the nodes
+ * were verified when the file was written, as long as the manifests didn't
+ * change.
+ */
+Document ReadPrecompiled(std::shared_ptr<const MappedFile> pFile, const std::unordered_map<std::string, TreeNodeManifest> &rManifestMap) {
+    auto ThrowInvalid = [](const std::string_view &rReason) {
+        throw util::RuntimeError("Invalid precompiled trees: ", rReason);
+    };
+
+    const char *pData = pFile->Data();
+    const size_t size = pFile->Size();
+    PrecompiledHeader header;
+    if(size < sizeof(header)) {
+        ThrowInvalid("the file is truncated");
+    }
+    std::memcpy(&header, pData, sizeof(header));
+    if(std::memcmp(header.magic, PRECOMPILED_MAGIC, sizeof(PRECOMPILED_MAGIC)) != 0) {
+        ThrowInvalid("this is not a file of precompiled trees");
+    }
+    if(header.byteOrder != BYTE_ORDER_MARK) {
+        ThrowInvalid("the file was written with another byte order");
+    }
+    if(header.version != PRECOMPILED_VERSION) {
+        ThrowInvalid(util::StrCat("the version of the file is ", std::to_string(header.version), ", expected ", std::to_string(PRECOMPILED_VERSION)));
+    }
+
+    SectionReader reader(pData, size, sizeof(header));
+    const auto *pTreeArr = reader.Next<TreeRecord>(header.treesNum);
+    const auto *pNodeArr = reader.Next<NodeRecord>(header.nodesNum);
+    const auto *pAttributeArr = reader.Next<AttributeRecord>(header.attributesNum);
+    const auto *pModelArr = reader.Next<SubtreeModelRecord>(header.subtreeModelsNum);
+    const auto *pPortArr = reader.Next<PortRecord>(header.portsNum);
+    const auto *pIdArr = reader.Next<uint32_t>(header.registrationIdsNum);
+    const auto *pStringArr = reader.Next<StringRecord>(header.stringsNum);
+    const char *pChars = reader.Next<char>(header.charsNum);
+
+    for(uint32_t i = 0; i < header.stringsNum; i++) {
+        if(uint64_t(pStringArr[i].offset) + pStringArr[i].size > header.charsNum) {
+            ThrowInvalid("a string is out of bounds");
+        }
+    }
+    auto String = [&](uint32_t idx) -> std::string_view {
+        if(idx >= header.stringsNum) {
+            ThrowInvalid("a string is out of bounds");
+        }
+        return {pChars + pStringArr[idx].offset, pStringArr[idx].size};
+    };
+    auto CheckRange = [&](uint64_t first, uint64_t num, uint64_t total) {
+        if(first + num > total) {
+            ThrowInvalid("a record is out of bounds");
+        }
+    };
+
+    // validation against the manifests of the registered nodes
+    std::vector<std::string_view> idVec;
+    idVec.reserve(header.registrationIdsNum);
+    for(uint32_t i = 0; i < header.registrationIdsNum; i++) {
+        idVec.push_back(String(pIdArr[i]));
+    }
+    if(ManifestHash(rManifestMap, idVec) != header.manifestHash) {
+        throw util::RuntimeError("The precompiled trees were written for other manifests of the nodes: they must be compiled again");
+    }
+
+    Document document;
+    document.pStorage = std::move(pFile);
+    if(header.mainTreeStr != NO_STRING) {
+        document.mainTreeId = String(header.mainTreeStr);
+    }
+
+    document.treeVec.reserve(header.treesNum);
+    // end of the ancestors of the current node
+    std::vector<uint32_t> endStack;
+    for(uint32_t treeIdx = 0; treeIdx < header.treesNum; treeIdx++) {
+        const TreeRecord &rTreeRecord = pTreeArr[treeIdx];
+        CheckRange(rTreeRecord.firstNode, rTreeRecord.nodesNum, header.nodesNum);
+        const NodeRecord *pTreeNodeArr = pNodeArr + rTreeRecord.firstNode;
+        if(rTreeRecord.nodesNum == 0 or pTreeNodeArr[0].endIdx != rTreeRecord.nodesNum) {
+            ThrowInvalid("the structure of a tree is not valid");
+        }
+
+        auto &[rName, rTree] = document.treeVec.emplace_back(String(rTreeRecord.nameStr), TreeSpec());
+        rTree.nodeVec.resize(rTreeRecord.nodesNum);
+
+        endStack.assign(1, rTreeRecord.nodesNum);
+        for(uint32_t nodeIdx = 0; nodeIdx < rTreeRecord.nodesNum; nodeIdx++) {
+            const NodeRecord &rNodeRecord = pTreeNodeArr[nodeIdx];
+            while(nodeIdx >= endStack.back()) {
+                endStack.pop_back();
+            }
+            // the descendants of a node must be inside its parent
+            if(rNodeRecord.endIdx <= nodeIdx or rNodeRecord.endIdx > endStack.back()) {
+                ThrowInvalid(util::StrCat("the structure of the tree [", rName, "] is not valid"));
+            }
+            endStack.push_back(rNodeRecord.endIdx);
+
+            NodeSpec &rNode = rTree.nodeVec[nodeIdx];
+            rNode.type = String(rNodeRecord.typeStr);
+            rNode.endIdx = rNodeRecord.endIdx;
+            rNode.childrenNum = rNodeRecord.childrenNum;
+
+            CheckRange(rNodeRecord.firstAttribute, rNodeRecord.attributesNum, header.attributesNum);
+            rNode.attributeVec.reserve(rNodeRecord.attributesNum);
+            for(uint32_t i = 0; i < rNodeRecord.attributesNum; i++) {
+                const AttributeRecord &rAttribute = pAttributeArr[rNodeRecord.firstAttribute + i];
+                rNode.attributeVec.emplace_back(String(rAttribute.nameStr), String(rAttribute.valueStr));
+            }
+        }
+    }
+
+    document.subtreeModelVec.reserve(header.subtreeModelsNum);
+    for(uint32_t modelIdx = 0; modelIdx < header.subtreeModelsNum; modelIdx++) {
+        const SubtreeModelRecord &rModelRecord = pModelArr[modelIdx];
+        CheckRange(rModelRecord.firstPort, rModelRecord.portsNum, header.portsNum);
+
+        auto &[rId, rModel] = document.subtreeModelVec.emplace_back(String(rModelRecord.idStr), SubtreeModel());
+        for(uint32_t i = 0; i < rModelRecord.portsNum; i++) {
+            const PortRecord &rPortRecord = pPortArr[rModelRecord.firstPort + i];
+            if(rPortRecord.direction > uint32_t(PortDirection::InOut)) {
+                ThrowInvalid("the direction of a port is not valid");
+            }
+            PortInfo port(PortDirection(rPortRecord.direction));
+            if(rPortRecord.defaultStr != NO_STRING) {
+                port.SetDefaultValue(std::string(String(rPortRecord.defaultStr)));
+            }
+            if(rPortRecord.descriptionStr != NO_STRING) {
+                port.SetDescription(String(rPortRecord.descriptionStr));
+            }
+            rModel.portMap[std::string(String(rPortRecord.nameStr))] = std::move(port);
+        }
+    }
+    return document;
+}
+}// namespace
+
 struct JsonParser::PImpl {
-    TreeNode::Ptr CreateNodeFromJson(const XMLElement *pElement, const Blackboard::Ptr &rBlackboard, const TreeNode::Ptr &rNodeParent, const std::string &rPrefixPath, Tree &rOutputTree);
+    TreeNode::Ptr CreateNodeFromSpec(const NodeSpec &rSpec, const Blackboard::Ptr &rBlackboard, const TreeNode::Ptr &rNodeParent, const std::string &rPrefixPath, Tree &rOutputTree);
 
-    void RecursivelyCreateSubtree(const std::string &pParentNode, const std::string &pSubtree, const std::string &rPrefixPath, Tree &rOutputTree, Blackboard::Ptr pBlackboard, const TreeNode::Ptr &pRootNode);
+    void RecursivelyCreateSubtree(const std::string &rTreeId, const std::string &rTreePath, const std::string &rPrefixPath, Tree &rOutputTree, Blackboard::Ptr pBlackboard, const TreeNode::Ptr &pRootNode);
 
-    void GetPortsRecursively(const XMLElement *pElement, std::vector<std::string> &rOutputPortVec);
+    void LoadDocument(Document &&rDocument, bool addInclude);
 
-    void LoadJsonImpl(nlohmann::json &rJsonTree);
+    /// Add the trees and the models of a document that has been verified.
+    void RegisterDocument(Document &&rDocument);
 
-    std::list<nlohmann::json> openedJsonList;
-    std::map<std::string, const nlohmann::json *> treeMap;
+    std::map<std::string, TreeSpec> treeMap;
+    // storages of the documents, the strings of treeMap refer to them
+    std::vector<std::shared_ptr<const void>> storageVec;
 
     const BehaviorTreeFactory &rFactory;
 
     std::filesystem::path currentPath;
     std::map<std::string, SubtreeModel> subtreeModelMap;
 
+    // "mainTreeToExecute" of the first document loaded
+    std::string mainTreeId;
+    size_t documentsNum;
+
     int32_t suffixCount;
 
-    explicit PImpl(const BehaviorTreeFactory &rFact): rFactory(rFact), currentPath(std::filesystem::current_path()), suffixCount(0) {}
+    explicit PImpl(const BehaviorTreeFactory &rFact): rFactory(rFact), currentPath(std::filesystem::current_path()), documentsNum(0), suffixCount(0) {}
 
     void Clear() {
         suffixCount = 0;
+        documentsNum = 0;
         currentPath = std::filesystem::current_path();
-        openedJsonList.clear();
+        mainTreeId.clear();
         treeMap.clear();
+        storageVec.clear();
+        subtreeModelMap.clear();
     }
-
- private:
-    void LoadSubtreeModel(const nlohmann::json &);
 };
 
 #if defined(__linux) or defined(__linux__)
@@ -84,308 +968,181 @@ JsonParser &JsonParser::operator=(JsonParser &&rOther) noexcept {
 
 JsonParser::~JsonParser() = default;
 
-void JsonParser::LoadFromFile(const std::filesystem::path &rFilepath) {
-    if(!std::filesystem::exists(rFilepath) or !std::filesystem::is_regular_file(rFilepath)) {
-        throw util::RuntimeError("file is not exists: ", rFilepath.string());
-    }
-
-    nlohmann::json jsonTree;
-    try {
-        std::ifstream jsonFile(rFilepath);
-        jsonFile >> jsonTree;
-    } catch(std::exception &ex) {
-        throw util::RuntimeError("read json file fail: ", ex.what());
-    }
+void JsonParser::LoadFromFile(const std::filesystem::path &rFilepath, bool addInclude) {
+    Document document = ReadDocumentFile(rFilepath);
 
     m_pPImpl->currentPath = std::filesystem::absolute(rFilepath.parent_path());
 
-    m_pPImpl->LoadJsonImpl(jsonTree);
+    m_pPImpl->LoadDocument(std::move(document), addInclude);
 }
 
-void JsonParser::LoadFromText(const std::string_view &rText) {
-    nlohmann::json jsonTree = nlohmann::json::parse(rText);
-    m_pPImpl->LoadJsonImpl(rJsonTree);
+void JsonParser::LoadFromText(const std::string &rText, bool addInclude) {
+    m_pPImpl->LoadDocument(ReadDocument(rText), addInclude);
 }
 
 std::vector<std::string> JsonParser::GetRegisteredTreeName() const {
     std::vector<std::string> out;
-    for(const auto &[name, jsonTree]: m_pPImpl->treeMap) {
+    out.reserve(m_pPImpl->treeMap.size());
+    for(const auto &[name, treeSpec]: m_pPImpl->treeMap) {
         out.emplace_back(name);
     }
     return out;
 }
 
-void behaviortree::JsonParser::PImpl::LoadSubtreeModel(const nlohmann::json &rJsonTree) {
-    for(auto models_node = rJsonTree->FirstChildElement("TreeNodeModel"); models_node != nullptr; models_node = models_node->NextSiblingElement("TreeNodeModel")) {
-        for(auto sub_node = models_node->FirstChildElement("Subtree");
-            sub_node != nullptr;
-            sub_node = sub_node->NextSiblingElement("Subtree")) {
-            auto subtree_id = sub_node->Attribute("Id");
-            auto &subtree_model = subtreeModelMap[subtree_id];
-
-            std::pair<const std::string_view &, behaviortree::PortDirection> portType[3] = {
-                    {"Input", behaviortree::PortDirection::In},
-                    {"Output", behaviortree::PortDirection::Out},
-                    {"InOutPut", behaviortree::PortDirection::InOut}
-            };
-
-            for(const auto &[name, direction]: portType) {
-                for(auto port_node = sub_node->FirstChildElement(name);
-                    port_node != nullptr;
-                    port_node = port_node->NextSiblingElement(name)) {
-                    behaviortree::PortInfo port(direction);
-                    auto name = port_node->Attribute("name");
-                    if(!name) {
-                        throw util::RuntimeError("Missing attribute [name] in port (Subtree model)");
-                    }
-                    if(auto default_value = port_node->Attribute("default")) {
-                        port.SetDefaultValue(default_value);
-                    }
-                    if(auto description = port_node->Attribute("description")) {
-                        port.SetDescription(description);
-                    }
-                    subtree_model.portMap[name] = std::move(port);
-                }
-            }
+void JsonParser::PImpl::LoadDocument(Document &&rDocument, bool addInclude) {
+    // check the whole document before registering any of its trees
+    for(auto &[rName, rTree]: rDocument.treeVec) {
+        if(rName.empty()) {
+            rName = "behaviortree_" + std::to_string(suffixCount++);
         }
+        VerifyTree(rName, rTree, rFactory.GetManifest());
     }
-}
 
-void JsonParser::PImpl::LoadJsonImpl(nlohmann::json &rJsonTree) {
-    // Collect the names of all nodes registered with the behavior tree factory
-    std::unordered_map<std::string, behaviortree::NodeType> registeredNodeMap;
-    for(const auto &[name, treeNodeManifest]: rFactory.GetManifest()) {
-        registeredNodeMap.insert({name, treeNodeManifest.type});
+    auto includeVec = std::move(rDocument.includeVec);
+    RegisterDocument(std::move(rDocument));
+
+    if(!addInclude) {
+        return;
     }
+    for(const auto &rInclude: includeVec) {
+        std::filesystem::path filePath(rInclude);
+        if(filePath.is_relative()) {
+            filePath = currentPath / filePath;
+        }
+
+        Document includedDocument = ReadDocumentFile(filePath);
 
-    //    VerifyJson(rJsonTree, registeredNodeMap);
+        // the paths in the included file are relative to that file
+        auto previousPath = std::exchange(currentPath, std::filesystem::absolute(filePath.parent_path()));
+        LoadDocument(std::move(includedDocument), addInclude);
+        currentPath = std::move(previousPath);
+    }
+}
 
-    LoadSubtreeModel(rJsonTree);
+void JsonParser::PImpl::RegisterDocument(Document &&rDocument) {
+    if(documentsNum++ == 0) {
+        mainTreeId = std::move(rDocument.mainTreeId);
+    }
+    storageVec.push_back(std::move(rDocument.pStorage));
 
-    // Register each behaviortree within the json
-    for(auto &[rKey, rValue]: rJsonTree.items()) {
-        if(rKey == "behaviortree") {
-            std::string treeName;
-            if(rValue.contains("treeName")) {
-                treeName = rValue["treeName"].get<std::string>();
-            } else {
-                treeName = "behaviortree_" + std::to_string(suffixCount++);
-            }
+    for(auto &[rId, rModel]: rDocument.subtreeModelVec) {
+        subtreeModelMap[rId] = std::move(rModel);
+    }
 
-            treeMap[treeName] = &rValue;
-        }
+    // Register each behaviortree within the document
+    for(auto &[rName, rTree]: rDocument.treeVec) {
+        treeMap[rName] = std::move(rTree);
     }
 }
 
-void VerifyJson(const std::string &rJsonText, const std::unordered_map<std::string, behaviortree::NodeType> &rRegisteredNodes) {
-    XMLDocument doc;
-    auto xml_error = doc.Parse(rJsonText.c_str(), rJsonText.size());
-    if(xml_error) {
-        char buffer[512];
-        snprintf(buffer, sizeof buffer, "Error parsing the XML: %s", doc.ErrorName());
-        throw util::RuntimeError(buffer);
-    }
-
-    //-------- Helper functions (lambdas) -----------------
-    auto ThrowError = [&](int line_num, const std::string &text) {
-        char buffer[512];
-        snprintf(buffer, sizeof buffer, "Error at line %d: -> %s", line_num, text.c_str());
-        throw util::RuntimeError(buffer);
-    };
+void JsonParser::SavePrecompiled(const std::filesystem::path &rFilepath) const {
+    const PImpl &rImpl = *m_pPImpl;
 
-    auto ChildrenCount = [](const XMLElement *parent_node) {
-        int count = 0;
-        for(auto node = parent_node->FirstChildElement(); node != nullptr;
-            node = node->NextSiblingElement()) {
-            count++;
+    std::vector<std::string_view> stringVec;
+    std::unordered_map<std::string_view, uint32_t> stringIdxMap;
+    // the strings must outlive stringIdxMap
+    auto Intern = [&](std::string_view str) {
+        auto [it, inserted] = stringIdxMap.try_emplace(str, uint32_t(stringVec.size()));
+        if(inserted) {
+            stringVec.push_back(str);
         }
-        return count;
+        return it->second;
     };
-    //-----------------------------
-
-    const XMLElement *xml_root = doc.RootElement();
 
-    if(!xml_root or !StrEqual(xml_root->Name(), "root")) {
-        throw util::RuntimeError("The XML must have a root node called <root>");
+    std::vector<TreeRecord> treeRecordVec;
+    std::vector<NodeRecord> nodeRecordVec;
+    std::vector<AttributeRecord> attributeRecordVec;
+    for(const auto &[rName, rTree]: rImpl.treeMap) {
+        treeRecordVec.push_back({Intern(rName), uint32_t(nodeRecordVec.size()), uint32_t(rTree.nodeVec.size())});
+        for(const auto &rNode: rTree.nodeVec) {
+            nodeRecordVec.push_back({Intern(rNode.type), uint32_t(attributeRecordVec.size()), uint32_t(rNode.attributeVec.size()), rNode.endIdx, rNode.childrenNum});
+            for(const auto &[rAttributeName, rValue]: rNode.attributeVec) {
+                attributeRecordVec.push_back({Intern(rAttributeName), Intern(rValue)});
+            }
+        }
     }
-    //-------------------------------------------------
-    auto models_root = xml_root->FirstChildElement("TreeNodeModel");
-    auto meta_sibling = models_root ? models_root->NextSiblingElement("TreeNodeModel") : nullptr;
 
-    if(meta_sibling) {
-        ThrowError(meta_sibling->GetLineNum(), " Only a single node <TreeNodeModel> is supported");
-    }
-    if(models_root) {
-        // not having a MetaModel is not an error. But consider that the
-        // Graphical editor needs it.
-        for(auto node = xml_root->FirstChildElement(); node != nullptr;
-            node = node->NextSiblingElement()) {
-            const std::string name = node->Name();
-            if(name == "Action" or name == "Decorator" or name == "Subtree" or name == "Condition" or name == "Control") {
-                const char *pId = node->Attribute("Id");
-                if(!pId) {
-                    ThrowError(node->GetLineNum(), "Error at line %d: -> The attribute [ID] is mandatory");
-                }
+    std::vector<SubtreeModelRecord> modelRecordVec;
+    std::vector<PortRecord> portRecordVec;
+    for(const auto &[rId, rModel]: rImpl.subtreeModelMap) {
+        modelRecordVec.push_back({Intern(rId), uint32_t(portRecordVec.size()), uint32_t(rModel.portMap.size())});
+        // sorted, so that the same trees always give the same file
+        const std::map<std::string_view, const PortInfo *> orderedPortMap = [&rModel] {
+            std::map<std::string_view, const PortInfo *> portMap;
+            for(const auto &[rPortName, rPortInfo]: rModel.portMap) {
+                portMap.emplace(rPortName, &rPortInfo);
             }
+            return portMap;
+        }();
+        for(const auto &[rPortName, pPortInfo]: orderedPortMap) {
+            const auto &rDefault = pPortInfo->DefaultValueString();
+            const auto &rDescription = pPortInfo->Description();
+            portRecordVec.push_back({Intern(rPortName), uint32_t(pPortInfo->Direction()), rDefault.empty() ? NO_STRING : Intern(rDefault), rDescription.empty() ? NO_STRING : Intern(rDescription)});
         }
     }
-    //-------------------------------------------------
 
-    int behavior_tree_count = 0;
-    for(auto child = xml_root->FirstChildElement(); child != nullptr;
-        child = child->NextSiblingElement()) {
-        behavior_tree_count++;
+    const std::vector<std::string> registrationIdVec = CollectRegistrationIds(rImpl.treeMap);
+    const std::vector<std::string_view> idVec(registrationIdVec.begin(), registrationIdVec.end());
+    std::vector<uint32_t> idRecordVec;
+    for(const auto &rId: idVec) {
+        idRecordVec.push_back(Intern(rId));
     }
 
-    // function to be called recursively
-    std::function<void(const XMLElement *)> RecursiveStep = [&](const XMLElement *node) {
-        const int children_count = ChildrenCount(node);
-        const std::string name = node->Name();
-        const std::string ID =
-                node->Attribute("ID") ? node->Attribute("ID") : "";
-        const int line_number = node->GetLineNum();
-
-        if(name == "Decorator") {
-            if(children_count != 1) {
-                ThrowError(
-                        line_number,
-                        "The tag <Decorator> must have exactly 1 "
-                        "GetChildNode"
-                );
-            }
-            if(ID.empty()) {
-                ThrowError(
-                        line_number,
-                        "The tag <Decorator> must have the "
-                        "attribute [ID]"
-                );
-            }
-        } else if(name == "Action") {
-            if(children_count != 0) {
-                ThrowError(
-                        line_number,
-                        "The tag <Action> must not have any "
-                        "GetChildNode"
-                );
-            }
-            if(ID.empty()) {
-                ThrowError(
-                        line_number,
-                        "The tag <Action> must have the "
-                        "attribute [ID]"
-                );
-            }
-        } else if(name == "Condition") {
-            if(children_count != 0) {
-                ThrowError(
-                        line_number,
-                        "The tag <Condition> must not have any "
-                        "GetChildNode"
-                );
-            }
-            if(ID.empty()) {
-                ThrowError(
-                        line_number,
-                        "The tag <Condition> must have the "
-                        "attribute [ID]"
-                );
-            }
-        } else if(name == "Control") {
-            if(children_count == 0) {
-                ThrowError(
-                        line_number,
-                        "The tag <Control> must have at least 1 "
-                        "GetChildNode"
-                );
-            }
-            if(ID.empty()) {
-                ThrowError(
-                        line_number,
-                        "The tag <Control> must have the "
-                        "attribute [ID]"
-                );
-            }
-        } else if(name == "Subtree") {
-            if(children_count != 0) {
-                ThrowError(
-                        line_number, "<Subtree> should not have any GetChildNode"
-                );
-            }
-            if(ID.empty()) {
-                ThrowError(
-                        line_number,
-                        "The tag <Subtree> must have the "
-                        "attribute [ID]"
-                );
-            }
-            if(rRegisteredNodes.count(ID) != 0) {
-                ThrowError(
-                        line_number,
-                        "The attribute [ID] of tag <Subtree> must "
-                        "not use the name of a registered Node"
-                );
-            }
-        } else if(name == "BehaviorTree") {
-            if(ID.empty() and behavior_tree_count > 1) {
-                ThrowError(
-                        line_number,
-                        "The tag <BehaviorTree> must have the "
-                        "attribute [ID]"
-                );
-            }
-            if(children_count != 1) {
-                ThrowError(
-                        line_number,
-                        "The tag <BehaviorTree> must have exactly 1 "
-                        "GetChildNode"
-                );
-            }
-            if(rRegisteredNodes.count(ID) != 0) {
-                ThrowError(
-                        line_number,
-                        "The attribute [ID] of tag <BehaviorTree> "
-                        "must not use the name of a registered Node"
-                );
-            }
-        } else {
-            // search in the factory and the list of subtrees
-            const auto search = rRegisteredNodes.find(name);
-            bool found = (search != rRegisteredNodes.end());
-            if(!found) {
-                ThrowError(
-                        line_number, std::string("Node not recognized: ") + name
-                );
-            }
-
-            if(search->second == NodeType::Decorator) {
-                if(children_count != 1) {
-                    ThrowError(
-                            line_number,
-                            std::string("The node <") + name +
-                                    "> must have exactly 1 GetChildNode"
-                    );
-                }
-            } else if(search->second == NodeType::Control) {
-                if(children_count == 0) {
-                    ThrowError(
-                            line_number,
-                            std::string("The node <") + name +
-                                    "> must have 1 or more Children"
-                    );
-                }
-            }
-        }
-        //recursion
-        for(auto child = node->FirstChildElement(); child != nullptr;
-            child = child->NextSiblingElement()) {
-            RecursiveStep(child);
+    PrecompiledHeader header{};
+    std::memcpy(header.magic, PRECOMPILED_MAGIC, sizeof(PRECOMPILED_MAGIC));
+    header.version = PRECOMPILED_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.manifestHash = ManifestHash(rImpl.rFactory.GetManifest(), idVec);
+    header.mainTreeStr = rImpl.mainTreeId.empty() ? NO_STRING : Intern(rImpl.mainTreeId);
+    header.treesNum = uint32_t(treeRecordVec.size());
+    header.nodesNum = uint32_t(nodeRecordVec.size());
+    header.attributesNum = uint32_t(attributeRecordVec.size());
+    header.subtreeModelsNum = uint32_t(modelRecordVec.size());
+    header.portsNum = uint32_t(portRecordVec.size());
+    header.registrationIdsNum = uint32_t(idRecordVec.size());
+    header.stringsNum = uint32_t(stringVec.size());
+
+    std::vector<StringRecord> stringRecordVec;
+    stringRecordVec.reserve(stringVec.size());
+    for(const auto &rStr: stringVec) {
+        if(header.charsNum + rStr.size() > UINT32_MAX) {
+            throw util::RuntimeError("The trees are too large to be precompiled");
         }
+        stringRecordVec.push_back({uint32_t(header.charsNum), uint32_t(rStr.size())});
+        header.charsNum += rStr.size();
+    }
+
+    std::ofstream file(rFilepath, std::ios::binary | std::ios::trunc);
+    auto Write = [&file](const auto &rVec) {
+        file.write(reinterpret_cast<const char *>(rVec.data()), std::streamsize(rVec.size() * sizeof(rVec[0])));
     };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    Write(treeRecordVec);
+    Write(nodeRecordVec);
+    Write(attributeRecordVec);
+    Write(modelRecordVec);
+    Write(portRecordVec);
+    Write(idRecordVec);
+    Write(stringRecordVec);
+    for(const auto &rStr: stringVec) {
+        file.write(rStr.data(), std::streamsize(rStr.size()));
+    }
+    file.close();
+    if(!file) {
+        throw util::RuntimeError("write precompiled trees fail: ", rFilepath.string());
+    }
+}
+
+void JsonParser::LoadPrecompiled(const std::filesystem::path &rFilepath) {
+    m_pPImpl->RegisterDocument(ReadPrecompiled(std::make_shared<const MappedFile>(rFilepath), m_pPImpl->rFactory.GetManifest()));
+}
 
-    for(auto bt_root = xml_root->FirstChildElement("BehaviorTree");
-        bt_root != nullptr;
-        bt_root = bt_root->NextSiblingElement("BehaviorTree")) {
-        RecursiveStep(bt_root);
+void VerifyJson(const std::string &rJsonText, const std::unordered_map<std::string, behaviortree::NodeType> &rRegisteredNodes) {
+    const Document document = ReadDocument(rJsonText);
+
+    int32_t suffixCount = 0;
+    for(const auto &[rName, rTree]: document.treeVec) {
+        VerifyTree(rName.empty() ? "behaviortree_" + std::to_string(suffixCount++) : rName, rTree, rRegisteredNodes);
     }
 }
 
@@ -395,21 +1152,19 @@ Tree JsonParser::InstantiateTree(const Blackboard::Ptr &rRootBlackboard, std::st
     // use the main_tree_to_execute argument if it was provided by the user
     // or the one in the FIRST document opened
     if(main_tree_ID.empty()) {
-        XMLElement *first_xml_root = m_pPImpl->openedJsonList.front()->RootElement();
-
-        if(auto main_tree_attribute = first_xml_root->Attribute("main_tree_to_execute")) {
-            main_tree_ID = main_tree_attribute;
+        if(!m_pPImpl->mainTreeId.empty()) {
+            main_tree_ID = m_pPImpl->mainTreeId;
         } else if(m_pPImpl->treeMap.size() == 1) {
             // special case: there is only one registered BT.
             main_tree_ID = m_pPImpl->treeMap.begin()->first;
         } else {
-            throw util::RuntimeError("[main_tree_to_execute] was not specified correctly");
+            throw util::RuntimeError("[mainTreeToExecute] was not specified correctly");
         }
     }
 
     //--------------------------------------
     if(!rRootBlackboard) {
-        throw util::RuntimeError("XMLParser::InstantiateTree needs a non-Empty root_blackboard");
+        throw util::RuntimeError("JsonParser::InstantiateTree needs a non-Empty root_blackboard");
     }
 
     m_pPImpl->RecursivelyCreateSubtree(main_tree_ID, {}, {}, output_tree, rRootBlackboard, TreeNode::Ptr());
@@ -421,16 +1176,16 @@ void JsonParser::ClearInternalState() {
     m_pPImpl->Clear();
 }
 
-TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement, const Blackboard::Ptr &rBlackboard, const TreeNode::Ptr &rNodeParent, const std::string &rPrefixPath, Tree &rOutputTree) {
-    const auto element_name = pElement->Name();
-    const auto element_ID = pElement->Attribute("Id");
+TreeNode::Ptr JsonParser::PImpl::CreateNodeFromSpec(const NodeSpec &rSpec, const Blackboard::Ptr &rBlackboard, const TreeNode::Ptr &rNodeParent, const std::string &rPrefixPath, Tree &rOutputTree) {
+    const std::string element_name(rSpec.type);
+    const std::string_view *element_ID = rSpec.FindAttribute("id");
 
     auto node_type = ConvertFromString<NodeType>(element_name);
     // name used by the factory
     std::string type_ID;
 
     if(node_type == NodeType::Undefined) {
-        // This is the case of nodes like <MyCustomAction>
+        // This is the case of nodes like {"type": "MyCustomAction"}
         // check if the factory has this name
         if(rFactory.GetBuilder().count(element_name) == 0) {
             throw util::RuntimeError(element_name, " is not a registered node");
@@ -438,20 +1193,20 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
         type_ID = element_name;
 
         if(element_ID) {
-            throw util::RuntimeError("Attribute [ID] is not allowed in <", type_ID, ">");
+            throw util::RuntimeError("Attribute [id] is not allowed in <", type_ID, ">");
         }
     } else {
-        // in this case, it is mandatory to have a field "ID"
+        // in this case, it is mandatory to have a field "id"
         if(!element_ID) {
-            throw util::RuntimeError("Attribute [ID] is mandatory in <", type_ID, ">");
+            throw util::RuntimeError("Attribute [id] is mandatory in <", element_name, ">");
         }
-        type_ID = element_ID;
+        type_ID = *element_ID;
     }
 
     // By default, the instance name is equal to ID, unless the
     // attribute [name] is present.
-    const char *attr_name = pElement->Attribute("name");
-    const std::string instance_name = (attr_name != nullptr) ? attr_name : type_ID;
+    const std::string_view *attr_name = rSpec.FindAttribute("name");
+    const std::string instance_name = (attr_name != nullptr) ? std::string(*attr_name) : type_ID;
 
     const TreeNodeManifest *manifest = nullptr;
 
@@ -461,18 +1216,14 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
     }
 
     PortsRemapping port_remap;
-    for(const XMLAttribute *att = pElement->FirstAttribute(); att;
-        att = att->Next()) {
-        if(IsAllowedPortName(att->Name())) {
-            const std::string port_name = att->Name();
-            const std::string port_value = att->Value();
-
+    for(const auto &[port_name, port_value]: rSpec.attributeVec) {
+        if(IsAllowedPortName(port_name)) {
             if(manifest) {
-                auto port_model_it = manifest->portMap.find(port_name);
+                auto port_model_it = manifest->portMap.find(std::string(port_name));
                 if(port_model_it == manifest->portMap.end()) {
                     throw util::RuntimeError(
                             util::StrCat("a port with name [", port_name,
-                                         "] is found in the XML, but not in the "
+                                         "] is found in the JSON, but not in the "
                                          "ProvidedPorts()")
                     );
                 }
@@ -495,7 +1246,7 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
                 }
             }
 
-            port_remap[port_name] = port_value;
+            port_remap[std::string(port_name)] = port_value;
         }
     }
 
@@ -509,19 +1260,19 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
         config.path += std::string("::") + std::to_string(config.uid);
     }
 
-    auto AddCondition = [&](auto &conditions, const char *attr_name, auto ID) {
-        if(auto script = pElement->Attribute(attr_name)) {
-            conditions.insert({ID, std::string(script)});
+    auto AddCondition = [&](auto &conditions, const std::string &attr_name, auto ID) {
+        if(auto script = rSpec.FindAttribute(attr_name)) {
+            conditions.insert({ID, std::string(*script)});
         }
     };
 
     for(int i = 0; i < int(PreCond::Count); i++) {
         auto pre = static_cast<PreCond>(i);
-        AddCondition(config.preConditionMap, ToStr(pre).c_str(), pre);
+        AddCondition(config.preConditionMap, ToStr(pre), pre);
     }
     for(int i = 0; i < int(PostCond::Count); i++) {
         auto post = static_cast<PostCond>(i);
-        AddCondition(config.postConditionMap, ToStr(post).c_str(), post);
+        AddCondition(config.postConditionMap, ToStr(post), post);
     }
 
     //---------------------------------------------
@@ -535,7 +1286,7 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
     } else {
         if(!manifest) {
             auto msg =
-                    util::StrCat("Missing manifest for element_ID: ", element_ID, ". It shouldn't happen. Please report this issue.");
+                    util::StrCat("Missing manifest for element_ID: ", type_ID, ". It shouldn't happen. Please report this issue.");
             throw util::RuntimeError(msg);
         }
 
@@ -543,7 +1294,7 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
         for(const auto &[name_in_subtree, _]: port_remap) {
             if(manifest->portMap.count(name_in_subtree) == 0) {
                 throw util::RuntimeError(
-                        "Possible typo? In the XML, you tried to remap port \"",
+                        "Possible typo? In the JSON, you tried to remap port \"",
                         name_in_subtree, "\" in node [", config.path, "(Type ",
                         type_ID,
                         ")], but the manifest/model of this node does not "
@@ -646,26 +1397,34 @@ TreeNode::Ptr JsonParser::PImpl::CreateNodeFromJson(const XMLElement *pElement,
 }
 
 void behaviortree::JsonParser::PImpl::RecursivelyCreateSubtree(const std::string &rTreeId, const std::string &rTreePath, const std::string &rPrefixPath, Tree &rOutputTree, Blackboard::Ptr pBlackboard, const TreeNode::Ptr &pRootNode) {
-    std::function<void(const TreeNode::Ptr &, Tree::Subtree::Ptr, std::string, const XMLElement *)> recursiveStep;
-    recursiveStep = [&](TreeNode::Ptr pParentNode, Tree::Subtree::Ptr pSubtree, std::string prefix, const XMLElement *element) {
+    auto iter = treeMap.find(rTreeId);
+    if(iter == treeMap.end()) {
+        throw util::RuntimeError("Can't find a tree with name: ", rTreeId);
+    }
+    const auto &rNodeVec = iter->second.nodeVec;
+
+    std::function<void(const TreeNode::Ptr &, Tree::Subtree::Ptr, std::string, uint32_t)> recursiveStep;
+    recursiveStep = [&](TreeNode::Ptr pParentNode, Tree::Subtree::Ptr pSubtree, std::string prefix, uint32_t nodeIdx) {
+        const NodeSpec &rSpec = rNodeVec[nodeIdx];
+
         // create the node
-        auto pTreeNode = CreateNodeFromJson(element, pBlackboard, pParentNode, prefix, rOutputTree);
+        auto pTreeNode = CreateNodeFromSpec(rSpec, pBlackboard, pParentNode, prefix, rOutputTree);
         pSubtree->nodeVec.push_back(pTreeNode);
 
         // common case: iterate through all children
         if(pTreeNode->Type() != NodeType::Subtree) {
-            for(auto child_element = element->FirstChildElement(); child_element; child_element = child_element->NextSiblingElement()) {
-                recursiveStep(pTreeNode, pSubtree, prefix, child_element);
+            for(uint32_t childIdx = nodeIdx + 1; childIdx < rSpec.endIdx; childIdx = rNodeVec[childIdx].endIdx) {
+                recursiveStep(pTreeNode, pSubtree, prefix, childIdx);
             }
         } else { // special case: SubtreeNode
             auto new_bb = Blackboard::Create(pBlackboard);
-            const std::string subtreeId = element->Attribute("Id");
+            // checked by CreateNodeFromSpec()
+            const std::string subtreeId(*rSpec.FindAttribute("id"));
             std::unordered_map<std::string, std::string> subtree_remapping;
             bool do_autoremap = false;
 
-            for(auto attr = element->FirstAttribute(); attr != nullptr; attr = attr->Next()) {
-                std::string attr_name = attr->Name();
-                std::string attr_value = attr->Value();
+            for(const auto &[attr_name, value]: rSpec.attributeVec) {
+                std::string attr_value(value);
                 if(attr_value == "{=}") {
                     attr_value = util::StrCat("{", attr_name, "}");
                 }
@@ -675,10 +1434,10 @@ void behaviortree::JsonParser::PImpl::RecursivelyCreateSubtree(const std::string
                     new_bb->EnableAutoRemapping(do_autoremap);
                     continue;
                 }
-                if(!IsAllowedPortName(attr->Name())) {
+                if(!IsAllowedPortName(attr_name)) {
                     continue;
                 }
-                subtree_remapping.insert({attr_name, attr_value});
+                subtree_remapping.insert({std::string(attr_name), attr_value});
             }
             // check if this subtree has a model. If it does,
             // we want to check if all the mandatory ports were remapped and
@@ -693,9 +1452,9 @@ void behaviortree::JsonParser::PImpl::RecursivelyCreateSubtree(const std::string
                     auto it = subtree_remapping.find(port_name);
                     // don't override existing remapping
                     if(it == subtree_remapping.end() and !do_autoremap) {
-                        // remapping is not explicitly defined in the XML: use the model
+                        // remapping is not explicitly defined in the JSON: use the model
                         if(port_info.DefaultValueString().empty()) {
-                            auto msg = util::StrCat("In the <TreeNodeModel> the <Subtree ID=\"", subtreeId, "\"> is defining a mandatory port called [", port_name, "], but you are not remapping it");
+                            auto msg = util::StrCat("In the [treeNodeModel] the Subtree [", subtreeId, "] is defining a mandatory port called [", port_name, "], but you are not remapping it");
                             throw util::RuntimeError(msg);
                         } else {
                             subtree_remapping.insert({port_name, port_info.DefaultValueString()});
@@ -722,8 +1481,8 @@ void behaviortree::JsonParser::PImpl::RecursivelyCreateSubtree(const std::string
             if(!subtreePath.empty()) {
                 subtreePath += "/";
             }
-            if(auto name = element->Attribute("name")) {
-                subtreePath += name;
+            if(auto name = rSpec.FindAttribute("name")) {
+                subtreePath += *name;
             } else {
                 subtreePath += subtreeId + "::" + std::to_string(pTreeNode->GetUid());
             }
@@ -737,13 +1496,6 @@ void behaviortree::JsonParser::PImpl::RecursivelyCreateSubtree(const std::string
         }
     };
 
-    auto iter = treeMap.find(rTreeId);
-    if(iter == treeMap.end()) {
-        throw std::runtime_error(std::string("Can't find a tree with name: ") + rTreeId);
-    }
-
-    auto root_element = iter->second->FirstChildElement();
-
     //-------- start recursion -----------
 
     // Append a new subtree to the list
@@ -753,133 +1505,109 @@ void behaviortree::JsonParser::PImpl::RecursivelyCreateSubtree(const std::string
     new_tree->treeId = rTreeId;
     rOutputTree.m_subtreeVec.push_back(new_tree);
 
-    recursiveStep(pRootNode, new_tree, rPrefixPath, root_element);
+    recursiveStep(pRootNode, new_tree, rPrefixPath, 0);
 }
 
-void JsonParser::PImpl::GetPortsRecursively(const XMLElement *element, std::vector<std::string> &rOutputPortVec) {
-    for(const XMLAttribute *attr = element->FirstAttribute(); attr != nullptr; attr = attr->Next()) {
-        const char *attr_name = attr->Name();
-        const char *attr_value = attr->Value();
-        if(IsAllowedPortName(attr_name) and TreeNode::IsBlackboardPointer(attr_value)) {
-            auto port_name = TreeNode::StripBlackboardPointer(attr_value);
-            rOutputPortVec.push_back(static_cast<std::string>(port_name));
-        }
-    }
-
-    for(auto child_element = element->FirstChildElement(); child_element;
-        child_element = child_element->NextSiblingElement()) {
-        GetPortsRecursively(child_element, rOutputPortVec);
-    }
-}
-
-void AddNodeModelToJson(const TreeNodeManifest &model, XMLDocument &doc, XMLElement *model_root) {
-    XMLElement *element = doc.NewElement(ToStr(model.type).c_str());
-    element->SetAttribute("ID", model.registrationId.c_str());
+nlohmann::ordered_json NodeModelToJson(const TreeNodeManifest &model) {
+    nlohmann::ordered_json element;
+    element["type"] = ToStr(model.type);
+    element["id"] = model.registrationId;
 
     for(const auto &[port_name, port_info]: model.portMap) {
-        XMLElement *port_element = nullptr;
+        const char *list_name = "inOut";
         switch(port_info.Direction()) {
             case PortDirection::In:
-                port_element = doc.NewElement("input_port");
+                list_name = "input";
                 break;
             case PortDirection::Out:
-                port_element = doc.NewElement("output_port");
+                list_name = "output";
                 break;
             case PortDirection::InOut:
-                port_element = doc.NewElement("inout_port");
                 break;
         }
 
-        port_element->SetAttribute("name", port_name.c_str());
+        nlohmann::ordered_json port_element;
+        port_element["name"] = port_name;
         if(port_info.Type() != typeid(void)) {
-            port_element->SetAttribute("Type", behaviortree::Demangle(port_info.Type()).c_str());
+            port_element["type"] = behaviortree::Demangle(port_info.Type());
         }
         if(!port_info.DefaultValue().Empty()) {
-            port_element->SetAttribute("default", port_info.DefaultValueString().c_str());
+            port_element["default"] = port_info.DefaultValueString();
         }
-
         if(!port_info.Description().empty()) {
-            port_element->SetText(port_info.Description().c_str());
+            port_element["description"] = port_info.Description();
         }
-        element->InsertEndChild(port_element);
+        element[list_name].push_back(std::move(port_element));
     }
 
     if(!model.metadataVec.empty()) {
-        auto metadata_root = doc.NewElement("MetadataFields");
-
+        auto &metadata_root = element["metadata"];
         for(const auto &[name, value]: model.metadataVec) {
-            auto metadata_element = doc.NewElement("Metadata");
-            metadata_element->SetAttribute(name.c_str(), value.c_str());
-            metadata_root->InsertEndChild(metadata_element);
+            metadata_root[name] = value;
         }
-
-        element->InsertEndChild(metadata_root);
     }
 
-    model_root->InsertEndChild(element);
+    return element;
 }
 
-void AddTreeToJson(const Tree &tree, XMLDocument &doc, XMLElement *rootXML, bool add_metadata, bool add_builtin_models) {
-    std::function<void(const TreeNode &, XMLElement *)> addNode;
-    addNode = [&](const TreeNode &node, XMLElement *parent_elem) {
-        XMLElement *elem = nullptr;
+void AddTreeToJson(const Tree &tree, nlohmann::ordered_json &rootJson, bool add_metadata, bool add_builtin_models) {
+    std::function<nlohmann::ordered_json(const TreeNode &)> nodeToJson;
+    nodeToJson = [&](const TreeNode &node) {
+        nlohmann::ordered_json elem;
+        elem["type"] = node.GetRegistrAtionName();
 
         if(auto subtree = dynamic_cast<const SubtreeNode *>(&node)) {
-            elem = doc.NewElement(node.GetRegistrAtionName().c_str());
-            elem->SetAttribute("ID", subtree->GetSubtreeId().c_str());
+            elem["id"] = subtree->GetSubtreeId();
             if(add_metadata) {
-                elem->SetAttribute("_fullpath", subtree->GetConfig().path.c_str());
+                elem["_fullpath"] = subtree->GetConfig().path;
             }
         } else {
-            elem = doc.NewElement(node.GetRegistrAtionName().c_str());
-            elem->SetAttribute("name", node.GetNodeName().c_str());
+            elem["name"] = node.GetNodeName();
         }
 
         if(add_metadata) {
-            elem->SetAttribute("_uid", node.GetUid());
+            elem["_uid"] = node.GetUid();
         }
 
         for(const auto &[name, value]: node.GetConfig().inputPortMap) {
-            elem->SetAttribute(name.c_str(), value.c_str());
+            elem[name] = value;
         }
         for(const auto &[name, value]: node.GetConfig().outputPortMap) {
             // avoid duplicates, in the case of INOUT ports
             if(node.GetConfig().inputPortMap.count(name) == 0) {
-                elem->SetAttribute(name.c_str(), value.c_str());
+                elem[name] = value;
             }
         }
 
         for(const auto &[pre, script]: node.GetConfig().preConditionMap) {
-            elem->SetAttribute(ToStr(pre).c_str(), script.c_str());
+            elem[ToStr(pre)] = script;
         }
         for(const auto &[post, script]: node.GetConfig().postConditionMap) {
-            elem->SetAttribute(ToStr(post).c_str(), script.c_str());
+            elem[ToStr(post)] = script;
         }
 
-        parent_elem->InsertEndChild(elem);
-
         if(auto control = dynamic_cast<const ControlNode *>(&node)) {
+            auto &children = elem["children"];
             for(const auto &child: control->GetChildrenNode()) {
-                addNode(*child, elem);
+                children.push_back(nodeToJson(*child));
             }
         } else if(auto decorator = dynamic_cast<const DecoratorNode *>(&node)) {
             if(decorator->Type() != NodeType::Subtree) {
-                addNode(*decorator->GetChildNode(), elem);
+                elem["children"].push_back(nodeToJson(*decorator->GetChildNode()));
             }
         }
+        return elem;
     };
 
+    auto &tree_list = rootJson["behaviortree"];
     for(const auto &subtree: tree.m_subtreeVec) {
-        XMLElement *subtree_elem = doc.NewElement("BehaviorTree");
-        subtree_elem->SetAttribute("ID", subtree->treeId.c_str());
-        subtree_elem->SetAttribute("_fullpath", subtree->instanceName.c_str());
-        rootXML->InsertEndChild(subtree_elem);
-        addNode(*subtree->nodeVec.front(), subtree_elem);
+        nlohmann::ordered_json subtree_elem;
+        subtree_elem["treeName"] = subtree->treeId;
+        subtree_elem["_fullpath"] = subtree->instanceName;
+        subtree_elem["root"] = nodeToJson(*subtree->nodeVec.front());
+        tree_list.push_back(std::move(subtree_elem));
     }
 
-    XMLElement *model_root = doc.NewElement("TreeNodeModel");
-    rootXML->InsertEndChild(model_root);
-
     static const BehaviorTreeFactory temp_factory;
 
     std::map<std::string, const TreeNodeManifest *> ordered_models;
@@ -890,20 +1618,16 @@ void AddTreeToJson(const Tree &tree, XMLDocument &doc, XMLElement *rootXML, bool
         }
     }
 
+    auto &model_list = rootJson["treeNodeModel"];
+    model_list = nlohmann::ordered_json::array();
     for(const auto &[registration_ID, model]: ordered_models) {
-        AddNodeModelToJson(*model, doc, model_root);
+        model_list.push_back(NodeModelToJson(*model));
     }
 }
 
 std::string WriteTreeNodeModelJson(const BehaviorTreeFactory &rFactory, bool include_builtin) {
-    XMLDocument doc;
-
-    XMLElement *rootXML = doc.NewElement("root");
-    rootXML->SetAttribute("BTCPP_format", "4");
-    doc.InsertFirstChild(rootXML);
-
-    XMLElement *model_root = doc.NewElement("TreeNodeModel");
-    rootXML->InsertEndChild(model_root);
+    nlohmann::ordered_json rootJson;
+    rootJson["BTCPP_format"] = 4;
 
     std::map<std::string, const TreeNodeManifest *> ordered_models;
 
@@ -914,13 +1638,13 @@ std::string WriteTreeNodeModelJson(const BehaviorTreeFactory &rFactory, bool inc
         }
     }
 
+    auto &model_list = rootJson["treeNodeModel"];
+    model_list = nlohmann::ordered_json::array();
     for(const auto &[registration_ID, model]: ordered_models) {
-        AddNodeModelToJson(*model, doc, model_root);
+        model_list.push_back(NodeModelToJson(*model));
     }
 
-    XMLPrinter printer;
-    doc.Print(&printer);
-    return std::string(printer.CStr(), size_t(printer.CStrSize() - 1));
+    return rootJson.dump(4);
 }
 
 Tree BuildTreeFromText(const BehaviorTreeFactory &factory, const std::string &text, const Blackboard::Ptr &blackboard) {
@@ -936,17 +1660,12 @@ Tree BuildTreeFromFile(const BehaviorTreeFactory &factory, const std::string &fi
 }
 
 std::string WriteTreeToJson(const Tree &rTree, bool add_metadata, bool add_builtin_models) {
-    XMLDocument doc;
-
-    XMLElement *rootXML = doc.NewElement("root");
-    rootXML->SetAttribute("BTCPP_format", 4);
-    doc.InsertFirstChild(rootXML);
+    nlohmann::ordered_json rootJson;
+    rootJson["BTCPP_format"] = 4;
 
-    AddTreeToJson(rTree, doc, rootXML, add_metadata, add_builtin_models);
+    AddTreeToJson(rTree, rootJson, add_metadata, add_builtin_models);
 
-    XMLPrinter printer;
-    doc.Print(&printer);
-    return std::string(printer.CStr(), size_t(printer.CStrSize() - 1));
+    return rootJson.dump(4);
 }
 
 } // namespace behaviortree
@@ -0,0 +1,57 @@
+#include "behaviortree/port_binding.h"
+
+#include "behaviortree/tree_node.h"
+
+namespace behaviortree {
+PortBinding PortBinding::Create(const std::string &rPortName, std::string_view remappedPort, const Blackboard::Ptr &pBlackboard) {
+    PortBinding binding;
+    binding.portName = rPortName;
+    binding.pBlackboard = pBlackboard.get();
+
+    auto blackboardKey = TreeNode::GetRemappedKey(rPortName, remappedPort);
+    if(!blackboardKey) {
+        // pure string, not a blackboard key
+        binding.kind = Kind::Literal;
+        binding.literal.assign(remappedPort.data(), remappedPort.size());
+        return binding;
+    }
+
+    binding.kind = Kind::Entry;
+    binding.blackboardKey.assign(blackboardKey->data(), blackboardKey->size());
+    if(pBlackboard != nullptr) {
+        binding.entry.Publish(pBlackboard->GetEntry(binding.blackboardKey));
+    }
+    return binding;
+}
+
+template<>
+std::string ToStr<PortErrorCode>(const PortErrorCode &rErrorCode) {
+    switch(rErrorCode) {
+        case PortErrorCode::Ok: {
+            return "Ok";
+        } break;
+        case PortErrorCode::MissingPort: {
+            return "MissingPort";
+        } break;
+        case PortErrorCode::MissingBlackboard: {
+            return "MissingBlackboard";
+        } break;
+        case PortErrorCode::MissingEntry: {
+            return "MissingEntry";
+        } break;
+        case PortErrorCode::EmptyEntry: {
+            return "EmptyEntry";
+        } break;
+        case PortErrorCode::NotBlackboardPointer: {
+            return "NotBlackboardPointer";
+        } break;
+        case PortErrorCode::ConversionFailed: {
+            return "ConversionFailed";
+        } break;
+        default: {
+            return "Undefined";
+        } break;
+    }
+}
+
+}// namespace behaviortree
@@ -1,5 +1,11 @@
 #include "behaviortree/scripting/script_parser.hpp"
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <lexy/action/parse.hpp>
 #include <lexy/action/validate.hpp>
 #include <lexy/code_point.hpp>
@@ -7,12 +13,25 @@
 #include <lexy_ext/report_error.hpp>
 
 #include "behaviortree/scripting/operators.hpp"
+#include "behaviortree/scripting/script_program.hpp"
 
 namespace behaviortree {
 
 using ErrorReport = lexy_ext::_report_error<char *>;
 
-Expected<ScriptFunction> ParseScript(const std::string &script) {
+namespace {
+using ExprVec = std::vector<behaviortree::Ast::ExprBase::Ptr>;
+
+// immutable, shared by all the functions created from the same text
+struct CompiledScript {
+    ExprVec exprs;
+    // nullptr if the AST must be evaluated
+    ScriptProgram::Ptr program;
+};
+
+using CompiledScriptPtr = std::shared_ptr<const CompiledScript>;
+
+Expected<ExprVec> ParseExpressions(const std::string &script) {
     char error_msgs_buffer[2048];
 
     auto input = lexy::string_input<lexy::utf8_encoding>(script);
@@ -21,24 +40,11 @@ Expected<ScriptFunction> ParseScript(const std::string &script) {
     );
     if(result.has_value() and result.error_count() == 0) {
         try {
-            std::vector<behaviortree::Ast::ExprBase::Ptr> exprs =
-                    LEXY_MOV(result).value();
+            ExprVec exprs = LEXY_MOV(result).value();
             if(exprs.empty()) {
                 return nonstd::make_unexpected("Empty Script");
             }
-
-            return [exprs, script](Ast::Environment &env) -> Any {
-                try {
-                    for(auto i = 0u; i < exprs.size() - 1; ++i) {
-                        exprs[i]->evaluate(env);
-                    }
-                    return exprs.back()->evaluate(env);
-                } catch(util::RuntimeError &err) {
-                    throw util::RuntimeError(util::StrCat(
-                            "Error in script [", script, "]\n", err.what()
-                    ));
-                }
-            };
+            return exprs;
         } catch(std::runtime_error &err) {
             return nonstd::make_unexpected(err.what());
         }
@@ -47,6 +53,243 @@ Expected<ScriptFunction> ParseScript(const std::string &script) {
     }
 }
 
+class CompiledScriptCache {
+ public:
+    static CompiledScriptCache &Get() {
+        static CompiledScriptCache cache;
+        return cache;
+    }
+
+    // invalid scripts are not cached
+    Expected<CompiledScriptPtr> Find(const std::string &script) {
+        {
+            std::unique_lock lock(m_mutex);
+            auto iter = m_scriptMap.find(script);
+            if(iter != m_scriptMap.end()) {
+                m_lruList.splice(m_lruList.begin(), m_lruList, iter->second.lruIter);
+                m_hitsNum++;
+                return iter->second.pScript;
+            }
+            m_missesNum++;
+        }
+
+        // parse without holding the lock
+        auto exprs = ParseExpressions(script);
+        if(!exprs) {
+            return nonstd::make_unexpected(exprs.error());
+        }
+        auto pScript = std::make_shared<CompiledScript>();
+        pScript->program = ScriptProgram::Compile(exprs.value());
+        pScript->exprs = LEXY_MOV(exprs.value());
+
+        std::unique_lock lock(m_mutex);
+        auto [iter, inserted] = m_scriptMap.try_emplace(script);
+        if(!inserted) {
+            // parsed concurrently by another thread
+            return iter->second.pScript;
+        }
+        m_lruList.push_front(script);
+        iter->second.pScript = pScript;
+        iter->second.lruIter = m_lruList.begin();
+        Shrink();
+        return CompiledScriptPtr(pScript);
+    }
+
+    void SetOptions(const ScriptCache::Options &rOptions) {
+        std::unique_lock lock(m_mutex);
+        m_options = rOptions;
+        Shrink();
+    }
+
+    ScriptCache::Options GetOptions() const {
+        std::unique_lock lock(m_mutex);
+        return m_options;
+    }
+
+    ScriptCache::Stats GetStats() const {
+        std::unique_lock lock(m_mutex);
+        return {m_hitsNum, m_missesNum, m_scriptMap.size()};
+    }
+
+    void Clear() {
+        std::unique_lock lock(m_mutex);
+        m_scriptMap.clear();
+        m_lruList.clear();
+    }
+
+ private:
+    struct Entry {
+        CompiledScriptPtr pScript;
+        std::list<std::string>::iterator lruIter;
+    };
+
+    // require mutex
+    void Shrink() {
+        if(m_options.maxCachedNum == 0) {
+            return;
+        }
+        while(m_scriptMap.size() > m_options.maxCachedNum) {
+            m_scriptMap.erase(m_lruList.back());
+            m_lruList.pop_back();
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    ScriptCache::Options m_options;
+    std::unordered_map<std::string, Entry> m_scriptMap;
+    // most recently used first
+    std::list<std::string> m_lruList;
+    uint64_t m_hitsNum{0};
+    uint64_t m_missesNum{0};
+};
+
+template<typename Callable>
+Any ExecuteScript(const std::string &script, Callable &&execute) {
+    try {
+        return execute();
+    } catch(util::RuntimeError &err) {
+        throw util::RuntimeError(util::StrCat(
+                "Error in script [", script, "]\n", err.what()
+        ));
+    }
+}
+
+// A script compiled for the blackboard and the enums of an environment
+struct BoundScript {
+    ScriptProgram::Ptr pProgram;
+    std::shared_ptr<ScriptProgram::EntryCache> pEntryCache;
+    EnumsTablePtr pEnums;
+    // the enums are only added (see BehaviorTreeFactory::RegisterScriptingEnum()):
+    // their number tells whether the table changed since the script was bound
+    size_t enumsNum{0};
+};
+
+size_t EnumsNum(const EnumsTablePtr &pEnums) {
+    return pEnums ? pEnums->size() : 0;
+}
+
+std::shared_ptr<const BoundScript> BindScript(const CompiledScriptPtr &compiled, const Ast::Environment &env) {
+    auto pBound = std::make_shared<BoundScript>();
+    pBound->pEnums = env.ptrEnums;
+    pBound->enumsNum = EnumsNum(env.ptrEnums);
+    pBound->pProgram = ScriptProgram::Compile(compiled->exprs, env.ptrEnums);
+    if(!pBound->pProgram) {
+        return nullptr;
+    }
+    if(env.ptrVars) {
+        pBound->pEntryCache = std::make_shared<ScriptProgram::EntryCache>(*pBound->pProgram, env.ptrVars);
+    }
+    return pBound;
+}
+
+// Current binding of a script. A script is bound again when enums are
+// registered after it was bound; the previous bindings are kept alive, so
+// that Get() never locks unless the script must be bound again.
+class BoundScriptHolder {
+ public:
+    explicit BoundScriptHolder(std::shared_ptr<const BoundScript> pBound): m_pCurrent(pBound.get()),
+                                                                          m_boundVec{std::move(pBound)} {}
+
+    /// nullptr if the script must be executed without binding.
+    const BoundScript *Get(const CompiledScriptPtr &compiled, const Ast::Environment &env) {
+        const BoundScript *pBound = m_pCurrent.load(std::memory_order_acquire);
+        // the enums replaced at compile time must be the same
+        if(env.ptrEnums != pBound->pEnums) {
+            return nullptr;
+        }
+        if(EnumsNum(env.ptrEnums) == pBound->enumsNum) {
+            return pBound;
+        }
+
+        std::unique_lock lock(m_mutex);
+        pBound = m_pCurrent.load(std::memory_order_relaxed);
+        if(EnumsNum(env.ptrEnums) != pBound->enumsNum) {
+            auto pRebound = BindScript(compiled, env);
+            if(!pRebound) {
+                return nullptr;
+            }
+            pBound = pRebound.get();
+            m_boundVec.push_back(std::move(pRebound));
+            m_pCurrent.store(pBound, std::memory_order_release);
+        }
+        return pBound;
+    }
+
+ private:
+    std::atomic<const BoundScript *> m_pCurrent;
+    std::mutex m_mutex;
+    std::vector<std::shared_ptr<const BoundScript>> m_boundVec;
+};
+
+ScriptFunction MakeScriptFunction(const std::string &script, const CompiledScriptPtr &compiled) {
+    if(auto program = compiled->program) {
+        return [program, script](Ast::Environment &env) -> Any {
+            return ExecuteScript(script, [&] {
+                return program->Execute(env);
+            });
+        };
+    }
+    return [compiled, script](Ast::Environment &env) -> Any {
+        return ExecuteScript(script, [&] {
+            const auto &exprs = compiled->exprs;
+            for(auto i = 0u; i < exprs.size() - 1; ++i) {
+                exprs[i]->evaluate(env);
+            }
+            return exprs.back()->evaluate(env);
+        });
+    };
+}
+}// namespace
+
+void ScriptCache::SetOptions(const Options &rOptions) {
+    CompiledScriptCache::Get().SetOptions(rOptions);
+}
+
+ScriptCache::Options ScriptCache::GetOptions() {
+    return CompiledScriptCache::Get().GetOptions();
+}
+
+ScriptCache::Stats ScriptCache::GetStats() {
+    return CompiledScriptCache::Get().GetStats();
+}
+
+void ScriptCache::Clear() {
+    CompiledScriptCache::Get().Clear();
+}
+
+Expected<ScriptFunction> ParseScript(const std::string &script) {
+    auto compiled = CompiledScriptCache::Get().Find(script);
+    if(!compiled) {
+        return nonstd::make_unexpected(compiled.error());
+    }
+    return MakeScriptFunction(script, compiled.value());
+}
+
+Expected<ScriptFunction> ParseScript(const std::string &script, const Ast::Environment &env) {
+    auto compiled = CompiledScriptCache::Get().Find(script);
+    if(!compiled) {
+        return nonstd::make_unexpected(compiled.error());
+    }
+    auto program = compiled.value()->program;
+    // the enums are specific to the environment: not cached
+    auto bound = program ? BindScript(compiled.value(), env) : nullptr;
+    if(!bound) {
+        return MakeScriptFunction(script, compiled.value());
+    }
+
+    auto holder = std::make_shared<BoundScriptHolder>(std::move(bound));
+    return [compiled = compiled.value(), holder, script](Ast::Environment &env) -> Any {
+        return ExecuteScript(script, [&] {
+            const BoundScript *pBound = holder->Get(compiled, env);
+            if(pBound == nullptr) {
+                return compiled->program->Execute(env);
+            }
+            const bool useCache = pBound->pEntryCache and pBound->pEntryCache->IsBoundTo(env.ptrVars);
+            return pBound->pProgram->Execute(env, useCache ? pBound->pEntryCache.get() : nullptr);
+        });
+    };
+}
+
 behaviortree::Expected<Any> ParseScriptAndExecute(
         Ast::Environment &env, const std::string &script
 ) {
@@ -60,26 +303,12 @@ behaviortree::Expected<Any> ParseScriptAndExecute(
 }
 
 Result ValidateScript(const std::string &script) {
-    char error_msgs_buffer[2048];
-
-    auto input = lexy::string_input<lexy::utf8_encoding>(script);
-    auto result = lexy::parse<behaviortree::Grammar::stmt>(
-            input, ErrorReport().to(error_msgs_buffer)
-    );
-    if(result.has_value() and result.error_count() == 0) {
-        try {
-            std::vector<behaviortree::Ast::ExprBase::Ptr> exprs =
-                    LEXY_MOV(result).value();
-            if(exprs.empty()) {
-                return nonstd::make_unexpected("Empty Script");
-            }
-            // valid script
-            return {};
-        } catch(std::runtime_error &err) {
-            return nonstd::make_unexpected(err.what());
-        }
+    auto compiled = CompiledScriptCache::Get().Find(script);
+    if(!compiled) {
+        return nonstd::make_unexpected(compiled.error());
     }
-    return nonstd::make_unexpected(error_msgs_buffer);
+    // valid script
+    return {};
 }
 
 }// namespace behaviortree
@@ -0,0 +1,501 @@
+#include "behaviortree/scripting/script_program.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "behaviortree/scripting/operators.hpp"
+
+namespace behaviortree {
+namespace {
+// registers allocated on the stack by Execute(), enough for most scripts
+constexpr size_t LocalRegistersNum = 16;
+
+constexpr size_t MaxRegistersNum = std::numeric_limits<uint16_t>::max();
+
+double UnaryNumber(Ast::ExprUnaryArithmetic::op_t op, double value) {
+    switch(op) {
+        case Ast::ExprUnaryArithmetic::negate:
+            return -value;
+        case Ast::ExprUnaryArithmetic::complement:
+            return static_cast<double>(~static_cast<int64_t>(value));
+        case Ast::ExprUnaryArithmetic::logical_not:
+            return static_cast<double>(!static_cast<bool>(value));
+    }
+    return value;
+}
+
+// false if the operation must use ExprBinaryArithmetic::Apply()
+bool BinaryNumber(Ast::ExprBinaryArithmetic::op_t op, double lhs, double rhs, double &rResult) {
+    switch(op) {
+        case Ast::ExprBinaryArithmetic::plus:
+            rResult = lhs + rhs;
+            return true;
+        case Ast::ExprBinaryArithmetic::minus:
+            rResult = lhs - rhs;
+            return true;
+        case Ast::ExprBinaryArithmetic::times:
+            rResult = lhs * rhs;
+            return true;
+        case Ast::ExprBinaryArithmetic::div:
+            rResult = lhs / rhs;
+            return true;
+        case Ast::ExprBinaryArithmetic::logic_and:
+        case Ast::ExprBinaryArithmetic::logic_or:
+            // Any::Cast<bool>() rejects the negative numbers
+            if(lhs < 0.0 or rhs < 0.0) {
+                return false;
+            }
+            if(op == Ast::ExprBinaryArithmetic::logic_and) {
+                rResult = static_cast<double>(static_cast<bool>(lhs) and static_cast<bool>(rhs));
+            } else {
+                rResult = static_cast<double>(static_cast<bool>(lhs) or static_cast<bool>(rhs));
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+}// namespace
+
+struct ScriptProgram::Register {
+    Register() = default;
+    Register(const Register &rOther) = delete;
+    Register &operator=(const Register &rOther) = delete;
+
+    void SetNumber(double value) {
+        isNumber = true;
+        number = value;
+    }
+
+    void SetConstant(const Any &rValue) {
+        isNumber = false;
+        pAny = &rValue;
+    }
+
+    void SetBoxed(Any &&rValue) {
+        isNumber = false;
+        boxed = std::move(rValue);
+        pAny = &boxed;
+    }
+
+    // numbers are unboxed only if their type is double: the others keep
+    // their original type, as in the AST
+    void SetVariable(Any &&rValue) {
+        if(rValue.IsType<double>()) {
+            SetNumber(rValue.Cast<double>());
+        } else {
+            SetBoxed(std::move(rValue));
+        }
+    }
+
+    // rTemp holds the boxed number
+    const Any &Get(Any &rTemp) const {
+        if(isNumber) {
+            rTemp = Any(number);
+            return rTemp;
+        }
+        return *pAny;
+    }
+
+    // unboxed number, otherwise the value is *pAny
+    bool isNumber{false};
+    double number{0.0};
+    const Any *pAny{nullptr};
+    Any boxed;
+};
+
+class ScriptProgram::Compiler {
+ public:
+    Compiler(ScriptProgram &rProgram, const EnumsTable *pEnums): m_rProgram(rProgram), m_pEnums(pEnums) {}
+
+    // false if the expression can't be compiled
+    bool CompileInto(const Ast::ExprBase &rExpr, size_t dst) {
+        if(dst >= MaxRegistersNum) {
+            return false;
+        }
+        m_rProgram.m_registersNum = std::max(m_rProgram.m_registersNum, dst + 1);
+        const auto reg = static_cast<uint16_t>(dst);
+
+        double constant = 0.0;
+        if(EvaluateConstant(rExpr, constant)) {
+            Emit({OpCode::LoadNumber, 0, reg, 0, 0, AddNumber(constant)});
+            return true;
+        }
+
+        if(auto pLiteral = dynamic_cast<const Ast::ExprLiteral *>(&rExpr)) {
+            if(pLiteral->value.IsType<double>()) {
+                Emit({OpCode::LoadNumber, 0, reg, 0, 0, AddNumber(pLiteral->value.Cast<double>())});
+            } else {
+                Emit({OpCode::LoadConstant, 0, reg, 0, 0, AddConstant(pLiteral->value)});
+            }
+            return true;
+        }
+        if(auto pName = dynamic_cast<const Ast::ExprName *>(&rExpr)) {
+            Emit({OpCode::LoadVariable, 0, reg, 0, 0, AddName(pName->name)});
+            return true;
+        }
+        if(auto pUnary = dynamic_cast<const Ast::ExprUnaryArithmetic *>(&rExpr)) {
+            if(!CompileInto(*pUnary->rhs, dst)) {
+                return false;
+            }
+            Emit({OpCode::Unary, static_cast<uint8_t>(pUnary->op), reg, reg, 0, 0});
+            return true;
+        }
+        if(auto pBinary = dynamic_cast<const Ast::ExprBinaryArithmetic *>(&rExpr)) {
+            if(!CompileInto(*pBinary->lhs, dst) or !CompileInto(*pBinary->rhs, dst + 1)) {
+                return false;
+            }
+            Emit({OpCode::Binary, static_cast<uint8_t>(pBinary->op), reg, reg, static_cast<uint16_t>(dst + 1), 0});
+            return true;
+        }
+        if(auto pComparison = dynamic_cast<const Ast::ExprComparison *>(&rExpr)) {
+            return CompileComparison(*pComparison, dst);
+        }
+        if(auto pIf = dynamic_cast<const Ast::ExprIf *>(&rExpr)) {
+            double condition = 0.0;
+            if(EvaluateConstant(*pIf->condition, condition)) {
+                return CompileInto(condition != 0.0 ? *pIf->then : *pIf->else_, dst);
+            }
+            if(!CompileInto(*pIf->condition, dst)) {
+                return false;
+            }
+            const size_t jumpElse = Emit({OpCode::JumpUnless, 0, reg, 0, 0, 0});
+            if(!CompileInto(*pIf->then, dst)) {
+                return false;
+            }
+            const size_t jumpEnd = Emit({OpCode::Jump, 0, 0, 0, 0, 0});
+            PatchJump(jumpElse);
+            if(!CompileInto(*pIf->else_, dst)) {
+                return false;
+            }
+            PatchJump(jumpEnd);
+            return true;
+        }
+        if(auto pAssignment = dynamic_cast<const Ast::ExprAssignment *>(&rExpr)) {
+            // other left operands are reported when the AST is evaluated
+            auto pName = dynamic_cast<const Ast::ExprName *>(pAssignment->lhs.get());
+            if(!pName) {
+                return false;
+            }
+            const uint32_t nameIdx = AddName(pName->name);
+            const auto op = static_cast<uint8_t>(pAssignment->op);
+            Emit({OpCode::PrepareAssign, op, 0, 0, 0, nameIdx});
+            if(!CompileInto(*pAssignment->rhs, dst)) {
+                return false;
+            }
+            Emit({OpCode::Assign, op, reg, reg, 0, nameIdx});
+            return true;
+        }
+        return false;
+    }
+
+ private:
+    /**
+     * Number literals, enums and the operations on numbers that can't fail
+     * are evaluated at compile time. Anything else (strings, variables, and
+     * operations that may throw) is left to the program.
+     */
+    bool EvaluateConstant(const Ast::ExprBase &rExpr, double &rValue) const {
+        if(auto pLiteral = dynamic_cast<const Ast::ExprLiteral *>(&rExpr)) {
+            if(!pLiteral->value.IsType<double>()) {
+                return false;
+            }
+            rValue = pLiteral->value.Cast<double>();
+            return true;
+        }
+        if(auto pName = dynamic_cast<const Ast::ExprName *>(&rExpr)) {
+            if(m_pEnums == nullptr) {
+                return false;
+            }
+            auto iter = m_pEnums->find(pName->name);
+            if(iter == m_pEnums->end()) {
+                return false;
+            }
+            rValue = double(iter->second);
+            return true;
+        }
+        if(auto pUnary = dynamic_cast<const Ast::ExprUnaryArithmetic *>(&rExpr)) {
+            double operand = 0.0;
+            if(!EvaluateConstant(*pUnary->rhs, operand)) {
+                return false;
+            }
+            rValue = UnaryNumber(pUnary->op, operand);
+            return true;
+        }
+        if(auto pBinary = dynamic_cast<const Ast::ExprBinaryArithmetic *>(&rExpr)) {
+            double lhs = 0.0;
+            double rhs = 0.0;
+            return EvaluateConstant(*pBinary->lhs, lhs) and EvaluateConstant(*pBinary->rhs, rhs) and BinaryNumber(pBinary->op, lhs, rhs, rValue);
+        }
+        if(auto pComparison = dynamic_cast<const Ast::ExprComparison *>(&rExpr)) {
+            const auto &rOperandVec = pComparison->operands;
+            if(rOperandVec.size() != pComparison->ops.size() + 1) {
+                return false;
+            }
+            std::vector<double> valueVec(rOperandVec.size());
+            for(size_t i = 0; i < rOperandVec.size(); ++i) {
+                if(!EvaluateConstant(*rOperandVec[i], valueVec[i])) {
+                    return false;
+                }
+            }
+            rValue = 1.0;
+            for(size_t i = 0; i < pComparison->ops.size(); ++i) {
+                if(!Ast::ExprComparison::Compare(pComparison->ops[i], valueVec[i], valueVec[i + 1])) {
+                    rValue = 0.0;
+                    break;
+                }
+            }
+            return true;
+        }
+        if(auto pIf = dynamic_cast<const Ast::ExprIf *>(&rExpr)) {
+            double condition = 0.0;
+            if(!EvaluateConstant(*pIf->condition, condition)) {
+                return false;
+            }
+            return EvaluateConstant(condition != 0.0 ? *pIf->then : *pIf->else_, rValue);
+        }
+        return false;
+    }
+
+    // the operands alternate between dst+1 and dst+2; the chain stops at the
+    // first comparison that fails, as ExprComparison::evaluate()
+    bool CompileComparison(const Ast::ExprComparison &rComparison, size_t dst) {
+        const auto &rOperandVec = rComparison.operands;
+        if(rOperandVec.size() != rComparison.ops.size() + 1 or !CompileInto(*rOperandVec[0], dst + 1)) {
+            return false;
+        }
+        std::vector<size_t> jumpVec;
+        for(size_t i = 0; i != rComparison.ops.size(); ++i) {
+            // each operand gets its own register: the temporaries of a compound
+            // operand are above its destination, they never clobber the lhs
+            const size_t lhs = dst + 1 + i;
+            const size_t rhs = lhs + 1;
+            if(!CompileInto(*rOperandVec[i + 1], rhs)) {
+                return false;
+            }
+            Emit({OpCode::Compare, static_cast<uint8_t>(rComparison.ops[i]), static_cast<uint16_t>(dst), static_cast<uint16_t>(lhs), static_cast<uint16_t>(rhs), 0});
+            if(i + 1 != rComparison.ops.size()) {
+                jumpVec.push_back(Emit({OpCode::JumpIfZero, 0, static_cast<uint16_t>(dst), 0, 0, 0}));
+            }
+        }
+        for(size_t jump: jumpVec) {
+            PatchJump(jump);
+        }
+        return true;
+    }
+
+    size_t Emit(const Instruction &rInstruction) {
+        m_rProgram.m_instructionVec.push_back(rInstruction);
+        return m_rProgram.m_instructionVec.size() - 1;
+    }
+
+    // jump to the next instruction emitted
+    void PatchJump(size_t instructionIdx) {
+        m_rProgram.m_instructionVec[instructionIdx].arg = static_cast<uint32_t>(m_rProgram.m_instructionVec.size());
+    }
+
+    uint32_t AddNumber(double value) {
+        auto &rNumberVec = m_rProgram.m_numberVec;
+        auto iter = std::find(rNumberVec.begin(), rNumberVec.end(), value);
+        if(iter != rNumberVec.end()) {
+            return static_cast<uint32_t>(iter - rNumberVec.begin());
+        }
+        rNumberVec.push_back(value);
+        return static_cast<uint32_t>(rNumberVec.size() - 1);
+    }
+
+    uint32_t AddConstant(const Any &rValue) {
+        auto &rConstantVec = m_rProgram.m_constantVec;
+        if(rValue.IsString()) {
+            const auto str = rValue.GetStringView();
+            for(size_t i = 0; i < rConstantVec.size(); ++i) {
+                if(rConstantVec[i].IsString() and rConstantVec[i].Type() == rValue.Type() and rConstantVec[i].GetStringView() == str) {
+                    return static_cast<uint32_t>(i);
+                }
+            }
+        }
+        rConstantVec.push_back(rValue);
+        return static_cast<uint32_t>(rConstantVec.size() - 1);
+    }
+
+    uint32_t AddName(const std::string &rName) {
+        auto &rNameVec = m_rProgram.m_nameVec;
+        auto iter = std::find(rNameVec.begin(), rNameVec.end(), rName);
+        if(iter != rNameVec.end()) {
+            return static_cast<uint32_t>(iter - rNameVec.begin());
+        }
+        rNameVec.push_back(rName);
+        return static_cast<uint32_t>(rNameVec.size() - 1);
+    }
+
+    ScriptProgram &m_rProgram;
+    const EnumsTable *m_pEnums;
+};
+
+ScriptProgram::EntryCache::EntryCache(const ScriptProgram &rProgram, const Blackboard::Ptr &pBlackboard): m_pBlackboard(pBlackboard),
+                                                                                                       m_pEntryArr(new std::atomic<Blackboard::Entry *>[rProgram.m_nameVec.size()]),
+                                                                                                       m_holderVec(rProgram.m_nameVec.size()) {
+    for(size_t i = 0; i < rProgram.m_nameVec.size(); ++i) {
+        if(pBlackboard) {
+            m_holderVec[i] = static_cast<const Blackboard &>(*pBlackboard).GetEntry(rProgram.m_nameVec[i]);
+        }
+        m_pEntryArr[i].store(m_holderVec[i].get(), std::memory_order_relaxed);
+    }
+}
+
+Blackboard::Entry *ScriptProgram::EntryCache::Resolve(uint32_t nameIdx, const std::string &rName, const Blackboard &rBlackboard) {
+    Blackboard::Entry *pEntry = m_pEntryArr[nameIdx].load(std::memory_order_acquire);
+    if(pEntry != nullptr and !pEntry->detached.load(std::memory_order_acquire)) {
+        return pEntry;
+    }
+
+    // created after the binding, or removed: look it up again
+    auto pNewEntry = rBlackboard.GetEntry(rName);
+    std::unique_lock lock(m_mutex);
+    if(pNewEntry) {
+        m_holderVec[nameIdx] = pNewEntry;
+    }
+    m_pEntryArr[nameIdx].store(pNewEntry.get(), std::memory_order_release);
+    return pNewEntry.get();
+}
+
+ScriptProgram::Ptr ScriptProgram::Compile(const std::vector<std::shared_ptr<Ast::ExprBase>> &rExprVec, const EnumsTablePtr &pEnums) {
+    if(rExprVec.empty()) {
+        return nullptr;
+    }
+    auto pProgram = std::make_shared<ScriptProgram>();
+    Compiler compiler(*pProgram, pEnums.get());
+    // every statement writes its value in the register 0
+    for(const auto &pExpr: rExprVec) {
+        if(!pExpr or !compiler.CompileInto(*pExpr, 0)) {
+            return nullptr;
+        }
+    }
+    return pProgram;
+}
+
+Any ScriptProgram::Execute(Ast::Environment &rEnv, EntryCache *pEntryCache) const {
+    Register localRegisterArr[LocalRegistersNum];
+    std::unique_ptr<Register[]> pHeapRegisterArr;
+    Register *pRegisterArr = localRegisterArr;
+    if(m_registersNum > LocalRegistersNum) {
+        pHeapRegisterArr.reset(new Register[m_registersNum]);
+        pRegisterArr = pHeapRegisterArr.get();
+    }
+
+    // numbers boxed for the slow paths
+    Any lhsTemp;
+    Any rhsTemp;
+
+    const size_t instructionsNum = m_instructionVec.size();
+    size_t pc = 0;
+    while(pc < instructionsNum) {
+        const Instruction &rInstruction = m_instructionVec[pc++];
+        Register &rDst = pRegisterArr[rInstruction.dst];
+
+        switch(rInstruction.opCode) {
+            case OpCode::LoadNumber: {
+                rDst.SetNumber(m_numberVec[rInstruction.arg]);
+            } break;
+            case OpCode::LoadConstant: {
+                rDst.SetConstant(m_constantVec[rInstruction.arg]);
+            } break;
+            case OpCode::LoadVariable: {
+                const auto &rName = m_nameVec[rInstruction.arg];
+                if(pEntryCache == nullptr) {
+                    rDst.SetVariable(Ast::ExprName::Load(rEnv, rName));
+                    break;
+                }
+                // the enums have been replaced by the compiler
+                Blackboard::Entry *pEntry = pEntryCache->Resolve(rInstruction.arg, rName, *rEnv.ptrVars);
+                if(pEntry == nullptr) {
+                    throw util::RuntimeError(util::StrCat("Variable not found: ", rName));
+                }
+                double number = 0.0;
+                if(pEntry->TryReadSnapshot(number)) {
+                    rDst.SetNumber(number);
+                    break;
+                }
+                ReadLock lock(pEntry->entryMutex);
+                Any value = pEntry->value;
+                lock.Unlock();
+                rDst.SetVariable(std::move(value));
+            } break;
+            case OpCode::Unary: {
+                const auto op = static_cast<Ast::ExprUnaryArithmetic::op_t>(rInstruction.op);
+                const Register &rOperand = pRegisterArr[rInstruction.lhs];
+                if(rOperand.isNumber) {
+                    rDst.SetNumber(UnaryNumber(op, rOperand.number));
+                } else {
+                    rDst.SetBoxed(Ast::ExprUnaryArithmetic::Apply(op, *rOperand.pAny));
+                }
+            } break;
+            case OpCode::Binary: {
+                const auto op = static_cast<Ast::ExprBinaryArithmetic::op_t>(rInstruction.op);
+                const Register &rLhs = pRegisterArr[rInstruction.lhs];
+                const Register &rRhs = pRegisterArr[rInstruction.rhs];
+                double result = 0.0;
+                if(rLhs.isNumber and rRhs.isNumber and BinaryNumber(op, rLhs.number, rRhs.number, result)) {
+                    rDst.SetNumber(result);
+                } else {
+                    rDst.SetBoxed(Ast::ExprBinaryArithmetic::Apply(op, rLhs.Get(lhsTemp), rRhs.Get(rhsTemp)));
+                }
+            } break;
+            case OpCode::Compare: {
+                const auto op = static_cast<Ast::ExprComparison::op_t>(rInstruction.op);
+                const Register &rLhs = pRegisterArr[rInstruction.lhs];
+                const Register &rRhs = pRegisterArr[rInstruction.rhs];
+                bool result = false;
+                if(rLhs.isNumber and rRhs.isNumber) {
+                    result = Ast::ExprComparison::Compare(op, rLhs.number, rRhs.number);
+                } else {
+                    result = Ast::ExprComparison::Compare(op, rLhs.Get(lhsTemp), rRhs.Get(rhsTemp), rEnv);
+                }
+                rDst.SetNumber(result ? 1.0 : 0.0);
+            } break;
+            case OpCode::JumpIfZero: {
+                if(rDst.number == 0.0) {
+                    pc = rInstruction.arg;
+                }
+            } break;
+            case OpCode::JumpUnless: {
+                const bool isTrue = rDst.isNumber ? (rDst.number != 0.0) : Ast::ExprIf::IsTrue(*rDst.pAny);
+                if(!isTrue) {
+                    pc = rInstruction.arg;
+                }
+            } break;
+            case OpCode::Jump: {
+                pc = rInstruction.arg;
+            } break;
+            case OpCode::PrepareAssign: {
+                const auto op = static_cast<Ast::ExprAssignment::op_t>(rInstruction.op);
+                const auto &rKey = m_nameVec[rInstruction.arg];
+                if(pEntryCache == nullptr or pEntryCache->Resolve(rInstruction.arg, rKey, *rEnv.ptrVars) == nullptr) {
+                    (void)Ast::ExprAssignment::PrepareEntry(rEnv, rKey, op);
+                }
+            } break;
+            case OpCode::Assign: {
+                const auto op = static_cast<Ast::ExprAssignment::op_t>(rInstruction.op);
+                const auto &rKey = m_nameVec[rInstruction.arg];
+                Blackboard::Entry *pEntry = nullptr;
+                std::shared_ptr<Blackboard::Entry> pLookupEntry;
+                if(pEntryCache != nullptr) {
+                    pEntry = pEntryCache->Resolve(rInstruction.arg, rKey, *rEnv.ptrVars);
+                }
+                if(pEntry == nullptr) {
+                    pLookupEntry = Ast::ExprAssignment::PrepareEntry(rEnv, rKey, op);
+                    pEntry = pLookupEntry.get();
+                }
+                rDst.SetBoxed(Ast::ExprAssignment::Assign(rEnv, rKey, *pEntry, op, rDst.Get(lhsTemp)));
+            } break;
+        }
+    }
+
+    const Register &rResult = pRegisterArr[0];
+    if(rResult.isNumber) {
+        return Any(rResult.number);
+    }
+    return *rResult.pAny;
+}
+
+}// namespace behaviortree
@@ -0,0 +1,322 @@
+#include "behaviortree/util/timer_service.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "behaviortree/util/clock.h"
+
+namespace behaviortree {
+namespace {
+// the service is destroyed (and its thread stopped) when nobody uses it
+std::mutex s_serviceMutex;
+std::weak_ptr<TimerService> s_pWeakService;
+// set by the destructor, when it runs in the service thread
+thread_local bool t_serviceDestroyed{false};
+}// namespace
+
+std::shared_ptr<TimerService> TimerService::Get() {
+    std::unique_lock lock(s_serviceMutex);
+    auto pService = s_pWeakService.lock();
+    if(!pService) {
+        pService = std::make_shared<TimerService>();
+        s_pWeakService = pService;
+    }
+    return pService;
+}
+
+void TimerService::NotifyClockChanged() {
+    std::shared_ptr<TimerService> pService;
+    {
+        std::unique_lock lock(s_serviceMutex);
+        pService = s_pWeakService.lock();
+    }
+    if(pService) {
+        // the service thread reads the time with m_mutex locked: it either
+        // sees the new time, or is waiting when it is notified
+        {
+            std::unique_lock lock(pService->m_mutex);
+        }
+        pService->m_workCv.notify_one();
+    }
+}
+
+TimerService::TimerService(): m_startTime(Clock::PreciseNow()) {
+    m_thread = std::thread([this]() {
+        Run();
+    });
+}
+
+TimerService::~TimerService() {
+    {
+        std::unique_lock lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workCv.notify_one();
+    if(std::this_thread::get_id() == m_thread.get_id()) {
+        // released by a handler: Run() returns without touching the service
+        t_serviceDestroyed = true;
+        m_thread.detach();
+    } else {
+        m_thread.join();
+    }
+}
+
+uint64_t TimerService::Add(const std::shared_ptr<Client> &pClient, std::chrono::milliseconds duration, Handler handler) {
+    auto pTimer = std::make_unique<Timer>();
+    pTimer->handler = std::move(handler);
+    pTimer->pClient = pClient;
+    // round up: a timer must never expire earlier than requested
+    const auto expiryTick = static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(Clock::PreciseNow() - m_startTime + duration).count()));
+
+    std::unique_lock lock(m_mutex);
+    pTimer->id = ++m_idCounter;
+    pTimer->expiryTick = std::max(expiryTick, m_currentTick + 1);
+    const uint64_t timerId = pTimer->id;
+    const bool earlier = pTimer->expiryTick < m_nextWakeTick;
+
+    Insert(pTimer.get());
+    m_timerMap.insert({timerId, std::move(pTimer)});
+    pClient->timerIdSet.insert(timerId);
+    pClient->pendingNum++;
+    lock.unlock();
+
+    if(earlier) {
+        m_workCv.notify_one();
+    }
+    return timerId;
+}
+
+size_t TimerService::Cancel(Client &rClient, uint64_t timerId) {
+    std::unique_lock lock(m_mutex);
+    auto iter = m_timerMap.find(timerId);
+    if(iter == m_timerMap.end() or iter->second->pClient.get() != &rClient) {
+        return 0;
+    }
+    auto pTimer = std::move(iter->second);
+    m_timerMap.erase(iter);
+    rClient.timerIdSet.erase(timerId);
+    Unlink(pTimer.get());
+    m_abortedVec.push_back(std::move(pTimer));
+    lock.unlock();
+
+    m_workCv.notify_one();
+    return 1;
+}
+
+size_t TimerService::CancelAll(Client &rClient) {
+    std::unique_lock lock(m_mutex);
+    const size_t cancelledNum = rClient.timerIdSet.size();
+    for(uint64_t timerId: rClient.timerIdSet) {
+        auto iter = m_timerMap.find(timerId);
+        auto pTimer = std::move(iter->second);
+        m_timerMap.erase(iter);
+        Unlink(pTimer.get());
+        m_abortedVec.push_back(std::move(pTimer));
+    }
+    rClient.timerIdSet.clear();
+    lock.unlock();
+
+    if(cancelledNum > 0) {
+        m_workCv.notify_one();
+    }
+    return cancelledNum;
+}
+
+void TimerService::Wait(Client &rClient) {
+    if(std::this_thread::get_id() == m_thread.get_id()) {
+        return;
+    }
+    std::unique_lock lock(m_mutex);
+    rClient.idleCv.wait(lock, [&rClient]() {
+        return rClient.pendingNum == 0;
+    });
+}
+
+size_t TimerService::GetTimersNum() const {
+    std::unique_lock lock(m_mutex);
+    return m_timerMap.size();
+}
+
+void TimerService::Run() {
+    std::vector<std::unique_ptr<Timer>> batchVec;
+    std::vector<bool> abortedVec;
+
+    std::unique_lock lock(m_mutex);
+    while(!m_stopping) {
+        AdvanceTo(NowTick(), batchVec);
+        abortedVec.assign(batchVec.size(), false);
+        for(auto &pTimer: m_abortedVec) {
+            batchVec.push_back(std::move(pTimer));
+            abortedVec.push_back(true);
+        }
+        m_abortedVec.clear();
+
+        if(!batchVec.empty()) {
+            // the handlers may own the last references to the service: keep
+            // it alive until they are destroyed (null if already being destroyed)
+            auto pSelf = weak_from_this().lock();
+            lock.unlock();
+            for(size_t i = 0; i < batchVec.size(); i++) {
+                batchVec[i]->handler(abortedVec[i]);
+                // released before Wait() returns, and without holding the lock
+                batchVec[i]->handler = nullptr;
+            }
+            lock.lock();
+
+            for(auto &pTimer: batchVec) {
+                auto &rClient = *pTimer->pClient;
+                if(--rClient.pendingNum == 0) {
+                    rClient.idleCv.notify_all();
+                }
+            }
+            lock.unlock();
+            batchVec.clear();
+            pSelf.reset();
+            if(t_serviceDestroyed) {
+                return;
+            }
+            lock.lock();
+            continue;
+        }
+
+        m_nextWakeTick = NextWakeTick();
+        // the virtual time is advanced by the application, see NotifyClockChanged()
+        if(m_nextWakeTick == UINT64_MAX or Clock::GetMode() == Clock::Mode::Virtual) {
+            m_workCv.wait(lock);
+        } else {
+            m_workCv.wait_until(lock, TickTime(m_nextWakeTick));
+        }
+        m_nextWakeTick = UINT64_MAX;
+    }
+}
+
+uint64_t TimerService::NowTick() const {
+    // the virtual time may be set before the start of the service
+    return static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(Clock::PreciseNow() - m_startTime).count()));
+}
+
+std::chrono::steady_clock::time_point TimerService::TickTime(uint64_t tick) const {
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_startTime + std::chrono::milliseconds(tick)));
+}
+
+void TimerService::Insert(Timer *pTimer) {
+    const uint64_t delta = pTimer->expiryTick > m_currentTick ? pTimer->expiryTick - m_currentTick : 0;
+    uint32_t level = 0;
+    while(level + 1 < LevelsNum and delta >= (uint64_t(1) << (LevelBits * (level + 1)))) {
+        level++;
+    }
+
+    uint64_t tick = pTimer->expiryTick;
+    if(delta >= (uint64_t(1) << (LevelBits * LevelsNum))) {
+        // beyond the range of the wheel: park it in the farthest slot,
+        // it will be inserted again when that slot is cascaded
+        tick = m_currentTick + (uint64_t(1) << (LevelBits * LevelsNum)) - 1;
+    }
+
+    const auto slot = static_cast<uint32_t>((tick >> (LevelBits * level)) & (SlotsNum - 1));
+    auto &rLevel = m_levelArr[level];
+    pTimer->level = level;
+    pTimer->slot = slot;
+    pTimer->pPrev = nullptr;
+    pTimer->pNext = rLevel.slotArr[slot];
+    if(pTimer->pNext) {
+        pTimer->pNext->pPrev = pTimer;
+    }
+    rLevel.slotArr[slot] = pTimer;
+    rLevel.occupancyBits |= uint64_t(1) << slot;
+}
+
+void TimerService::Unlink(Timer *pTimer) {
+    auto &rLevel = m_levelArr[pTimer->level];
+    if(pTimer->pPrev) {
+        pTimer->pPrev->pNext = pTimer->pNext;
+    } else {
+        rLevel.slotArr[pTimer->slot] = pTimer->pNext;
+    }
+    if(pTimer->pNext) {
+        pTimer->pNext->pPrev = pTimer->pPrev;
+    }
+    if(rLevel.slotArr[pTimer->slot] == nullptr) {
+        rLevel.occupancyBits &= ~(uint64_t(1) << pTimer->slot);
+    }
+    pTimer->pPrev = nullptr;
+    pTimer->pNext = nullptr;
+}
+
+void TimerService::Cascade(uint32_t level, uint32_t slot) {
+    auto &rLevel = m_levelArr[level];
+    Timer *pTimer = rLevel.slotArr[slot];
+    rLevel.slotArr[slot] = nullptr;
+    rLevel.occupancyBits &= ~(uint64_t(1) << slot);
+    while(pTimer) {
+        Timer *pNext = pTimer->pNext;
+        Insert(pTimer);
+        pTimer = pNext;
+    }
+}
+
+void TimerService::AdvanceTo(uint64_t tick, std::vector<std::unique_ptr<Timer>> &rExpiredVec) {
+    while(m_currentTick < tick) {
+        if(m_timerMap.empty()) {
+            m_currentTick = tick;
+            break;
+        }
+        if(m_levelArr[0].occupancyBits == 0) {
+            // nothing can expire before the next cascade: skip to it
+            const uint64_t lastTick = m_currentTick | (SlotsNum - 1);
+            if(lastTick > m_currentTick) {
+                m_currentTick = std::min(lastTick, tick);
+                continue;
+            }
+        }
+
+        const uint64_t currentTick = ++m_currentTick;
+        // cascade from the highest level, so that the timers moved down
+        // reach the slots that are going to be processed
+        uint32_t topLevel = 0;
+        while(topLevel + 1 < LevelsNum and (currentTick & ((uint64_t(1) << (LevelBits * (topLevel + 1))) - 1)) == 0) {
+            topLevel++;
+        }
+        for(uint32_t level = topLevel; level > 0; level--) {
+            Cascade(level, static_cast<uint32_t>((currentTick >> (LevelBits * level)) & (SlotsNum - 1)));
+        }
+
+        auto &rLevel = m_levelArr[0];
+        const auto slot = static_cast<uint32_t>(currentTick & (SlotsNum - 1));
+        Timer *pTimer = rLevel.slotArr[slot];
+        rLevel.slotArr[slot] = nullptr;
+        rLevel.occupancyBits &= ~(uint64_t(1) << slot);
+        const size_t firstIdx = rExpiredVec.size();
+        while(pTimer) {
+            Timer *pNext = pTimer->pNext;
+            auto iter = m_timerMap.find(pTimer->id);
+            pTimer->pClient->timerIdSet.erase(pTimer->id);
+            rExpiredVec.push_back(std::move(iter->second));
+            m_timerMap.erase(iter);
+            pTimer = pNext;
+        }
+        // the slots are filled in reverse, and cascaded: restore the order of Add()
+        std::sort(rExpiredVec.begin() + firstIdx, rExpiredVec.end(), [](const std::unique_ptr<Timer> &pLeft, const std::unique_ptr<Timer> &pRight) {
+            return pLeft->id < pRight->id;
+        });
+    }
+}
+
+uint64_t TimerService::NextWakeTick() const {
+    uint64_t nextTick = UINT64_MAX;
+    const uint64_t bits = m_levelArr[0].occupancyBits;
+    if(bits != 0) {
+        const auto startSlot = static_cast<int>((m_currentTick + 1) & (SlotsNum - 1));
+        nextTick = m_currentTick + 1 + static_cast<uint64_t>(std::countr_zero(std::rotr(bits, startSlot)));
+    }
+    for(uint32_t level = 1; level < LevelsNum; level++) {
+        if(m_levelArr[level].occupancyBits != 0) {
+            // wake up at the next cascade
+            nextTick = std::min(nextTick, (m_currentTick | (SlotsNum - 1)) + 1);
+            break;
+        }
+    }
+    return nextTick;
+}
+
+}// namespace behaviortree
@@ -0,0 +1,77 @@
+#include "behaviortree/tree_arena.h"
+
+#include <new>
+
+namespace behaviortree {
+namespace {
+// Placed in front of every block, also the ones of the heap, to know where
+// it comes from: operator delete only receives the pointer, long after the
+// Scope ended. Its size preserves the fundamental alignment of the block.
+struct alignas(std::max_align_t) BlockHeader {
+    TreeArena *pArena;
+};
+
+TreeArena *&CurrentArena() {
+    thread_local TreeArena *pArena = nullptr;
+    return pArena;
+}
+}// namespace
+
+TreeArena::TreeArena(size_t initialSize): m_resource(initialSize) {}
+
+TreeArena::Ptr TreeArena::Create(size_t initialSize) {
+    return Ptr(new TreeArena(initialSize), [](TreeArena *pArena) {
+        pArena->Release();
+    });
+}
+
+size_t TreeArena::GetAllocatedBytes() const {
+    return m_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void *TreeArena::Allocate(size_t size) {
+    TreeArena *pArena = CurrentArena();
+    void *pBlock;
+    if(pArena != nullptr) {
+        pBlock = pArena->m_resource.allocate(sizeof(BlockHeader) + size, alignof(BlockHeader));
+        pArena->m_allocatedBytes.fetch_add(sizeof(BlockHeader) + size, std::memory_order_relaxed);
+        pArena->Acquire();
+    } else {
+        pBlock = ::operator new(sizeof(BlockHeader) + size);
+    }
+    auto pHeader = new(pBlock) BlockHeader{pArena};
+    return pHeader + 1;
+}
+
+void TreeArena::Deallocate(void *pMemory) noexcept {
+    if(pMemory == nullptr) {
+        return;
+    }
+    auto pHeader = static_cast<BlockHeader *>(pMemory) - 1;
+    if(pHeader->pArena != nullptr) {
+        // the memory itself is released with the whole arena
+        pHeader->pArena->Release();
+    } else {
+        ::operator delete(pHeader);
+    }
+}
+
+void TreeArena::Acquire() {
+    m_refsNum.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TreeArena::Release() {
+    if(m_refsNum.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+TreeArena::Scope::Scope(const Ptr &pArena): m_pPreArena(CurrentArena()) {
+    CurrentArena() = pArena.get();
+}
+
+TreeArena::Scope::~Scope() {
+    CurrentArena() = m_pPreArena;
+}
+
+}// namespace behaviortree
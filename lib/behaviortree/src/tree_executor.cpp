@@ -0,0 +1,444 @@
+import shadow.thread.pool;
+
+#include "behaviortree/tree_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace behaviortree {
+namespace {
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}// namespace
+
+struct TreeExecutor::PImpl {
+    struct TreeEntry {
+        enum class State : uint8_t {
+            // RUNNING, waiting for a wake-up
+            Idle = 0,
+            // in a worker queue
+            Queued,
+            Ticking,
+            // woken up while ticking: queue it again after the tick, if still RUNNING
+            TickingPending,
+            // scheduled while ticking: queue it again after the tick, even if completed
+            TickingRestart,
+            // completed (or failed): only Schedule() restarts it
+            Done
+        };
+
+        TreeId id{0};
+        Tree tree;
+        std::atomic<State> state{State::Done};
+        std::atomic_bool removed{false};
+        // held during the tick, lets Remove() wait for it
+        std::mutex tickMutex;
+        // when the tree was woken up, to compute the latency
+        std::atomic<int64_t> wakeUpNs{0};
+
+        mutable std::mutex statsMutex;
+        TreeStats stats;
+    };
+
+    using EntryPtr = std::shared_ptr<TreeEntry>;
+    using State = TreeEntry::State;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<EntryPtr> entryDeque;
+    };
+
+    // Shared by the wake-up listeners of the trees: ~TreeExecutor() closes it,
+    // waiting for the listeners running in other threads.
+    struct ListenerGate {
+        std::shared_mutex mutex;
+        PImpl *pPImpl{nullptr};
+
+        void Wake(const std::weak_ptr<TreeEntry> &pWeakEntry) {
+            std::shared_lock lock(mutex);
+            if(pPImpl == nullptr) {
+                return;
+            }
+            if(auto pEntry = pWeakEntry.lock()) {
+                pPImpl->Wake(pEntry, false);
+            }
+        }
+
+        void Close() {
+            std::unique_lock lock(mutex);
+            pPImpl = nullptr;
+        }
+    };
+
+    explicit PImpl(const Options &rOptions): options(rOptions),
+                                             pListenerGate(std::make_shared<ListenerGate>()),
+                                             pool(rOptions.threadsNum) {
+        pListenerGate->pPImpl = this;
+        queueVec.reserve(pool.get_thread_count());
+        for(size_t i = 0; i < pool.get_thread_count(); i++) {
+            queueVec.push_back(std::make_unique<WorkerQueue>());
+        }
+        for(size_t i = 0; i < queueVec.size(); i++) {
+            pool.detach_task([this, i]() {
+                WorkerLoop(i);
+            });
+        }
+        lastStatsNs = NowNs();
+        if(options.heartbeat.count() > 0) {
+            heartbeatThread = std::thread([this]() {
+                HeartbeatLoop();
+            });
+        }
+    }
+
+    void Stop() {
+        {
+            std::scoped_lock lock(sleepMutex, heartbeatMutex);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        heartbeatCv.notify_all();
+        if(heartbeatThread.joinable()) {
+            heartbeatThread.join();
+        }
+        pool.wait();
+    }
+
+    /// Queue the tree, unless it is already queued. A tree being ticked
+    /// is queued again at the end of the tick.
+    void Wake(const EntryPtr &pEntry, bool restart) {
+        if(pEntry->removed.load(std::memory_order_acquire)) {
+            return;
+        }
+        State state = pEntry->state.load(std::memory_order_acquire);
+        while(true) {
+            State nextState;
+            switch(state) {
+                case State::Idle: {
+                    nextState = State::Queued;
+                } break;
+                case State::Done: {
+                    if(!restart) {
+                        return;
+                    }
+                    nextState = State::Queued;
+                } break;
+                case State::Ticking: {
+                    nextState = restart ? State::TickingRestart : State::TickingPending;
+                } break;
+                case State::TickingPending: {
+                    if(!restart) {
+                        return;
+                    }
+                    nextState = State::TickingRestart;
+                } break;
+                default: {
+                    // already scheduled: coalesce
+                    return;
+                }
+            }
+            if(pEntry->state.compare_exchange_weak(state, nextState, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                pEntry->wakeUpNs.store(NowNs(), std::memory_order_relaxed);
+                if(nextState == State::Queued) {
+                    Push(pEntry);
+                }
+                return;
+            }
+        }
+    }
+
+    void Push(const EntryPtr &pEntry) {
+        // a tree woken up by a worker stays on the same worker
+        size_t queueIdx;
+        auto pPool = shadow::thread::this_thread::get_pool();
+        auto threadIdx = shadow::thread::this_thread::get_index();
+        if(pPool and *pPool == static_cast<void *>(&pool) and threadIdx) {
+            queueIdx = *threadIdx;
+        } else {
+            queueIdx = nextQueueIdx.fetch_add(1, std::memory_order_relaxed) % queueVec.size();
+        }
+        {
+            auto &rQueue = *queueVec[queueIdx];
+            std::unique_lock lock(rQueue.mutex);
+            // counted before it can be popped, so that the counter never underflows
+            queuedNum.fetch_add(1, std::memory_order_release);
+            rQueue.entryDeque.push_back(pEntry);
+        }
+        {
+            std::unique_lock lock(sleepMutex);
+        }
+        sleepCv.notify_one();
+    }
+
+    EntryPtr Pop(size_t queueIdx) {
+        {
+            auto &rQueue = *queueVec[queueIdx];
+            std::unique_lock lock(rQueue.mutex);
+            if(!rQueue.entryDeque.empty()) {
+                EntryPtr pEntry = std::move(rQueue.entryDeque.front());
+                rQueue.entryDeque.pop_front();
+                queuedNum.fetch_sub(1, std::memory_order_relaxed);
+                return pEntry;
+            }
+        }
+        // steal from the back of the other queues
+        for(size_t i = 1; i < queueVec.size(); i++) {
+            auto &rQueue = *queueVec[(queueIdx + i) % queueVec.size()];
+            std::unique_lock lock(rQueue.mutex);
+            if(!rQueue.entryDeque.empty()) {
+                EntryPtr pEntry = std::move(rQueue.entryDeque.back());
+                rQueue.entryDeque.pop_back();
+                queuedNum.fetch_sub(1, std::memory_order_relaxed);
+                stealsNum.fetch_add(1, std::memory_order_relaxed);
+                return pEntry;
+            }
+        }
+        return nullptr;
+    }
+
+    void WorkerLoop(size_t queueIdx) {
+        while(!stopping.load(std::memory_order_acquire)) {
+            if(auto pEntry = Pop(queueIdx)) {
+                TickEntry(pEntry);
+                continue;
+            }
+            std::unique_lock lock(sleepMutex);
+            sleepCv.wait(lock, [this]() {
+                return stopping.load() or queuedNum.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+
+    void TickEntry(const EntryPtr &pEntry) {
+        if(pEntry->removed.load(std::memory_order_acquire)) {
+            return;
+        }
+        // only the worker that popped the tree can leave the Queued state
+        pEntry->state.store(State::Ticking, std::memory_order_release);
+
+        const int64_t startNs = NowNs();
+        NodeStatus nodeStatus = NodeStatus::Failure;
+        std::string error;
+        {
+            std::unique_lock tickLock(pEntry->tickMutex);
+            // Remove() may have halted the tree while the lock was taken
+            if(pEntry->removed.load(std::memory_order_acquire)) {
+                return;
+            }
+            try {
+                nodeStatus = pEntry->tree.TickExactlyOnce();
+            } catch(const std::exception &rException) {
+                error = rException.what();
+                try {
+                    pEntry->tree.HaltTree();
+                } catch(...) {
+                }
+            }
+        }
+        const int64_t endNs = NowNs();
+        ticksNum.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::unique_lock lock(pEntry->statsMutex);
+            auto &rStats = pEntry->stats;
+            rStats.nodeStatus = nodeStatus;
+            rStats.ticksNum++;
+            rStats.lastLatency = std::chrono::nanoseconds(std::max<int64_t>(0, startNs - pEntry->wakeUpNs.load(std::memory_order_relaxed)));
+            rStats.maxLatency = std::max(rStats.maxLatency, rStats.lastLatency);
+            rStats.lastTickDuration = std::chrono::nanoseconds(endNs - startNs);
+            rStats.maxTickDuration = std::max(rStats.maxTickDuration, rStats.lastTickDuration);
+            rStats.lastError = std::move(error);
+        }
+
+        // the wake-ups received during the tick are meaningless once it completed,
+        // unlike a Schedule()
+        State state = State::Ticking;
+        while(true) {
+            State nextState;
+            if(state == State::TickingRestart) {
+                nextState = State::Queued;
+            } else if(nodeStatus != NodeStatus::Running) {
+                nextState = State::Done;
+            } else {
+                nextState = state == State::Ticking ? State::Idle : State::Queued;
+            }
+            if(pEntry->state.compare_exchange_weak(state, nextState, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                if(nextState == State::Queued) {
+                    Push(pEntry);
+                }
+                return;
+            }
+        }
+    }
+
+    void HeartbeatLoop() {
+        std::unique_lock lock(heartbeatMutex);
+        while(!heartbeatCv.wait_for(lock, options.heartbeat, [this]() {
+            return stopping.load();
+        })) {
+            lock.unlock();
+            for(const auto &pEntry: GetEntries()) {
+                Wake(pEntry, false);
+            }
+            lock.lock();
+        }
+    }
+
+    std::vector<EntryPtr> GetEntries() const {
+        std::unique_lock lock(treesMutex);
+        std::vector<EntryPtr> entryVec;
+        entryVec.reserve(entryMap.size());
+        for(const auto &[_, pEntry]: entryMap) {
+            entryVec.push_back(pEntry);
+        }
+        return entryVec;
+    }
+
+    EntryPtr FindEntry(TreeId treeId) const {
+        std::unique_lock lock(treesMutex);
+        auto it = entryMap.find(treeId);
+        return it == entryMap.end() ? nullptr : it->second;
+    }
+
+    Options options;
+
+    mutable std::mutex treesMutex;
+    std::unordered_map<TreeId, EntryPtr> entryMap;
+    TreeId nextTreeId{1};
+
+    std::vector<std::unique_ptr<WorkerQueue>> queueVec;
+    std::atomic<size_t> nextQueueIdx{0};
+    std::atomic<size_t> queuedNum{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    std::atomic_bool stopping{false};
+
+    std::mutex heartbeatMutex;
+    std::condition_variable heartbeatCv;
+    std::thread heartbeatThread;
+
+    std::atomic<uint64_t> ticksNum{0};
+    std::atomic<uint64_t> stealsNum{0};
+
+    mutable std::mutex statsMutex;
+    mutable uint64_t lastStatsTicksNum{0};
+    mutable int64_t lastStatsNs{0};
+
+    std::shared_ptr<ListenerGate> pListenerGate;
+
+    // last member: its threads are joined before the rest is destroyed
+    shadow::thread::Pool<shadow::thread::tp::none> pool;
+};
+
+TreeExecutor::TreeExecutor(): TreeExecutor(Options{}) {}
+
+TreeExecutor::TreeExecutor(const Options &rOptions): m_pPImpl(new PImpl(rOptions)) {}
+
+TreeExecutor::~TreeExecutor() {
+    // unregister the listeners before the teardown: a wake-up emitted by
+    // another thread must not reach the workers being stopped
+    const auto entryVec = m_pPImpl->GetEntries();
+    for(const auto &pEntry: entryVec) {
+        pEntry->removed.store(true, std::memory_order_release);
+        pEntry->tree.m_wakeUp->SetListener(nullptr);
+    }
+    m_pPImpl->pListenerGate->Close();
+
+    m_pPImpl->Stop();
+    for(const auto &pEntry: entryVec) {
+        pEntry->tree.HaltTree();
+    }
+}
+
+TreeExecutor::TreeId TreeExecutor::Add(Tree &&rTree) {
+    auto pEntry = std::make_shared<PImpl::TreeEntry>();
+    pEntry->tree = std::move(rTree);
+    if(!pEntry->tree.m_wakeUp) {
+        pEntry->tree.Initialize();
+    }
+
+    std::weak_ptr<PImpl::TreeEntry> pWeakEntry = pEntry;
+    pEntry->tree.m_wakeUp->SetListener([pListenerGate = m_pPImpl->pListenerGate, pWeakEntry]() {
+        pListenerGate->Wake(pWeakEntry);
+    });
+
+    {
+        std::unique_lock lock(m_pPImpl->treesMutex);
+        pEntry->id = m_pPImpl->nextTreeId++;
+        m_pPImpl->entryMap.insert({pEntry->id, pEntry});
+    }
+    m_pPImpl->Wake(pEntry, true);
+    return pEntry->id;
+}
+
+bool TreeExecutor::Remove(TreeId treeId) {
+    PImpl::EntryPtr pEntry;
+    {
+        std::unique_lock lock(m_pPImpl->treesMutex);
+        auto it = m_pPImpl->entryMap.find(treeId);
+        if(it == m_pPImpl->entryMap.end()) {
+            return false;
+        }
+        pEntry = std::move(it->second);
+        m_pPImpl->entryMap.erase(it);
+    }
+    pEntry->removed.store(true, std::memory_order_release);
+    pEntry->tree.m_wakeUp->SetListener(nullptr);
+
+    // wait for the current tick
+    std::unique_lock tickLock(pEntry->tickMutex);
+    pEntry->tree.HaltTree();
+    return true;
+}
+
+bool TreeExecutor::Schedule(TreeId treeId) {
+    if(auto pEntry = m_pPImpl->FindEntry(treeId)) {
+        m_pPImpl->Wake(pEntry, true);
+        return true;
+    }
+    return false;
+}
+
+std::optional<TreeExecutor::TreeStats> TreeExecutor::GetTreeStats(TreeId treeId) const {
+    if(auto pEntry = m_pPImpl->FindEntry(treeId)) {
+        std::unique_lock lock(pEntry->statsMutex);
+        return pEntry->stats;
+    }
+    return std::nullopt;
+}
+
+TreeExecutor::Stats TreeExecutor::GetStats() const {
+    Stats stats;
+    stats.ticksNum = m_pPImpl->ticksNum.load(std::memory_order_relaxed);
+    stats.stealsNum = m_pPImpl->stealsNum.load(std::memory_order_relaxed);
+    stats.queueDepth = m_pPImpl->queuedNum.load(std::memory_order_relaxed);
+    {
+        std::unique_lock lock(m_pPImpl->treesMutex);
+        stats.treesNum = m_pPImpl->entryMap.size();
+    }
+
+    std::unique_lock lock(m_pPImpl->statsMutex);
+    const int64_t nowNs = NowNs();
+    const int64_t elapsedNs = nowNs - m_pPImpl->lastStatsNs;
+    if(elapsedNs > 0) {
+        stats.ticksPerSecond = double(stats.ticksNum - m_pPImpl->lastStatsTicksNum) * 1e9 / double(elapsedNs);
+    }
+    m_pPImpl->lastStatsTicksNum = stats.ticksNum;
+    m_pPImpl->lastStatsNs = nowNs;
+    return stats;
+}
+
+size_t TreeExecutor::GetThreadsNum() const {
+    return m_pPImpl->pool.get_thread_count();
+}
+
+}// namespace behaviortree
@@ -1,16 +1,113 @@
 #include "behaviortree/tree_node.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstring>
+#include <mutex>
+#include <optional>
 
 namespace behaviortree {
+namespace {
+// Immutable set of injected callbacks. A new snapshot is published every
+// time a callback is injected, so that ExecuteTick() can read them without
+// locking or copying the std::function objects.
+struct TickCallbacks {
+    TreeNode::PreTickCallback preTickCallback;
+    TreeNode::PostTickCallback postTickCallback;
+    TreeNode::TickMonitorCallback tickMonitorCallback;
+
+    [[nodiscard]] bool Empty() const {
+        return !preTickCallback and !postTickCallback and !tickMonitorCallback;
+    }
+};
+
+// Invoke the tick monitor when leaving the scope, even if Tick() throws.
+class TickMonitorScope {
+ public:
+    TickMonitorScope(TreeNode &rNode, const TreeNode::TickMonitorCallback &rMonitorTick, const NodeStatus &rNodeStatus): m_node(rNode),
+                                                                                                                             m_monitorTick(rMonitorTick),
+                                                                                                                             m_nodeStatus(rNodeStatus),
+                                                                                                                             m_beginTime(std::chrono::steady_clock::now()) {}
+
+    ~TickMonitorScope() {
+        auto endTime = std::chrono::steady_clock::now();
+        m_monitorTick(m_node, m_nodeStatus, std::chrono::duration_cast<std::chrono::microseconds>(endTime - m_beginTime));
+    }
+
+ private:
+    TreeNode &m_node;
+    const TreeNode::TickMonitorCallback &m_monitorTick;
+    const NodeStatus &m_nodeStatus;
+    std::chrono::steady_clock::time_point m_beginTime;
+};
+
+void UpdatePortBinding(std::unordered_map<std::string, PortBinding> &rBindingMap, const std::string &rPortName, std::string_view remappedPort, const Blackboard::Ptr &pBlackboard, uint64_t configVersion) {
+    // assign, instead of replacing the element of the map: the binding keeps its address
+    auto &rBinding = rBindingMap[rPortName];
+    rBinding = PortBinding::Create(rPortName, remappedPort, pBlackboard);
+    rBinding.configVersion = configVersion;
+}
+
+// Binding of an input port that is not remapped, from its default value in the manifest
+std::optional<PortBinding> CreateDefaultBinding(const NodeConfig &rConfig, const std::string &rPortName) {
+    if(rConfig.pManifest == nullptr) {
+        return std::nullopt;
+    }
+    auto iter = rConfig.pManifest->portMap.find(rPortName);
+    if(iter == rConfig.pManifest->portMap.end() or iter->second.Direction() == PortDirection::Out) {
+        return std::nullopt;
+    }
+    const auto &rDefaultValue = iter->second.DefaultValue();
+    if(rDefaultValue.Empty()) {
+        return std::nullopt;
+    }
+
+    PortBinding binding;
+    if(rDefaultValue.IsString()) {
+        binding = PortBinding::Create(rPortName, rDefaultValue.Cast<std::string>(), rConfig.pBlackboard);
+    } else {
+        binding.kind = PortBinding::Kind::Constant;
+        binding.portName = rPortName;
+        binding.constant = rDefaultValue;
+        binding.pBlackboard = rConfig.pBlackboard.get();
+    }
+    return binding;
+}
+
+std::optional<PortBinding> CreateBinding(const NodeConfig &rConfig, const std::string &rPortName, bool isInput) {
+    const auto &rPortMap = isInput ? rConfig.inputPortMap : rConfig.outputPortMap;
+    auto iter = rPortMap.find(rPortName);
+    if(iter != rPortMap.end()) {
+        return PortBinding::Create(rPortName, iter->second, rConfig.pBlackboard);
+    }
+    if(isInput) {
+        return CreateDefaultBinding(rConfig, rPortName);
+    }
+    return std::nullopt;
+}
+
+// False if the ports were remapped, or the blackboard replaced, after the binding was created
+bool IsBindingCurrent(const PortBinding &rBinding, const NodeConfig &rConfig, uint64_t configVersion) {
+    return rBinding.configVersion == configVersion and rBinding.pBlackboard == rConfig.pBlackboard.get();
+}
+}// namespace
+
 struct TreeNode::PImpl {
     PImpl(std::string name, NodeConfig config): name(std::move(name)), config(std::move(config)) {}
 
+    // next to the node, in the TreeArena of the tree being built (if any)
+    static void *operator new(std::size_t size) {
+        return TreeArena::Allocate(size);
+    }
+
+    static void operator delete(void *pMemory) noexcept {
+        TreeArena::Deallocate(pMemory);
+    }
+
     const std::string name;
 
-    NodeStatus nodeStatus{NodeStatus::Idle};
+    std::atomic<NodeStatus> nodeStatus{NodeStatus::Idle};
 
     std::condition_variable stateConditionVariable;
 
@@ -22,16 +119,133 @@ struct TreeNode::PImpl {
 
     std::string registrationId;
 
-    PreTickCallback preTickCallback;
-    PostTickCallback postTickCallback;
-    TickMonitorCallback tickMonitorCallback;
+    // number of threads blocked in WaitValidStatus()
+    std::atomic<uint32_t> statusWaitersNum{0};
+
+    // Wake up WaitValidStatus(). The mutex is taken only when somebody waits,
+    // to make sure that the transition isn't lost between its check and its wait.
+    void NotifyStatusWaiters() {
+        if(statusWaitersNum.load() == 0) {
+            return;
+        }
+        { std::lock_guard<std::mutex> lock(stateMutex); }
+        stateConditionVariable.notify_all();
+    }
+
+    // nullptr when no callback is injected
+    std::atomic<const TickCallbacks *> pTickCallbacks{nullptr};
+    std::unique_ptr<const TickCallbacks> pCurrentCallbacks;
+    // Replaced snapshots are released as soon as no ExecuteTick() is using
+    // callbacks, i.e. when ticksInFlight drops to zero.
+    std::vector<std::unique_ptr<const TickCallbacks>> retiredCallbacksVec;
+    std::atomic<uint32_t> ticksInFlight{0};
+    std::atomic<bool> hasRetiredCallbacks{false};
 
     std::mutex callbackInjectionMutex;
 
+    template<typename Modifier>
+    void InjectCallback(Modifier &&rModifier) {
+        std::unique_lock lock(callbackInjectionMutex);
+        auto pSnapshot = std::make_unique<TickCallbacks>(pCurrentCallbacks ? *pCurrentCallbacks : TickCallbacks{});
+        rModifier(*pSnapshot);
+        if(pSnapshot->Empty()) {
+            pSnapshot.reset();
+        }
+        pTickCallbacks.store(pSnapshot.get());
+        if(pCurrentCallbacks) {
+            retiredCallbacksVec.push_back(std::move(pCurrentCallbacks));
+            hasRetiredCallbacks.store(true);
+        }
+        pCurrentCallbacks = std::move(pSnapshot);
+        ReleaseRetiredCallbacks();
+    }
+
+    // callbackInjectionMutex must be locked
+    void ReleaseRetiredCallbacks() {
+        // A tick starting after this check reloads pTickCallbacks, which
+        // never points to a retired snapshot.
+        if(ticksInFlight.load() == 0) {
+            retiredCallbacksVec.clear();
+            hasRetiredCallbacks.store(false);
+        }
+    }
+
+    // Pin the published snapshot for the duration of a tick. Nothing is
+    // written when no callback is injected.
+    class CallbacksGuard {
+     public:
+        explicit CallbacksGuard(PImpl &rPImpl): m_pImpl(rPImpl) {
+            if(m_pImpl.pTickCallbacks.load(std::memory_order_relaxed) == nullptr) {
+                return;
+            }
+            m_pinned = true;
+            m_pImpl.ticksInFlight.fetch_add(1);
+            // reload: the value read before pinning might have been retired
+            m_pCallbacks = m_pImpl.pTickCallbacks.load();
+        }
+
+        ~CallbacksGuard() {
+            if(m_pinned and m_pImpl.ticksInFlight.fetch_sub(1) == 1 and m_pImpl.hasRetiredCallbacks.load()) {
+                std::unique_lock lock(m_pImpl.callbackInjectionMutex, std::try_to_lock);
+                if(lock.owns_lock()) {
+                    m_pImpl.ReleaseRetiredCallbacks();
+                }
+            }
+        }
+
+        CallbacksGuard(const CallbacksGuard &) = delete;
+        CallbacksGuard &operator=(const CallbacksGuard &) = delete;
+
+        [[nodiscard]] const TickCallbacks *Get() const {
+            return m_pCallbacks;
+        }
+
+     private:
+        PImpl &m_pImpl;
+        const TickCallbacks *m_pCallbacks{nullptr};
+        bool m_pinned{false};
+    };
+
     std::shared_ptr<WakeUpSignal> pWakeUp;
 
     std::array<ScriptFunction, size_t(PreCond::Count)> preParsedArr;
     std::array<ScriptFunction, size_t(PostCond::Count)> postParsedArr;
+
+    std::unordered_map<std::string, PortBinding> inputBindingMap;
+    std::unordered_map<std::string, PortBinding> outputBindingMap;
+    // incremented when the bindings are resolved again: the older ones are stale
+    uint64_t configVersion{0};
+
+    // Bindings created on demand, for the nodes that were not built by the
+    // factory or whose blackboard was replaced since ResolvePortBindings().
+    // The maps above are never modified while the node is ticked.
+    std::mutex lateBindingMutex;
+    std::unordered_map<std::string, PortBinding> lateInputBindingMap;
+    std::unordered_map<std::string, PortBinding> lateOutputBindingMap;
+
+    const PortBinding *FindBinding(const std::string &rKey, bool isInput) {
+        const auto &rBindingMap = isInput ? inputBindingMap : outputBindingMap;
+        auto iter = rBindingMap.find(rKey);
+        if(iter != rBindingMap.end() and IsBindingCurrent(iter->second, config, configVersion)) {
+            return &iter->second;
+        }
+
+        std::unique_lock lock(lateBindingMutex);
+        auto &rLateBindingMap = isInput ? lateInputBindingMap : lateOutputBindingMap;
+        auto lateIter = rLateBindingMap.find(rKey);
+        if(lateIter != rLateBindingMap.end() and IsBindingCurrent(lateIter->second, config, configVersion)) {
+            return &lateIter->second;
+        }
+        auto binding = CreateBinding(config, rKey, isInput);
+        if(!binding) {
+            return nullptr;
+        }
+        // a stale binding is updated in place: its address stays valid
+        auto &rBinding = rLateBindingMap[rKey];
+        rBinding = std::move(*binding);
+        rBinding.configVersion = configVersion;
+        return &rBinding;
+    }
 };
 
 TreeNode::TreeNode(std::string name, NodeConfig config): m_pPImpl(new PImpl(std::move(name), std::move(config))) {}
@@ -48,17 +262,10 @@ TreeNode &TreeNode::operator=(TreeNode &&rOther) noexcept {
 TreeNode::~TreeNode() {}
 
 NodeStatus TreeNode::ExecuteTick() {
-    auto newNodeStatus = m_pPImpl->nodeStatus;
-    PreTickCallback preTick;
-    PostTickCallback postTick;
-    TickMonitorCallback monitorTick;
-
-    {
-        std::scoped_lock lock(m_pPImpl->callbackInjectionMutex);
-        preTick = m_pPImpl->preTickCallback;
-        postTick = m_pPImpl->postTickCallback;
-        monitorTick = m_pPImpl->tickMonitorCallback;
-    }
+    NodeStatus newNodeStatus = m_pPImpl->nodeStatus.load(std::memory_order_relaxed);
+    // No lock and no copy: the snapshot is immutable and outlives this call
+    PImpl::CallbacksGuard callbacksGuard(*m_pPImpl);
+    const TickCallbacks *pCallbacks = callbacksGuard.Get();
 
     // a pre-condition may return the new status.
     // In this case it override the actual tick()
@@ -67,8 +274,8 @@ NodeStatus TreeNode::ExecuteTick() {
     } else {
         // injected pre-callback
         bool subStituted = false;
-        if(preTick and !IsNodeStatusCompleted(m_pPImpl->nodeStatus)) {
-            auto overrideNodeStatus = preTick(*this);
+        if(pCallbacks and pCallbacks->preTickCallback and !IsNodeStatusCompleted(newNodeStatus)) {
+            auto overrideNodeStatus = pCallbacks->preTickCallback(*this);
             if(IsNodeStatusCompleted(overrideNodeStatus)) {
                 // don't execute the actual tick()
                 subStituted = true;
@@ -78,15 +285,12 @@ NodeStatus TreeNode::ExecuteTick() {
 
         // Call the ACTUAL tick
         if(!subStituted) {
-            auto beginTime = std::chrono::steady_clock::now();
-            std::shared_ptr<void> executeLater(nullptr, [&](...) {
-                if(monitorTick) {
-                    auto endTime = std::chrono::steady_clock::now();
-                    monitorTick(*this, newNodeStatus, duration_cast<std::chrono::microseconds>(endTime - beginTime));
-                }
-            });
-
-            newNodeStatus = Tick();
+            if(pCallbacks and pCallbacks->tickMonitorCallback) {
+                TickMonitorScope monitorScope(*this, pCallbacks->tickMonitorCallback, newNodeStatus);
+                newNodeStatus = Tick();
+            } else {
+                newNodeStatus = Tick();
+            }
         }
     }
 
@@ -95,8 +299,8 @@ NodeStatus TreeNode::ExecuteTick() {
         CheckPostConditions(newNodeStatus);
     }
 
-    if(postTick) {
-        auto overrideNodeStatus = postTick(*this, newNodeStatus);
+    if(pCallbacks and pCallbacks->postTickCallback) {
+        auto overrideNodeStatus = pCallbacks->postTickCallback(*this, newNodeStatus);
         if(IsNodeStatusCompleted(overrideNodeStatus)) {
             newNodeStatus = overrideNodeStatus;
         }
@@ -124,15 +328,17 @@ void TreeNode::SetNodeStatus(NodeStatus newNodeStatus) {
         throw util::RuntimeError("Node [", GetNodeName(), "]: you are not allowed to set manually the status to IDLE. If you know what you are doing (?) use resetStatus() instead.");
     }
 
-    NodeStatus preNodeStatus;
-    {
-        std::unique_lock<std::mutex> uniqueLock(m_pPImpl->stateMutex);
-        preNodeStatus = m_pPImpl->nodeStatus;
-        m_pPImpl->nodeStatus = newNodeStatus;
+    // fast path: nothing to notify, no need to Lock
+    if(m_pPImpl->nodeStatus.load(std::memory_order_acquire) == newNodeStatus) {
+        return;
     }
+
+    const NodeStatus preNodeStatus = m_pPImpl->nodeStatus.exchange(newNodeStatus);
     if(preNodeStatus != newNodeStatus) {
-        m_pPImpl->stateConditionVariable.notify_all();
-        m_pPImpl->stateChangeSignal.notify(std::chrono::high_resolution_clock::now(), *this, preNodeStatus, newNodeStatus);
+        m_pPImpl->NotifyStatusWaiters();
+        if(m_pPImpl->stateChangeSignal.HasSubscribers()) {
+            m_pPImpl->stateChangeSignal.notify(Clock::ToTimePoint(Clock::Now()), *this, preNodeStatus, newNodeStatus);
+        }
     }
 }
 
@@ -144,8 +350,23 @@ TreeNode::PostScripts &TreeNode::PostConditionsScripts() {
     return m_pPImpl->postParsedArr;
 }
 
+bool TreeNode::HasTickHooks() const {
+    for(const auto &rParseExecutor: m_pPImpl->preParsedArr) {
+        if(rParseExecutor) {
+            return true;
+        }
+    }
+    for(const auto &rParseExecutor: m_pPImpl->postParsedArr) {
+        if(rParseExecutor) {
+            return true;
+        }
+    }
+    return m_pPImpl->pTickCallbacks.load(std::memory_order_acquire) != nullptr or m_pPImpl->stateChangeSignal.HasSubscribers();
+}
+
 Expected<NodeStatus> TreeNode::CheckPreConditions() {
-    Ast::Environment env = {GetConfig().pBlackboard, GetConfig().pEnums};
+    // the environment is built only if there is at least one script to execute
+    std::optional<Ast::Environment> env;
 
     // check the pre-conditions
     for(size_t index = 0; index < size_t(PreCond::Count); index++) {
@@ -153,13 +374,16 @@ Expected<NodeStatus> TreeNode::CheckPreConditions() {
         if(!rParseExecutor) {
             continue;
         }
+        if(!env) {
+            env.emplace(Ast::Environment{GetConfig().pBlackboard, GetConfig().pEnums});
+        }
 
         const PreCond preCond = PreCond(index);
 
         // Some preconditions are applied only when the node state is IDLE or SKIPPED
         if(m_pPImpl->nodeStatus == NodeStatus::Idle or m_pPImpl->nodeStatus == NodeStatus::Skipped) {
             // what to do if the condition is true
-            if(rParseExecutor(env).Cast<bool>()) {
+            if(rParseExecutor(*env).Cast<bool>()) {
                 switch(preCond) {
                     case PreCond::FailureIf: {
                         return NodeStatus::Failure;
@@ -178,7 +402,7 @@ Expected<NodeStatus> TreeNode::CheckPreConditions() {
             }
         } else if(m_pPImpl->nodeStatus == NodeStatus::Running and preCond == PreCond::WhileTrue) {
             // what to do if the condition is false
-            if(!rParseExecutor(env).Cast<bool>()) {
+            if(!rParseExecutor(*env).Cast<bool>()) {
                 HaltNode();
                 return NodeStatus::Skipped;
             }
@@ -205,31 +429,31 @@ void TreeNode::CheckPostConditions(NodeStatus nodeStatus) {
 }
 
 void TreeNode::ResetNodeStatus() {
-    NodeStatus preNodeStatus;
-    {
-        std::unique_lock<std::mutex> lock(m_pPImpl->stateMutex);
-        preNodeStatus = m_pPImpl->nodeStatus;
-        m_pPImpl->nodeStatus = NodeStatus::Idle;
+    if(m_pPImpl->nodeStatus.load(std::memory_order_acquire) == NodeStatus::Idle) {
+        return;
     }
 
+    const NodeStatus preNodeStatus = m_pPImpl->nodeStatus.exchange(NodeStatus::Idle);
     if(preNodeStatus != NodeStatus::Idle) {
-        m_pPImpl->stateConditionVariable.notify_all();
-        m_pPImpl->stateChangeSignal.notify(std::chrono::high_resolution_clock::now(), *this, preNodeStatus, NodeStatus::Idle);
+        m_pPImpl->NotifyStatusWaiters();
+        if(m_pPImpl->stateChangeSignal.HasSubscribers()) {
+            m_pPImpl->stateChangeSignal.notify(Clock::ToTimePoint(Clock::Now()), *this, preNodeStatus, NodeStatus::Idle);
+        }
     }
 }
 
 NodeStatus TreeNode::GetNodeStatus() const {
-    std::lock_guard<std::mutex> lock(m_pPImpl->stateMutex);
-    return m_pPImpl->nodeStatus;
+    return m_pPImpl->nodeStatus.load(std::memory_order_acquire);
 }
 
 NodeStatus TreeNode::WaitValidStatus() {
     std::unique_lock<std::mutex> lock(m_pPImpl->stateMutex);
-
-    while(IsHalted()) {
+    m_pPImpl->statusWaitersNum++;
+    while(m_pPImpl->nodeStatus.load() == NodeStatus::Idle) {
         m_pPImpl->stateConditionVariable.wait(lock);
     }
-    return m_pPImpl->nodeStatus;
+    m_pPImpl->statusWaitersNum--;
+    return m_pPImpl->nodeStatus.load();
 }
 
 const std::string &TreeNode::GetNodeName() const {
@@ -237,7 +461,7 @@ const std::string &TreeNode::GetNodeName() const {
 }
 
 bool TreeNode::IsHalted() const {
-    return m_pPImpl->nodeStatus == NodeStatus::Idle;
+    return m_pPImpl->nodeStatus.load(std::memory_order_acquire) == NodeStatus::Idle;
 }
 
 TreeNode::StatusChangeSubscriber TreeNode::SubscribeToStatusChange(TreeNode::StatusChangeCallback callback) {
@@ -245,18 +469,21 @@ TreeNode::StatusChangeSubscriber TreeNode::SubscribeToStatusChange(TreeNode::Sta
 }
 
 void TreeNode::SetPreTickFunction(PreTickCallback callback) {
-    std::unique_lock lock(m_pPImpl->callbackInjectionMutex);
-    m_pPImpl->preTickCallback = callback;
+    m_pPImpl->InjectCallback([&](TickCallbacks &rCallbacks) {
+        rCallbacks.preTickCallback = std::move(callback);
+    });
 }
 
 void TreeNode::SetPostTickFunction(PostTickCallback callback) {
-    std::unique_lock lock(m_pPImpl->callbackInjectionMutex);
-    m_pPImpl->postTickCallback = callback;
+    m_pPImpl->InjectCallback([&](TickCallbacks &rCallbacks) {
+        rCallbacks.postTickCallback = std::move(callback);
+    });
 }
 
 void TreeNode::SetTickMonitorCallback(TickMonitorCallback callback) {
-    std::unique_lock lock(m_pPImpl->callbackInjectionMutex);
-    m_pPImpl->tickMonitorCallback = callback;
+    m_pPImpl->InjectCallback([&](TickCallbacks &rCallbacks) {
+        rCallbacks.tickMonitorCallback = std::move(callback);
+    });
 }
 
 uint16_t TreeNode::GetUid() const {
@@ -348,17 +575,80 @@ void TreeNode::SetWakeUpInstance(std::shared_ptr<WakeUpSignal> pInstance) {
     m_pPImpl->pWakeUp = pInstance;
 }
 
+std::shared_ptr<WakeUpSignal> TreeNode::GetWakeUpInstance() const {
+    return m_pPImpl->pWakeUp;
+}
+
 void TreeNode::ModifyPortsRemapping(const PortsRemapping &rNewRemapping) {
+    auto &rConfig = m_pPImpl->config;
     for(const auto &newIter: rNewRemapping) {
-        auto iter = m_pPImpl->config.inputPortMap.find(newIter.first);
-        if(iter != m_pPImpl->config.inputPortMap.end()) {
+        auto iter = rConfig.inputPortMap.find(newIter.first);
+        if(iter != rConfig.inputPortMap.end()) {
             iter->second = newIter.second;
         }
-        iter = m_pPImpl->config.outputPortMap.find(newIter.first);
-        if(iter != m_pPImpl->config.outputPortMap.end()) {
+        iter = rConfig.outputPortMap.find(newIter.first);
+        if(iter != rConfig.outputPortMap.end()) {
             iter->second = newIter.second;
         }
     }
+    ResolvePortBindings();
+}
+
+void TreeNode::ResolvePortBindings() {
+    const auto &rConfig = m_pPImpl->config;
+    auto &rInputBindingMap = m_pPImpl->inputBindingMap;
+    auto &rOutputBindingMap = m_pPImpl->outputBindingMap;
+    const uint64_t configVersion = ++m_pPImpl->configVersion;
+
+    for(const auto &[portName, remappedPort]: rConfig.inputPortMap) {
+        UpdatePortBinding(rInputBindingMap, portName, remappedPort, rConfig.pBlackboard, configVersion);
+    }
+    for(const auto &[portName, remappedPort]: rConfig.outputPortMap) {
+        UpdatePortBinding(rOutputBindingMap, portName, remappedPort, rConfig.pBlackboard, configVersion);
+    }
+
+    if(rConfig.pManifest == nullptr) {
+        return;
+    }
+    // input ports that are not remapped may be declared with a default value in the manifest
+    for(const auto &rIter: rConfig.pManifest->portMap) {
+        if(rConfig.inputPortMap.count(rIter.first) != 0) {
+            continue;
+        }
+        if(auto binding = CreateDefaultBinding(rConfig, rIter.first)) {
+            binding->configVersion = configVersion;
+            rInputBindingMap[rIter.first] = std::move(*binding);
+        }
+    }
+}
+
+const PortBinding *TreeNode::GetInputBinding(const std::string &rKey) const {
+    return m_pPImpl->FindBinding(rKey, true);
+}
+
+const PortBinding *TreeNode::GetOutputBinding(const std::string &rKey) const {
+    return m_pPImpl->FindBinding(rKey, false);
+}
+
+std::string TreeNode::PortErrorMessage(std::string_view function, const std::string &rKey, const PortBinding &rBinding, PortErrorCode errorCode, std::string_view what) const {
+    switch(errorCode) {
+        case PortErrorCode::MissingBlackboard: {
+            return util::StrCat(function, "(): trying to access an invalid Blackboard");
+        }
+        case PortErrorCode::MissingEntry:
+        case PortErrorCode::EmptyEntry: {
+            return util::StrCat(function, "() failed because it was unable to find the key [", rKey, "] remapped to [", rBinding.blackboardKey, "]");
+        }
+        case PortErrorCode::NotBlackboardPointer: {
+            return util::StrCat(function, "() requires a blackboard pointer. Use {}");
+        }
+        case PortErrorCode::ConversionFailed: {
+            return util::StrCat(function, "() of node '", GetFullPath(), "' failed to convert the value of the port [", rKey, "]: ", what);
+        }
+        default: {
+            return util::StrCat(function, "() of node '", GetFullPath(), "' failed with error [", ToStr(errorCode), "] on the key [", rKey, "]");
+        }
+    }
 }
 
 template<>
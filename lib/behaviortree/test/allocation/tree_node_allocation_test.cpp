@@ -0,0 +1,63 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+#include "helper/toggle_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+// The replaced operator new counts the heap allocations of the whole binary:
+// this test has its own target, so that it doesn't affect the other suites.
+namespace {
+std::atomic<bool> s_countAllocations{false};
+std::atomic<size_t> s_allocationsNum{0};
+}// namespace
+
+void *operator new(std::size_t size) {
+    if(s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocationsNum.fetch_add(1, std::memory_order_relaxed);
+    }
+    if(void *pMemory = std::malloc(size ? size : 1)) {
+        return pMemory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t) noexcept {
+    std::free(pMemory);
+}
+
+TEST_SUITE("tree_node_allocation") {
+    TEST_CASE("execute_tick_does_not_allocate") {
+        ActionCounters counters;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, counters);
+        auto tree = factory.CreateTreeFromText(TRANSITIONS_TREE_TEXT);
+        // warm up: first activation of every node
+        for(int i = 0; i < 10; i++) {
+            tree.TickExactlyOnce();
+        }
+
+        constexpr int TICKS_NUM = 1'000'000;
+        s_allocationsNum = 0;
+        s_countAllocations = true;
+        for(int i = 0; i < TICKS_NUM; i++) {
+            tree.TickExactlyOnce();
+        }
+        s_countAllocations = false;
+
+        CHECK(s_allocationsNum.load() == 0);
+        CHECK(counters.runNum > TICKS_NUM);
+    }
+}
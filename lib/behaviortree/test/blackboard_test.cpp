@@ -0,0 +1,246 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/blackboard.h"
+
+using namespace behaviortree;
+
+TEST_SUITE("blackboard") {
+    TEST_CASE("unset_reuses_the_slot") {
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("key", 1);
+        const auto keyId = pBlackboard->GetKeyId("key");
+        auto pEntry = pBlackboard->GetEntry("key");
+
+        for(int i = 0; i < 1000; i++) {
+            pBlackboard->Unset("key");
+            CHECK(pBlackboard->GetEntry("key") == nullptr);
+            CHECK(pBlackboard->GetEntry(keyId) == nullptr);
+            CHECK(pEntry->detached.load());
+            pBlackboard->Set("key", i);
+        }
+        CHECK(pBlackboard->GetKeyId("key") == keyId);
+        CHECK(pBlackboard->Get<int>("key") == 999);
+        // the handle taken before the removal refers to the new entry
+        CHECK_FALSE(pEntry->detached.load());
+        CHECK(pEntry.get() == pBlackboard->GetEntry("key").get());
+
+        // no slot was added
+        pBlackboard->Set("other", 0);
+        CHECK(pBlackboard->GetKeyId("other") == keyId + 1);
+    }
+
+    TEST_CASE("unset_releases_the_value") {
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("text", std::string(1000, 'x'));
+        auto pEntry = pBlackboard->GetEntry("text");
+        pBlackboard->Unset("text");
+        CHECK(pEntry->value.Empty());
+
+        // a removed key can change type
+        pBlackboard->Set("text", 3.5);
+        CHECK(pBlackboard->Get<double>("text") == 3.5);
+    }
+
+    TEST_CASE("clone_into_reuses_the_slots") {
+        auto pSrc = Blackboard::Create();
+        auto pDst = Blackboard::Create();
+        pSrc->Set("a", 1);
+        pSrc->Set("b", 2);
+        pSrc->CloneInto(*pDst);
+        const auto keyIdA = pDst->GetKeyId("a");
+        const auto keyIdB = pDst->GetKeyId("b");
+
+        auto pEmpty = Blackboard::Create();
+        for(int i = 0; i < 100; i++) {
+            pEmpty->CloneInto(*pDst);
+            CHECK(pDst->GetKeys().empty());
+            pSrc->CloneInto(*pDst);
+        }
+        CHECK(pDst->GetKeyId("a") == keyIdA);
+        CHECK(pDst->GetKeyId("b") == keyIdB);
+        CHECK(pDst->Get<int>("b") == 2);
+
+        pDst->Set("c", 3);
+        CHECK(pDst->GetKeyId("c") == 2);
+    }
+
+    TEST_CASE("optimistic_reads_are_consistent") {
+        // both halves are always written with the same value: a torn read
+        // would return two different numbers
+        struct Pair {
+            int64_t first;
+            int64_t second;
+        };
+        static_assert(Blackboard::Entry::HasSnapshot<Pair>);
+
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("pair", Pair{0, 0});
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> writerVec;
+        for(int w = 0; w < 4; w++) {
+            writerVec.emplace_back([&, w]() {
+                for(int64_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+                    const int64_t value = i * 4 + w;
+                    pBlackboard->Set("pair", Pair{value, value});
+                }
+            });
+        }
+
+        size_t tornNum = 0;
+        uint64_t lastSequenceId = 0;
+        bool monotonic = true;
+        for(int i = 0; i < 200000; i++) {
+            Pair pair{};
+            auto stamp = pBlackboard->GetStamped("pair", pair);
+            REQUIRE(stamp.has_value());
+            if(pair.first != pair.second) {
+                tornNum++;
+            }
+            if(stamp->seq < lastSequenceId) {
+                monotonic = false;
+            }
+            lastSequenceId = stamp->seq;
+        }
+        stop = true;
+        for(auto &rWriter: writerVec) {
+            rWriter.join();
+        }
+        CHECK(tornNum == 0);
+        CHECK(monotonic);
+    }
+
+    TEST_CASE("snapshot_is_invalidated_by_locked_access") {
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("value", 1);
+        auto pEntry = pBlackboard->GetEntry("value");
+        int value = 0;
+        CHECK(pEntry->TryReadSnapshot(value));
+        CHECK(value == 1);
+
+        // reading through GetAnyLocked() keeps the snapshot
+        {
+            auto anyLocked = pBlackboard->GetAnyLocked("value");
+            CHECK(anyLocked.Get()->Cast<int>() == 1);
+        }
+        CHECK(pEntry->TryReadSnapshot(value));
+        CHECK(pBlackboard->Get<int>("value") == 1);
+        CHECK(pEntry->TryReadSnapshot(value));
+
+        // the caller of GetAnyLocked() may modify the value in place
+        {
+            auto anyLocked = pBlackboard->GetAnyLocked("value");
+            anyLocked.Assign(Any(2));
+        }
+        CHECK_FALSE(pEntry->TryReadSnapshot(value));
+        CHECK(pBlackboard->Get<int>("value") == 2);
+
+        // the next Set() publishes a new snapshot
+        pBlackboard->Set("value", 3);
+        CHECK(pEntry->TryReadSnapshot(value));
+        CHECK(value == 3);
+        // a snapshot of another type is never used
+        double other = 0.0;
+        CHECK_FALSE(pEntry->TryReadSnapshot(other));
+    }
+
+    TEST_CASE("watch_remapped_key") {
+        auto pParent = Blackboard::Create();
+        auto pChild = Blackboard::Create(pParent);
+        pChild->AddSubtreeRemapping("target", "goal");
+        auto pAutoChild = Blackboard::Create(pParent);
+        pAutoChild->EnableAutoRemapping(true);
+
+        std::vector<std::string> keyVec;
+        auto pSubscriber = pChild->Watch("target", [&keyVec](const std::string &rKey, Blackboard::EntryEvent) {
+            keyVec.push_back(rKey);
+        });
+        auto pAutoSubscriber = pAutoChild->Watch("goal", [&keyVec](const std::string &rKey, Blackboard::EntryEvent) {
+            keyVec.push_back(rKey);
+        });
+
+        // written by the parent, by the child and by a sibling
+        pParent->Set("goal", 1);
+        pChild->Set("target", 2);
+        pAutoChild->Set("goal", 3);
+        CHECK(keyVec == std::vector<std::string>{"target", "goal", "target", "goal", "target", "goal"});
+    }
+
+    TEST_CASE("watchers_are_counted_per_blackboard") {
+        auto pWatched = Blackboard::Create();
+        auto pOther = Blackboard::Create();
+        int calledNum = 0;
+        auto pSubscriber = pWatched->WatchPrefix("", [&calledNum](const std::string &, Blackboard::EntryEvent) {
+            calledNum++;
+        });
+        pOther->Set("key", 1);
+        pWatched->Set("key", 1);
+        CHECK(calledNum == 1);
+
+        pSubscriber.reset();
+        pWatched->Set("key", 2);
+        CHECK(calledNum == 1);
+    }
+
+    TEST_CASE("unsubscribe_waits_for_the_callback") {
+        auto pBlackboard = Blackboard::Create();
+        std::atomic<bool> inCallback{false};
+        std::atomic<int> calledNum{0};
+        auto pSubscriber = pBlackboard->Watch("key", [&](const std::string &, Blackboard::EntryEvent) {
+            inCallback = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            calledNum++;
+            inCallback = false;
+        });
+
+        std::atomic<bool> stop{false};
+        std::thread writer([&]() {
+            for(int i = 0; !stop; i++) {
+                pBlackboard->Set("key", i);
+            }
+        });
+        while(!inCallback) {
+            std::this_thread::yield();
+        }
+        pSubscriber.reset();
+        // the running invocation completed, and no other one started
+        CHECK_FALSE(inCallback.load());
+        const int calledAtReset = calledNum.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        stop = true;
+        writer.join();
+        CHECK(calledNum.load() == calledAtReset);
+    }
+
+    TEST_CASE("modify_converted_types") {
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("text", std::string("abc"));
+        pBlackboard->Set("counter", 41);
+        pBlackboard->Set("flag", false);
+
+        pBlackboard->Modify<std::string>("text", [](std::string &rText) {
+            rText += "def";
+        });
+        pBlackboard->Modify<int>("counter", [](int &rCounter) {
+            rCounter++;
+        });
+        pBlackboard->Modify<bool>("flag", [](bool &rFlag) {
+            rFlag = !rFlag;
+        });
+        CHECK(pBlackboard->Get<std::string>("text") == "abcdef");
+        CHECK(pBlackboard->Get<int>("counter") == 42);
+        CHECK(pBlackboard->Get<bool>("flag"));
+        // the type of the entry is kept
+        CHECK(pBlackboard->GetEntry("counter")->value.Type() == typeid(int));
+
+        // no conversion
+        CHECK_THROWS(pBlackboard->Modify<int64_t>("counter", [](int64_t &) {}));
+        CHECK_THROWS(pBlackboard->Modify<std::string>("counter", [](std::string &) {}));
+    }
+}
@@ -0,0 +1,136 @@
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/compiled_tree.h"
+#include "behaviortree/factory.h"
+
+#include "helper/toggle_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Sequence", "children": [
+    {"type": "Fallback", "children": [{"type": "Fail"}, {"type": "Inverter", "children": [{"type": "Fail"}]}]},
+    {"type": "Toggle"},
+    {"type": "ForceFailure", "children": [{"type": "Succeed"}]},
+    {"type": "Succeed"}]}}
+})";
+
+// Counts the status changes of all the nodes of a tree, as a logger would.
+class TransitionCounter {
+ public:
+    explicit TransitionCounter(Tree &rTree) {
+        rTree.ApplyVisitor([this](TreeNode *pNode) {
+            m_subscriberVec.push_back(pNode->SubscribeToStatusChange([this](TimePoint, const TreeNode &, NodeStatus, NodeStatus) {
+                transitionsNum++;
+            }));
+        });
+    }
+
+    int transitionsNum{0};
+
+ private:
+    std::vector<TreeNode::StatusChangeSubscriber> m_subscriberVec;
+};
+}// namespace
+
+TEST_SUITE("compiled_tree") {
+    TEST_CASE("compiled_tree_matches_interpreter") {
+        ActionCounters interpretedCounters;
+        BehaviorTreeFactory interpretedFactory;
+        RegisterActions(interpretedFactory, interpretedCounters);
+        auto interpretedTree = interpretedFactory.CreateTreeFromText(TREE_TEXT);
+
+        ActionCounters compiledCounters;
+        BehaviorTreeFactory compiledFactory;
+        RegisterActions(compiledFactory, compiledCounters);
+        auto compiledTree = compiledFactory.CreateTreeFromText(TREE_TEXT);
+        compiledTree.Compile();
+        REQUIRE(compiledTree.GetCompiledTree() != nullptr);
+
+        for(int i = 0; i < 10; i++) {
+            CHECK(compiledTree.TickExactlyOnce() == interpretedTree.TickExactlyOnce());
+            CHECK(compiledCounters.succeedNum == interpretedCounters.succeedNum);
+            CHECK(compiledCounters.failNum == interpretedCounters.failNum);
+            CHECK(compiledCounters.runNum == interpretedCounters.runNum);
+        }
+        // the RUNNING action is resumed, the sequence then fails on ForceFailure
+        CHECK(interpretedCounters.runNum == 10);
+        CHECK(interpretedCounters.succeedNum == 5);
+        CHECK(interpretedCounters.failNum == 10);
+    }
+
+    TEST_CASE("compiled_tree_layout") {
+        ActionCounters counters;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, counters);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT);
+        tree.Compile();
+
+        const CompiledTree *pProgram = tree.GetCompiledTree();
+        REQUIRE(pProgram != nullptr);
+        CHECK(pProgram->GetNodesNum() == 9);
+        // only the custom actions are ticked through TreeNode::ExecuteTick()
+        CHECK(pProgram->GetOpaqueNodesNum() == 5);
+        CHECK(pProgram->GetNodeRecord(0).pNode == tree.GetRootNode());
+        CHECK(pProgram->GetNodeInfo(0).registrationId == "Sequence");
+
+        for(size_t index = 0; index < pProgram->GetNodesNum(); index++) {
+            const auto &rRecord = pProgram->GetNodeRecord(index);
+            // breadth-first: children are stored after their parent, contiguously
+            if(rRecord.childrenNum > 0) {
+                CHECK(rRecord.firstChild > index);
+                CHECK(rRecord.firstChild + rRecord.childrenNum <= pProgram->GetNodesNum());
+            }
+        }
+    }
+
+    TEST_CASE("compiled_tree_halt") {
+        ActionCounters counters;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, counters);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT);
+        tree.Compile();
+
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        const CompiledTree *pProgram = tree.GetCompiledTree();
+        CHECK(pProgram->GetNodeStatus(0) == NodeStatus::Running);
+
+        tree.HaltTree();
+        for(size_t index = 0; index < pProgram->GetNodesNum(); index++) {
+            CHECK(pProgram->GetNodeStatus(index) == NodeStatus::Idle);
+        }
+    }
+
+    TEST_CASE("status_subscribers_keep_the_nodes_opaque") {
+        ActionCounters interpretedCounters;
+        BehaviorTreeFactory interpretedFactory;
+        RegisterActions(interpretedFactory, interpretedCounters);
+        auto interpretedTree = interpretedFactory.CreateTreeFromText(TREE_TEXT);
+        TransitionCounter interpretedCounter(interpretedTree);
+
+        ActionCounters compiledCounters;
+        BehaviorTreeFactory compiledFactory;
+        RegisterActions(compiledFactory, compiledCounters);
+        auto compiledTree = compiledFactory.CreateTreeFromText(TREE_TEXT);
+        TransitionCounter beforeCounter(compiledTree);
+        compiledTree.Compile();
+        TransitionCounter afterCounter(compiledTree);
+
+        // no node is inlined: they all notify their status changes
+        const CompiledTree *pProgram = compiledTree.GetCompiledTree();
+        REQUIRE(pProgram != nullptr);
+        CHECK(pProgram->GetOpaqueNodesNum() == pProgram->GetNodesNum());
+
+        for(int i = 0; i < 10; i++) {
+            CHECK(compiledTree.TickExactlyOnce() == interpretedTree.TickExactlyOnce());
+            CHECK(beforeCounter.transitionsNum == interpretedCounter.transitionsNum);
+            CHECK(afterCounter.transitionsNum == interpretedCounter.transitionsNum);
+        }
+        CHECK(interpretedCounter.transitionsNum > 0);
+    }
+}
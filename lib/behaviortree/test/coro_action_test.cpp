@@ -0,0 +1,64 @@
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+#include "behaviortree/util/coro_stack_pool.h"
+
+#include "helper/yield_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+// all the nodes are RUNNING at the same time, then they complete and are
+// reset, as their parent would do
+void Activate(const std::vector<TreeNode::Ptr> &rNodeVec) {
+    for(const auto &pNode: rNodeVec) {
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+    }
+    for(const auto &pNode: rNodeVec) {
+        CHECK(pNode->ExecuteTick() == NodeStatus::Success);
+        pNode->HaltNode();
+    }
+}
+}// namespace
+
+TEST_SUITE("coro_action") {
+    TEST_CASE("stacks_are_reused") {
+        const auto previousOptions = CoroStackPool::GetOptions();
+        CoroStackPool::SetOptions({64 * 1024, 16});
+        BehaviorTreeFactory factory;
+        const auto nodeVec = CreateYieldNodes(factory, 8);
+
+        // fills the cache of the thread with blocks of the new size
+        Activate(nodeVec);
+        const auto stats = CoroStackPool::GetStats();
+        CHECK(stats.stackSize == 64 * 1024);
+        CHECK(stats.cachedNum >= 8);
+        CHECK(stats.maxStackUsage > 0);
+
+        Activate(nodeVec);
+        const auto reusedStats = CoroStackPool::GetStats();
+        CHECK(reusedStats.allocatedNum == stats.allocatedNum);
+        CHECK(reusedStats.reusedNum == stats.reusedNum + 8);
+
+        CoroStackPool::SetOptions(previousOptions);
+    }
+
+    TEST_CASE("halt_releases_the_stack") {
+        BehaviorTreeFactory factory;
+        const auto nodeVec = CreateYieldNodes(factory, 1);
+        Activate(nodeVec);
+
+        const auto stats = CoroStackPool::GetStats();
+        CHECK(nodeVec.front()->ExecuteTick() == NodeStatus::Running);
+        nodeVec.front()->HaltNode();
+        CHECK(nodeVec.front()->GetNodeStatus() == NodeStatus::Idle);
+        // the stack of the halted coroutine is back in the cache, and reused
+        CHECK(CoroStackPool::GetStats().cachedNum == stats.cachedNum);
+        Activate(nodeVec);
+        CHECK(CoroStackPool::GetStats().allocatedNum == stats.allocatedNum);
+    }
+}
@@ -0,0 +1,148 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/coroutine_action_node.h"
+#include "behaviortree/factory.h"
+
+#include "helper/signal_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+// Counts the objects alive in the coroutine frames.
+struct Local {
+    explicit Local(int *pAliveNum): pAliveNum(pAliveNum) {
+        ++*pAliveNum;
+    }
+
+    ~Local() {
+        --*pAliveNum;
+    }
+
+    int *pAliveNum;
+};
+
+// Goes through all the awaitables, then succeeds.
+class StepsAction: public CoroutineActionNode {
+ public:
+    StepsAction(const std::string &rName, const NodeConfig &rConfig, int *pAliveNum): CoroutineActionNode(rName, rConfig), m_pAliveNum(pAliveNum) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    ActionTask Run() override {
+        Local local(m_pAliveNum);
+        co_await NextTick();
+        co_await WaitForSignal();
+        co_await WaitForEntryUpdate("key");
+        co_await SleepFor(std::chrono::milliseconds(5));
+        co_return NodeStatus::Success;
+    }
+
+    int *m_pAliveNum;
+};
+
+std::unique_ptr<TreeNode> CreateStepsNode(BehaviorTreeFactory &rFactory, const Blackboard::Ptr &pBlackboard, int &rAliveNum) {
+    rFactory.RegisterNodeType<StepsAction>("Steps", &rAliveNum);
+    NodeConfig config;
+    config.pBlackboard = pBlackboard;
+    return rFactory.InstantiateTreeNode("steps", "Steps", config);
+}
+}// namespace
+
+TEST_SUITE("coroutine_action") {
+    TEST_CASE("awaitables") {
+        int aliveNum = 0;
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        auto pNode = CreateStepsNode(factory, pBlackboard, aliveNum);
+        auto *pAction = static_cast<StepsAction *>(pNode.get());
+
+        // NextTick()
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        CHECK(aliveNum == 1);
+        // WaitForSignal()
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        pAction->Notify();
+        // WaitForEntryUpdate()
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        pBlackboard->Set("key", 1);
+        // SleepFor()
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        NodeStatus nodeStatus = NodeStatus::Running;
+        while(nodeStatus == NodeStatus::Running and std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            nodeStatus = pNode->ExecuteTick();
+        }
+        CHECK(nodeStatus == NodeStatus::Success);
+        CHECK(aliveNum == 0);
+    }
+
+    TEST_CASE("notify_before_the_wait") {
+        BehaviorTreeFactory factory;
+        const auto nodeVec = CreateSignalNodes(factory, 1);
+        const auto &pNode = nodeVec.front();
+        auto *pAction = static_cast<SignalAction *>(pNode.get());
+
+        // the signal received before the coroutine waits for it is not lost
+        pAction->Notify();
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        CHECK(pNode->ExecuteTick() == NodeStatus::Success);
+    }
+
+    TEST_CASE("halt_destroys_the_frame") {
+        int aliveNum = 0;
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        auto pNode = CreateStepsNode(factory, pBlackboard, aliveNum);
+        auto pAllocator = std::make_shared<CoroFrameAllocator>();
+        static_cast<StepsAction *>(pNode.get())->SetFrameAllocator(pAllocator);
+
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        CHECK(aliveNum == 1);
+        CHECK(pAllocator->GetCachedBytes() == 0);
+        pNode->HaltNode();
+        CHECK(aliveNum == 0);
+        CHECK(pNode->GetNodeStatus() == NodeStatus::Idle);
+        // the frame went back to the allocator of the tree, and is reused
+        const size_t cachedBytes = pAllocator->GetCachedBytes();
+        CHECK(cachedBytes > 0);
+        CHECK(pNode->ExecuteTick() == NodeStatus::Running);
+        CHECK(pAllocator->GetCachedBytes() == 0);
+        pNode->HaltNode();
+        CHECK(pAllocator->GetCachedBytes() == cachedBytes);
+    }
+
+    TEST_CASE("100k_suspended_actions") {
+        constexpr size_t ACTIONS_NUM = 100'000;
+        BehaviorTreeFactory factory;
+        auto pAllocator = std::make_shared<CoroFrameAllocator>();
+        const auto nodeVec = CreateSignalNodes(factory, ACTIONS_NUM, pAllocator);
+
+        size_t runningNum = 0;
+        for(const auto &pNode: nodeVec) {
+            runningNum += pNode->ExecuteTick() == NodeStatus::Running;
+        }
+        CHECK(runningNum == ACTIONS_NUM);
+
+        size_t successNum = 0;
+        for(const auto &pNode: nodeVec) {
+            static_cast<SignalAction *>(pNode.get())->Notify();
+            successNum += pNode->ExecuteTick() == NodeStatus::Success;
+        }
+        CHECK(successNum == ACTIONS_NUM);
+        // all the frames are back in the allocator
+        CHECK(pAllocator->GetCachedBytes() >= ACTIONS_NUM * CoroFrameAllocator::SizeClass);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef BEHAVIORTREE_TEST_DELAYED_ACTION_H
+#define BEHAVIORTREE_TEST_DELAYED_ACTION_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "behaviortree/factory.h"
+
+namespace behaviortree::testing {
+struct DelayedSamples {
+    // the delays of the activations are spread over [minDelay, maxDelay]
+    std::chrono::microseconds minDelay{std::chrono::milliseconds(50)};
+    std::chrono::microseconds maxDelay{std::chrono::milliseconds(50)};
+    // time between the completion of the action and the tick that observes it
+    std::vector<double> latencyVec;
+    // ticks of the action while it was RUNNING
+    int runningNum{0};
+};
+
+// Completed by a thread of its own after a delay, that then wakes the tree up.
+class DelayedAction: public StatefulActionNode {
+ public:
+    using SteadyClock = std::chrono::steady_clock;
+
+    DelayedAction(const std::string &rName, const NodeConfig &rConfig, DelayedSamples *pSamples): StatefulActionNode(rName, rConfig), m_pSamples(pSamples) {}
+
+    ~DelayedAction() override {
+        JoinWorker();
+    }
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    NodeStatus OnStart() override {
+        m_done = false;
+        auto delay = m_pSamples->minDelay;
+        if(const auto span = (m_pSamples->maxDelay - m_pSamples->minDelay).count(); span > 0) {
+            delay += std::chrono::microseconds((m_pSamples->latencyVec.size() * 3373) % span);
+        }
+        m_worker = std::thread([this, delay]() {
+            std::this_thread::sleep_for(delay);
+            m_doneTime = SteadyClock::now();
+            m_done = true;
+            EmitWakeUpSignal();
+        });
+        return NodeStatus::Running;
+    }
+
+    NodeStatus OnRunning() override {
+        m_pSamples->runningNum++;
+        if(!m_done.load()) {
+            return NodeStatus::Running;
+        }
+        JoinWorker();
+        m_pSamples->latencyVec.push_back(std::chrono::duration<double, std::micro>(SteadyClock::now() - m_doneTime).count());
+        return NodeStatus::Success;
+    }
+
+    void OnHalted() override {
+        JoinWorker();
+    }
+
+    void JoinWorker() {
+        if(m_worker.joinable()) {
+            m_worker.join();
+        }
+    }
+
+    DelayedSamples *m_pSamples;
+    std::atomic<bool> m_done{false};
+    SteadyClock::time_point m_doneTime;
+    std::thread m_worker;
+};
+}// namespace behaviortree::testing
+
+#endif// BEHAVIORTREE_TEST_DELAYED_ACTION_H
@@ -0,0 +1,46 @@
+#ifndef BEHAVIORTREE_TEST_SIGNAL_ACTION_H
+#define BEHAVIORTREE_TEST_SIGNAL_ACTION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "behaviortree/coroutine_action_node.h"
+#include "behaviortree/factory.h"
+
+namespace behaviortree::testing {
+// Suspended until Notify().
+class SignalAction: public CoroutineActionNode {
+ public:
+    SignalAction(const std::string &rName, const NodeConfig &rConfig): CoroutineActionNode(rName, rConfig) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    ActionTask Run() override {
+        co_await WaitForSignal();
+        co_return NodeStatus::Success;
+    }
+};
+
+/// Register SignalAction as "Signal" and instantiate nodesNum of them, sharing
+/// a blackboard and pAllocator, if any.
+inline std::vector<std::unique_ptr<TreeNode>> CreateSignalNodes(BehaviorTreeFactory &rFactory, size_t nodesNum, const CoroFrameAllocator::Ptr &pAllocator = {}) {
+    rFactory.RegisterNodeType<SignalAction>("Signal");
+    NodeConfig config;
+    config.pBlackboard = Blackboard::Create();
+    std::vector<std::unique_ptr<TreeNode>> nodeVec;
+    nodeVec.reserve(nodesNum);
+    for(size_t i = 0; i < nodesNum; i++) {
+        nodeVec.push_back(rFactory.InstantiateTreeNode("signal", "Signal", config));
+        if(pAllocator) {
+            static_cast<SignalAction *>(nodeVec.back().get())->SetFrameAllocator(pAllocator);
+        }
+    }
+    return nodeVec;
+}
+}// namespace behaviortree::testing
+
+#endif// BEHAVIORTREE_TEST_SIGNAL_ACTION_H
@@ -0,0 +1,66 @@
+#ifndef BEHAVIORTREE_TEST_TOGGLE_ACTION_H
+#define BEHAVIORTREE_TEST_TOGGLE_ACTION_H
+
+#include <string>
+
+#include "behaviortree/factory.h"
+
+namespace behaviortree::testing {
+// RUNNING on odd calls, SUCCESS on even calls
+class ToggleAction: public StatefulActionNode {
+ public:
+    ToggleAction(const std::string &rName, const NodeConfig &rConfig, int *pCallsNum): StatefulActionNode(rName, rConfig), m_pCallsNum(pCallsNum) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    NodeStatus OnStart() override {
+        ++*m_pCallsNum;
+        return NodeStatus::Running;
+    }
+
+    NodeStatus OnRunning() override {
+        ++*m_pCallsNum;
+        return NodeStatus::Success;
+    }
+
+    void OnHalted() override {}
+
+    int *m_pCallsNum;
+};
+
+struct ActionCounters {
+    int succeedNum{0};
+    int failNum{0};
+    int runNum{0};
+};
+
+/// Register "Succeed", "Fail" and "Toggle" (a ToggleAction), counting their calls.
+inline void RegisterActions(BehaviorTreeFactory &rFactory, ActionCounters &rCounters) {
+    rFactory.RegisterSimpleAction("Succeed", [&rCounters](TreeNode &) {
+        rCounters.succeedNum++;
+        return NodeStatus::Success;
+    });
+    rFactory.RegisterSimpleAction("Fail", [&rCounters](TreeNode &) {
+        rCounters.failNum++;
+        return NodeStatus::Failure;
+    });
+    rFactory.RegisterNodeType<ToggleAction>("Toggle", &rCounters.runNum);
+}
+
+// goes through all the transitions of the control nodes, the Toggle action
+// being RUNNING every other call
+inline const char *TRANSITIONS_TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Sequence", "children": [
+    {"type": "Fallback", "children": [
+      {"type": "Fail"},
+      {"type": "Inverter", "children": [{"type": "AlwaysFailure"}]}]},
+    {"type": "ReactiveSequence", "children": [{"type": "Succeed"}, {"type": "Toggle"}]},
+    {"type": "ForceSuccess", "children": [{"type": "AlwaysFailure"}]},
+    {"type": "Toggle"}]}}
+})";
+}// namespace behaviortree::testing
+
+#endif// BEHAVIORTREE_TEST_TOGGLE_ACTION_H
@@ -0,0 +1,40 @@
+#ifndef BEHAVIORTREE_TEST_YIELD_ACTION_H
+#define BEHAVIORTREE_TEST_YIELD_ACTION_H
+
+#include <string>
+#include <vector>
+
+#include "behaviortree/factory.h"
+
+namespace behaviortree::testing {
+// RUNNING at the first tick, SUCCESS at the second one.
+class YieldAction: public CoroActionNode {
+ public:
+    YieldAction(const std::string &rName, const NodeConfig &rConfig): CoroActionNode(rName, rConfig) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    NodeStatus Tick() override {
+        SetStatusRunningAndYield();
+        return NodeStatus::Success;
+    }
+};
+
+/// Register YieldAction as "Yield" and instantiate nodesNum of them, sharing a blackboard.
+inline std::vector<TreeNode::Ptr> CreateYieldNodes(BehaviorTreeFactory &rFactory, size_t nodesNum) {
+    rFactory.RegisterNodeType<YieldAction>("Yield");
+    NodeConfig config;
+    config.pBlackboard = Blackboard::Create();
+    std::vector<TreeNode::Ptr> nodeVec;
+    nodeVec.reserve(nodesNum);
+    for(size_t i = 0; i < nodesNum; i++) {
+        nodeVec.push_back(rFactory.InstantiateTreeNode("yield", "Yield", config));
+    }
+    return nodeVec;
+}
+}// namespace behaviortree::testing
+
+#endif// BEHAVIORTREE_TEST_YIELD_ACTION_H
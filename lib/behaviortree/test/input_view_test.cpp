@@ -0,0 +1,176 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+using namespace behaviortree;
+
+namespace {
+// stored in the blackboard, never default-constructed by GetInputView()
+struct Path {
+    explicit Path(int pointsNum): pointVec(pointsNum, 0) {}
+
+    std::vector<int> pointVec;
+};
+
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Read", "path": "{path}", "number": "{number}", "literal": "7", "out": "{out}"}}
+})";
+
+Tree CreateTree(BehaviorTreeFactory &rFactory, const Blackboard::Ptr &pBlackboard) {
+    rFactory.RegisterSimpleAction("Read", [](TreeNode &) { return NodeStatus::Success; },
+                                  {InputPort<Path>("path"), InputPort<int>("number"), InputPort<int>("literal"), OutputPort<std::vector<int>>("out")});
+    return rFactory.CreateTreeFromText(TREE_TEXT, pBlackboard);
+}
+}// namespace
+
+TEST_SUITE("input_view") {
+    TEST_CASE("view_of_the_stored_value") {
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("path", Path(1000));
+        auto tree = CreateTree(factory, pBlackboard);
+        TreeNode *pNode = tree.GetRootNode();
+
+        auto view = pNode->GetInputView<Path>("path");
+        REQUIRE(view);
+        CHECK((*view)->pointVec.size() == 1000);
+        // no copy: the view points to the value of the entry
+        CHECK(view->Get() == pBlackboard->GetEntry("path")->value.CastPtr<Path>());
+
+        auto anyView = pNode->GetInputView<Any>("path");
+        REQUIRE(anyView);
+        CHECK(anyView->Get() == &pBlackboard->GetEntry("path")->value);
+
+        CHECK_FALSE(pNode->GetInputView<Path>("missing"));
+    }
+
+    TEST_CASE("readers_share_the_entry") {
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("path", Path(10));
+        auto tree = CreateTree(factory, pBlackboard);
+        TreeNode *pNode = tree.GetRootNode();
+
+        auto view = pNode->GetInputView<Path>("path");
+        REQUIRE(view);
+        // the same thread may read the entry again
+        auto secondView = pNode->GetInputView<Path>("path");
+        REQUIRE(secondView);
+        CHECK(secondView->Get() == view->Get());
+        CHECK(pNode->GetInput<Any>("path").value().Cast<Path>().pointVec.size() == 10);
+
+        // other readers are not blocked
+        auto reader = std::async(std::launch::async, [pNode]() {
+            auto otherView = pNode->GetInputView<Path>("path");
+            return otherView ? (*otherView)->pointVec.size() : 0;
+        });
+        REQUIRE(reader.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        CHECK(reader.get() == 10);
+
+        // writers are
+        std::atomic<bool> written{false};
+        std::thread writer([&]() {
+            pBlackboard->Set("path", Path(20));
+            written = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK_FALSE(written.load());
+        *secondView = LockedView<Path>();
+        *view = LockedView<Path>();
+        writer.join();
+        CHECK(written.load());
+        CHECK((*pNode->GetInputView<Path>("path"))->pointVec.size() == 20);
+    }
+
+    TEST_CASE("view_released_by_another_thread") {
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("path", Path(10));
+        auto tree = CreateTree(factory, pBlackboard);
+        TreeNode *pNode = tree.GetRootNode();
+
+        // as a coroutine action resumed by another worker
+        auto view = pNode->GetInputView<Path>("path");
+        auto secondView = pNode->GetInputView<Path>("path");
+        REQUIRE(view);
+        REQUIRE(secondView);
+        std::thread([movedView = std::move(*view)]() {}).join();
+
+        // the entry is still read-locked by the second view
+        auto writer = std::async(std::launch::async, [pBlackboard]() {
+            pBlackboard->Set("path", Path(20));
+        });
+        CHECK(writer.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+        std::thread([movedView = std::move(*secondView)]() {}).join();
+        REQUIRE(writer.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+        // the lock is no longer counted for this thread
+        auto otherView = pNode->GetInputView<Path>("path");
+        REQUIRE(otherView);
+        CHECK((*otherView)->pointVec.size() == 20);
+        *otherView = LockedView<Path>();
+        pBlackboard->Set("path", Path(30));
+        CHECK((*pNode->GetInputView<Path>("path"))->pointVec.size() == 30);
+    }
+
+    TEST_CASE("view_of_a_converted_value") {
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("number", std::string("42"));
+        auto tree = CreateTree(factory, pBlackboard);
+        TreeNode *pNode = tree.GetRootNode();
+
+        auto view = pNode->GetInputView<int>("number");
+        REQUIRE(view);
+        CHECK(**view == 42);
+
+        pBlackboard->Set("number", std::string("not a number"));
+        auto failedView = pNode->GetInputView<int>("number");
+        REQUIRE_FALSE(failedView);
+        CHECK(failedView.error().find("not a number") != std::string::npos);
+
+        // literals are converted once: the views share the cached value
+        auto literalView = pNode->GetInputView<int>("literal");
+        REQUIRE(literalView);
+        CHECK(**literalView == 7);
+        CHECK(pNode->GetInputView<int>("literal")->Get() == literalView->Get());
+    }
+
+    TEST_CASE("set_output_moves_the_value") {
+        BehaviorTreeFactory factory;
+        auto pBlackboard = Blackboard::Create();
+        auto tree = CreateTree(factory, pBlackboard);
+        TreeNode *pNode = tree.GetRootNode();
+
+        std::vector<int> valueVec(100, 1);
+        const int *pData = valueVec.data();
+        REQUIRE(pNode->SetOutput("out", std::move(valueVec)));
+        // the buffer was moved into the entry
+        auto pStored = pBlackboard->GetEntry("out")->value.CastPtr<std::vector<int>>();
+        REQUIRE(pStored != nullptr);
+        CHECK(pStored->data() == pData);
+
+        const PortBinding *pBinding = pNode->GetOutputBinding("out");
+        REQUIRE(pBinding != nullptr);
+        std::vector<int> otherVec(50, 2);
+        pData = otherVec.data();
+        CHECK(pNode->SetOutput(*pBinding, std::move(otherVec)) == PortErrorCode::Ok);
+        pStored = pBlackboard->GetEntry("out")->value.CastPtr<std::vector<int>>();
+        REQUIRE(pStored != nullptr);
+        CHECK(pStored->size() == 50);
+        CHECK(pStored->data() == pData);
+
+        // an lvalue is copied
+        std::vector<int> copiedVec(10, 3);
+        REQUIRE(pNode->SetOutput("out", copiedVec));
+        CHECK(copiedVec.size() == 10);
+        CHECK(pBlackboard->Get<std::vector<int>>("out").size() == 10);
+    }
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+#include "behaviortree/json_parser.h"
+
+using namespace behaviortree;
+
+namespace {
+const char *TREE_TEXT = R"({
+  "mainTreeToExecute": "Main",
+  "behaviortree": [
+    {"treeName": "Main", "root": {"type": "Sequence", "name": "root", "children": [
+      {"type": "SetBlackboard", "value": "1", "output_key": "result"},
+      {"type": "Subtree", "id": "Child", "target": "{result}"}]}},
+    {"treeName": "Child", "root": {"type": "Fallback", "children": [
+      {"type": "Inverter", "children": [{"type": "AlwaysSuccess"}]},
+      {"type": "SetBlackboard", "value": "{target}", "output_key": "copy"}]}}]
+})";
+
+const char *MODEL_TEXT = R"({
+  "behaviortree": [
+    {"treeName": "Main", "root": {"type": "Sequence", "children": [
+      {"type": "SetBlackboard", "value": "5", "output_key": "fallback"},
+      {"type": "Subtree", "id": "Child"},
+      {"type": "Subtree", "id": "Child", "target": "{other}"}]}},
+    {"treeName": "Child", "root": {"type": "AlwaysSuccess"}},
+    {"treeName": "Strict", "root": {"type": "Subtree", "id": "Required"}},
+    {"treeName": "Required", "root": {"type": "AlwaysSuccess"}}],
+  "treeNodeModel": [
+    {"type": "Subtree", "id": "Child", "input": [{"name": "target", "default": "{fallback}"}, {"name": "constant", "default": "7"}]},
+    {"type": "Subtree", "id": "Required", "input": [{"name": "mandatory"}]}]
+})";
+
+// message of the exception thrown by the loading of rText
+std::string LoadError(const std::string &rText) {
+    BehaviorTreeFactory factory;
+    try {
+        factory.RegisterBehaviorTreeFromText(rText);
+    } catch(const std::exception &rEx) {
+        CHECK(factory.GetRegisteredTreeName().empty());
+        return rEx.what();
+    }
+    return {};
+}
+
+std::string TreeText(const std::string &rRoot) {
+    return R"({"behaviortree": {"treeName": "Main", )" + rRoot + "}}";
+}
+
+void WriteFile(const std::filesystem::path &rPath, const std::string &rText) {
+    std::ofstream file(rPath);
+    file << rText;
+}
+}// namespace
+
+TEST_SUITE("json_parser") {
+    TEST_CASE("schema_errors") {
+        CHECK(LoadError(TreeText(R"("root": {"name": "typeless"})")).find("doesn't have the member [type]") != std::string::npos);
+        CHECK(LoadError(TreeText(R"("root": {"type": "Sequence", "children": [{"type": "AlwaysSuccess"}, {"name": "typeless"}]})")).find("doesn't have the member [type]") != std::string::npos);
+
+        CHECK(LoadError(TreeText(R"("root": {"type": "Sequence", "children": {"type": "AlwaysSuccess"}})")).find("[children] must be an array") != std::string::npos);
+        CHECK(LoadError(TreeText(R"("root": {"type": "Sequence", "children": "AlwaysSuccess"})")).find("[children] must be an array") != std::string::npos);
+        CHECK(LoadError(TreeText(R"("root": {"type": "Sequence", "children": [[{"type": "AlwaysSuccess"}]]})")).find("must contain objects") != std::string::npos);
+
+        CHECK(LoadError(TreeText(R"("root": {"type": "AlwaysSuccess"}, "root": {"type": "AlwaysFailure"})")).find("must have exactly 1 root node") != std::string::npos);
+        CHECK(LoadError(TreeText(R"("root": [{"type": "AlwaysSuccess"}])")).find("must be an object") != std::string::npos);
+        CHECK(LoadError(R"({"behaviortree": {"treeName": "Main"}})").find("doesn't have a [root] node") != std::string::npos);
+
+        CHECK(LoadError(TreeText(R"("root": {"type": "Unknown"})")).find("Node not recognized") != std::string::npos);
+        CHECK(LoadError(TreeText(R"("root": {"type": "Inverter"})")).find("must have exactly 1 child") != std::string::npos);
+        CHECK(LoadError(R"({"behaviortree": )").find("Error parsing the JSON") != std::string::npos);
+        CHECK(LoadError(TreeText(R"("root": {"type": "AlwaysSuccess"})")).empty());
+    }
+
+    TEST_CASE("include_relative_to_the_including_file") {
+        const auto directory = std::filesystem::temp_directory_path() / "behaviortree_json_parser_test";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory / "sub");
+        WriteFile(directory / "main.json", R"({
+          "mainTreeToExecute": "Main", "include": ["sub/child.json"],
+          "behaviortree": {"treeName": "Main", "root": {"type": "Subtree", "id": "Child"}}})");
+        // "leaf.json" is next to "child.json", not to "main.json"
+        WriteFile(directory / "sub" / "child.json", R"({
+          "include": ["leaf.json"],
+          "behaviortree": {"treeName": "Child", "root": {"type": "Subtree", "id": "Leaf"}}})");
+        WriteFile(directory / "sub" / "leaf.json", R"({
+          "behaviortree": {"treeName": "Leaf", "root": {"type": "AlwaysSuccess"}}})");
+
+        BehaviorTreeFactory factory;
+        factory.RegisterBehaviorTreeFromFile(directory / "main.json");
+        auto nameVec = factory.GetRegisteredTreeName();
+        std::sort(nameVec.begin(), nameVec.end());
+        CHECK(nameVec == std::vector<std::string>{"Child", "Leaf", "Main"});
+
+        auto tree = factory.CreateTree("Main");
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(tree.m_subtreeVec.size() == 3);
+
+        // a missing include is an error
+        WriteFile(directory / "sub" / "child.json", R"({
+          "include": ["missing.json"],
+          "behaviortree": {"treeName": "Child", "root": {"type": "AlwaysSuccess"}}})");
+        BehaviorTreeFactory otherFactory;
+        CHECK_THROWS(otherFactory.RegisterBehaviorTreeFromFile(directory / "main.json"));
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST_CASE("subtree_model_default_ports") {
+        BehaviorTreeFactory factory;
+        factory.RegisterBehaviorTreeFromText(MODEL_TEXT);
+
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("other", std::string("9"));
+        auto tree = factory.CreateTree("Main", pBlackboard);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        REQUIRE(tree.m_subtreeVec.size() == 3);
+
+        // the ports that are not remapped use the defaults of the model
+        const auto &pChildBlackboard = tree.m_subtreeVec[1]->pBlackboard;
+        CHECK(pChildBlackboard->Get<std::string>("target") == "5");
+        CHECK(pChildBlackboard->Get<std::string>("constant") == "7");
+        // an explicit remapping overrides the default
+        const auto &pRemappedBlackboard = tree.m_subtreeVec[2]->pBlackboard;
+        CHECK(pRemappedBlackboard->Get<std::string>("target") == "9");
+        CHECK(pRemappedBlackboard->Get<std::string>("constant") == "7");
+
+        // a port without default must be remapped
+        CHECK_THROWS(factory.CreateTree("Strict"));
+    }
+
+    TEST_CASE("write_and_read_back") {
+        BehaviorTreeFactory factory;
+        factory.RegisterBehaviorTreeFromText(TREE_TEXT);
+        auto pBlackboard = Blackboard::Create();
+        auto tree = factory.CreateTree("Main", pBlackboard);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<std::string>("result") == "1");
+        const std::string text = WriteTreeToJson(tree, false, false);
+
+        JsonParser parser(factory);
+        parser.LoadFromText(text);
+        auto nameVec = parser.GetRegisteredTreeName();
+        std::sort(nameVec.begin(), nameVec.end());
+        CHECK(nameVec == std::vector<std::string>{"Child", "Main"});
+
+        auto pReadBlackboard = Blackboard::Create();
+        auto readTree = parser.InstantiateTree(pReadBlackboard, "Main");
+        CHECK(readTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pReadBlackboard->Get<std::string>("result") == "1");
+        REQUIRE(readTree.m_subtreeVec.size() == 2);
+        CHECK(readTree.m_subtreeVec[1]->pBlackboard->Get<std::string>("copy") == "1");
+
+        // the tree read back is written the same
+        CHECK(nlohmann::json::parse(WriteTreeToJson(readTree, false, false)) == nlohmann::json::parse(text));
+    }
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/control/parallel_all_node.hpp"
+#include "behaviortree/control/parallel_node.hpp"
+#include "behaviortree/factory.h"
+
+using namespace behaviortree;
+
+namespace {
+struct ThreadRecorder {
+    std::mutex mutex;
+    std::set<std::thread::id> threadIdSet;
+};
+
+void RegisterActions(BehaviorTreeFactory &rFactory, ThreadRecorder &rRecorder) {
+    rFactory.RegisterSimpleAction("Record", [&rRecorder](TreeNode &) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::unique_lock lock(rRecorder.mutex);
+        rRecorder.threadIdSet.insert(std::this_thread::get_id());
+        return NodeStatus::Success;
+    });
+}
+
+const char *PARALLEL_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Parallel", "success_count": "-1", "children": [
+    {"type": "Record"}, {"type": "Record"}, {"type": "Record"}, {"type": "Record"}]}}
+})";
+
+const char *PARALLEL_ALL_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "ParallelAll", "children": [
+    {"type": "Record"}, {"type": "Record"}, {"type": "Record"}, {"type": "Record"}]}}
+})";
+
+// a concurrent Parallel of 8 children, that succeed or fail
+std::string EarlyStopText(const char *pChild, const char *pSuccessCount, const char *pFailureCount) {
+    std::string text = R"({"behaviortree": {"treeName": "Main", "root": {"type": "Parallel", "concurrent": "true", "success_count": ")";
+    text += pSuccessCount;
+    text += R"(", "failure_count": ")";
+    text += pFailureCount;
+    text += R"(", "children": [)";
+    for(int i = 0; i < 8; i++) {
+        text += i ? ", " : "";
+        text += R"({"type": ")";
+        text += pChild;
+        text += R"("})";
+    }
+    return text + "]}}}";
+}
+}// namespace
+
+TEST_SUITE("parallel_node") {
+    TEST_CASE("set_concurrent_overrides_the_port_default") {
+        ThreadRecorder recorder;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, recorder);
+        auto tree = factory.CreateTreeFromText(PARALLEL_TEXT);
+        auto *pParallel = dynamic_cast<ParallelNode *>(tree.GetRootNode());
+        REQUIRE(pParallel != nullptr);
+
+        pParallel->SetConcurrent(true);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pParallel->IsConcurrent());
+        CHECK(recorder.threadIdSet.size() > 1);
+
+        pParallel->SetConcurrent(false);
+        CHECK_FALSE(pParallel->IsConcurrent());
+        recorder.threadIdSet.clear();
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(recorder.threadIdSet.size() == 1);
+    }
+
+    TEST_CASE("parallel_all_set_concurrent") {
+        ThreadRecorder recorder;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, recorder);
+        auto tree = factory.CreateTreeFromText(PARALLEL_ALL_TEXT);
+        auto *pParallel = dynamic_cast<ParallelAllNode *>(tree.GetRootNode());
+        REQUIRE(pParallel != nullptr);
+
+        pParallel->SetConcurrent(true);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pParallel->IsConcurrent());
+        CHECK(recorder.threadIdSet.size() > 1);
+    }
+
+    TEST_CASE("concurrent_mode_stops_once_the_result_is_certain") {
+        std::atomic<int> tickedNum{0};
+        BehaviorTreeFactory factory;
+        for(auto [pName, status]: {std::pair{"Succeed", NodeStatus::Success}, std::pair{"Fail", NodeStatus::Failure}}) {
+            factory.RegisterSimpleAction(pName, [&tickedNum, status = status](TreeNode &) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                tickedNum++;
+                return status;
+            });
+        }
+        // the calling thread and a worker
+        auto pPool = std::make_shared<ActionPool>(ActionPool::Options{1, 0});
+
+        auto successTree = factory.CreateTreeFromText(EarlyStopText("Succeed", "2", "1"));
+        dynamic_cast<ParallelNode *>(successTree.GetRootNode())->SetActionPool(pPool);
+        CHECK(successTree.TickExactlyOnce() == NodeStatus::Success);
+        // at most one more child is started while the first ones complete
+        CHECK(tickedNum.load() >= 2);
+        CHECK(tickedNum.load() <= 3);
+
+        tickedNum = 0;
+        auto failureTree = factory.CreateTreeFromText(EarlyStopText("Fail", "-1", "1"));
+        dynamic_cast<ParallelNode *>(failureTree.GetRootNode())->SetActionPool(pPool);
+        CHECK(failureTree.TickExactlyOnce() == NodeStatus::Failure);
+        CHECK(tickedNum.load() >= 1);
+        CHECK(tickedNum.load() <= 2);
+
+        // all the children are needed to succeed
+        tickedNum = 0;
+        auto allTree = factory.CreateTreeFromText(EarlyStopText("Succeed", "8", "1"));
+        dynamic_cast<ParallelNode *>(allTree.GetRootNode())->SetActionPool(pPool);
+        CHECK(allTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(tickedNum.load() == 8);
+    }
+}
@@ -0,0 +1,284 @@
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+using namespace behaviortree;
+
+namespace {
+// out = in + 1
+class IncrementAction: public SyncActionNode {
+ public:
+    IncrementAction(const std::string &rName, const NodeConfig &rConfig): SyncActionNode(rName, rConfig) {}
+
+    static PortMap ProvidedPorts() {
+        return {InputPort<int>("in"), OutputPort<int>("out"), InputPort<int>("step", 1, "increment")};
+    }
+
+ private:
+    NodeStatus Tick() override {
+        int value = 0;
+        int step = 0;
+        if(!GetInput("in", value) or !GetInput("step", step)) {
+            return NodeStatus::Failure;
+        }
+        SetOutput("out", value + step);
+        return NodeStatus::Success;
+    }
+};
+
+// IncrementAction that can be remapped after its construction
+class RemappableAction: public IncrementAction {
+ public:
+    using IncrementAction::IncrementAction;
+
+    void Remap(const std::string &rPortName, const std::string &rRemappedPort) {
+        ModifyPortsRemapping({{rPortName, rRemappedPort}});
+    }
+};
+
+enum class Color { Red = 1, Blue = 2, Green = 3 };
+
+// Reads its ports from the tests
+class ReadAction: public SyncActionNode {
+ public:
+    ReadAction(const std::string &rName, const NodeConfig &rConfig): SyncActionNode(rName, rConfig) {}
+
+    static PortMap ProvidedPorts() {
+        return {InputPort<int>("number"), InputPort<Color>("color")};
+    }
+
+    void Remap(const std::string &rPortName, const std::string &rRemappedPort) {
+        ModifyPortsRemapping({{rPortName, rRemappedPort}});
+    }
+
+ private:
+    NodeStatus Tick() override {
+        return NodeStatus::Success;
+    }
+};
+
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Increment", "in": "{a}", "out": "{b}"}}
+})";
+
+const char *READ_TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Read", "number": "3", "color": "Blue"}}
+})";
+}// namespace
+
+TEST_SUITE("port_binding") {
+    TEST_CASE("entry_created_after_the_binding") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<IncrementAction>("Increment");
+        auto pBlackboard = Blackboard::Create();
+        NodeConfig config;
+        config.pBlackboard = pBlackboard;
+        config.inputPortMap["in"] = "{a}";
+        config.inputPortMap["step"] = "1";
+        config.outputPortMap["out"] = "{b}";
+        // unlike the parsers, the factory neither creates the entries of the
+        // ports nor applies their default values
+        auto pNode = factory.InstantiateTreeNode("increment", "Increment", config);
+
+        const PortBinding *pInput = pNode->GetInputBinding("in");
+        const PortBinding *pOutput = pNode->GetOutputBinding("out");
+        REQUIRE(pInput != nullptr);
+        REQUIRE(pOutput != nullptr);
+        CHECK(pInput->kind == PortBinding::Kind::Entry);
+        CHECK(pInput->entry.Get() == nullptr);
+        CHECK(pOutput->entry.Get() == nullptr);
+
+        // the entry doesn't exist yet
+        CHECK(pNode->ExecuteTick() == NodeStatus::Failure);
+
+        pBlackboard->Set("a", 41);
+        CHECK(pNode->ExecuteTick() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 42);
+        // the first access that found the entries cached them
+        CHECK(pInput->entry.Get() == pBlackboard->GetEntry("a").get());
+
+        // the output entry was created by the first write
+        CHECK(pNode->ExecuteTick() == NodeStatus::Success);
+        CHECK(pOutput->entry.Get() == pBlackboard->GetEntry("b").get());
+
+        // the bindings keep their address
+        CHECK(pNode->GetInputBinding("in") == pInput);
+        CHECK(pNode->GetOutputBinding("out") == pOutput);
+    }
+
+    TEST_CASE("removed_entry") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<IncrementAction>("Increment");
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", 1);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT, pBlackboard);
+        CHECK(tree.GetRootNode()->GetInputBinding("in")->entry.Get() != nullptr);
+
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        pBlackboard->Unset("a");
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Failure);
+        pBlackboard->Set("a", 10);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 11);
+    }
+
+    TEST_CASE("default_value") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<IncrementAction>("Increment");
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", 1);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT, pBlackboard);
+
+        const PortBinding *pStep = tree.GetRootNode()->GetInputBinding("step");
+        REQUIRE(pStep != nullptr);
+        CHECK(pStep->kind != PortBinding::Kind::Entry);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 2);
+    }
+
+    TEST_CASE("node_built_by_hand") {
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", 1);
+        NodeConfig config;
+        config.pBlackboard = pBlackboard;
+        config.inputPortMap["in"] = "{a}";
+        config.inputPortMap["step"] = "2";
+        config.outputPortMap["out"] = "{b}";
+        // no factory: the bindings are created by the first access
+        RemappableAction node("increment", config);
+
+        CHECK(node.ExecuteTick() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 3);
+        const PortBinding *pInput = node.GetInputBinding("in");
+        REQUIRE(pInput != nullptr);
+        CHECK(node.GetInputBinding("in") == pInput);
+        CHECK(node.GetInputBinding("missing") == nullptr);
+
+        // remapped after the binding was created
+        pBlackboard->Set("c", 10);
+        node.Remap("in", "{c}");
+        CHECK(node.ExecuteTick() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 12);
+        node.Remap("step", "5");
+        CHECK(node.ExecuteTick() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 15);
+    }
+
+    TEST_CASE("remapped_in_place") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<RemappableAction>("Increment");
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", 1);
+        pBlackboard->Set("c", 10);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT, pBlackboard);
+        auto *pNode = dynamic_cast<RemappableAction *>(tree.GetRootNode());
+        REQUIRE(pNode != nullptr);
+        const PortBinding *pInput = pNode->GetInputBinding("in");
+        const PortBinding *pStep = pNode->GetInputBinding("step");
+        REQUIRE(pInput != nullptr);
+        REQUIRE(pStep != nullptr);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 2);
+
+        // all the bindings are resolved again, at the same address
+        pNode->Remap("in", "{c}");
+        CHECK(pNode->GetInputBinding("in") == pInput);
+        CHECK(pInput->blackboardKey == "c");
+        CHECK(pNode->GetInputBinding("step") == pStep);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pBlackboard->Get<int>("b") == 11);
+    }
+
+    TEST_CASE("conversion_error_message") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<IncrementAction>("Increment");
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", std::string("not a number"));
+        auto tree = factory.CreateTreeFromText(TREE_TEXT, pBlackboard);
+
+        int value = 0;
+        auto res = tree.GetRootNode()->GetInput("in", value);
+        REQUIRE(!res);
+        // the cause reported by the conversion is kept
+        CHECK(res.error().find("Can't Convert string [not a number] to integer") != std::string::npos);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Failure);
+    }
+
+    TEST_CASE("literal_cache") {
+        LiteralCache cache;
+        CHECK(cache.Find<int>() == nullptr);
+        cache.Insert(3);
+        REQUIRE(cache.Find<int>() != nullptr);
+        CHECK(*cache.Find<int>() == 3);
+        CHECK(cache.Find<double>() == nullptr);
+
+        cache.Insert(2.5);
+        REQUIRE(cache.Find<double>() != nullptr);
+        CHECK(*cache.Find<double>() == 2.5);
+        CHECK(*cache.Find<int>() == 3);
+
+        // a value is only found with its key
+        CHECK(cache.Find<int>(1) == nullptr);
+        cache.Insert(4, 1);
+        CHECK(*cache.Find<int>(1) == 4);
+        CHECK(*cache.Find<int>() == 3);
+    }
+
+    TEST_CASE("literal_parsed_once") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<ReadAction>("Read");
+        factory.RegisterScriptingEnum("Blue", 2);
+        auto tree = factory.CreateTreeFromText(READ_TREE_TEXT);
+        auto *pNode = dynamic_cast<ReadAction *>(tree.GetRootNode());
+        REQUIRE(pNode != nullptr);
+        const PortBinding *pNumber = pNode->GetInputBinding("number");
+        REQUIRE(pNumber != nullptr);
+        CHECK(pNumber->kind == PortBinding::Kind::Literal);
+        CHECK(pNumber->literalCache.Find<int>() == nullptr);
+
+        CHECK(pNode->GetInput<int>("number").value() == 3);
+        const int *pCached = pNumber->literalCache.Find<int>();
+        REQUIRE(pCached != nullptr);
+        CHECK(*pCached == 3);
+        // hit: nothing is parsed nor inserted again
+        CHECK(pNode->GetInput<int>("number").value() == 3);
+        CHECK(pNumber->literalCache.Find<int>() == pCached);
+
+        // another type is parsed and cached next to it
+        CHECK(pNode->GetInput<double>("number").value() == 3.0);
+        CHECK(pNumber->literalCache.Find<double>() != nullptr);
+        CHECK(pNumber->literalCache.Find<int>() == pCached);
+        CHECK(pNode->GetInput<std::string>("number").value() == "3");
+
+        // the remapping clears the cache of the binding
+        pNode->Remap("number", "5");
+        CHECK(pNode->GetInputBinding("number") == pNumber);
+        CHECK(pNumber->literalCache.Find<int>() == nullptr);
+        CHECK(pNumber->literalCache.Find<double>() == nullptr);
+        CHECK(pNode->GetInput<int>("number").value() == 5);
+    }
+
+    TEST_CASE("enum_literal_follows_the_registered_enums") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<ReadAction>("Read");
+        factory.RegisterScriptingEnum("Red", 1);
+        auto tree = factory.CreateTreeFromText(READ_TREE_TEXT);
+        auto *pNode = dynamic_cast<ReadAction *>(tree.GetRootNode());
+        REQUIRE(pNode != nullptr);
+        const PortBinding *pColor = pNode->GetInputBinding("color");
+        REQUIRE(pColor != nullptr);
+
+        // not registered yet
+        CHECK_FALSE(pNode->GetInput<Color>("color"));
+        factory.RegisterScriptingEnum("Blue", 2);
+        CHECK(pNode->GetInput<Color>("color").value() == Color::Blue);
+        // cached for the current table of 2 enums
+        CHECK(pColor->literalCache.Find<Color>(2) != nullptr);
+
+        // parsed again once the table changed
+        factory.RegisterScriptingEnum("Green", 3);
+        CHECK(pColor->literalCache.Find<Color>(3) == nullptr);
+        CHECK(pNode->GetInput<Color>("color").value() == Color::Blue);
+        CHECK(pColor->literalCache.Find<Color>(3) != nullptr);
+    }
+}
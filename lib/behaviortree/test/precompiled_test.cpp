@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+using namespace behaviortree;
+
+namespace {
+const char *TREE_TEXT = R"({
+  "mainTreeToExecute": "Main",
+  "behaviortree": [
+    {"treeName": "Main", "root": {"type": "Sequence", "children": [
+      {"type": "Count", "name": "first"},
+      {"type": "Subtree", "id": "Child"}]}},
+    {"treeName": "Child", "root": {"type": "Fallback", "children": [
+      {"type": "Inverter", "children": [{"type": "Count"}]},
+      {"type": "Count", "name": "last"}]}}]
+})";
+
+void RegisterActions(BehaviorTreeFactory &rFactory, int &rCountNum) {
+    rFactory.RegisterSimpleAction("Count", [&rCountNum](TreeNode &) {
+        rCountNum++;
+        return NodeStatus::Success;
+    });
+}
+
+std::filesystem::path PrecompiledPath() {
+    return std::filesystem::temp_directory_path() / "behaviortree_precompiled_test.btp";
+}
+}// namespace
+
+TEST_SUITE("precompiled") {
+    TEST_CASE("load_precompiled_trees") {
+        int parsedNum = 0;
+        BehaviorTreeFactory parsedFactory;
+        RegisterActions(parsedFactory, parsedNum);
+        parsedFactory.RegisterBehaviorTreeFromText(TREE_TEXT);
+        parsedFactory.SavePrecompiledBehaviorTrees(PrecompiledPath());
+
+        int loadedNum = 0;
+        BehaviorTreeFactory loadedFactory;
+        RegisterActions(loadedFactory, loadedNum);
+        loadedFactory.RegisterBehaviorTreeFromPrecompiled(PrecompiledPath());
+        std::filesystem::remove(PrecompiledPath());
+        CHECK(loadedFactory.GetRegisteredTreeName() == parsedFactory.GetRegisteredTreeName());
+
+        // the trees refer to the mapping, that the parser keeps alive
+        auto parsedTree = parsedFactory.CreateTree("Main");
+        auto loadedTree = loadedFactory.CreateTree("Main");
+        CHECK(loadedTree.TickExactlyOnce() == parsedTree.TickExactlyOnce());
+        CHECK(loadedNum == parsedNum);
+        CHECK(loadedNum == 3);
+
+        std::vector<std::string> nameVec;
+        loadedTree.ApplyVisitor([&nameVec](TreeNode *pNode) {
+            nameVec.push_back(pNode->GetNodeName());
+        });
+        CHECK(nameVec.size() == 7);
+        CHECK(std::find(nameVec.begin(), nameVec.end(), "last") != nameVec.end());
+    }
+
+    TEST_CASE("tree_name_registered_as_node") {
+        int countNum = 0;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, countNum);
+        factory.RegisterBehaviorTreeFromText(TREE_TEXT);
+        factory.SavePrecompiledBehaviorTrees(PrecompiledPath());
+
+        // "Child" is the name of a tree and the id of a Subtree
+        BehaviorTreeFactory otherFactory;
+        RegisterActions(otherFactory, countNum);
+        otherFactory.RegisterSimpleAction("Child", [](TreeNode &) {
+            return NodeStatus::Success;
+        });
+        CHECK_THROWS(otherFactory.RegisterBehaviorTreeFromPrecompiled(PrecompiledPath()));
+        std::filesystem::remove(PrecompiledPath());
+    }
+}
@@ -0,0 +1,163 @@
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/basic_types.h"
+
+using namespace behaviortree;
+
+namespace {
+enum class Color { Red = 1, Green = 2 };
+
+const std::string SHORT_TEXT = "short";
+// longer than the strings stored in place
+const std::string LONG_TEXT(100, 'x');
+}// namespace
+
+TEST_SUITE("safe_any") {
+    TEST_CASE("copy_and_move_strings") {
+        for(const std::string &rText: {SHORT_TEXT, LONG_TEXT}) {
+            Any value(rText);
+            REQUIRE(value.IsString());
+
+            Any copy(value);
+            CHECK(copy.Cast<std::string>() == rText);
+            CHECK(value.Cast<std::string>() == rText);
+
+            Any moved(std::move(copy));
+            CHECK(moved.Cast<std::string>() == rText);
+            CHECK(copy.Empty());
+
+            // assigned over a value of another kind
+            Any assigned(std::vector<int>(3, 1));
+            assigned = value;
+            CHECK(assigned.GetStringView() == rText);
+            assigned = Any(42);
+            CHECK(assigned.Cast<int>() == 42);
+            assigned = std::move(moved);
+            CHECK(assigned.GetStringView() == rText);
+            CHECK(moved.Empty());
+        }
+
+        // the long strings are shared by the copies
+        Any value(LONG_TEXT);
+        Any copy(value);
+        CHECK(copy.GetStringView().data() == value.GetStringView().data());
+        value = Any(SHORT_TEXT);
+        CHECK(copy.GetStringView() == LONG_TEXT);
+    }
+
+    TEST_CASE("copy_into_and_move_into") {
+        // an empty destination takes the kind of the source
+        Any dst;
+        Any(1.5).CopyInto(dst);
+        CHECK(dst.CastedType() == typeid(double));
+
+        // numbers are converted to the kind of the destination
+        Any(3).CopyInto(dst);
+        CHECK(dst.CastedType() == typeid(double));
+        CHECK(dst.Cast<double>() == 3.0);
+        Any integral(7);
+        Any(2.0).CopyInto(integral);
+        CHECK(integral.CastedType() == typeid(int64_t));
+        CHECK(integral.Cast<int>() == 2);
+
+        // short and long strings are interchangeable
+        Any text(SHORT_TEXT);
+        Any(LONG_TEXT).CopyInto(text);
+        CHECK(text.GetStringView() == LONG_TEXT);
+        Any(SHORT_TEXT).MoveInto(text);
+        CHECK(text.GetStringView() == SHORT_TEXT);
+
+        CHECK_THROWS(Any(SHORT_TEXT).CopyInto(integral));
+        CHECK_THROWS(Any(1.5).CopyInto(text));
+        Any vector(std::vector<int>(3, 1));
+        CHECK_THROWS(Any(std::vector<double>()).CopyInto(vector));
+        CHECK_THROWS(Any(std::vector<double>()).MoveInto(vector));
+
+        // the values of the same type are moved
+        std::vector<int> valueVec(10, 2);
+        const int *pData = valueVec.data();
+        Any source(std::move(valueVec));
+        source.MoveInto(vector);
+        REQUIRE(vector.CastPtr<std::vector<int>>() != nullptr);
+        CHECK(vector.CastPtr<std::vector<int>>()->data() == pData);
+        CHECK(source.Empty());
+
+        Any longText(LONG_TEXT);
+        const char *pText = longText.GetStringView().data();
+        longText.MoveInto(text);
+        CHECK(text.GetStringView().data() == pText);
+        CHECK(longText.Empty());
+
+        // a number moved into a number of another kind is converted
+        Any number(4);
+        number.MoveInto(dst);
+        CHECK(dst.CastedType() == typeid(double));
+        CHECK(dst.Cast<double>() == 4.0);
+    }
+
+    TEST_CASE("try_cast") {
+        Any integral(42);
+        CHECK(integral.Cast<int>() == 42);
+        CHECK(integral.Cast<uint8_t>() == 42);
+        CHECK(integral.Cast<double>() == 42.0);
+        CHECK(integral.Cast<std::string>() == "42");
+        CHECK(integral.Cast<Color>() == Color(42));
+        CHECK(Any(2).Cast<Color>() == Color::Green);
+        CHECK_FALSE(integral.TryCast<std::vector<int>>());
+
+        Any text("42");
+        CHECK(text.Cast<int>() == 42);
+        CHECK(text.Cast<double>() == 42.0);
+        CHECK(text.Cast<std::string>() == "42");
+        CHECK(text.Cast<SafeAny::SimpleString>().toStdString() == "42");
+        CHECK(text.Cast<Color>() == Color(42));
+        CHECK_FALSE(Any("not a number").TryCast<int>());
+
+        // the arithmetic types that are not casted internally
+        Any extended((long double)(2.5));
+        auto extendedValue = extended.TryCast<long double>();
+        REQUIRE(extendedValue);
+        CHECK(extendedValue.value() == 2.5);
+
+        Any vector(std::vector<int>(3, 1));
+        auto vectorValue = vector.TryCast<std::vector<int>>();
+        REQUIRE(vectorValue);
+        CHECK(vectorValue->size() == 3);
+        CHECK_FALSE(vector.TryCast<int>());
+        CHECK_FALSE(vector.TryCast<std::string>());
+
+        CHECK_THROWS(Any().TryCast<int>());
+    }
+
+    TEST_CASE("casted_type") {
+        CHECK(Any().CastedType() == typeid(void));
+
+        Any integral(int16_t(3));
+        CHECK(integral.CastedType() == typeid(int64_t));
+        CHECK(integral.Type() == typeid(int16_t));
+        CHECK(integral.IsType<int16_t>());
+
+        CHECK(Any(uint64_t(3)).CastedType() == typeid(uint64_t));
+        CHECK(Any(Color::Red).CastedType() == typeid(int64_t));
+
+        Any real(1.5f);
+        CHECK(real.CastedType() == typeid(double));
+        CHECK(real.Type() == typeid(float));
+        REQUIRE(real.CastPtr<double>() != nullptr);
+        CHECK(*real.CastPtr<double>() == 1.5);
+
+        for(const std::string &rText: {SHORT_TEXT, LONG_TEXT}) {
+            Any text(rText);
+            CHECK(text.CastedType() == typeid(SafeAny::SimpleString));
+            CHECK(text.Type() == typeid(std::string));
+        }
+
+        CHECK(Any((long double)(1)).CastedType() == typeid(long double));
+        Any vector(std::vector<int>{});
+        CHECK(vector.CastedType() == typeid(std::vector<int>));
+        CHECK(vector.CastPtr<double>() == nullptr);
+    }
+}
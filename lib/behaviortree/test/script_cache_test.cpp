@@ -0,0 +1,111 @@
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/scripting/script_parser.hpp"
+
+using namespace behaviortree;
+
+namespace {
+// the cache is shared by the whole process: start empty and unbounded
+void ResetCache() {
+    ScriptCache::SetOptions({});
+    ScriptCache::Clear();
+}
+
+// counters since rStart
+ScriptCache::Stats StatsSince(const ScriptCache::Stats &rStart) {
+    auto stats = ScriptCache::GetStats();
+    return {stats.hitsNum - rStart.hitsNum, stats.missesNum - rStart.missesNum, stats.cachedNum};
+}
+
+bool Parse(const std::string &rScript) {
+    return bool(ParseScript(rScript));
+}
+}// namespace
+
+TEST_SUITE("script_cache") {
+    TEST_CASE("hits_and_misses") {
+        ResetCache();
+        const auto start = ScriptCache::GetStats();
+        CHECK(start.cachedNum == 0);
+
+        CHECK(Parse("a := 1"));
+        CHECK(StatsSince(start).missesNum == 1);
+        CHECK(StatsSince(start).cachedNum == 1);
+
+        CHECK(Parse("a := 1"));
+        CHECK(ValidateScript("a := 1"));
+        CHECK(StatsSince(start).hitsNum == 2);
+        CHECK(StatsSince(start).missesNum == 1);
+
+        // the invalid scripts are parsed again each time
+        CHECK_FALSE(Parse("a := "));
+        CHECK_FALSE(ValidateScript("a := "));
+        CHECK(StatsSince(start).hitsNum == 2);
+        CHECK(StatsSince(start).missesNum == 3);
+        CHECK(StatsSince(start).cachedNum == 1);
+    }
+
+    TEST_CASE("least_recently_used_are_evicted") {
+        ResetCache();
+        ScriptCache::SetOptions({2});
+        CHECK(ScriptCache::GetOptions().maxCachedNum == 2);
+        const auto start = ScriptCache::GetStats();
+
+        CHECK(Parse("a := 1"));
+        CHECK(Parse("b := 2"));
+        // "a" is now more recent than "b"
+        CHECK(Parse("a := 1"));
+        CHECK(Parse("c := 3"));
+        CHECK(StatsSince(start).hitsNum == 1);
+        CHECK(StatsSince(start).missesNum == 3);
+        CHECK(StatsSince(start).cachedNum == 2);
+
+        // "b" was evicted
+        CHECK(Parse("a := 1"));
+        CHECK(StatsSince(start).hitsNum == 2);
+        // "c", the least recently used, is evicted for "b"
+        CHECK(Parse("b := 2"));
+        CHECK(StatsSince(start).missesNum == 4);
+        CHECK(Parse("a := 1"));
+        CHECK(StatsSince(start).hitsNum == 3);
+        CHECK(Parse("c := 3"));
+        CHECK(StatsSince(start).missesNum == 5);
+
+        // a lower limit evicts at once, the most recent stays
+        ScriptCache::SetOptions({1});
+        CHECK(StatsSince(start).cachedNum == 1);
+        CHECK(Parse("c := 3"));
+        CHECK(StatsSince(start).hitsNum == 4);
+        CHECK(Parse("a := 1"));
+        CHECK(StatsSince(start).missesNum == 6);
+        CHECK(StatsSince(start).cachedNum == 1);
+
+        ResetCache();
+    }
+
+    TEST_CASE("clear") {
+        ResetCache();
+        auto script = ParseScript("a := 1; b := a + 1");
+        REQUIRE(script);
+        CHECK(Parse("c := 3"));
+        const auto start = ScriptCache::GetStats();
+        CHECK(start.cachedNum == 2);
+
+        ScriptCache::Clear();
+        CHECK(ScriptCache::GetStats().cachedNum == 0);
+        // the counters are kept
+        CHECK(StatsSince(start).hitsNum == 0);
+        CHECK(StatsSince(start).missesNum == 0);
+
+        // the functions already created keep their script
+        Ast::Environment env{Blackboard::Create(), {}};
+        CHECK(script.value()(env).Cast<double>() == 2.0);
+        CHECK(env.ptrVars->Get<double>("b") == 2.0);
+
+        CHECK(Parse("c := 3"));
+        CHECK(StatsSince(start).missesNum == 1);
+        CHECK(StatsSince(start).cachedNum == 1);
+    }
+}
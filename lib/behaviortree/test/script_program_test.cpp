@@ -0,0 +1,131 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/scripting/operators.hpp"
+#include "behaviortree/scripting/script_parser.hpp"
+#include "behaviortree/scripting/script_program.hpp"
+
+using namespace behaviortree;
+
+namespace {
+using Ast::ExprAssignment;
+using Ast::ExprBinaryArithmetic;
+using Ast::ExprComparison;
+using ExprVec = std::vector<Ast::PtrExpr>;
+
+Ast::PtrExpr Number(double value) {
+    return std::make_shared<Ast::ExprLiteral>(Any(value));
+}
+
+Ast::PtrExpr Name(const std::string &rName) {
+    return std::make_shared<Ast::ExprName>(rName);
+}
+
+Ast::PtrExpr Binary(Ast::PtrExpr pLhs, ExprBinaryArithmetic::op_t op, Ast::PtrExpr pRhs) {
+    return std::make_shared<ExprBinaryArithmetic>(std::move(pLhs), op, std::move(pRhs));
+}
+
+Ast::PtrExpr Comparison(ExprVec operandVec, std::vector<ExprComparison::op_t> opVec) {
+    auto pComparison = std::make_shared<ExprComparison>();
+    pComparison->operands = std::move(operandVec);
+    pComparison->ops = std::move(opVec);
+    return pComparison;
+}
+
+Blackboard::Ptr MakeBlackboard() {
+    auto pBlackboard = Blackboard::Create();
+    pBlackboard->Set("a", 1.0);
+    pBlackboard->Set("b", 5.0);
+    pBlackboard->Set("c", 3.0);
+    return pBlackboard;
+}
+
+// value of the last statement, evaluated by the tree-walking interpreter
+double EvaluateAst(const ExprVec &rExprVec, Blackboard::Ptr pBlackboard) {
+    Ast::Environment env{std::move(pBlackboard), {}};
+    Any result;
+    for(const auto &pExpr: rExprVec) {
+        result = pExpr->evaluate(env);
+    }
+    return result.Cast<double>();
+}
+
+double ExecuteProgram(const ExprVec &rExprVec, Blackboard::Ptr pBlackboard) {
+    auto pProgram = ScriptProgram::Compile(rExprVec);
+    REQUIRE(pProgram != nullptr);
+    Ast::Environment env{pBlackboard, {}};
+    ScriptProgram::EntryCache entryCache(*pProgram, pBlackboard);
+    return pProgram->Execute(env, &entryCache).Cast<double>();
+}
+
+void CheckSameResult(const ExprVec &rExprVec) {
+    auto pAstBlackboard = MakeBlackboard();
+    auto pProgramBlackboard = MakeBlackboard();
+    CHECK(ExecuteProgram(rExprVec, pProgramBlackboard) == EvaluateAst(rExprVec, pAstBlackboard));
+    for(const char *pName: {"a", "b", "c"}) {
+        CHECK(pProgramBlackboard->Get<double>(pName) == pAstBlackboard->Get<double>(pName));
+    }
+}
+}// namespace
+
+TEST_SUITE("script_program") {
+    TEST_CASE("comparison_chain_with_compound_operands") {
+        // a < b < c + 1, i.e. 1 < 5 and 5 < 4
+        const ExprVec exprVec = {Comparison({Name("a"), Name("b"), Binary(Name("c"), ExprBinaryArithmetic::plus, Number(1))}, {ExprComparison::less, ExprComparison::less})};
+        CHECK(ExecuteProgram(exprVec, MakeBlackboard()) == 0.0);
+        CheckSameResult(exprVec);
+
+        CheckSameResult({Comparison({Binary(Name("a"), ExprBinaryArithmetic::times, Name("b")), Name("b"), Binary(Name("c"), ExprBinaryArithmetic::plus, Name("c")), Name("c")}, {ExprComparison::equal, ExprComparison::greater_equal, ExprComparison::not_equal})});
+        CheckSameResult({Comparison({Name("a"), Binary(Name("b"), ExprBinaryArithmetic::minus, Name("c")), Binary(Name("c"), ExprBinaryArithmetic::plus, Name("a")), Binary(Name("b"), ExprBinaryArithmetic::div, Name("a"))}, {ExprComparison::less, ExprComparison::less, ExprComparison::less})});
+    }
+
+    TEST_CASE("arithmetic") {
+        CheckSameResult({Binary(Binary(Name("a"), ExprBinaryArithmetic::plus, Name("b")), ExprBinaryArithmetic::times, Binary(Name("c"), ExprBinaryArithmetic::minus, Number(0.5)))});
+        CheckSameResult({Binary(Name("b"), ExprBinaryArithmetic::div, Binary(Name("c"), ExprBinaryArithmetic::plus, Name("a")))});
+    }
+
+    TEST_CASE("assignment") {
+        CheckSameResult({std::make_shared<ExprAssignment>(Name("a"), ExprAssignment::assign_plus, Binary(Name("b"), ExprBinaryArithmetic::times, Number(2))),
+                         std::make_shared<ExprAssignment>(Name("c"), ExprAssignment::assign_existing, Binary(Name("a"), ExprBinaryArithmetic::minus, Name("c")))});
+    }
+
+    TEST_CASE("enums_registered_after_binding") {
+        auto pBlackboard = Blackboard::Create();
+        auto pEnums = std::make_shared<EnumsTable>();
+        (*pEnums)["RED"] = 1;
+        Ast::Environment env{pBlackboard, pEnums};
+
+        auto script = ParseScript("x := RED + GREEN", env);
+        REQUIRE(script);
+        // GREEN is registered once the script is bound to the table
+        (*pEnums)["GREEN"] = 2;
+        CHECK(script.value()(env).Cast<double>() == 3.0);
+        CHECK(pBlackboard->Get<double>("x") == 3.0);
+
+        (*pEnums)["BLUE"] = 4;
+        CHECK(script.value()(env).Cast<double>() == 3.0);
+    }
+
+    TEST_CASE("assignment_publishes_the_snapshot") {
+        auto pBlackboard = Blackboard::Create();
+        Ast::Environment env{pBlackboard, {}};
+
+        auto script = ParseScript("x := 3.5", env);
+        REQUIRE(script);
+        script.value()(env);
+        auto pEntry = pBlackboard->GetEntry("x");
+        REQUIRE(pEntry != nullptr);
+        double value = 0;
+        REQUIRE(pEntry->TryReadSnapshot(value));
+        CHECK(value == 3.5);
+
+        auto increment = ParseScript("x += 1", env);
+        REQUIRE(increment);
+        increment.value()(env);
+        REQUIRE(pEntry->TryReadSnapshot(value));
+        CHECK(value == 4.5);
+    }
+}
@@ -0,0 +1,347 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+using namespace behaviortree;
+
+namespace {
+// SUCCESS after the given number of milliseconds, unless halted.
+class WorkAction: public ThreadedAction {
+ public:
+    WorkAction(const std::string &rName, const NodeConfig &rConfig, int durationMs): ThreadedAction(rName, rConfig), m_durationMs(durationMs) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+    std::atomic<bool> ticking{false};
+    std::atomic<int> completedNum{0};
+
+ private:
+    NodeStatus Tick() override {
+        ticking = true;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_durationMs);
+        while(std::chrono::steady_clock::now() < deadline) {
+            if(IsHaltRequested()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                ticking = false;
+                return NodeStatus::Idle;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        completedNum++;
+        ticking = false;
+        return NodeStatus::Success;
+    }
+
+    const int m_durationMs;
+};
+
+// SUCCESS after the given number of milliseconds, even if halted.
+class StubbornAction: public ThreadedAction {
+ public:
+    StubbornAction(const std::string &rName, const NodeConfig &rConfig, int durationMs): ThreadedAction(rName, rConfig), m_durationMs(durationMs) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+    std::atomic<int> tickingNum{0};
+    std::atomic<int> maxTickingNum{0};
+    std::atomic<int> startedNum{0};
+
+ private:
+    NodeStatus Tick() override {
+        startedNum++;
+        int tickingNum = ++this->tickingNum;
+        int maxTickingNum = this->maxTickingNum.load();
+        while(tickingNum > maxTickingNum and !this->maxTickingNum.compare_exchange_weak(maxTickingNum, tickingNum)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_durationMs));
+        this->tickingNum--;
+        return NodeStatus::Success;
+    }
+
+    const int m_durationMs;
+};
+
+// Blocks the jobs until opened, and records the order in which they ran.
+class JobLog {
+ public:
+    void Open() {
+        m_open = true;
+    }
+
+    ActionPool::Job Blocker() {
+        return [this]() {
+            runningNum++;
+            while(!m_open.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            runningNum--;
+        };
+    }
+
+    ActionPool::Job Recorder(int id) {
+        return [this, id]() {
+            std::unique_lock lock(m_mutex);
+            m_idVec.push_back(id);
+        };
+    }
+
+    std::vector<int> GetIds() const {
+        std::unique_lock lock(m_mutex);
+        return m_idVec;
+    }
+
+    // wait until idsNum jobs were recorded
+    bool WaitFor(size_t idsNum) const {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(GetIds().size() < idsNum) {
+            if(std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::atomic<int> runningNum{0};
+
+ private:
+    std::atomic<bool> m_open{false};
+    mutable std::mutex m_mutex;
+    std::vector<int> m_idVec;
+};
+
+// SUCCESS once the gate is open, counting the actions of the tree ticking together.
+class GatedAction: public ThreadedAction {
+ public:
+    struct Shared {
+        std::atomic<bool> open{false};
+        std::atomic<int> tickingNum{0};
+        std::atomic<int> maxTickingNum{0};
+    };
+
+    GatedAction(const std::string &rName, const NodeConfig &rConfig, Shared *pShared): ThreadedAction(rName, rConfig), m_pShared(pShared) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    NodeStatus Tick() override {
+        int tickingNum = ++m_pShared->tickingNum;
+        int maxTickingNum = m_pShared->maxTickingNum.load();
+        while(tickingNum > maxTickingNum and !m_pShared->maxTickingNum.compare_exchange_weak(maxTickingNum, tickingNum)) {
+        }
+        while(!m_pShared->open.load() and !IsHaltRequested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        m_pShared->tickingNum--;
+        return NodeStatus::Success;
+    }
+
+    Shared *m_pShared;
+};
+
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Work"}}
+})";
+
+const char *PARALLEL_TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Parallel", "success_count": "-1", "children": [
+    {"type": "Gated"}, {"type": "Gated"}, {"type": "Gated"}]}}
+})";
+
+bool WaitForRunning(const std::atomic<int> &rRunningNum, int runningNum) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(rRunningNum.load() != runningNum) {
+        if(std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+}// namespace
+
+TEST_SUITE("threaded_action") {
+    TEST_CASE("halt_returns_immediately") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<StubbornAction>("Work", 200);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT);
+        auto *pAction = dynamic_cast<StubbornAction *>(tree.GetRootNode());
+        REQUIRE(pAction != nullptr);
+
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        while(pAction->tickingNum.load() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const auto begin = std::chrono::steady_clock::now();
+        tree.HaltTree();
+        CHECK(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(100));
+        CHECK(pAction->IsHaltRequested());
+        CHECK(pAction->GetNodeStatus() == NodeStatus::Idle);
+
+        // the result of the halted tick() is discarded
+        while(pAction->tickingNum.load() != 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(pAction->GetNodeStatus() == NodeStatus::Idle);
+    }
+
+    TEST_CASE("tick_while_the_halted_tick_returns") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<StubbornAction>("Work", 50);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT);
+        auto *pAction = dynamic_cast<StubbornAction *>(tree.GetRootNode());
+        REQUIRE(pAction != nullptr);
+
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        tree.HaltTree();
+        // neither waits for the previous tick()
+        const auto begin = std::chrono::steady_clock::now();
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        CHECK(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(40));
+
+        CHECK(tree.TickWhileRunning(std::chrono::milliseconds(1000)) == NodeStatus::Success);
+        // the new activation started once the halted one had completed
+        CHECK(pAction->maxTickingNum.load() == 1);
+    }
+
+    TEST_CASE("restart_after_halt") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<WorkAction>("Work", 20);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT);
+        auto *pAction = dynamic_cast<WorkAction *>(tree.GetRootNode());
+        REQUIRE(pAction != nullptr);
+
+        for(int i = 0; i < 10; i++) {
+            CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+            tree.HaltTree();
+        }
+        // the last activation completes and wakes up the tree
+        CHECK(tree.TickWhileRunning(std::chrono::milliseconds(1000)) == NodeStatus::Success);
+        CHECK(pAction->completedNum.load() == 1);
+    }
+
+    TEST_CASE("status_callback_uses_the_node") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<WorkAction>("Work", 5);
+        auto tree = factory.CreateTreeFromText(TREE_TEXT);
+        auto *pAction = dynamic_cast<WorkAction *>(tree.GetRootNode());
+        REQUIRE(pAction != nullptr);
+
+        // the callbacks are invoked without the mutex of the node
+        std::atomic<int> changesNum{0};
+        auto pSubscriber = pAction->SubscribeToStatusChange([&changesNum](TimePoint, const TreeNode &rNode, NodeStatus, NodeStatus) {
+            if(!dynamic_cast<const WorkAction &>(rNode).IsHaltRequested()) {
+                changesNum++;
+            }
+        });
+        CHECK(tree.TickWhileRunning(std::chrono::milliseconds(1000)) == NodeStatus::Success);
+        // at least IDLE -> RUNNING -> SUCCESS
+        CHECK(changesNum.load() >= 2);
+    }
+
+    TEST_CASE("pool_limit_releases_in_fifo_order") {
+        JobLog log;
+        ActionPool pool(ActionPool::Options{4, 1});
+        pool.Submit(log.Blocker(), {});
+        REQUIRE(WaitForRunning(log.runningNum, 1));
+        for(int id = 1; id <= 4; id++) {
+            pool.Submit(log.Recorder(id), {});
+        }
+        CHECK(pool.GetInFlightNum() == 1);
+        CHECK(pool.GetPendingNum() == 4);
+        CHECK(log.GetIds().empty());
+
+        // a single job in flight: the pending ones run one after the other
+        log.Open();
+        REQUIRE(log.WaitFor(4));
+        CHECK(log.GetIds() == std::vector<int>{1, 2, 3, 4});
+        CHECK(pool.GetPendingNum() == 0);
+    }
+
+    TEST_CASE("group_limit") {
+        JobLog log;
+        ActionPool pool(ActionPool::Options{4, 0});
+        auto pLimit = std::make_shared<ActionPool::Limit>(1);
+        CHECK(pLimit->GetMaxInFlight() == 1);
+        pool.Submit(log.Blocker(), {}, pLimit);
+        REQUIRE(WaitForRunning(log.runningNum, 1));
+        for(int id = 1; id <= 3; id++) {
+            pool.Submit(log.Recorder(id), {}, pLimit);
+        }
+        CHECK(pool.GetPendingNum() == 3);
+
+        // the jobs of other groups are not limited
+        pool.Submit(log.Recorder(0), {});
+        REQUIRE(log.WaitFor(1));
+        CHECK(log.GetIds() == std::vector<int>{0});
+        CHECK(pool.GetPendingNum() == 3);
+
+        log.Open();
+        REQUIRE(log.WaitFor(4));
+        CHECK(log.GetIds() == std::vector<int>{0, 1, 2, 3});
+    }
+
+    TEST_CASE("cancelled_pending_jobs_skip_the_queue") {
+        JobLog log;
+        ActionPool pool(ActionPool::Options{4, 1});
+        pool.Submit(log.Blocker(), {});
+        REQUIRE(WaitForRunning(log.runningNum, 1));
+        CancellationToken firstToken;
+        CancellationToken secondToken;
+        pool.Submit(log.Recorder(1), firstToken);
+        pool.Submit(log.Recorder(2), secondToken);
+        CHECK(pool.GetPendingNum() == 2);
+
+        // released at once, without waiting for the job in flight
+        pool.Cancel(secondToken);
+        CHECK(secondToken.IsCancelled());
+        REQUIRE(log.WaitFor(1));
+        CHECK(log.GetIds() == std::vector<int>{2});
+        CHECK(pool.GetPendingNum() == 1);
+
+        // so is a job submitted with a cancelled token
+        pool.Submit(log.Recorder(3), secondToken);
+        REQUIRE(log.WaitFor(2));
+        CHECK(log.GetIds() == std::vector<int>{2, 3});
+        CHECK(pool.GetPendingNum() == 1);
+        CHECK(pool.GetInFlightNum() == 1);
+
+        log.Open();
+        REQUIRE(log.WaitFor(3));
+        CHECK(log.GetIds() == std::vector<int>{2, 3, 1});
+    }
+
+    TEST_CASE("tree_limit") {
+        GatedAction::Shared shared;
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<GatedAction>("Gated", &shared);
+        auto tree = factory.CreateTreeFromText(PARALLEL_TREE_TEXT);
+        auto pPool = std::make_shared<ActionPool>(ActionPool::Options{4, 0});
+        tree.SetActionPool(pPool, 1);
+
+        // the Parallel starts the three actions, one at a time
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        REQUIRE(WaitForRunning(shared.tickingNum, 1));
+        CHECK(pPool->GetInFlightNum() == 1);
+        CHECK(pPool->GetPendingNum() == 2);
+
+        shared.open = true;
+        CHECK(tree.TickWhileRunning(std::chrono::milliseconds(1000)) == NodeStatus::Success);
+        CHECK(shared.maxTickingNum.load() == 1);
+        CHECK(pPool->GetPendingNum() == 0);
+    }
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+#include "helper/delayed_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+namespace {
+// Completed at its 5th OnRunning(), never emits the wake-up signal.
+class PollingAction: public StatefulActionNode {
+ public:
+    PollingAction(const std::string &rName, const NodeConfig &rConfig, int *pRunningNum): StatefulActionNode(rName, rConfig), m_pRunningNum(pRunningNum) {}
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    NodeStatus OnStart() override {
+        return NodeStatus::Running;
+    }
+
+    NodeStatus OnRunning() override {
+        return ++*m_pRunningNum % 5 == 0 ? NodeStatus::Success : NodeStatus::Running;
+    }
+
+    void OnHalted() override {}
+
+    int *m_pRunningNum;
+};
+
+const char *DELAYED_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Delayed"}}
+})";
+
+const char *POLLING_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Polling"}}
+})";
+}// namespace
+
+TEST_SUITE("tick_on_event") {
+    TEST_CASE("ticked_again_on_wake_up") {
+        DelayedSamples samples;
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<DelayedAction>("Delayed", &samples);
+        auto tree = factory.CreateTreeFromText(DELAYED_TEXT);
+
+        CHECK(tree.TickWhileRunningOnEvent() == NodeStatus::Success);
+        // TickWhileRunning(10ms) would have ticked it about 5 times
+        CHECK(samples.runningNum == 1);
+
+        // the tree can be ticked again
+        samples.runningNum = 0;
+        CHECK(tree.TickWhileRunningOnEvent() == NodeStatus::Success);
+        CHECK(samples.runningNum == 1);
+    }
+
+    TEST_CASE("heartbeat") {
+        int runningNum = 0;
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<PollingAction>("Polling", &runningNum);
+        auto tree = factory.CreateTreeFromText(POLLING_TEXT);
+
+        CHECK(tree.TickWhileRunningOnEvent(std::chrono::milliseconds(1)) == NodeStatus::Success);
+        CHECK(runningNum == 5);
+    }
+
+    TEST_CASE("signals_are_coalesced") {
+        int runningNum = 0;
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<PollingAction>("Polling", &runningNum);
+        auto tree = factory.CreateTreeFromText(POLLING_TEXT);
+
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        // the signals received while the tree is not ticked produce a single
+        // tick, after the one of TickOnce()
+        tree.ApplyVisitor([](TreeNode *pNode) {
+            for(int i = 0; i < 10; i++) {
+                pNode->EmitWakeUpSignal();
+            }
+        });
+        CHECK(tree.TickOnce() == NodeStatus::Running);
+        CHECK(runningNum == 2);
+    }
+}
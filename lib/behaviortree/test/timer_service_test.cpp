@@ -0,0 +1,243 @@
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/util/clock.h"
+#include "behaviortree/util/timer_queue.h"
+#include "behaviortree/util/timer_service.h"
+
+using namespace behaviortree;
+
+namespace {
+// Virtual time starting at 0, with a service created at that time: the
+// timers expire exactly at their deadline.
+class VirtualClock {
+ public:
+    VirtualClock() {
+        Clock::SetVirtualTime(std::chrono::nanoseconds(0));
+        Clock::SetMode(Clock::Mode::Virtual);
+        pService = TimerService::Get();
+        // nobody else uses the service: it was created in virtual time
+        REQUIRE(pService.use_count() == 1);
+    }
+
+    ~VirtualClock() {
+        pService.reset();
+        Clock::SetMode(Clock::Mode::Precise);
+    }
+
+    std::shared_ptr<TimerService> pService;
+};
+
+// Executions of the handler of a timer.
+struct Record {
+    std::atomic<int> firedNum{0};
+    std::atomic<int> abortedNum{0};
+    // virtual time of the last normal execution
+    std::atomic<int64_t> firedNs{-1};
+
+    TimerService::Handler Handler() {
+        return [this](bool aborted) {
+            if(aborted) {
+                abortedNum++;
+            } else {
+                firedNs = Clock::PreciseNow().count();
+                firedNum++;
+            }
+        };
+    }
+
+    // wait until the handler was executed
+    bool Wait() const {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(firedNum.load() + abortedNum.load() == 0) {
+            if(std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        return true;
+    }
+};
+
+std::chrono::nanoseconds Ms(int64_t milliseconds) {
+    return std::chrono::milliseconds(milliseconds);
+}
+}// namespace
+
+TEST_SUITE("timer_service") {
+    TEST_CASE("last_reference_released_by_a_handler") {
+        std::atomic<bool> expired{false};
+        {
+            auto pService = TimerService::Get();
+            auto pClient = std::make_shared<TimerService::Client>();
+            // the handler owns the only reference left when it is executed
+            pService->Add(pClient, std::chrono::milliseconds(1), [pService, &expired](bool) {
+                expired = true;
+            });
+        }
+        while(!expired) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // a new service is started
+        std::atomic<bool> aborted{true};
+        auto pService = TimerService::Get();
+        auto pClient = std::make_shared<TimerService::Client>();
+        pService->Add(pClient, std::chrono::milliseconds(1), [&aborted](bool wasAborted) {
+            aborted = wasAborted;
+        });
+        pService->Wait(*pClient);
+        CHECK_FALSE(aborted.load());
+    }
+
+    TEST_CASE("expiry_around_the_level_boundaries") {
+        VirtualClock clock;
+        std::set<int64_t> deadlineSet;
+        for(int64_t boundary: {1, 63, 64, 65, 4095, 4096, 300000}) {
+            deadlineSet.insert({boundary - 1, boundary, boundary + 1});
+        }
+        deadlineSet.erase(0);
+
+        // a timer per deadline, and a probe 1 ms earlier telling that the
+        // service processed the time just before the deadline
+        std::map<int64_t, Record> recordMap;
+        std::map<int64_t, Record> probeMap;
+        TimerQueue<> queue;
+        for(int64_t deadline: deadlineSet) {
+            queue.Add(std::chrono::milliseconds(deadline), recordMap[deadline].Handler());
+            if(deadline > 1) {
+                queue.Add(std::chrono::milliseconds(deadline - 1), probeMap[deadline].Handler());
+            }
+        }
+
+        for(int64_t deadline: deadlineSet) {
+            Clock::SetVirtualTime(Ms(deadline) - std::chrono::nanoseconds(1));
+            if(deadline > 1) {
+                REQUIRE(probeMap[deadline].Wait());
+            }
+            for(auto iter = recordMap.find(deadline); iter != recordMap.end(); ++iter) {
+                CHECK(iter->second.firedNum.load() == 0);
+            }
+
+            Clock::SetVirtualTime(Ms(deadline));
+            auto &rRecord = recordMap[deadline];
+            REQUIRE(rRecord.Wait());
+            CHECK(rRecord.firedNs.load() == Ms(deadline).count());
+        }
+        for(const auto &rEntry: recordMap) {
+            CHECK(rEntry.second.firedNum.load() == 1);
+            CHECK(rEntry.second.abortedNum.load() == 0);
+        }
+        CHECK(clock.pService->GetTimersNum() == 0);
+    }
+
+    TEST_CASE("same_deadline_in_the_order_of_add") {
+        VirtualClock clock;
+        std::mutex idMutex;
+        std::vector<int> idVec;
+        auto handler = [&idMutex, &idVec](int id) {
+            return [&idMutex, &idVec, id](bool) {
+                std::unique_lock lock(idMutex);
+                idVec.push_back(id);
+            };
+        };
+
+        Record probe;
+        Record last;
+        TimerQueue<> queue;
+        queue.Add(std::chrono::milliseconds(40), probe.Handler());
+        // the first ones are cascaded from level 1, the others are added to level 0
+        for(int id = 0; id < 3; id++) {
+            queue.Add(std::chrono::milliseconds(100), handler(id));
+        }
+        Clock::SetVirtualTime(Ms(40));
+        REQUIRE(probe.Wait());
+        for(int id = 3; id < 6; id++) {
+            queue.Add(std::chrono::milliseconds(60), handler(id));
+        }
+        // executed after all the others
+        queue.Add(std::chrono::milliseconds(60), last.Handler());
+        Clock::SetVirtualTime(Ms(100));
+        REQUIRE(last.Wait());
+        std::unique_lock lock(idMutex);
+        CHECK(idVec == std::vector<int>{0, 1, 2, 3, 4, 5});
+    }
+
+    TEST_CASE("cancelled_timers_abort_once") {
+        VirtualClock clock;
+        Record cancelled;
+        Record expired;
+        Record cancelledAll;
+        Record otherCancelledAll;
+        Record probe;
+        TimerQueue<> queue;
+        const uint64_t cancelledId = queue.Add(std::chrono::milliseconds(10), cancelled.Handler());
+        const uint64_t expiredId = queue.Add(std::chrono::milliseconds(10), expired.Handler());
+        queue.Add(std::chrono::milliseconds(20), cancelledAll.Handler());
+        queue.Add(std::chrono::milliseconds(5000), otherCancelledAll.Handler());
+
+        // executed at once, without waiting for the deadline
+        CHECK(queue.Cancel(cancelledId) == 1);
+        CHECK(queue.Cancel(cancelledId) == 0);
+        REQUIRE(cancelled.Wait());
+
+        Clock::SetVirtualTime(Ms(10));
+        REQUIRE(expired.Wait());
+        // too late
+        CHECK(queue.Cancel(expiredId) == 0);
+
+        CHECK(queue.CancelAll() == 2);
+        CHECK(queue.CancelAll() == 0);
+        REQUIRE(cancelledAll.Wait());
+        REQUIRE(otherCancelledAll.Wait());
+
+        // past all the deadlines
+        queue.Add(std::chrono::milliseconds(5000), probe.Handler());
+        Clock::SetVirtualTime(Ms(6000));
+        REQUIRE(probe.Wait());
+        for(const Record *pRecord: {&cancelled, &cancelledAll, &otherCancelledAll}) {
+            CHECK(pRecord->abortedNum.load() == 1);
+            CHECK(pRecord->firedNum.load() == 0);
+        }
+        CHECK(expired.firedNum.load() == 1);
+        CHECK(expired.abortedNum.load() == 0);
+        CHECK(clock.pService->GetTimersNum() == 0);
+    }
+
+    TEST_CASE("queue_destruction_waits_for_the_handlers") {
+        VirtualClock clock;
+        std::atomic<bool> started{false};
+        std::atomic<bool> finished{false};
+        Record pending;
+        auto pQueue = std::make_unique<TimerQueue<>>();
+        pQueue->Add(std::chrono::milliseconds(1), [&started, &finished](bool) {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            finished = true;
+        });
+        pQueue->Add(std::chrono::milliseconds(1000), pending.Handler());
+
+        Clock::SetVirtualTime(Ms(1));
+        while(!started.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // cancels the pending timer, and waits for both handlers
+        pQueue.reset();
+        CHECK(finished.load());
+        CHECK(pending.abortedNum.load() == 1);
+
+        Clock::SetVirtualTime(Ms(1000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(pending.firedNum.load() == 0);
+        CHECK(pending.abortedNum.load() == 1);
+        CHECK(clock.pService->GetTimersNum() == 0);
+    }
+}
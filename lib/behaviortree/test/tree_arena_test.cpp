@@ -0,0 +1,126 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+#include "behaviortree/tree_arena.h"
+
+using namespace behaviortree;
+
+namespace {
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Sequence", "children": [
+    {"type": "AlwaysSuccess", "name": "first"},
+    {"type": "Inverter", "children": [{"type": "AlwaysFailure"}]}]}}
+})";
+
+bool IsAligned(const void *pMemory) {
+    return reinterpret_cast<std::uintptr_t>(pMemory) % alignof(std::max_align_t) == 0;
+}
+}// namespace
+
+TEST_SUITE("tree_arena") {
+    TEST_CASE("allocations_with_and_without_arena") {
+        auto pArena = TreeArena::Create(1024);
+        void *pHeapBlock = TreeArena::Allocate(24);
+        CHECK(pArena->GetAllocatedBytes() == 0);
+
+        void *pArenaBlock;
+        void *pOtherHeapBlock;
+        {
+            TreeArena::Scope scope(pArena);
+            pArenaBlock = TreeArena::Allocate(24);
+            CHECK(pArena->GetAllocatedBytes() >= 24);
+            {
+                // a null arena routes the allocations to the heap again
+                TreeArena::Scope heapScope(nullptr);
+                pOtherHeapBlock = TreeArena::Allocate(24);
+            }
+        }
+        const size_t allocatedBytes = pArena->GetAllocatedBytes();
+        void *pLaterHeapBlock = TreeArena::Allocate(24);
+        CHECK(pArena->GetAllocatedBytes() == allocatedBytes);
+
+        for(void *pBlock: {pHeapBlock, pArenaBlock, pOtherHeapBlock, pLaterHeapBlock}) {
+            CHECK(IsAligned(pBlock));
+        }
+
+        // the block keeps the arena alive
+        pArena.reset();
+        TreeArena::Deallocate(pHeapBlock);
+        TreeArena::Deallocate(pArenaBlock);
+        TreeArena::Deallocate(pOtherHeapBlock);
+        TreeArena::Deallocate(pLaterHeapBlock);
+        TreeArena::Deallocate(nullptr);
+    }
+
+    TEST_CASE("nested_scopes") {
+        auto pOuterArena = TreeArena::Create(256);
+        auto pInnerArena = TreeArena::Create(256);
+        void *pInnerBlock;
+        void *pOuterBlock;
+        {
+            TreeArena::Scope outerScope(pOuterArena);
+            {
+                TreeArena::Scope innerScope(pInnerArena);
+                pInnerBlock = TreeArena::Allocate(40);
+            }
+            pOuterBlock = TreeArena::Allocate(40);
+        }
+        CHECK(pInnerArena->GetAllocatedBytes() >= 40);
+        CHECK(pOuterArena->GetAllocatedBytes() >= 40);
+        CHECK(pInnerArena->GetAllocatedBytes() == pOuterArena->GetAllocatedBytes());
+
+        TreeArena::Deallocate(pInnerBlock);
+        TreeArena::Deallocate(pOuterBlock);
+    }
+
+    TEST_CASE("node_outlives_its_tree") {
+        BehaviorTreeFactory factory;
+        factory.SetTreeArenaSize(4096);
+        factory.RegisterBehaviorTreeFromText(TREE_TEXT);
+
+        TreeNode::Ptr pLeaf;
+        {
+            auto tree = factory.CreateTree("Main");
+            REQUIRE(tree.m_pArena != nullptr);
+            CHECK(tree.m_pArena->GetAllocatedBytes() > 0);
+            CHECK(tree.TickExactlyOnce() == NodeStatus::Failure);
+            pLeaf = tree.m_subtreeVec.front()->nodeVec[1];
+            REQUIRE(pLeaf->GetNodeName() == "first");
+        }
+        // the arena is released with the last of its nodes
+        CHECK(pLeaf->GetNodeName() == "first");
+        CHECK(pLeaf->ExecuteTick() == NodeStatus::Success);
+        pLeaf.reset();
+    }
+
+    TEST_CASE("trees_with_and_without_arena") {
+        BehaviorTreeFactory factory;
+        factory.RegisterBehaviorTreeFromText(TREE_TEXT);
+        std::optional<Tree> heapTree(factory.CreateTree("Main"));
+        CHECK(heapTree->m_pArena == nullptr);
+
+        factory.SetTreeArenaSize(4096);
+        std::optional<Tree> arenaTree(factory.CreateTree("Main"));
+        REQUIRE(arenaTree->m_pArena != nullptr);
+
+        factory.SetTreeArenaSize(0);
+        std::optional<Tree> otherHeapTree(factory.CreateTree("Main"));
+        CHECK(otherHeapTree->m_pArena == nullptr);
+
+        for(auto *pTree: {&heapTree, &arenaTree, &otherHeapTree}) {
+            CHECK((*pTree)->TickExactlyOnce() == NodeStatus::Failure);
+        }
+
+        // destroyed in any order
+        arenaTree.reset();
+        CHECK(heapTree->TickExactlyOnce() == NodeStatus::Failure);
+        heapTree.reset();
+        CHECK(otherHeapTree->TickExactlyOnce() == NodeStatus::Failure);
+        otherHeapTree.reset();
+    }
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+#include "behaviortree/tree_executor.h"
+
+using namespace behaviortree;
+
+namespace {
+// Always RUNNING, woken up continuously by a thread of its own until halted.
+class BusyAction: public StatefulActionNode {
+ public:
+    BusyAction(const std::string &rName, const NodeConfig &rConfig): StatefulActionNode(rName, rConfig) {}
+
+    ~BusyAction() override {
+        StopEmitter();
+    }
+
+    static PortMap ProvidedPorts() {
+        return {};
+    }
+
+ private:
+    NodeStatus OnStart() override {
+        m_stop = false;
+        m_emitter = std::thread([this]() {
+            while(!m_stop.load()) {
+                EmitWakeUpSignal();
+            }
+        });
+        return NodeStatus::Running;
+    }
+
+    NodeStatus OnRunning() override {
+        return NodeStatus::Running;
+    }
+
+    void OnHalted() override {
+        StopEmitter();
+    }
+
+    void StopEmitter() {
+        m_stop = true;
+        if(m_emitter.joinable()) {
+            m_emitter.join();
+        }
+    }
+
+    std::atomic<bool> m_stop{false};
+    std::thread m_emitter;
+};
+
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Busy"}}
+})";
+
+const char *GATE_TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Gate"}}
+})";
+
+template<typename Predicate>
+bool WaitFor(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(!predicate()) {
+        if(std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+}// namespace
+
+TEST_SUITE("tree_executor") {
+    TEST_CASE("queue_depth_never_underflows") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<BusyAction>("Busy");
+        TreeExecutor executor(TreeExecutor::Options{2, std::chrono::milliseconds(0)});
+        const auto treeId = executor.Add(factory.CreateTreeFromText(TREE_TEXT));
+
+        // a single tree is queued at most once
+        size_t maxQueueDepth = 0;
+        for(int i = 0; i < 100000; i++) {
+            maxQueueDepth = std::max(maxQueueDepth, executor.GetStats().queueDepth);
+        }
+        CHECK(maxQueueDepth <= 1);
+        CHECK(executor.GetTreeStats(treeId)->ticksNum > 0);
+        CHECK(executor.Remove(treeId));
+    }
+
+    TEST_CASE("destroyed_while_woken_up") {
+        BehaviorTreeFactory factory;
+        factory.RegisterNodeType<BusyAction>("Busy");
+        for(int i = 0; i < 20; i++) {
+            TreeExecutor executor(TreeExecutor::Options{2, std::chrono::milliseconds(0)});
+            for(int j = 0; j < 4; j++) {
+                executor.Add(factory.CreateTreeFromText(TREE_TEXT));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            // the emitters keep running until the trees are halted, after the workers stopped
+        }
+    }
+
+    TEST_CASE("scheduled_while_ticking_a_completed_tree") {
+        std::atomic<int> ticksNum{0};
+        std::atomic<bool> open{false};
+        BehaviorTreeFactory factory;
+        // the first tick waits for the gate, then the tree completes
+        factory.RegisterSimpleAction("Gate", [&ticksNum, &open](TreeNode &) {
+            if(ticksNum.fetch_add(1) == 0) {
+                while(!open.load()) {
+                    std::this_thread::yield();
+                }
+            }
+            return NodeStatus::Success;
+        });
+        TreeExecutor executor(TreeExecutor::Options{2, std::chrono::milliseconds(0)});
+        const auto treeId = executor.Add(factory.CreateTreeFromText(GATE_TREE_TEXT));
+        REQUIRE(WaitFor([&ticksNum]() {
+            return ticksNum.load() == 1;
+        }));
+
+        // the Schedule() received during the tick restarts the completed tree
+        CHECK(executor.Schedule(treeId));
+        open = true;
+        CHECK(WaitFor([&executor, treeId]() {
+            return executor.GetTreeStats(treeId)->ticksNum == 2;
+        }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(ticksNum.load() == 2);
+        CHECK(executor.GetTreeStats(treeId)->nodeStatus == NodeStatus::Success);
+        CHECK(executor.Remove(treeId));
+    }
+}
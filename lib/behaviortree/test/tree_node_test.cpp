@@ -0,0 +1,87 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+#include "helper/toggle_action.h"
+
+using namespace behaviortree;
+using namespace behaviortree::testing;
+
+TEST_SUITE("tree_node") {
+    TEST_CASE("injected_callbacks") {
+        ActionCounters counters;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, counters);
+        auto tree = factory.CreateTreeFromText(TRANSITIONS_TREE_TEXT);
+
+        int preNum = 0;
+        int postNum = 0;
+        tree.ApplyVisitor([&](TreeNode *pNode) {
+            pNode->SetPreTickFunction([&preNum](TreeNode &) {
+                preNum++;
+                return NodeStatus::Idle;
+            });
+            pNode->SetPostTickFunction([&postNum](TreeNode &, NodeStatus) {
+                postNum++;
+                return NodeStatus::Idle;
+            });
+        });
+        tree.TickExactlyOnce();
+        CHECK(preNum > 0);
+        CHECK(preNum == postNum);
+
+        // replacing the callbacks between ticks
+        int overrideNum = 0;
+        tree.GetRootNode()->SetPreTickFunction([&overrideNum](TreeNode &) {
+            overrideNum++;
+            return NodeStatus::Failure;
+        });
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Failure);
+        CHECK(overrideNum == 1);
+
+        // removing them
+        tree.GetRootNode()->SetPreTickFunction({});
+        tree.GetRootNode()->SetPostTickFunction({});
+        tree.TickExactlyOnce();
+        CHECK(overrideNum == 1);
+    }
+
+    TEST_CASE("wait_valid_status") {
+        ActionCounters counters;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, counters);
+        auto tree = factory.CreateTreeFromText(TRANSITIONS_TREE_TEXT);
+
+        std::atomic<NodeStatus> waitedStatus{NodeStatus::Idle};
+        std::thread waiter([&]() {
+            waitedStatus = tree.GetRootNode()->WaitValidStatus();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Running);
+        waiter.join();
+        CHECK(waitedStatus.load() == NodeStatus::Running);
+    }
+
+    TEST_CASE("status_change_time_point") {
+        ActionCounters counters;
+        BehaviorTreeFactory factory;
+        RegisterActions(factory, counters);
+        auto tree = factory.CreateTreeFromText(TRANSITIONS_TREE_TEXT);
+
+        // the subscribers receive a time of std::chrono::high_resolution_clock
+        std::vector<TimePoint> timePointVec;
+        auto pSubscriber = tree.GetRootNode()->SubscribeToStatusChange([&timePointVec](TimePoint timePoint, const TreeNode &, NodeStatus, NodeStatus) {
+            timePointVec.push_back(timePoint);
+        });
+        const TimePoint before = std::chrono::high_resolution_clock::now();
+        tree.TickExactlyOnce();
+        const TimePoint after = std::chrono::high_resolution_clock::now();
+        REQUIRE_FALSE(timePointVec.empty());
+        CHECK(timePointVec.front() >= before - std::chrono::milliseconds(1));
+        CHECK(timePointVec.front() <= after + std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,151 @@
+#include "doctest/doctest.h"
+
+#include "behaviortree/factory.h"
+
+using namespace behaviortree;
+
+namespace {
+const char *TREE_TEXT = R"({
+  "behaviortree": {"treeName": "Main", "root": {"type": "Sequence", "children": [
+    {"type": "AlwaysSuccess", "_onSuccess": "counter := 1"},
+    {"type": "AlwaysSuccess", "_skipIf": "counter != 1", "_post": "counter += 1"}]}}
+})";
+
+const char *SUBTREE_TEXT = R"({
+  "mainTreeToExecute": "Main",
+  "behaviortree": [
+    {"treeName": "Main", "root": {"type": "Sequence", "children": [
+      {"type": "Add", "in": "{a}", "step": "2", "out": "{b}"},
+      {"type": "Subtree", "id": "Child", "target": "{goal}", "start": "5"},
+      {"type": "AlwaysSuccess", "name": "replaced"}]}},
+    {"treeName": "Child", "root": {"type": "Sequence", "children": [
+      {"type": "Add", "in": "{start}", "out": "{local}"},
+      {"type": "Add", "in": "{local}", "step": "10", "out": "{target}"}]}}]
+})";
+
+// out = in + step
+void RegisterAdd(BehaviorTreeFactory &rFactory) {
+    rFactory.RegisterSimpleAction(
+            "Add", [](TreeNode &rNode) {
+                int value = 0;
+                int step = 0;
+                if(!rNode.GetInput("in", value) or !rNode.GetInput("step", step)) {
+                    return NodeStatus::Failure;
+                }
+                rNode.SetOutput("out", value + step);
+                return NodeStatus::Success;
+            },
+            {InputPort<int>("in"), InputPort<int>("step", 1, "increment"), OutputPort<int>("out")}
+    );
+}
+}// namespace
+
+TEST_SUITE("tree_template") {
+    TEST_CASE("scripts_are_bound_to_each_instance") {
+        BehaviorTreeFactory factory;
+        factory.RegisterBehaviorTreeFromText(TREE_TEXT);
+        auto pTemplate = factory.GetTreeTemplate("Main");
+        REQUIRE(pTemplate != nullptr);
+
+        auto pFirstBlackboard = Blackboard::Create();
+        auto pSecondBlackboard = Blackboard::Create();
+        auto firstTree = factory.CreateTree(*pTemplate, pFirstBlackboard);
+        auto secondTree = factory.CreateTree(*pTemplate, pSecondBlackboard);
+
+        CHECK(secondTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pSecondBlackboard->Get<int>("counter") == 2);
+        // neither the other instance nor the prototype are touched
+        CHECK(pFirstBlackboard->GetEntry("counter") == nullptr);
+
+        CHECK(firstTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pFirstBlackboard->Get<int>("counter") == 2);
+        CHECK(pSecondBlackboard->Get<int>("counter") == 2);
+    }
+
+    TEST_CASE("ports_and_substitution_rules") {
+        BehaviorTreeFactory factory;
+        RegisterAdd(factory);
+        factory.RegisterBehaviorTreeFromText(SUBTREE_TEXT);
+        auto pTemplate = factory.GetTreeTemplate("Main");
+        REQUIRE(pTemplate != nullptr);
+        CHECK(pTemplate->GetSubtreesNum() == 2);
+
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", 1);
+        auto tree = factory.CreateTree(*pTemplate, pBlackboard);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        // literal port and default value of the manifest
+        CHECK(pBlackboard->Get<int>("b") == 3);
+
+        // the rules added later apply to the new template
+        factory.AddSubstitutionRule("replaced", "AlwaysFailure");
+        auto pSubstitutedTemplate = factory.GetTreeTemplate("Main");
+        REQUIRE(pSubstitutedTemplate != nullptr);
+        CHECK(pSubstitutedTemplate != pTemplate);
+        auto substitutedTree = factory.CreateTree(*pSubstitutedTemplate, pBlackboard);
+        CHECK(substitutedTree.TickExactlyOnce() == NodeStatus::Failure);
+        CHECK(substitutedTree.GetRootNode() != nullptr);
+        CHECK(factory.CreateTree("Main", pBlackboard).TickExactlyOnce() == NodeStatus::Failure);
+    }
+
+    TEST_CASE("subtree_remapping") {
+        BehaviorTreeFactory factory;
+        RegisterAdd(factory);
+        factory.RegisterBehaviorTreeFromText(SUBTREE_TEXT);
+        auto pTemplate = factory.GetTreeTemplate("Main");
+        REQUIRE(pTemplate != nullptr);
+
+        auto pBlackboard = Blackboard::Create();
+        pBlackboard->Set("a", 1);
+        auto tree = factory.CreateTree(*pTemplate, pBlackboard);
+        CHECK(tree.TickExactlyOnce() == NodeStatus::Success);
+        // "start" is a constant of the subtree, "target" is remapped to "goal"
+        CHECK(pBlackboard->Get<int>("goal") == 16);
+        // "local" stays in the blackboard of the subtree
+        CHECK(pBlackboard->GetEntry("local") == nullptr);
+        REQUIRE(tree.m_subtreeVec.size() == 2);
+        CHECK(tree.m_subtreeVec[1]->pBlackboard->Get<int>("local") == 6);
+        CHECK(tree.m_subtreeVec[1]->treeId == "Child");
+
+        // same result as the tree created by the parser
+        auto pParsedBlackboard = Blackboard::Create();
+        pParsedBlackboard->Set("a", 1);
+        auto parsedTree = factory.CreateTree("Main", pParsedBlackboard);
+        CHECK(parsedTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pParsedBlackboard->Get<int>("goal") == 16);
+    }
+
+    TEST_CASE("blackboards_are_cloned_for_each_instance") {
+        BehaviorTreeFactory factory;
+        RegisterAdd(factory);
+        factory.RegisterBehaviorTreeFromText(SUBTREE_TEXT);
+        auto pTemplate = factory.GetTreeTemplate("Main");
+        REQUIRE(pTemplate != nullptr);
+
+        auto pFirstBlackboard = Blackboard::Create();
+        pFirstBlackboard->Set("a", 1);
+        auto firstTree = factory.CreateTree(*pTemplate, pFirstBlackboard);
+        auto pSecondBlackboard = Blackboard::Create();
+        pSecondBlackboard->Set("a", 1);
+        auto secondTree = factory.CreateTree(*pTemplate, pSecondBlackboard);
+
+        const auto &pFirstChildBlackboard = firstTree.m_subtreeVec[1]->pBlackboard;
+        const auto &pSecondChildBlackboard = secondTree.m_subtreeVec[1]->pBlackboard;
+        CHECK(pFirstChildBlackboard != pSecondChildBlackboard);
+
+        // a change in an instance is not seen by the other ones
+        pFirstChildBlackboard->Set("start", std::string("100"));
+        CHECK(firstTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(secondTree.TickExactlyOnce() == NodeStatus::Success);
+        CHECK(pFirstBlackboard->Get<int>("goal") == 111);
+        CHECK(pSecondBlackboard->Get<int>("goal") == 16);
+
+        // nor by the instances created later
+        auto pThirdBlackboard = Blackboard::Create();
+        pThirdBlackboard->Set("a", 1);
+        auto thirdTree = factory.CreateTree(*pTemplate, pThirdBlackboard);
+        CHECK(thirdTree.m_subtreeVec[1]->pBlackboard->Get<std::string>("start") == "5");
+        auto pLocalEntry = thirdTree.m_subtreeVec[1]->pBlackboard->GetEntry("local");
+        CHECK((pLocalEntry == nullptr or pLocalEntry->value.Empty()));
+    }
+}
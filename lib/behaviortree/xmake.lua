@@ -26,6 +26,7 @@ add_requires("lexy")
 add_requires("nlohmann_json")
 add_requires("magic_enum")
 add_requires("conan::minicoro/0.1.3", { alias = "minicoro" })
+add_requires("doctest")
 
 target("behaviortree", function()
     set_kind("$(kind)")
@@ -65,3 +66,37 @@ target("behaviortree", function()
         --os.cp("script", outdir)
     end)
 end)
+
+target("behaviortree_test", function()
+    set_kind("binary")
+
+    add_packages("doctest")
+
+    add_deps("behaviortree")
+
+    add_files("test/*.cpp", "test/**/*.cpp|allocation/*.cpp")
+end)
+
+-- replaces the global operator new: kept out of behaviortree_test
+target("behaviortree_allocation_test", function()
+    set_kind("binary")
+
+    add_packages("doctest")
+
+    add_deps("behaviortree")
+
+    add_includedirs("test")
+    add_files("test/allocation/*.cpp")
+end)
+
+target("behaviortree_benchmark", function()
+    set_kind("binary")
+
+    add_packages("doctest")
+
+    add_deps("behaviortree")
+
+    -- the helpers shared with the tests
+    add_includedirs("test")
+    add_files("benchmark/*.cpp", "benchmark/**/*.cpp")
+end)